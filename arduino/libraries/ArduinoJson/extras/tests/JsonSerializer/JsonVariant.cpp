@@ -45,6 +45,12 @@ TEST_CASE("serializeJson(JsonVariant)") {
     check(3.1415927, "3.1415927");
   }
 
+  SECTION("Decimal") {
+    check(JsonDecimal(234, -1), "23.4");
+    check(JsonDecimal(-5, -3), "-0.005");
+    check(JsonDecimal(12, 3), "12e3");
+  }
+
   SECTION("Zero") {
     check(0, "0");
   }
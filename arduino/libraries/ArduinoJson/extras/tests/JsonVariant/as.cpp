@@ -41,6 +41,43 @@ TEST_CASE("JsonVariant::as()") {
     REQUIRE(variant.as<long>() == 0L);
   }
 
+  SECTION("set(JsonDecimal(234, -1))") {
+    variant.set(JsonDecimal(234, -1));
+
+    REQUIRE(variant.as<bool>() == true);
+    REQUIRE(variant.as<long>() == 23L);
+    REQUIRE(variant.as<double>() == Approx(23.4));
+    REQUIRE(variant.as<JsonDecimal>() == JsonDecimal(234, -1));
+    REQUIRE(variant.as<std::string>() == "23.4");
+  }
+
+  SECTION("set(JsonDecimal(-25, 1))") {
+    variant.set(JsonDecimal(-25, 1));
+
+    REQUIRE(variant.as<int>() == -250);
+    REQUIRE(variant.as<unsigned>() == 0U);
+    REQUIRE(variant.as<double>() == -250.0);
+    REQUIRE(variant.as<std::string>() == "-25e1");
+  }
+
+  SECTION("set(JsonDecimal(0, -2))") {
+    variant.set(JsonDecimal(0, -2));
+
+    REQUIRE(variant.as<bool>() == false);
+    REQUIRE(variant.as<std::string>() == "0.00");
+  }
+
+  SECTION("as<JsonDecimal>()") {
+    variant.set(-42L);
+    REQUIRE(variant.as<JsonDecimal>() == JsonDecimal(-42, 0));
+
+    variant.set("23.4");
+    REQUIRE(variant.as<JsonDecimal>() == JsonDecimal(234, -1));
+
+    variant.set(4.2);
+    REQUIRE(variant.as<JsonDecimal>() == JsonDecimal());
+  }
+
   SECTION("set(false)") {
     variant.set(false);
 
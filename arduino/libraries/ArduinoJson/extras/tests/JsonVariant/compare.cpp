@@ -70,6 +70,18 @@ void checkComparisons(T low, T mid, T high) {
 }
 
 TEST_CASE("JsonVariant comparisons") {
+  SECTION("JsonDecimal") {
+    DynamicJsonDocument doc(4096);
+    JsonVariant variant = doc.to<JsonVariant>();
+    variant.set(JsonDecimal(12345, -2));
+
+    REQUIRE(variant == 123.45);
+    REQUIRE(variant > 123.44);
+    REQUIRE(variant < 124);
+    REQUIRE(variant != "123.45");
+    REQUIRE(variant != true);
+  }
+
   SECTION("Double") {
     checkComparisons<double>(123.44, 123.45, 123.46);
   }
@@ -148,6 +148,26 @@ TEST_CASE("JsonVariant::is()") {
     testString("42");
   }
 
+  SECTION("JsonDecimal") {
+    DynamicJsonDocument doc(4096);
+    JsonVariant var = doc.to<JsonVariant>();
+
+    var.set(JsonDecimal(234, -1));
+    REQUIRE(var.is<JsonDecimal>() == true);
+    REQUIRE(var.is<double>() == true);
+    REQUIRE(var.is<int>() == false);
+    REQUIRE(var.is<char *>() == false);
+
+    var.set(42);
+    REQUIRE(var.is<JsonDecimal>() == true);
+
+    var.set(4.2);
+    REQUIRE(var.is<JsonDecimal>() == false);
+
+    var.set("23.4");
+    REQUIRE(var.is<JsonDecimal>() == false);
+  }
+
   SECTION("null") {
     DynamicJsonDocument doc(4096);
     deserializeJson(doc, "[null]");
@@ -158,5 +178,6 @@ TEST_CASE("JsonVariant::is()") {
     REQUIRE(v.is<int>() == false);
     REQUIRE(v.is<std::string>() == false);
     REQUIRE(v.is<float>() == false);
+    REQUIRE(v.is<JsonDecimal>() == false);
   }
 }
@@ -0,0 +1,13 @@
+#define ARDUINOJSON_PARSE_DECIMAL 0
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+TEST_CASE("ARDUINOJSON_PARSE_DECIMAL == 0") {
+  DynamicJsonDocument doc(4096);
+  DeserializationError err = deserializeJson(doc, "{\"t\":23.4}");
+
+  REQUIRE(err == DeserializationError::Ok);
+  REQUIRE(doc["t"].is<JsonDecimal>() == false);
+  REQUIRE(doc["t"].as<float>() == 23.4f);
+}
@@ -0,0 +1,37 @@
+#define ARDUINOJSON_PARSE_DECIMAL 1
+#include <ArduinoJson.h>
+
+#include <catch.hpp>
+
+TEST_CASE("ARDUINOJSON_PARSE_DECIMAL == 1") {
+  DynamicJsonDocument doc(4096);
+
+  SECTION("decimals") {
+    DeserializationError err =
+        deserializeJson(doc, "{\"t\":23.4,\"h\":-0.50,\"p\":1.5e3}");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc["t"].as<JsonDecimal>() == JsonDecimal(234, -1));
+    REQUIRE(doc["h"].as<JsonDecimal>() == JsonDecimal(-50, -2));
+    REQUIRE(doc["p"].as<JsonDecimal>() == JsonDecimal(15, 2));
+
+    std::string json;
+    serializeJson(doc, json);
+    REQUIRE(json == "{\"t\":23.4,\"h\":-0.50,\"p\":15e2}");
+  }
+
+  SECTION("integers") {
+    DeserializationError err = deserializeJson(doc, "[42,-7]");
+
+    REQUIRE(err == DeserializationError::Ok);
+    REQUIRE(doc[0].is<int>() == true);
+    REQUIRE(doc[0].as<int>() == 42);
+    REQUIRE(doc[1].as<int>() == -7);
+  }
+
+  SECTION("out of range") {
+    DeserializationError err = deserializeJson(doc, "[1e300]");
+
+    REQUIRE(err == DeserializationError::InvalidInput);
+  }
+}
@@ -107,6 +107,12 @@ TEST_CASE("serialize MsgPack value") {
     check(3.1415, "\xCB\x40\x09\x21\xCA\xC0\x83\x12\x6F");
   }
 
+  SECTION("decimal") {
+    check(JsonDecimal(125, -2), "\xCA\x3F\xA0\x00\x00");
+    check(JsonDecimal(-42, 0), "\xD0\xD6");
+    check(JsonDecimal(128, 0), "\xCC\x80");
+  }
+
   SECTION("fixstr") {
     check("", "\xA0");
     check("hello world hello world hello !",
@@ -0,0 +1,83 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2019
+// MIT License
+
+#include <ArduinoJson/Numbers/parseDecimal.hpp>
+#include <catch.hpp>
+
+using namespace ARDUINOJSON_NAMESPACE;
+
+void checkDecimal(const char* input, Integer mantissa, int8_t scale) {
+  CAPTURE(input);
+  ParsedDecimal result = parseDecimal(input);
+  REQUIRE(result.type() == uint8_t(VALUE_IS_DECIMAL));
+  REQUIRE(result.decimalValue.mantissa() == mantissa);
+  REQUIRE(result.decimalValue.scale() == scale);
+}
+
+void checkInvalid(const char* input) {
+  CAPTURE(input);
+  REQUIRE(parseDecimal(input).type() == uint8_t(VALUE_IS_NULL));
+}
+
+TEST_CASE("parseDecimal()") {
+  SECTION("Integers") {
+    ParsedDecimal positive = parseDecimal("234");
+    REQUIRE(positive.type() == uint8_t(VALUE_IS_POSITIVE_INTEGER));
+    REQUIRE(positive.uintValue == 234);
+
+    ParsedDecimal negative = parseDecimal("-42");
+    REQUIRE(negative.type() == uint8_t(VALUE_IS_NEGATIVE_INTEGER));
+    REQUIRE(negative.uintValue == 42);
+  }
+
+  SECTION("Fraction") {
+    checkDecimal("23.4", 234, -1);
+    checkDecimal("-23.4", -234, -1);
+    checkDecimal("+23.4", 234, -1);
+    checkDecimal("0.005", 5, -3);
+    checkDecimal(".5", 5, -1);
+    checkDecimal("23.40", 2340, -2);
+  }
+
+  SECTION("Exponent") {
+    checkDecimal("12e3", 12, 3);
+    checkDecimal("12E+3", 12, 3);
+    checkDecimal("1.5e-3", 15, -4);
+    checkDecimal("-2.5e2", -25, 1);
+  }
+
+  SECTION("Zero") {
+    checkDecimal("0.0", 0, 0);
+    checkDecimal("0e-300", 0, 0);
+  }
+
+  SECTION("Scale out of range") {
+    checkDecimal("5e130", 5000, 127);
+    checkDecimal("123e-130", 1, -128);
+    checkDecimal("1e-300", 0, 0);
+    checkInvalid("1e300");
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("Digits beyond the mantissa are dropped") {
+    checkDecimal("1.23456789012345678901234567890", 1234567890123456789, -18);
+    checkDecimal("123456789012345678901234567890.5", 1234567890123456789,
+                 11);
+  }
+#endif
+
+  SECTION("Invalid") {
+    checkInvalid("6a3");
+    checkInvalid("1.2.3");
+    checkInvalid("NaN");
+    checkInvalid("Infinity");
+    checkInvalid("");
+  }
+
+  SECTION("asDecimal()") {
+    REQUIRE(parseDecimal("23.4").asDecimal() == Decimal(234, -1));
+    REQUIRE(parseDecimal("-7").asDecimal() == Decimal(-7, 0));
+    REQUIRE(parseDecimal("x").asDecimal() == Decimal(0, 0));
+  }
+}
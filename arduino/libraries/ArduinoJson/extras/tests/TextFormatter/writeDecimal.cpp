@@ -0,0 +1,55 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2019
+// MIT License
+
+#include <catch.hpp>
+#include <string>
+
+#include <ArduinoJson/Json/TextFormatter.hpp>
+#include <ArduinoJson/Serialization/DynamicStringWriter.hpp>
+
+using namespace ARDUINOJSON_NAMESPACE;
+
+void check(Integer mantissa, int8_t scale, const std::string& expected) {
+  std::string output;
+  DynamicStringWriter<std::string> sb(output);
+  TextFormatter<DynamicStringWriter<std::string> > writer(sb);
+  writer.writeDecimal(mantissa, scale);
+  REQUIRE(writer.bytesWritten() == output.size());
+  CHECK(expected == output);
+}
+
+TEST_CASE("TextFormatter::writeDecimal()") {
+  SECTION("Integer") {
+    check(0, 0, "0");
+    check(234, 0, "234");
+    check(-234, 0, "-234");
+  }
+
+  SECTION("Fraction") {
+    check(234, -1, "23.4");
+    check(-234, -1, "-23.4");
+    check(2340, -2, "23.40");
+    check(5, -3, "0.005");
+    check(-5, -3, "-0.005");
+    check(0, -2, "0.00");
+  }
+
+  SECTION("Positive scale") {
+    check(12, 3, "12e3");
+    check(-12, 127, "-12e127");
+  }
+
+  SECTION("Many decimal places") {
+    check(1, -24, "0.000000000000000000000001");
+    check(1, -25, "1e-25");
+    check(-15, -128, "-15e-128");
+  }
+
+#if ARDUINOJSON_USE_LONG_LONG
+  SECTION("Extremes") {
+    check(9223372036854775807, -1, "922337203685477580.7");
+    check(-9223372036854775807 - 1, -24, "-0.000009223372036854775808");
+  }
+#endif
+}
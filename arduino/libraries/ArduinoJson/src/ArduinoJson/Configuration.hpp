@@ -139,6 +139,12 @@
 #define ARDUINOJSON_DECODE_UNICODE 0
 #endif
 
+// Parse the numbers with a fraction or an exponent as decimals instead of
+// floats, to avoid the float arithmetic in deserializeJson()
+#ifndef ARDUINOJSON_PARSE_DECIMAL
+#define ARDUINOJSON_PARSE_DECIMAL 0
+#endif
+
 // Support NaN in JSON
 #ifndef ARDUINOJSON_ENABLE_NAN
 #define ARDUINOJSON_ENABLE_NAN 0
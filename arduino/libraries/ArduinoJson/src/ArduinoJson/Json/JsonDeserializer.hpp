@@ -8,6 +8,7 @@
 #include <ArduinoJson/Json/EscapeSequence.hpp>
 #include <ArduinoJson/Json/Utf8.hpp>
 #include <ArduinoJson/Memory/MemoryPool.hpp>
+#include <ArduinoJson/Numbers/parseDecimal.hpp>
 #include <ArduinoJson/Numbers/parseNumber.hpp>
 #include <ArduinoJson/Polyfills/type_traits.hpp>
 #include <ArduinoJson/Variant/VariantData.hpp>
@@ -272,7 +273,11 @@ class JsonDeserializer {
                     : DeserializationError::IncompleteInput;
     }
 
+#if ARDUINOJSON_PARSE_DECIMAL
+    ParsedDecimal num = parseDecimal(buffer);
+#else
     ParsedNumber<Float, UInt> num = parseNumber<Float, UInt>(buffer);
+#endif
 
     switch (num.type()) {
       case VALUE_IS_NEGATIVE_INTEGER:
@@ -283,9 +288,15 @@ class JsonDeserializer {
         result.setPositiveInteger(num.uintValue);
         return DeserializationError::Ok;
 
+#if ARDUINOJSON_PARSE_DECIMAL
+      case VALUE_IS_DECIMAL:
+        result.setDecimal(num.decimalValue);
+        return DeserializationError::Ok;
+#else
       case VALUE_IS_FLOAT:
         result.setFloat(num.floatValue);
         return DeserializationError::Ok;
+#endif
     }
 
     return DeserializationError::InvalidInput;
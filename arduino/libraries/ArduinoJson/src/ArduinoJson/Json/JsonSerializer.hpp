@@ -56,6 +56,10 @@ class JsonSerializer {
     _formatter.writeFloat(value);
   }
 
+  void visitDecimal(Integer mantissa, int8_t scale) {
+    _formatter.writeDecimal(mantissa, scale);
+  }
+
   void visitString(const char *value) {
     _formatter.writeString(value);
   }
@@ -87,6 +87,49 @@ class TextFormatter {
     }
   }
 
+  // Writes mantissa * 10^scale with integer arithmetic only:
+  // (234, -1) -> 23.4, (5, -3) -> 0.005, (12, 3) -> 12e3
+  void writeDecimal(Integer mantissa, int8_t scale) {
+    UInt value = static_cast<UInt>(mantissa);
+    if (mantissa < 0) {
+      writeRaw('-');
+      value = ~value + 1;
+    }
+
+    // the exponent notation avoids the long runs of zeros
+    if (scale >= 0 || scale < -maxDecimalPlaces) {
+      writePositiveInteger(value);
+      if (scale < 0) {
+        writeRaw("e-");
+        writePositiveInteger(uint8_t(-scale));
+      } else if (scale > 0) {
+        writeRaw('e');
+        writePositiveInteger(uint8_t(scale));
+      }
+      return;
+    }
+
+    // buffer should be big enough for the decimal places, the dot, and all
+    // the digits of the integral part
+    char buffer[maxDecimalPlaces + 22];
+    char *end = buffer + sizeof(buffer);
+    char *begin = end;
+
+    // write the string in reverse order
+    for (int8_t i = 0; i > scale; i--) {
+      *--begin = char(value % 10 + '0');
+      value /= 10;
+    }
+    *--begin = '.';
+    do {
+      *--begin = char(value % 10 + '0');
+      value /= 10;
+    } while (value);
+
+    // and dump it in the right order
+    writeRaw(begin, end);
+  }
+
   void writeNegativeInteger(UInt value) {
     writeRaw('-');
     writePositiveInteger(value);
@@ -151,6 +194,9 @@ class TextFormatter {
   size_t _length;
 
  private:
+  // beyond this, writeDecimal() uses the exponent notation
+  static const int8_t maxDecimalPlaces = 24;
+
   TextFormatter &operator=(const TextFormatter &);  // cannot be assigned
 };
 }  // namespace ARDUINOJSON_NAMESPACE
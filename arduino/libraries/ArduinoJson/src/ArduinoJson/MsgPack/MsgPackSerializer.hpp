@@ -36,6 +36,16 @@ class MsgPackSerializer {
     }
   }
 
+  // MessagePack has no decimal type
+  void visitDecimal(Integer mantissa, int8_t scale) {
+    if (scale != 0)
+      visitFloat(convertDecimal<Float>(mantissa, scale));
+    else if (mantissa < 0)
+      visitNegativeInteger(~static_cast<UInt>(mantissa) + 1);
+    else
+      visitPositiveInteger(static_cast<UInt>(mantissa));
+  }
+
   void visitArray(const CollectionData& array) {
     size_t n = array.size();
     if (n < 0x10) {
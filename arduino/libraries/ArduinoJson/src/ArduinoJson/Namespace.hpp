@@ -14,13 +14,15 @@
 #define ARDUINOJSON_CONCAT8(A, B, C, D, E, F, G, H)    \
   ARDUINOJSON_CONCAT2(ARDUINOJSON_CONCAT4(A, B, C, D), \
                       ARDUINOJSON_CONCAT4(E, F, G, H))
-#define ARDUINOJSON_CONCAT11(A, B, C, D, E, F, G, H, I, J, K) \
-  ARDUINOJSON_CONCAT8(A, B, C, D, E, F, G, ARDUINOJSON_CONCAT4(H, I, J, K))
+#define ARDUINOJSON_CONCAT12(A, B, C, D, E, F, G, H, I, J, K, L)            \
+  ARDUINOJSON_CONCAT8(A, B, C, D, ARDUINOJSON_CONCAT2(E, F),                \
+                      ARDUINOJSON_CONCAT2(G, H), ARDUINOJSON_CONCAT2(I, J), \
+                      ARDUINOJSON_CONCAT2(K, L))
 
 #define ARDUINOJSON_NAMESPACE                                            \
-  ARDUINOJSON_CONCAT11(                                                  \
+  ARDUINOJSON_CONCAT12(                                                  \
       ArduinoJson, ARDUINOJSON_VERSION_MAJOR, ARDUINOJSON_VERSION_MINOR, \
       ARDUINOJSON_VERSION_REVISION, _, ARDUINOJSON_USE_LONG_LONG,        \
       ARDUINOJSON_USE_DOUBLE, ARDUINOJSON_DECODE_UNICODE,                \
       ARDUINOJSON_ENABLE_NAN, ARDUINOJSON_ENABLE_INFINITY,               \
-      ARDUINOJSON_ENABLE_PROGMEM)
+      ARDUINOJSON_ENABLE_PROGMEM, ARDUINOJSON_PARSE_DECIMAL)
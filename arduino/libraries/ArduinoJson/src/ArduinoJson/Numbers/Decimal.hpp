@@ -0,0 +1,75 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2019
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/FloatTraits.hpp>
+#include <ArduinoJson/Numbers/Integer.hpp>
+#include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Polyfills/type_traits.hpp>
+
+namespace ARDUINOJSON_NAMESPACE {
+
+// A fixed-point decimal number: mantissa * 10^scale.
+// For example, Decimal(234, -1) is 23.4.
+// It's serialized exactly, with integer arithmetic only.
+class Decimal {
+ public:
+  Decimal() : _mantissa(0), _scale(0) {}
+  Decimal(Integer mantissa, int8_t scale)
+      : _mantissa(mantissa), _scale(scale) {}
+
+  Integer mantissa() const {
+    return _mantissa;
+  }
+
+  int8_t scale() const {
+    return _scale;
+  }
+
+  // Same mantissa and same scale (23.4 is not 23.40)
+  bool operator==(const Decimal& other) const {
+    return _mantissa == other._mantissa && _scale == other._scale;
+  }
+
+  bool operator!=(const Decimal& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  Integer _mantissa;
+  int8_t _scale;
+};
+
+// Truncates toward zero, returns 0 if the value doesn't fit
+template <typename TOut>
+typename enable_if<!is_floating_point<TOut>::value, TOut>::type convertDecimal(
+    Integer mantissa, int8_t scale) {
+  bool is_negative = mantissa < 0;
+  UInt value = static_cast<UInt>(mantissa);
+  if (is_negative) value = ~value + 1;
+
+  for (; scale < 0 && value != 0; scale++) value /= 10;
+  for (; scale > 0 && value != 0; scale--) {
+    if (value > UInt(-1) / 10) return 0;
+    value *= 10;
+  }
+
+  return is_negative ? convertNegativeInteger<TOut>(value)
+                     : convertPositiveInteger<TOut>(value);
+}
+
+template <typename TOut>
+typename enable_if<is_floating_point<TOut>::value, TOut>::type convertDecimal(
+    Integer mantissa, int8_t scale) {
+  typedef FloatTraits<TOut> traits;
+  TOut value = static_cast<TOut>(mantissa);
+
+  // make_float() only has the powers of ten of the range of TOut
+  for (; scale < -traits::exponent_max; scale++) value /= 10;
+  for (; scale > traits::exponent_max; scale--) value *= 10;
+
+  return traits::make_float(value, int(scale));
+}
+}  // namespace ARDUINOJSON_NAMESPACE
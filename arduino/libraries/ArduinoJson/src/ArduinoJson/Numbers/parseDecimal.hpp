@@ -0,0 +1,148 @@
+// ArduinoJson - arduinojson.org
+// Copyright Benoit Blanchon 2014-2019
+// MIT License
+
+#pragma once
+
+#include <ArduinoJson/Numbers/Decimal.hpp>
+#include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Polyfills/assert.hpp>
+#include <ArduinoJson/Polyfills/ctype.hpp>
+#include <ArduinoJson/Polyfills/limits.hpp>
+#include <ArduinoJson/Variant/VariantContent.hpp>
+
+namespace ARDUINOJSON_NAMESPACE {
+
+struct ParsedDecimal {
+  ParsedDecimal() : uintValue(0), _type(VALUE_IS_NULL) {}
+
+  ParsedDecimal(UInt value, bool is_negative)
+      : uintValue(value),
+        _type(uint8_t(is_negative ? VALUE_IS_NEGATIVE_INTEGER
+                                  : VALUE_IS_POSITIVE_INTEGER)) {}
+  ParsedDecimal(Decimal value)
+      : uintValue(0), decimalValue(value), _type(VALUE_IS_DECIMAL) {}
+
+  Decimal asDecimal() const {
+    switch (_type) {
+      case VALUE_IS_NEGATIVE_INTEGER:
+        return Decimal(convertNegativeInteger<Integer>(uintValue), 0);
+      case VALUE_IS_POSITIVE_INTEGER:
+        return Decimal(convertPositiveInteger<Integer>(uintValue), 0);
+      case VALUE_IS_DECIMAL:
+        return decimalValue;
+      default:
+        return Decimal();
+    }
+  }
+
+  uint8_t type() const {
+    return _type;
+  }
+
+  UInt uintValue;
+  Decimal decimalValue;
+  uint8_t _type;
+};
+
+// Same syntax as parseNumber(), but with integer arithmetic only: the numbers
+// with a fraction or an exponent become a Decimal.
+// The digits that don't fit in the mantissa are dropped; NaN, Infinity, and
+// the numbers out of the range of Decimal are invalid.
+inline ParsedDecimal parseDecimal(const char *s) {
+  ARDUINOJSON_ASSERT(s != 0);
+
+  bool is_negative = false;
+  switch (*s) {
+    case '-':
+      is_negative = true;
+      s++;
+      break;
+    case '+':
+      s++;
+      break;
+  }
+
+  if (!isdigit(*s) && *s != '.') return ParsedDecimal();
+
+  UInt mantissa = 0;
+  const UInt maxUint = UInt(-1);
+
+  while (isdigit(*s)) {
+    uint8_t digit = uint8_t(*s - '0');
+    if (mantissa > maxUint / 10) break;
+    if (mantissa * 10 > maxUint - digit) break;
+    mantissa = mantissa * 10 + digit;
+    s++;
+  }
+
+  if (*s == '\0') return ParsedDecimal(mantissa, is_negative);
+
+  const UInt maxMantissa = UInt(numeric_limits<Integer>::highest());
+  int exponent = 0;
+
+  // avoid mantissa overflow
+  while (mantissa > maxMantissa) {
+    mantissa /= 10;
+    exponent++;
+  }
+
+  // remaing digits can't fit in the mantissa
+  while (isdigit(*s)) {
+    exponent++;
+    s++;
+  }
+
+  if (*s == '.') {
+    s++;
+    while (isdigit(*s)) {
+      uint8_t digit = uint8_t(*s - '0');
+      if (mantissa <= (maxMantissa - digit) / 10) {
+        mantissa = mantissa * 10 + digit;
+        exponent--;
+      }
+      s++;
+    }
+  }
+
+  if (*s == 'e' || *s == 'E') {
+    s++;
+    bool negative_exponent = false;
+    if (*s == '-') {
+      negative_exponent = true;
+      s++;
+    } else if (*s == '+') {
+      s++;
+    }
+
+    int value = 0;
+    while (isdigit(*s)) {
+      // far beyond the range of the scale, but can't overflow
+      if (value < 1000) value = value * 10 + (*s - '0');
+      s++;
+    }
+    exponent += negative_exponent ? -value : value;
+  }
+
+  // we should be at the end of the string, otherwise it's an error
+  if (*s != '\0') return ParsedDecimal();
+
+  if (mantissa == 0) exponent = 0;
+
+  // bring the exponent in the range of the scale, without changing the value
+  while (exponent < numeric_limits<int8_t>::lowest() && mantissa != 0) {
+    mantissa /= 10;
+    exponent++;
+  }
+  if (mantissa == 0) exponent = 0;
+  while (exponent > numeric_limits<int8_t>::highest() &&
+         mantissa <= maxMantissa / 10) {
+    mantissa *= 10;
+    exponent--;
+  }
+  if (exponent > numeric_limits<int8_t>::highest()) return ParsedDecimal();
+
+  Integer value = static_cast<Integer>(mantissa);
+  return Decimal(is_negative ? -value : value, int8_t(exponent));
+}
+}  // namespace ARDUINOJSON_NAMESPACE
@@ -21,6 +21,7 @@ struct Comparer<T, typename enable_if<IsString<T>::value>::type> {
   void visitArray(const CollectionData &) {}
   void visitObject(const CollectionData &) {}
   void visitFloat(Float) {}
+  void visitDecimal(Integer, int8_t) {}
   void visitString(const char *lhs) {
     result = -adaptString(rhs).compare(lhs);
   }
@@ -56,6 +57,9 @@ struct Comparer<T, typename enable_if<is_integral<T>::value ||
   void visitFloat(Float lhs) {
     result = sign(lhs - static_cast<Float>(rhs));
   }
+  void visitDecimal(Integer mantissa, int8_t scale) {
+    visitFloat(convertDecimal<Float>(mantissa, scale));
+  }
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
   void visitNegativeInteger(UInt lhs) {
@@ -78,6 +82,7 @@ struct Comparer<bool, void> {
   void visitArray(const CollectionData &) {}
   void visitObject(const CollectionData &) {}
   void visitFloat(Float) {}
+  void visitDecimal(Integer, int8_t) {}
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
   void visitNegativeInteger(UInt) {}
@@ -98,6 +103,7 @@ struct Comparer<decltype(nullptr), void> {
   void visitArray(const CollectionData &) {}
   void visitObject(const CollectionData &) {}
   void visitFloat(Float) {}
+  void visitDecimal(Integer, int8_t) {}
   void visitString(const char *) {}
   void visitRawJson(const char *, size_t) {}
   void visitNegativeInteger(UInt) {}
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <ArduinoJson/Numbers/Decimal.hpp>
 #include <ArduinoJson/Serialization/DynamicStringWriter.hpp>
 
 namespace ARDUINOJSON_NAMESPACE {
@@ -69,6 +70,12 @@ inline typename enable_if<is_floating_point<T>::value, T>::type variantAs(
   return _data != 0 ? _data->asFloat<T>() : T(0);
 }
 
+template <typename T>
+inline typename enable_if<is_same<T, Decimal>::value, T>::type variantAs(
+    const VariantData* _data) {
+  return _data != 0 ? _data->asDecimal() : Decimal();
+}
+
 template <typename T>
 inline typename enable_if<is_same<T, const char*>::value ||
                               is_same<T, char*>::value,
@@ -28,6 +28,7 @@ enum {
   VALUE_IS_POSITIVE_INTEGER = 0x08,
   VALUE_IS_NEGATIVE_INTEGER = 0x0A,
   VALUE_IS_FLOAT = 0x0C,
+  VALUE_IS_DECIMAL = 0x0E,
 
   COLLECTION_MASK = 0x60,
   VALUE_IS_OBJECT = 0x20,
@@ -50,5 +51,9 @@ union VariantContent {
     const char *data;
     size_t size;
   } asRaw;
+  struct {
+    Integer mantissa;
+    int8_t scale;
+  } asDecimal;
 };
 }  // namespace ARDUINOJSON_NAMESPACE
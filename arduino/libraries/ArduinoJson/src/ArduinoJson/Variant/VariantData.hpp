@@ -5,6 +5,7 @@
 #pragma once
 
 #include <ArduinoJson/Misc/SerializedValue.hpp>
+#include <ArduinoJson/Numbers/Decimal.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
 #include <ArduinoJson/Polyfills/gsl/not_null.hpp>
 #include <ArduinoJson/Strings/RamStringAdapter.hpp>
@@ -29,6 +30,10 @@ class VariantData {
       case VALUE_IS_FLOAT:
         return visitor.visitFloat(_content.asFloat);
 
+      case VALUE_IS_DECIMAL:
+        return visitor.visitDecimal(_content.asDecimal.mantissa,
+                                    _content.asDecimal.scale);
+
       case VALUE_IS_ARRAY:
         return visitor.visitArray(_content.asCollection);
 
@@ -63,6 +68,8 @@ class VariantData {
   template <typename T>
   T asFloat() const;
 
+  Decimal asDecimal() const;
+
   const char *asString() const;
 
   bool asBoolean() const;
@@ -131,6 +138,11 @@ class VariantData {
       case VALUE_IS_FLOAT:
         return _content.asFloat == other._content.asFloat;
 
+      case VALUE_IS_DECIMAL:
+        return _content.asDecimal.mantissa ==
+                   other._content.asDecimal.mantissa &&
+               _content.asDecimal.scale == other._content.asDecimal.scale;
+
       case VALUE_IS_NULL:
       default:
         return true;
@@ -164,10 +176,15 @@ class VariantData {
   }
 
   bool isFloat() const {
-    return type() == VALUE_IS_FLOAT || type() == VALUE_IS_POSITIVE_INTEGER ||
+    return type() == VALUE_IS_FLOAT || type() == VALUE_IS_DECIMAL ||
+           type() == VALUE_IS_POSITIVE_INTEGER ||
            type() == VALUE_IS_NEGATIVE_INTEGER;
   }
 
+  bool isDecimal() const {
+    return type() == VALUE_IS_DECIMAL || isInteger<Integer>();
+  }
+
   bool isString() const {
     return type() == VALUE_IS_LINKED_STRING || type() == VALUE_IS_OWNED_STRING;
   }
@@ -203,6 +220,12 @@ class VariantData {
     _content.asFloat = value;
   }
 
+  void setDecimal(Decimal value) {
+    setType(VALUE_IS_DECIMAL);
+    _content.asDecimal.mantissa = value.mantissa();
+    _content.asDecimal.scale = value.scale();
+  }
+
   void setLinkedRaw(SerializedValue<const char *> value) {
     if (value.data()) {
       setType(VALUE_IS_LINKED_RAW);
@@ -61,6 +61,10 @@ inline bool variantIsFloat(const VariantData *var) {
   return var && var->isFloat();
 }
 
+inline bool variantIsDecimal(const VariantData *var) {
+  return var && var->isDecimal();
+}
+
 inline bool variantIsString(const VariantData *var) {
   return var && var->isString();
 }
@@ -85,6 +89,12 @@ inline bool variantSetFloat(VariantData *var, Float value) {
   return true;
 }
 
+inline bool variantSetDecimal(VariantData *var, Decimal value) {
+  if (!var) return false;
+  var->setDecimal(value);
+  return true;
+}
+
 inline bool variantSetLinkedRaw(VariantData *var,
                                 SerializedValue<const char *> value) {
   if (!var) return false;
@@ -6,6 +6,7 @@
 
 #include <ArduinoJson/Configuration.hpp>
 #include <ArduinoJson/Numbers/convertNumber.hpp>
+#include <ArduinoJson/Numbers/parseDecimal.hpp>
 #include <ArduinoJson/Numbers/parseFloat.hpp>
 #include <ArduinoJson/Numbers/parseInteger.hpp>
 #include <ArduinoJson/Variant/VariantRef.hpp>
@@ -27,6 +28,9 @@ inline T VariantData::asIntegral() const {
       return parseInteger<T>(_content.asString);
     case VALUE_IS_FLOAT:
       return convertFloat<T>(_content.asFloat);
+    case VALUE_IS_DECIMAL:
+      return convertDecimal<T>(_content.asDecimal.mantissa,
+                               _content.asDecimal.scale);
     default:
       return 0;
   }
@@ -40,6 +44,8 @@ inline bool VariantData::asBoolean() const {
       return _content.asInteger != 0;
     case VALUE_IS_FLOAT:
       return _content.asFloat != 0;
+    case VALUE_IS_DECIMAL:
+      return _content.asDecimal.mantissa != 0;
     case VALUE_IS_NULL:
       return false;
     default:
@@ -61,11 +67,32 @@ inline T VariantData::asFloat() const {
       return parseFloat<T>(_content.asString);
     case VALUE_IS_FLOAT:
       return static_cast<T>(_content.asFloat);
+    case VALUE_IS_DECIMAL:
+      return convertDecimal<T>(_content.asDecimal.mantissa,
+                               _content.asDecimal.scale);
     default:
       return 0;
   }
 }
 
+// Integers, decimals, and strings (parsed without float arithmetic)
+inline Decimal VariantData::asDecimal() const {
+  switch (type()) {
+    case VALUE_IS_POSITIVE_INTEGER:
+    case VALUE_IS_BOOLEAN:
+      return Decimal(convertPositiveInteger<Integer>(_content.asInteger), 0);
+    case VALUE_IS_NEGATIVE_INTEGER:
+      return Decimal(convertNegativeInteger<Integer>(_content.asInteger), 0);
+    case VALUE_IS_LINKED_STRING:
+    case VALUE_IS_OWNED_STRING:
+      return parseDecimal(_content.asString).asDecimal();
+    case VALUE_IS_DECIMAL:
+      return Decimal(_content.asDecimal.mantissa, _content.asDecimal.scale);
+    default:
+      return Decimal();
+  }
+}
+
 inline const char *VariantData::asString() const {
   switch (type()) {
     case VALUE_IS_LINKED_STRING:
@@ -54,6 +54,13 @@ class VariantRefBase {
     return variantIsFloat(_data);
   }
   //
+  // bool is<Decimal>() const;
+  template <typename T>
+  FORCE_INLINE typename enable_if<is_same<T, Decimal>::value, bool>::type is()
+      const {
+    return variantIsDecimal(_data);
+  }
+  //
   // bool is<bool>() const
   template <typename T>
   FORCE_INLINE typename enable_if<is_same<T, bool>::value, bool>::type is()
@@ -156,6 +163,11 @@ class VariantRef : public VariantRefBase<VariantData>,
     return variantSetFloat(_data, static_cast<Float>(value));
   }
 
+  // set(Decimal)
+  FORCE_INLINE bool set(Decimal value) const {
+    return variantSetDecimal(_data, value);
+  }
+
   // set(char)
   // set(signed short)
   // set(signed int)
@@ -9,6 +9,9 @@
 
 PubSubClient::PubSubClient() {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     this->_client = NULL;
     this->stream = NULL;
     setCallback(NULL);
@@ -16,24 +19,36 @@ PubSubClient::PubSubClient() {
 
 PubSubClient::PubSubClient(Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setClient(client);
     this->stream = NULL;
 }
 
 PubSubClient::PubSubClient(IPAddress addr, uint16_t port, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(addr, port);
     setClient(client);
     this->stream = NULL;
 }
 PubSubClient::PubSubClient(IPAddress addr, uint16_t port, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(addr,port);
     setClient(client);
     setStream(stream);
 }
 PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(addr, port);
     setCallback(callback);
     setClient(client);
@@ -41,6 +56,9 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATUR
 }
 PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(addr,port);
     setCallback(callback);
     setClient(client);
@@ -49,18 +67,27 @@ PubSubClient::PubSubClient(IPAddress addr, uint16_t port, MQTT_CALLBACK_SIGNATUR
 
 PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(ip, port);
     setClient(client);
     this->stream = NULL;
 }
 PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(ip,port);
     setClient(client);
     setStream(stream);
 }
 PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(ip, port);
     setCallback(callback);
     setClient(client);
@@ -68,6 +95,9 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE,
 }
 PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(ip,port);
     setCallback(callback);
     setClient(client);
@@ -76,18 +106,27 @@ PubSubClient::PubSubClient(uint8_t *ip, uint16_t port, MQTT_CALLBACK_SIGNATURE,
 
 PubSubClient::PubSubClient(const char* domain, uint16_t port, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(domain,port);
     setClient(client);
     this->stream = NULL;
 }
 PubSubClient::PubSubClient(const char* domain, uint16_t port, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(domain,port);
     setClient(client);
     setStream(stream);
 }
 PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(domain,port);
     setCallback(callback);
     setClient(client);
@@ -95,6 +134,9 @@ PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGN
 }
 PubSubClient::PubSubClient(const char* domain, uint16_t port, MQTT_CALLBACK_SIGNATURE, Client& client, Stream& stream) {
     this->_state = MQTT_DISCONNECTED;
+    this->nextMsgId = 0;
+    this->pubQueueLength = 0;
+    this->inflightCount = 0;
     setServer(domain,port);
     setCallback(callback);
     setClient(client);
@@ -118,6 +160,31 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
 }
 
 boolean PubSubClient::connect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession) {
+    if (!beginConnect(id,user,pass,willTopic,willQos,willRetain,willMessage,cleanSession)) {
+        return false;
+    }
+    while (pollConnect() == MQTT_CONNECTING) {
+        yield();
+    }
+    return connected();
+}
+
+boolean PubSubClient::beginConnect(const char *id) {
+    return beginConnect(id,NULL,NULL,0,0,0,0,1);
+}
+
+boolean PubSubClient::beginConnect(const char *id, const char *user, const char *pass) {
+    return beginConnect(id,user,pass,0,0,0,0,1);
+}
+
+boolean PubSubClient::beginConnect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage) {
+    return beginConnect(id,user,pass,willTopic,willQos,willRetain,willMessage,1);
+}
+
+boolean PubSubClient::beginConnect(const char *id, const char *user, const char *pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession) {
+    if (_state == MQTT_CONNECTING) {
+        return true;
+    }
     if (!connected()) {
         int result = 0;
 
@@ -187,29 +254,9 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
             write(MQTTCONNECT,buffer,length-MQTT_MAX_HEADER_SIZE);
 
             lastInActivity = lastOutActivity = millis();
-
-            while (!_client->available()) {
-                unsigned long t = millis();
-                if (t-lastInActivity >= ((int32_t) MQTT_SOCKET_TIMEOUT*1000UL)) {
-                    _state = MQTT_CONNECTION_TIMEOUT;
-                    _client->stop();
-                    return false;
-                }
-            }
-            uint8_t llen;
-            uint16_t len = readPacket(&llen);
-
-            if (len == 4) {
-                if (buffer[3] == 0) {
-                    lastInActivity = millis();
-                    pingOutstanding = false;
-                    _state = MQTT_CONNECTED;
-                    return true;
-                } else {
-                    _state = buffer[3];
-                }
-            }
-            _client->stop();
+            connackLength = 0;
+            _state = MQTT_CONNECTING;
+            return true;
         } else {
             _state = MQTT_CONNECT_FAILED;
         }
@@ -218,6 +265,39 @@ boolean PubSubClient::connect(const char *id, const char *user, const char *pass
     return true;
 }
 
+int PubSubClient::pollConnect() {
+    if (_state != MQTT_CONNECTING) {
+        return _state;
+    }
+    // CONNACK = fixed header, length (2), flags & return code: taken byte by byte as they arrive
+    while ((connackLength < 4) && _client->available()) {
+        buffer[connackLength++] = _client->read();
+    }
+    if (connackLength == 4) {
+        if ((buffer[0] != MQTTCONNACK) || (buffer[1] != 2)) {
+            _state = MQTT_CONNECT_FAILED;
+        } else if (buffer[3] == 0) {
+            lastInActivity = millis();
+            pingOutstanding = false;
+            _state = MQTT_CONNECTED;
+            // Replay the QoS1 messages not acknowledged & the ones queued while disconnected
+            inflightCount = 0;
+            sendQueued();
+            return _state;
+        } else {
+            _state = buffer[3];
+        }
+        _client->stop();
+    } else if (!_client->connected()) {
+        // Closed by the server
+        _state = MQTT_CONNECT_FAILED;
+    } else if (millis()-lastInActivity >= ((int32_t) MQTT_SOCKET_TIMEOUT*1000UL)) {
+        _state = MQTT_CONNECTION_TIMEOUT;
+        _client->stop();
+    }
+    return _state;
+}
+
 // reads a byte into result
 boolean PubSubClient::readByte(uint8_t * result) {
    uint32_t previousMillis = millis();
@@ -300,6 +380,9 @@ uint16_t PubSubClient::readPacket(uint8_t* lengthLength) {
 }
 
 boolean PubSubClient::loop() {
+    if ((_state == MQTT_CONNECTING) && (pollConnect() != MQTT_CONNECTED)) {
+        return false;
+    }
     if (connected()) {
         unsigned long t = millis();
         if ((t - lastInActivity > MQTT_KEEPALIVE*1000UL) || (t - lastOutActivity > MQTT_KEEPALIVE*1000UL)) {
@@ -316,6 +399,7 @@ boolean PubSubClient::loop() {
                 pingOutstanding = true;
             }
         }
+        retryPublishes(t);
         if (_client->available()) {
             uint8_t llen;
             uint16_t len = readPacket(&llen);
@@ -354,6 +438,8 @@ boolean PubSubClient::loop() {
                     _client->write(buffer,2);
                 } else if (type == MQTTPINGRESP) {
                     pingOutstanding = false;
+                } else if (type == MQTTPUBACK) {
+                    ackPublish((buffer[llen+1]<<8)+buffer[llen+2]);
                 }
             } else if (!connected()) {
                 // readPacket has closed the connection
@@ -399,6 +485,140 @@ boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigne
     return false;
 }
 
+boolean PubSubClient::publish(const char* topic, const uint8_t* payload, unsigned int plength, boolean retained, uint8_t qos) {
+    if (qos == 0) {
+        return publish(topic, payload, plength, retained);
+    }
+    if (qos > 1) {
+        return false;
+    }
+    if (MQTT_MAX_PACKET_SIZE < MQTT_MAX_HEADER_SIZE + 2+strlen(topic) + 2 + plength) {
+        // Too long
+        return false;
+    }
+    // Leave room in the buffer for header and variable length field
+    uint16_t length = MQTT_MAX_HEADER_SIZE;
+    length = writeString(topic,buffer,length);
+    uint16_t msgIdPos = length;
+    length += 2;
+    uint16_t i;
+    for (i=0;i<plength;i++) {
+        buffer[length++] = payload[i];
+    }
+    uint8_t header = MQTTPUBLISH|MQTTQOS1;
+    if (retained) {
+        header |= 1;
+    }
+    uint8_t hlen = buildHeader(header,buffer,length-MQTT_MAX_HEADER_SIZE);
+    uint16_t start = MQTT_MAX_HEADER_SIZE-hlen;
+    return queuePacket(buffer+start,length-start,msgIdPos-start);
+}
+
+boolean PubSubClient::queuePacket(const uint8_t* packet, uint16_t length, uint16_t msgIdPos) {
+    if ((msgIdPos + 2 > length) || (pubQueueLength + 4 + length > MQTT_QOS1_QUEUE_SIZE)) {
+        // Queue full
+        return false;
+    }
+    uint16_t msgId = nextPacketId();
+
+    uint8_t* record = pubQueue+pubQueueLength;
+    record[0] = (length >> 8);
+    record[1] = (length & 0xFF);
+    record[2] = (msgId >> 8);
+    record[3] = (msgId & 0xFF);
+    memcpy(record+4,packet,length);
+    record[4+msgIdPos] = (msgId >> 8);
+    record[4+msgIdPos+1] = (msgId & 0xFF);
+    pubQueueLength += 4+length;
+
+    if (connected()) {
+        sendQueued();
+    }
+    return true;
+}
+
+uint16_t PubSubClient::pendingPublishes() {
+    uint16_t count = 0;
+    for (uint16_t pos = 0; pos < pubQueueLength; pos += 4+((pubQueue[pos]<<8)|pubQueue[pos+1])) {
+        count++;
+    }
+    return count;
+}
+
+uint16_t PubSubClient::nextPacketId() {
+    boolean used;
+    do {
+        nextMsgId++;
+        if (nextMsgId == 0) {
+            nextMsgId = 1;
+        }
+        used = false;
+        for (uint16_t pos = 0; pos < pubQueueLength; pos += 4+((pubQueue[pos]<<8)|pubQueue[pos+1])) {
+            if (((pubQueue[pos+2]<<8)|pubQueue[pos+3]) == nextMsgId) {
+                used = true;
+            }
+        }
+    } while (used);
+    return nextMsgId;
+}
+
+void PubSubClient::sendQueued() {
+    // Skip the records in flight
+    uint16_t pos = 0;
+    uint8_t i;
+    for (i = 0; i < inflightCount; i++) {
+        pos += 4+((pubQueue[pos]<<8)|pubQueue[pos+1]);
+    }
+    while ((inflightCount < MQTT_MAX_INFLIGHT) && (pos < pubQueueLength)) {
+        uint16_t plen = (pubQueue[pos]<<8)|pubQueue[pos+1];
+        if (!writePacket(pubQueue+pos+4,plen)) {
+            return;
+        }
+        // Any later send of this message is a duplicate
+        pubQueue[pos+4] |= MQTTDUP;
+        inflightId[inflightCount] = (pubQueue[pos+2]<<8)|pubQueue[pos+3];
+        inflightTime[inflightCount] = millis();
+        inflightCount++;
+        pos += 4+plen;
+    }
+}
+
+void PubSubClient::retryPublishes(unsigned long t) {
+    uint16_t pos = 0;
+    uint8_t i;
+    for (i = 0; i < inflightCount; i++) {
+        uint16_t plen = (pubQueue[pos]<<8)|pubQueue[pos+1];
+        if (t - inflightTime[i] >= MQTT_RETRY_TIMEOUT*1000UL) {
+            if (!writePacket(pubQueue+pos+4,plen)) {
+                return;
+            }
+            inflightTime[i] = t;
+        }
+        pos += 4+plen;
+    }
+}
+
+void PubSubClient::ackPublish(uint16_t msgId) {
+    uint16_t pos = 0;
+    uint8_t i;
+    for (i = 0; i < inflightCount; i++) {
+        uint16_t rlen = 4+((pubQueue[pos]<<8)|pubQueue[pos+1]);
+        if (inflightId[i] == msgId) {
+            memmove(pubQueue+pos,pubQueue+pos+rlen,pubQueueLength-pos-rlen);
+            pubQueueLength -= rlen;
+            for (; i+1 < inflightCount; i++) {
+                inflightId[i] = inflightId[i+1];
+                inflightTime[i] = inflightTime[i+1];
+            }
+            inflightCount--;
+            // A place in the window for the next one
+            sendQueued();
+            return;
+        }
+        pos += rlen;
+    }
+}
+
 boolean PubSubClient::publish_P(const char* topic, const char* payload, boolean retained) {
     return publish_P(topic, (const uint8_t*)payload, strlen(payload), retained);
 }
@@ -448,6 +668,55 @@ boolean PubSubClient::publish_P(const char* topic, const uint8_t* payload, unsig
     return rc == tlen + 4 + plength;
 }
 
+boolean PubSubClient::publishPacket(const uint8_t* packet, unsigned int length) {
+    if ((length < 2) || ((packet[0] & 0xF0) != MQTTPUBLISH)) {
+        return false;
+    }
+    if ((packet[0] & 0x06) == MQTTQOS1) {
+        // [header][remaining length(1..4)][topic length(2)][topic][msgId(2)]...
+        unsigned int pos = 1;
+        while ((pos < length) && (packet[pos] & 0x80)) {
+            pos++;
+        }
+        pos++;
+        if ((pos + 2 > length) || (length > MQTT_QOS1_QUEUE_SIZE)) {
+            return false;
+        }
+        unsigned int msgIdPos = pos+2+((packet[pos]<<8)|packet[pos+1]);
+        if (msgIdPos + 2 > length) {
+            return false;
+        }
+        return queuePacket(packet,length,msgIdPos);
+    }
+    if (packet[0] & 0x06) {
+        // No QoS2
+        return false;
+    }
+    return writePacket(packet,length);
+}
+
+boolean PubSubClient::writePacket(const uint8_t* packet, unsigned int length) {
+    if (!connected()) {
+        return false;
+    }
+#ifdef MQTT_MAX_TRANSFER_SIZE
+    boolean result = true;
+    while ((length > 0) && result) {
+        uint16_t bytesToWrite = (length > MQTT_MAX_TRANSFER_SIZE)?MQTT_MAX_TRANSFER_SIZE:length;
+        uint16_t rc = _client->write(packet,bytesToWrite);
+        result = (rc == bytesToWrite);
+        length -= rc;
+        packet += rc;
+    }
+    lastOutActivity = millis();
+    return result;
+#else
+    uint16_t rc = _client->write(packet,length);
+    lastOutActivity = millis();
+    return (rc == length);
+#endif
+}
+
 boolean PubSubClient::beginPublish(const char* topic, unsigned int plength, boolean retained) {
     if (connected()) {
         // Send the header and variable length field
@@ -542,12 +811,9 @@ boolean PubSubClient::subscribe(const char* topic, uint8_t qos) {
     if (connected()) {
         // Leave room in the buffer for header and variable length field
         uint16_t length = MQTT_MAX_HEADER_SIZE;
-        nextMsgId++;
-        if (nextMsgId == 0) {
-            nextMsgId = 1;
-        }
-        buffer[length++] = (nextMsgId >> 8);
-        buffer[length++] = (nextMsgId & 0xFF);
+        uint16_t msgId = nextPacketId();
+        buffer[length++] = (msgId >> 8);
+        buffer[length++] = (msgId & 0xFF);
         length = writeString((char*)topic, buffer,length);
         buffer[length++] = qos;
         return write(MQTTSUBSCRIBE|MQTTQOS1,buffer,length-MQTT_MAX_HEADER_SIZE);
@@ -562,12 +828,9 @@ boolean PubSubClient::unsubscribe(const char* topic) {
     }
     if (connected()) {
         uint16_t length = MQTT_MAX_HEADER_SIZE;
-        nextMsgId++;
-        if (nextMsgId == 0) {
-            nextMsgId = 1;
-        }
-        buffer[length++] = (nextMsgId >> 8);
-        buffer[length++] = (nextMsgId & 0xFF);
+        uint16_t msgId = nextPacketId();
+        buffer[length++] = (msgId >> 8);
+        buffer[length++] = (msgId & 0xFF);
         length = writeString(topic, buffer,length);
         return write(MQTTUNSUBSCRIBE|MQTTQOS1,buffer,length-MQTT_MAX_HEADER_SIZE);
     }
@@ -610,6 +873,9 @@ boolean PubSubClient::connected() {
                 _client->flush();
                 _client->stop();
             }
+        } else if (this->_state == MQTT_CONNECTING) {
+            // CONNACK not received yet
+            rc = false;
         }
     }
     return rc;
@@ -36,12 +36,29 @@
 #define MQTT_SOCKET_TIMEOUT 15
 #endif
 
+// MQTT_MAX_INFLIGHT : Maximum number of QoS1 messages sent and not yet acknowledged
+#ifndef MQTT_MAX_INFLIGHT
+#define MQTT_MAX_INFLIGHT 4
+#endif
+
+// MQTT_RETRY_TIMEOUT : delay before a QoS1 message not acknowledged is sent again, in Seconds
+#ifndef MQTT_RETRY_TIMEOUT
+#define MQTT_RETRY_TIMEOUT 5
+#endif
+
+// MQTT_QOS1_QUEUE_SIZE : Size of the queue of the QoS1 messages, in bytes: the messages not yet
+//  acknowledged, in flight or kept while disconnected. Each one takes its packet size + 4 bytes
+#ifndef MQTT_QOS1_QUEUE_SIZE
+#define MQTT_QOS1_QUEUE_SIZE 512
+#endif
+
 // MQTT_MAX_TRANSFER_SIZE : limit how much data is passed to the network client
 //  in each write call. Needed for the Arduino Wifi Shield. Leave undefined to
 //  pass the entire MQTT packet in each write call.
 //#define MQTT_MAX_TRANSFER_SIZE 80
 
 // Possible values for client.state()
+#define MQTT_CONNECTING             -5
 #define MQTT_CONNECTION_TIMEOUT     -4
 #define MQTT_CONNECTION_LOST        -3
 #define MQTT_CONNECT_FAILED         -2
@@ -72,6 +89,7 @@
 #define MQTTQOS0        (0 << 1)
 #define MQTTQOS1        (1 << 1)
 #define MQTTQOS2        (2 << 1)
+#define MQTTDUP         (1 << 3)
 
 // Maximum size of fixed header and variable length size header
 #define MQTT_MAX_HEADER_SIZE 5
@@ -93,6 +111,14 @@ private:
    unsigned long lastOutActivity;
    unsigned long lastInActivity;
    bool pingOutstanding;
+   uint8_t connackLength;
+   // QoS1 queue: records [length(2)][msgId(2)][PUBLISH packet], oldest first.
+   // The first inflightCount records are in flight (sent, waiting for the PUBACK)
+   uint8_t pubQueue[MQTT_QOS1_QUEUE_SIZE];
+   uint16_t pubQueueLength;
+   uint16_t inflightId[MQTT_MAX_INFLIGHT];
+   unsigned long inflightTime[MQTT_MAX_INFLIGHT];
+   uint8_t inflightCount;
    MQTT_CALLBACK_SIGNATURE;
    uint16_t readPacket(uint8_t*);
    boolean readByte(uint8_t * result);
@@ -104,6 +130,19 @@ private:
    // Note: the header is built at the end of the first MQTT_MAX_HEADER_SIZE bytes, so will start
    //       (MQTT_MAX_HEADER_SIZE - <returned size>) bytes into the buffer
    size_t buildHeader(uint8_t header, uint8_t* buf, uint16_t length);
+   // Next packet id: never 0, nor the id of a message still in the QoS1 queue
+   uint16_t nextPacketId();
+   // Copy a QoS1 PUBLISH packet to the queue, with a new msgId at msgIdPos, & send it if the
+   // window allows it. Returns 0 if the queue is full
+   boolean queuePacket(const uint8_t* packet, uint16_t length, uint16_t msgIdPos);
+   // Write a PUBLISH packet as is, in a single write
+   boolean writePacket(const uint8_t* packet, unsigned int length);
+   // Send the queued QoS1 messages while the in-flight window isn't full
+   void sendQueued();
+   // Send again the messages in flight for MQTT_RETRY_TIMEOUT, with DUP set
+   void retryPublishes(unsigned long t);
+   // Remove the message acknowledged by this PUBACK from the queue
+   void ackPublish(uint16_t msgId);
    IPAddress ip;
    const char* domain;
    uint16_t port;
@@ -137,13 +176,40 @@ public:
    boolean connect(const char* id, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
    boolean connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
    boolean connect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession);
+   // Start to connect without waiting for the CONNACK.
+   // This API:
+   //   beginConnect(...)
+   //   loop() (or pollConnect()) until state() is no longer MQTT_CONNECTING
+   // Opens the network connection & sends CONNECT, then returns at once: state() is
+   // MQTT_CONNECTING and connected() false until the CONNACK is received
+   // Returns 1 if CONNECT was sent (or the client is connected/connecting), 0 if there was an error
+   boolean beginConnect(const char* id);
+   boolean beginConnect(const char* id, const char* user, const char* pass);
+   boolean beginConnect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage);
+   boolean beginConnect(const char* id, const char* user, const char* pass, const char* willTopic, uint8_t willQos, boolean willRetain, const char* willMessage, boolean cleanSession);
+   // Read the CONNACK bytes received so far, without blocking
+   // Returns state(): MQTT_CONNECTING while waiting, MQTT_CONNECTED once accepted, else the error
+   int pollConnect();
    void disconnect();
    boolean publish(const char* topic, const char* payload);
    boolean publish(const char* topic, const char* payload, boolean retained);
    boolean publish(const char* topic, const uint8_t * payload, unsigned int plength);
    boolean publish(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained);
+   // Publish with QoS 0 or 1. A QoS1 message is copied to the queue, sent as soon as the
+   // in-flight window allows it, sent again (DUP) until its PUBACK, and replayed on reconnect
+   // if not acknowledged. It's queued even while disconnected.
+   // Returns 1 if the message was sent (QoS0) or queued (QoS1), 0 if there was an error
+   // (too long, queue full, QoS2)
+   boolean publish(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained, uint8_t qos);
+   // Number of the QoS1 messages in the queue, in flight or not sent yet
+   uint16_t pendingPublishes();
    boolean publish_P(const char* topic, const char* payload, boolean retained);
    boolean publish_P(const char* topic, const uint8_t * payload, unsigned int plength, boolean retained);
+   // Send a PUBLISH packet encoded by the caller (fixed header, topic & payload), as is, in a
+   // single write: for the messages sent again and again, pre-encoded once
+   // A QoS1 packet (msgId left to 0) is queued like publish(..., 1): the msgId is set in the copy
+   // Returns 1 if the packet was sent (QoS0) or queued (QoS1), 0 if there was an error
+   boolean publishPacket(const uint8_t* packet, unsigned int length);
    // Start to publish a message.
    // This API:
    //   beginPublish(...)
@@ -280,6 +280,130 @@ int test_connect_disconnect_connect() {
     END_IT
 }
 
+int test_begin_connect_delayed_connack() {
+    IT("starts to connect without waiting for the CONNACK");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connect[] = {0x10,0x18,0x0,0x4,0x4d,0x51,0x54,0x54,0x4,0x2,0x0,0xf,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.expect(connect,26);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+    IS_TRUE(client.state() == MQTT_CONNECTING);
+    IS_FALSE(client.connected());
+
+    // No CONNACK yet
+    IS_FALSE(client.loop());
+    IS_TRUE(client.state() == MQTT_CONNECTING);
+
+    // Already connecting: nothing sent again
+    rc = client.beginConnect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    shimClient.respond(connack,4);
+    IS_TRUE(client.loop());
+    IS_TRUE(client.state() == MQTT_CONNECTED);
+    IS_TRUE(client.connected());
+
+    END_IT
+}
+
+int test_begin_connect_partial_connack() {
+    IT("handles a CONNACK received in several parts");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack1[] = { 0x20, 0x02 };
+    byte connack2[] = { 0x00 };
+    byte connack3[] = { 0x00 };
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1",(char*)"user",(char*)"pass");
+    IS_TRUE(rc);
+
+    shimClient.respond(connack1,2);
+    IS_TRUE(client.pollConnect() == MQTT_CONNECTING);
+    shimClient.respond(connack2,1);
+    IS_FALSE(client.loop());
+    IS_TRUE(client.state() == MQTT_CONNECTING);
+    shimClient.respond(connack3,1);
+    IS_TRUE(client.pollConnect() == MQTT_CONNECTED);
+    IS_TRUE(client.connected());
+
+    END_IT
+}
+
+int test_begin_connect_bad_rc() {
+    IT("fails to connect in loop() if a bad return code is received");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+    byte connack[] = { 0x20, 0x02, 0x00, 0x05 };
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    shimClient.respond(connack,4);
+    IS_FALSE(client.loop());
+    IS_TRUE(client.state() == MQTT_CONNECT_UNAUTHORIZED);
+    IS_FALSE(shimClient.connected());
+
+    END_IT
+}
+
+int test_begin_connect_closed_by_server() {
+    IT("fails to connect if the server closes the connection before the CONNACK");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    shimClient.setConnected(false);
+    IS_TRUE(client.pollConnect() == MQTT_CONNECT_FAILED);
+    IS_FALSE(client.loop());
+
+    END_IT
+}
+
+int test_begin_connect_fails_no_network() {
+    IT("fails to start to connect if underlying client doesn't connect");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(false);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1");
+    IS_FALSE(rc);
+    IS_TRUE(client.state() == MQTT_CONNECT_FAILED);
+
+    END_IT
+}
+
+int test_begin_connect_no_publish() {
+    IT("does not publish before the CONNACK");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connect[] = {0x10,0x18,0x0,0x4,0x4d,0x51,0x54,0x54,0x4,0x2,0x0,0xf,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    shimClient.expect(connect,26);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.beginConnect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    rc = client.publish((char*)"topic",(char*)"payload");
+    IS_FALSE(rc);
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Connect");
@@ -298,5 +422,12 @@ int main()
     test_connect_with_will();
     test_connect_with_will_username_password();
     test_connect_disconnect_connect();
+
+    test_begin_connect_delayed_connack();
+    test_begin_connect_partial_connack();
+    test_begin_connect_bad_rc();
+    test_begin_connect_closed_by_server();
+    test_begin_connect_fails_no_network();
+    test_begin_connect_no_publish();
     FINISH
 }
@@ -3,6 +3,7 @@
 #include "Buffer.h"
 #include "BDDTest.h"
 #include "trace.h"
+#include <unistd.h>
 
 
 byte server[] = { 172, 16, 0, 2 };
@@ -175,6 +176,263 @@ int test_publish_P() {
 
 
 
+int test_publish_packet() {
+    IT("publishes a pre-encoded packet as is");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    byte publish[] = {0x31,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x1,0x2,0x3,0x0,0x5};
+    int rc = client.publishPacket(publish,14);
+    IS_FALSE(rc);
+
+    rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    shimClient.expect(publish,14);
+    rc = client.publishPacket(publish,14);
+    IS_TRUE(rc);
+    IS_FALSE(shimClient.error());
+
+    // Not a PUBLISH packet
+    byte subscribe[] = {0x82,0x2,0x0,0x1};
+    rc = client.publishPacket(subscribe,4);
+    IS_FALSE(rc);
+
+    END_IT
+}
+
+int test_publish_qos1() {
+    IT("publishes QoS1 until the PUBACK");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[] = { 0x01,0x02,0x03 };
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    shimClient.expect(publish,14);
+
+    rc = client.publish((char*)"topic",payload,3,false,1);
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 1);
+
+    // Not this message
+    byte puback_other[] = { 0x40, 0x02, 0x00, 0x07 };
+    shimClient.respond(puback_other,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 1);
+
+    byte puback[] = { 0x40, 0x02, 0x00, 0x02 };
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 0);
+
+    // No QoS2
+    rc = client.publish((char*)"topic",payload,3,false,2);
+    IS_FALSE(rc);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_packet_qos1() {
+    IT("queues a pre-encoded QoS1 packet with its own msgId");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    // msgId left to 0 by the caller
+    byte packet[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x0,0x1,0x2,0x3};
+    byte publish[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    shimClient.expect(publish,14);
+    rc = client.publishPacket(packet,14);
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 1);
+    IS_FALSE(shimClient.error());
+
+    byte puback[] = { 0x40, 0x02, 0x00, 0x02 };
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 0);
+
+    // Queued while disconnected too, not a QoS2 one
+    client.disconnect();
+    rc = client.publishPacket(packet,14);
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 1);
+    packet[0] = 0x34;
+    rc = client.publishPacket(packet,14);
+    IS_FALSE(rc);
+
+    END_IT
+}
+
+int test_publish_qos1_window() {
+    IT("keeps MQTT_MAX_INFLIGHT QoS1 messages in flight");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[] = { 0x01,0x02,0x03 };
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    int i;
+    for (i = 0; i < MQTT_MAX_INFLIGHT; i++) {
+        publish[10] = 2+i;
+        shimClient.expect(publish,14);
+    }
+    for (i = 0; i <= MQTT_MAX_INFLIGHT; i++) {
+        rc = client.publish((char*)"topic",payload,3,false,1);
+        IS_TRUE(rc);
+    }
+    // The last one waits for a place in the window
+    IS_TRUE(client.pendingPublishes() == MQTT_MAX_INFLIGHT+1);
+    IS_FALSE(shimClient.error());
+
+    // Acknowledged out of order
+    publish[10] = 2+MQTT_MAX_INFLIGHT;
+    shimClient.expect(publish,14);
+    byte puback[] = { 0x40, 0x02, 0x00, 0x03 };
+    shimClient.respond(puback,4);
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == MQTT_MAX_INFLIGHT);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_qos1_retry() {
+    IT("publishes QoS1 again with DUP after MQTT_RETRY_TIMEOUT");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[] = { 0x01,0x02,0x03 };
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    byte publish[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    byte publish_dup[] = {0x3a,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    shimClient.expect(publish,14);
+    shimClient.expect(publish_dup,14);
+
+    rc = client.publish((char*)"topic",payload,3,false,1);
+    IS_TRUE(rc);
+    uint16_t received = shimClient.received();
+
+    sleep(MQTT_RETRY_TIMEOUT);
+
+    rc = client.loop();
+    IS_TRUE(rc);
+    IS_TRUE(shimClient.received() == received+14);
+    IS_TRUE(client.pendingPublishes() == 1);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_qos1_reconnect() {
+    IT("replays the QoS1 queue on reconnect");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[] = { 0x01,0x02,0x03 };
+
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shimClient.respond(connack,4);
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    int rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+
+    rc = client.publish((char*)"topic",payload,3,false,1);
+    IS_TRUE(rc);
+
+    // Connection lost before the PUBACK: queued while disconnected
+    shimClient.setConnected(false);
+    IS_FALSE(client.connected());
+    rc = client.publish((char*)"topic",payload,3,false,1);
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 2);
+
+    // Sent again with DUP, then the one never sent
+    byte connect[] = {0x10,0x18,0x0,0x4,0x4d,0x51,0x54,0x54,0x4,0x2,0x0,0xf,0x0,0xc,0x63,0x6c,0x69,0x65,0x6e,0x74,0x5f,0x74,0x65,0x73,0x74,0x31};
+    byte publish_dup[] = {0x3a,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x2,0x1,0x2,0x3};
+    byte publish[] = {0x32,0xc,0x0,0x5,0x74,0x6f,0x70,0x69,0x63,0x0,0x3,0x1,0x2,0x3};
+    shimClient.expect(connect,26);
+    shimClient.expect(publish_dup,14);
+    shimClient.expect(publish,14);
+    shimClient.respond(connack,4);
+    rc = client.connect((char*)"client_test1");
+    IS_TRUE(rc);
+    IS_TRUE(client.pendingPublishes() == 2);
+
+    byte puback[] = { 0x40, 0x02, 0x00, 0x02, 0x40, 0x02, 0x00, 0x03 };
+    shimClient.respond(puback,8);
+    client.loop();
+    client.loop();
+    IS_TRUE(client.pendingPublishes() == 0);
+
+    IS_FALSE(shimClient.error());
+
+    END_IT
+}
+
+int test_publish_qos1_queue_full() {
+    IT("fails to queue QoS1 when MQTT_QOS1_QUEUE_SIZE is reached");
+    ShimClient shimClient;
+    shimClient.setAllowConnect(true);
+
+    byte payload[MQTT_QOS1_QUEUE_SIZE/2];
+    memset(payload,0,sizeof(payload));
+
+    PubSubClient client(server, 1883, callback, shimClient);
+    // Record: length & id (4), header (3), topic (7), id (2), payload
+    unsigned int length = MQTT_QOS1_QUEUE_SIZE/2-16;
+    int rc = client.publish((char*)"topic",payload,length,false,1);
+    IS_TRUE(rc);
+    rc = client.publish((char*)"topic",payload,length,false,1);
+    IS_TRUE(rc);
+    rc = client.publish((char*)"topic",payload,1,false,1);
+    IS_FALSE(rc);
+    IS_TRUE(client.pendingPublishes() == 2);
+
+    END_IT
+}
+
 int main()
 {
     SUITE("Publish");
@@ -185,6 +443,13 @@ int main()
     test_publish_not_connected();
     test_publish_too_long();
     test_publish_P();
+    test_publish_packet();
+    test_publish_qos1();
+    test_publish_packet_qos1();
+    test_publish_qos1_window();
+    test_publish_qos1_retry();
+    test_publish_qos1_reconnect();
+    test_publish_qos1_queue_full();
 
     FINISH
 }
@@ -0,0 +1,91 @@
+/** @brief Delta patch format: the new firmware image as edits of the running one, made by the
+ *  host tool (tools/wdm_delta) and applied in a stream by the node (delta_patch), without the
+ *  whole patch or image in RAM. Header-only, no allocation.
+ *  @note patch = [DeltaHeader][op()...][DELTA_OP_END]
+ *      DELTA_OP_DIFF:   [len(v)][src_delta(s)][run()...] : 'len' bytes = old bytes + diff bytes,
+ *                       read from the old image at src += src_delta (src moves on by 'len')
+ *          run()      = [zeros(v)][n(v)][n x diff(1)] : 'zeros' old bytes as is, then 'n' changed
+ *      DELTA_OP_INSERT: [len(v)][len x byte(1)]      : new bytes (src doesn't move)
+ *      (v): unsigned LEB128, (s): zigzag LEB128.
+ *  The CRCs (CRC-32, IEEE) of both images are in the header: the patch is refused on any other
+ *  running image, and the new one is checked before it is booted.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _WDM_DELTA_H_
+#define _WDM_DELTA_H_
+
+#include "wdm_frame.h"
+
+/* The CRC table is in flash on the node, in plain memory on the host (tool, tests) */
+#if defined(ARDUINO)
+#include <pgmspace.h>
+#endif
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_dword
+#define pgm_read_dword(p)           (*(const uint32_t *)(p))
+#endif
+
+namespace wdm_delta {
+
+using wdm_frame::Layout;
+using wdm_frame::U8;
+using wdm_frame::U16;
+using wdm_frame::U32;
+
+#define DELTA_MAGIC                 0x504d4457      // "WDMP"
+#define DELTA_VERSION               1
+
+/* [magic(4)][version(1)][flags(1)][reserved(2)][old_size(4)][old_crc(4)][new_size(4)][new_crc(4)] */
+typedef Layout<U32, U8, U8, U16, U32, U32, U32, U32> DeltaHeader;
+enum { DELTA_HDR_MAGIC, DELTA_HDR_VERSION, DELTA_HDR_FLAGS, DELTA_HDR_RESERVED,
+       DELTA_HDR_OLD_SIZE, DELTA_HDR_OLD_CRC, DELTA_HDR_NEW_SIZE, DELTA_HDR_NEW_CRC };
+
+/* Opcodes */
+#define DELTA_OP_END                0x00
+#define DELTA_OP_DIFF               0x01
+#define DELTA_OP_INSERT             0x02
+
+/* Longest varint (32-bit value) */
+#define DELTA_VARINT_MAX            5
+
+///////////////////////////////////////API/////////////////////////////////////////////////////////
+/* CRC-32 (IEEE, reflected), continued from 'crc' (0 to start): 4-bit table, 64 bytes of flash */
+static inline uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len) {
+    static const uint32_t T[16] PROGMEM = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ pgm_read_dword(&T[crc & 0x0f]);
+        crc = (crc >> 4) ^ pgm_read_dword(&T[crc & 0x0f]);
+    }
+    return ~crc;
+}
+
+/* Write 'v' as a varint at 'p': return its length */
+static inline size_t put_varint(uint8_t *p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+} // namespace wdm_delta
+
+#endif
@@ -0,0 +1,208 @@
+/** @brief define the Frame codec: a frame layout is a compile-time list of fields, from which
+ *  the encoder and the bounds-checked, zero-copy decoder view are generated. Field offsets are
+ *  constants, so encoding/decoding compiles to the same code as hand-written index arithmetic.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+ *  Usage:
+ *      typedef wdm_frame::Layout<U8, U32> Ack;    enum { ACK_OP, ACK_SEQ };
+ *      Ack::put(buf, op, seq);                     // encode, buf must hold Ack::size bytes
+ *      wdm_frame::View<Ack> v(buf, len);           // decode
+ *      if (v.valid()) seq = v.get<ACK_SEQ>();
+*/
+#ifndef _WDM_FRAME_H_
+#define _WDM_FRAME_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace wdm_frame {
+
+///////////////////////////////////////FIELD TYPES/////////////////////////////////////////////////
+/* Little-endian unsigned integer of N bytes */
+template <typename T, size_t N> struct Int;
+
+template <typename T> struct Int<T, 1> {
+    typedef T value_type;
+    typedef T arg_type;
+    static const size_t size = 1;
+    static inline T get(const uint8_t *p) { return (T)p[0]; }
+    static inline void put(uint8_t *p, T v) { p[0] = (uint8_t)v; }
+};
+
+template <typename T> struct Int<T, 2> {
+    typedef T value_type;
+    typedef T arg_type;
+    static const size_t size = 2;
+    static inline T get(const uint8_t *p) {
+        return (T)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+    }
+    static inline void put(uint8_t *p, T v) {
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)((uint16_t)v >> 8);
+    }
+};
+
+template <typename T> struct Int<T, 4> {
+    typedef T value_type;
+    typedef T arg_type;
+    static const size_t size = 4;
+    static inline T get(const uint8_t *p) {
+        return (T)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+    }
+    static inline void put(uint8_t *p, T v) {
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)((uint32_t)v >> 8);
+        p[2] = (uint8_t)((uint32_t)v >> 16);
+        p[3] = (uint8_t)((uint32_t)v >> 24);
+    }
+};
+
+typedef Int<uint8_t, 1> U8;
+typedef Int<uint16_t, 2> U16;
+typedef Int<uint32_t, 4> U32;
+
+/* Fixed size byte array: decoded as a pointer into the frame (no copy) */
+template <size_t N> struct Bytes {
+    typedef const uint8_t *value_type;
+    typedef const uint8_t *arg_type;
+    static const size_t size = N;
+    static inline const uint8_t *get(const uint8_t *p) { return p; }
+    static inline void put(uint8_t *p, const uint8_t *v) { memcpy(p, v, N); }
+};
+
+///////////////////////////////////////LAYOUT//////////////////////////////////////////////////////
+/* A frame (or frame part) made of the listed fields, without padding */
+template <typename... F> struct Layout;
+
+template <> struct Layout<> {
+    static const size_t size = 0;
+    static const size_t count = 0;
+    static inline void put(uint8_t *) {}
+};
+
+template <typename H, typename... T> struct Layout<H, T...> {
+    static const size_t size = H::size + Layout<T...>::size;
+    static const size_t count = 1 + sizeof...(T);
+
+    /* Encode all fields, in order. 'p' must hold 'size' bytes. */
+    static inline void put(uint8_t *p, typename H::arg_type v, typename T::arg_type... rest) {
+        H::put(p, v);
+        Layout<T...>::put(p + H::size, rest...);
+    }
+};
+
+/* Type & offset of the field I of a layout */
+template <size_t I, typename L> struct Field;
+
+template <typename H, typename... T> struct Field<0, Layout<H, T...> > {
+    typedef H type;
+    static const size_t offset = 0;
+};
+
+template <size_t I, typename H, typename... T> struct Field<I, Layout<H, T...> > {
+    typedef typename Field<I - 1, Layout<T...> >::type type;
+    static const size_t offset = H::size + Field<I - 1, Layout<T...> >::offset;
+};
+
+///////////////////////////////////////DECODER/////////////////////////////////////////////////////
+/* Read-only view of a frame: valid() only if the buffer holds the whole layout. Fields are read
+in place, get() must not be called on an invalid view. */
+template <typename L> class View
+{
+    public:
+        View() : _p(NULL), _len(0) {}
+        View(const uint8_t *buf, size_t len) : _p((len >= L::size) ? buf : NULL), _len(len) {}
+
+        bool valid() const { return _p != NULL; }
+
+        template <size_t I> typename Field<I, L>::type::value_type get() const {
+            return Field<I, L>::type::get(_p + Field<I, L>::offset);
+        }
+
+        /* What follows the layout (variable part of the frame) */
+        const uint8_t *tail() const { return _p + L::size; }
+        size_t tail_len() const { return valid() ? _len - L::size : 0; }
+
+    private:
+        const uint8_t *_p;
+        size_t _len;
+};
+
+/* Sequential decoder for frames made of several layouts (header + list of items) */
+class Reader
+{
+    public:
+        Reader(const uint8_t *buf, size_t len) : _p(buf), _left(len) {}
+
+        /* Take the next L from the frame: the view is invalid if there are not enough bytes left */
+        template <typename L> View<L> next() {
+            if (_left < L::size) {
+                _left = 0;
+                return View<L>();
+            }
+            View<L> v(_p, L::size);
+            _p += L::size;
+            _left -= L::size;
+            return v;
+        }
+
+        const uint8_t *pos() const { return _p; }
+        size_t left() const { return _left; }
+
+    private:
+        const uint8_t *_p;
+        size_t _left;
+};
+
+///////////////////////////////////////ENCODER/////////////////////////////////////////////////////
+/* Sequential encoder: every write is checked against the buffer size; after an overflow
+nothing else is written and ok() is false. */
+class Writer
+{
+    public:
+        Writer(uint8_t *buf, size_t size) : _buf(buf), _size(size), _len(0), _ok(true) {}
+
+        /* Append one L, return a pointer to it (NULL on overflow) */
+        template <typename L, typename... A> uint8_t *put(A... args) {
+            uint8_t *p = reserve(L::size);
+            if (p) {
+                L::put(p, args...);
+            }
+            return p;
+        }
+
+        /* Append 'n' bytes to be written by the caller (e.g. a count known at the end) */
+        uint8_t *reserve(size_t n) {
+            if (!_ok || (_len + n > _size)) {
+                _ok = false;
+                return NULL;
+            }
+            uint8_t *p = &_buf[_len];
+            _len += n;
+            return p;
+        }
+
+        bool bytes(const void *data, size_t n) {
+            uint8_t *p = reserve(n);
+            if (p) {
+                memcpy(p, data, n);
+            }
+            return p != NULL;
+        }
+
+        const uint8_t *data() const { return _buf; }
+        size_t length() const { return _len; }
+        bool ok() const { return _ok; }
+
+    private:
+        uint8_t *_buf;
+        size_t _size;
+        size_t _len;
+        bool _ok;
+};
+
+} // namespace wdm_frame
+
+#endif
@@ -0,0 +1,116 @@
+/** @brief define the frame layouts of the node <-> server protocols (UDP & MQTT transports).
+ *  The device status item is not the same on both transports: the server decodes them with
+ *  different parsers, so both are kept (UdpDeviceStatus vs MqttDeviceStatus).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _WDM_PROTO_H_
+#define _WDM_PROTO_H_
+
+#include "wdm_frame.h"
+
+namespace wdm_proto {
+
+using wdm_frame::Layout;
+using wdm_frame::U8;
+using wdm_frame::U16;
+using wdm_frame::U32;
+using wdm_frame::Bytes;
+
+#define WDM_ID_SZ                   6
+
+///////////////////////////////////////MQTT////////////////////////////////////////////////////////
+/* MQTT.Payload() = [mark(1)][opcode(1)][id(6)][data()] */
+typedef Layout<U8, U8, Bytes<WDM_ID_SZ> > MqttHeader;
+enum { MQTT_HDR_MARK, MQTT_HDR_OPCODE, MQTT_HDR_ID };
+
+/* OPU_TIME_GET, 'a': [time(4)] */
+typedef Layout<U32> MqttTime;
+enum { MQTT_TIME_T };
+
+/* OPU_STATUS: [DevCnt(1)=M][M x MqttDeviceStatus] */
+typedef Layout<U8> MqttCount;
+typedef Layout<U8, U8, U8, U8, U32, U32> MqttDeviceStatus;
+enum { MQTT_DEV_OFFSET, MQTT_DEV_TYPE, MQTT_DEV_RSSI, MQTT_DEV_POWER, MQTT_DEV_VALUE, MQTT_DEV_TIME };
+
+/* OPU_EVENT: [Dropped(4)][EvCnt(1)=M][M x event(9)] */
+typedef Layout<U32, U8> MqttEventHeader;
+enum { MQTT_EV_DROPPED, MQTT_EV_CNT };
+
+/* 'd': [N x MqttCommand] */
+typedef Layout<U8, U8> MqttCommand;
+enum { MQTT_CMD_OFFSET, MQTT_CMD_CMD };
+
+/* 'm': [mask(2)][cmds(2)] */
+typedef Layout<U16, U16> MqttCommandMask;
+enum { MQTT_MASK_MASK, MQTT_MASK_CMDS };
+
+/* 'h' (request): [reset(1)], optional
+   OPU_PERF (diagnostic topic): [MqttPerfHeader][HistCnt x ([MqttPerfHist][BucketCnt x MqttPerfBucket])] */
+typedef Layout<U8> MqttPerfRequest;
+enum { MQTT_PERF_REQ_RESET };
+typedef Layout<U32, U8, U8, U8> MqttPerfHeader;
+enum { MQTT_PERF_UPTIME, MQTT_PERF_HIST_CNT, MQTT_PERF_BUCKET_CNT, MQTT_PERF_BASE_SHIFT };
+typedef Layout<U8, U32, U32, U32> MqttPerfHist;
+enum { MQTT_HIST_ID, MQTT_HIST_COUNT, MQTT_HIST_MAX, MQTT_HIST_AVG };
+typedef Layout<U16> MqttPerfBucket;
+
+/* 's': sensor samples of another node (e.g. the UDP STATUS of a wdm_th, relayed):
+   [src_id(6)][DevCnt(1)=N][N x UdpDeviceStatus] */
+typedef Layout<Bytes<WDM_ID_SZ>, U8> MqttSampleHeader;
+enum { MQTT_SMP_SRC_ID, MQTT_SMP_CNT };
+
+/* 'c' with a rule table (a config document is a MsgPack map, so it never starts with 'R'):
+   [mark(1)='R'][RuleCnt(1)=N][N x MqttRule] */
+typedef Layout<U8, U8> MqttRuleHeader;
+enum { MQTT_RULE_HDR_MARK, MQTT_RULE_HDR_CNT };
+typedef Layout<U8, U8, Bytes<WDM_ID_SZ>, U8, U8, U32, U16, U8, U8> MqttRule;
+enum { MQTT_RULE_ID, MQTT_RULE_FLAGS, MQTT_RULE_SRC_ID, MQTT_RULE_SRC_OFFSET, MQTT_RULE_OP,
+       MQTT_RULE_THRESHOLD, MQTT_RULE_HYST, MQTT_RULE_OFFSET, MQTT_RULE_CMD };
+
+/* 'u': a chunk of a delta OTA patch (wdm_delta.h): [offset(4)][chunk()]
+   OPU_OTA: [status(1)][next(4)]: status of the update (DELTA_*), patch offset expected next */
+typedef Layout<U32> MqttOtaChunk;
+enum { MQTT_OTA_OFFSET };
+typedef Layout<U8, U32> MqttOtaStatus;
+enum { MQTT_OTA_STATUS, MQTT_OTA_NEXT };
+
+///////////////////////////////////////UDP/////////////////////////////////////////////////////////
+/* UDP packet: [marker(1)][sequence(4)][id(6)][opcode(1)][data()][FCS(8)] */
+typedef Layout<U8, U32, Bytes<WDM_ID_SZ>, U8> UdpHeader;
+enum { UDP_HDR_MARKER, UDP_HDR_SEQ, UDP_HDR_ID, UDP_HDR_OPCODE };
+
+#define UDP_MARKER                  0xa8
+
+#define UDP_FCS_SZ                  8
+
+/* OPU_STATUS: [DevCnt(1)=N][N x UdpDeviceStatus] */
+typedef Layout<U8> UdpCount;
+typedef Layout<U8, U8, U32, U8, U8> UdpDeviceStatus;
+enum { UDP_DEV_OFFSET, UDP_DEV_TYPE, UDP_DEV_VALUE, UDP_DEV_RSSI, UDP_DEV_POWER };
+
+/* OPH_ACK: [seq(4)][op(1)] */
+typedef Layout<U32, U8> UdpAck;
+enum { UDP_ACK_SEQ, UDP_ACK_OP };
+
+/* OPH_CMD: [offset(1)][cmd(1)] */
+typedef Layout<U8, U8> UdpCommand;
+enum { UDP_CMD_OFFSET, UDP_CMD_CMD };
+
+///////////////////////////////////////LAN/////////////////////////////////////////////////////////
+/* LAN multicast channel: UDP packets (UdpHeader), FCS = SipHash-2-4 of the packet (wdm_siphash.h).
+   id = sender, except for the commands: id = target node. */
+
+/* LAN_OP_ANNOUNCE: [proto(1)][DevCnt(1)=N][N x LanCapability] */
+typedef Layout<U8, U8> LanAnnounce;
+enum { LAN_ANN_PROTO, LAN_ANN_CNT };
+typedef Layout<U8, U8> LanCapability;
+enum { LAN_CAP_OFFSET, LAN_CAP_TYPE };
+
+/* LAN_OP_STATUS:   [DevCnt(1)=N][N x UdpDeviceStatus] */
+/* 'd':             [N x UdpCommand] */
+/* LAN_OP_ACK:      UdpAck */
+
+} // namespace wdm_proto
+
+#endif
@@ -0,0 +1,106 @@
+/** @brief SipHash-2-4: keyed 64-bit MAC of the short frames exchanged on the LAN.
+ *  The tag is exactly the 8 bytes of the UDP FCS field, the key is derived from the node's
+ *  'security' string. Header-only, no allocation.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _WDM_SIPHASH_H_
+#define _WDM_SIPHASH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+namespace wdm_siphash {
+
+/* 128-bit key */
+struct Key {
+    uint64_t k0;
+    uint64_t k1;
+};
+
+///////////////////////////////////////INTERNALS///////////////////////////////////////////////////
+static inline uint64_t rotl(uint64_t x, int b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+static inline void sip_round(uint64_t &v0, uint64_t &v1, uint64_t &v2, uint64_t &v3) {
+    v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+    v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+}
+
+static inline uint64_t load_le(const uint8_t *p, size_t n) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+///////////////////////////////////////API/////////////////////////////////////////////////////////
+/* SipHash-2-4 of 'len' bytes */
+static inline uint64_t hash(const Key &key, const uint8_t *data, size_t len) {
+    uint64_t v0 = key.k0 ^ 0x736f6d6570736575ULL;
+    uint64_t v1 = key.k1 ^ 0x646f72616e646f6dULL;
+    uint64_t v2 = key.k0 ^ 0x6c7967656e657261ULL;
+    uint64_t v3 = key.k1 ^ 0x7465646279746573ULL;
+    size_t left = len;
+
+    for (; left >= 8; left -= 8, data += 8) {
+        uint64_t m = load_le(data, 8);
+        v3 ^= m;
+        sip_round(v0, v1, v2, v3);
+        sip_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t b = ((uint64_t)len << 56) | load_le(data, left);
+    v3 ^= b;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; i++) {
+        sip_round(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/* Derive the key from a shared secret string (two hashes under fixed, distinct keys) */
+static inline Key derive(const char *secret) {
+    static const Key K0 = { 0x77646d2d6c616e30ULL, 0x6b65792d64657269ULL };
+    static const Key K1 = { 0x77646d2d6c616e31ULL, 0x6b65792d64657269ULL };
+    size_t len = strlen(secret);
+    Key k;
+
+    k.k0 = hash(K0, (const uint8_t *)secret, len);
+    k.k1 = hash(K1, (const uint8_t *)secret, len);
+    return k;
+}
+
+/* Write the tag of data[0..len) as 8 bytes (little-endian) at 'tag' */
+static inline void sign(const Key &key, const uint8_t *data, size_t len, uint8_t tag[8]) {
+    uint64_t h = hash(key, data, len);
+    for (int i = 0; i < 8; i++) {
+        tag[i] = (uint8_t)(h >> (8 * i));
+    }
+}
+
+/* Check the tag of data[0..len), in constant time */
+static inline bool verify(const Key &key, const uint8_t *data, size_t len, const uint8_t tag[8]) {
+    uint8_t expected[8];
+    uint8_t diff = 0;
+
+    sign(key, data, len, expected);
+    for (int i = 0; i < 8; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    return diff == 0;
+}
+
+} // namespace wdm_siphash
+
+#endif
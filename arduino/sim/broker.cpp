@@ -0,0 +1,563 @@
+/**	@brief minimal MQTT 3.1.1 broker for local tests: one epoll loop, QoS 0/1 publish (forwarded
+ *  at QoS 0), wildcard subscriptions, retained messages, Last-Will and keep-alive timeout.
+ *  No authentication: any user/password is accepted.
+ *  It also stands in for the wdm backend (unless --plain), on the frames published on
+ *  wdm/dev/pub/<id>:
+ *      - OPU_TIME_GET: answered by 'a' [time(4)] (UTC) on wdm/dev/sub/<id>.
+ *      - downlink opcodes ('a', 'c', 'd', 'm'): echoed as they are on wdm/dev/sub/<id>, so a
+ *        client can time a command round trip (see loadgen.cpp).
+ *  It reports the message rates & the forward latency: from reading a PUBLISH to writing it to
+ *  the subscriber socket.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <map>
+#include <set>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wdm_proto.h>
+#include "lat_hist.h"
+#include "mqtt_wire.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define BROKER_PORT_DEFAULT     18830
+#define EPOLL_BATCH             256
+#define RX_CHUNK                4096
+
+/* wdm frame (see mqtt_inf.cpp) */
+#define FRAME_MARK              0x01
+#define OPU_TIME_GET            0x41
+
+/* wdm topics */
+#define WDM_PUB_PREFIX          "wdm/dev/pub/"
+#define WDM_SUB_PREFIX          "wdm/dev/sub/"
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+struct Conn {
+    int fd;
+    bool connected;
+    bool out_armed;
+    uint64_t last_rx_ms;
+    uint16_t keepalive;
+    std::string rx;
+    std::string tx;
+    uint64_t tx_sent;       // Bytes sent since the connection start
+    std::deque<std::pair<uint64_t, uint64_t> > tx_marks;   // [end of a message, rx time (us)]
+    mqtt_wire::Connect info;
+    std::set<std::string> subs;
+};
+
+struct Stats {
+    uint64_t rx_msgs;
+    uint64_t tx_msgs;
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t time_replies;
+    uint64_t echoes;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static int g_epfd;
+static std::unordered_map<int, Conn *> g_conns;
+static std::map<std::string, std::string> g_retained;
+
+/* Subscriptions: exact topics are looked up, filters with wildcards are scanned */
+static std::unordered_map<std::string, std::set<Conn *> > g_subs_exact;
+static std::map<std::string, std::set<Conn *> > g_subs_wild;
+
+/* Connections with queued TX data, sent at the end of each epoll batch */
+static std::vector<int> g_dirty;
+
+static Stats g_stats;
+static LatHist g_lat_period;
+static LatHist g_lat_all;
+
+/* Time the current packets were read (us) */
+static uint64_t g_rx_us;
+
+/* wdm backend stand-in */
+static bool g_wdm = true;
+
+static volatile sig_atomic_t g_stop;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t now_ms()
+{
+    return now_us() / 1000;
+}
+
+static void conn_close(Conn *c, bool send_will);
+
+static void flush_tx(Conn *c)
+{
+    while (!c->tx.empty()) {
+        ssize_t n = send(c->fd, c->tx.data(), c->tx.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            g_stats.tx_bytes += n;
+            c->tx_sent += n;
+            c->tx.erase(0, n);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    if (!c->tx_marks.empty()) {
+        uint64_t now = now_us();
+        while (!c->tx_marks.empty() && (c->tx_marks.front().first <= c->tx_sent)) {
+            uint32_t lat = now - c->tx_marks.front().second;
+            g_lat_period.add(lat);
+            c->tx_marks.pop_front();
+        }
+    }
+    bool want_out = !c->tx.empty();
+    if (want_out != c->out_armed) {
+        struct epoll_event ev;
+        ev.events = EPOLLIN | (want_out ? EPOLLOUT : 0);
+        ev.data.fd = c->fd;
+        epoll_ctl(g_epfd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->out_armed = want_out;
+    }
+}
+
+static void deliver(Conn *c, const std::string &topic, const std::string &payload, bool retain)
+{
+    if (c->tx.empty()) {
+        g_dirty.push_back(c->fd);
+    }
+    mqtt_wire::publish(c->tx, topic, payload.data(), payload.size(), retain);
+    c->tx_marks.push_back(std::make_pair(c->tx_sent + c->tx.size(), g_rx_us));
+    g_stats.tx_msgs++;
+}
+
+static void route(const std::string &topic, const std::string &payload)
+{
+    std::unordered_map<std::string, std::set<Conn *> >::iterator it = g_subs_exact.find(topic);
+    if (it != g_subs_exact.end()) {
+        for (Conn *c : it->second) {
+            deliver(c, topic, payload, false);
+        }
+    }
+    for (std::map<std::string, std::set<Conn *> >::iterator w = g_subs_wild.begin(); w != g_subs_wild.end(); ++w) {
+        if (mqtt_wire::match(w->first, topic)) {
+            for (Conn *c : w->second) {
+                deliver(c, topic, payload, false);
+            }
+        }
+    }
+}
+
+static void publish(const std::string &topic, const std::string &payload, bool retain)
+{
+    if (retain) {
+        if (payload.empty()) {
+            g_retained.erase(topic);
+        } else {
+            g_retained[topic] = payload;
+        }
+    }
+    route(topic, payload);
+}
+
+/** @brief wdm backend stand-in: answer OPU_TIME_GET, echo the downlink opcodes.
+*/
+static void wdm_backend(const std::string &topic, const std::string &payload)
+{
+    static const std::string PUB = WDM_PUB_PREFIX;
+
+    if (topic.compare(0, PUB.size(), PUB) != 0) {
+        return;
+    }
+    wdm_frame::View<MqttHeader> hdr((const uint8_t *)payload.data(), payload.size());
+    if (!hdr.valid() || (hdr.get<MQTT_HDR_MARK>() != FRAME_MARK)) {
+        return;
+    }
+    std::string sub_topic = WDM_SUB_PREFIX + topic.substr(PUB.size());
+    uint8_t opcode = hdr.get<MQTT_HDR_OPCODE>();
+
+    if (opcode == OPU_TIME_GET) {
+        uint8_t arr[MqttHeader::size + MqttTime::size];
+        wdm_frame::Writer w(arr, sizeof(arr));
+        w.put<MqttHeader>(FRAME_MARK, 'a', hdr.get<MQTT_HDR_ID>());
+        w.put<MqttTime>((uint32_t)time(NULL));
+        route(sub_topic, std::string((const char *)arr, w.length()));
+        g_stats.time_replies++;
+    } else if ((opcode == 'a') || (opcode == 'c') || (opcode == 'd') || (opcode == 'm')) {
+        route(sub_topic, payload);
+        g_stats.echoes++;
+    }
+}
+
+static void subscribe(Conn *c, const std::string &filter)
+{
+    if (!c->subs.insert(filter).second) {
+        return;
+    }
+    if (mqtt_wire::has_wildcard(filter)) {
+        g_subs_wild[filter].insert(c);
+        for (std::map<std::string, std::string>::iterator r = g_retained.begin(); r != g_retained.end(); ++r) {
+            if (mqtt_wire::match(filter, r->first)) {
+                deliver(c, r->first, r->second, true);
+            }
+        }
+    } else {
+        g_subs_exact[filter].insert(c);
+        std::map<std::string, std::string>::iterator r = g_retained.find(filter);
+        if (r != g_retained.end()) {
+            deliver(c, r->first, r->second, true);
+        }
+    }
+}
+
+static void unsubscribe(Conn *c, const std::string &filter)
+{
+    if (c->subs.erase(filter) == 0) {
+        return;
+    }
+    if (mqtt_wire::has_wildcard(filter)) {
+        g_subs_wild[filter].erase(c);
+        if (g_subs_wild[filter].empty()) {
+            g_subs_wild.erase(filter);
+        }
+    } else {
+        g_subs_exact[filter].erase(c);
+        if (g_subs_exact[filter].empty()) {
+            g_subs_exact.erase(filter);
+        }
+    }
+}
+
+/** @brief process one packet.
+    @return false to close the connection.
+*/
+static bool handle(Conn *c, const mqtt_wire::Packet &pkt)
+{
+    g_stats.rx_msgs++;
+    if (!c->connected && (pkt.type != MQTT_CONNECT)) {
+        return false;
+    }
+
+    switch (pkt.type) {
+    case MQTT_CONNECT:
+        if (c->connected || !mqtt_wire::parse_connect(pkt, &c->info)) {
+            return false;
+        }
+        c->connected = true;
+        c->keepalive = c->info.keepalive;
+        mqtt_wire::connack(c->tx, 0);
+        break;
+
+    case MQTT_PUBLISH: {
+        mqtt_wire::Publish p;
+        if (!mqtt_wire::parse_publish(pkt, &p)) {
+            return false;
+        }
+        if (p.qos == 1) {
+            mqtt_wire::ack(c->tx, MQTT_PUBACK, p.pid);
+        }
+        std::string payload((const char *)p.payload, p.len);
+        publish(p.topic, payload, p.retain);
+        if (g_wdm) {
+            wdm_backend(p.topic, payload);
+        }
+    } break;
+
+    case MQTT_SUBSCRIBE:
+    case MQTT_UNSUBSCRIBE: {
+        uint32_t pos = 0;
+        uint16_t pid;
+        std::string filter;
+        std::string granted;
+        if (!mqtt_wire::get_u16(pkt, pos, &pid)) {
+            return false;
+        }
+        while (pos < pkt.len) {
+            if (!mqtt_wire::get_str(pkt, pos, &filter)) {
+                return false;
+            }
+            if (pkt.type == MQTT_SUBSCRIBE) {
+                pos++;      // Requested QoS: always granted QoS 0
+                granted += (char)0;
+            } else {
+                unsubscribe(c, filter);
+            }
+        }
+        if (pkt.type == MQTT_SUBSCRIBE) {
+            mqtt_wire::put_header(c->tx, MQTT_SUBACK << 4, 2 + granted.size());
+            mqtt_wire::put_u16(c->tx, pid);
+            c->tx += granted;
+            // Retained messages are sent after the SUBACK:
+            pos = 2;
+            while ((pos < pkt.len) && mqtt_wire::get_str(pkt, pos, &filter)) {
+                pos++;
+                subscribe(c, filter);
+            }
+        } else {
+            mqtt_wire::ack(c->tx, MQTT_UNSUBACK, pid);
+        }
+    } break;
+
+    case MQTT_PUBACK:
+        break;
+
+    case MQTT_PINGREQ:
+        mqtt_wire::simple(c->tx, MQTT_PINGRESP);
+        break;
+
+    case MQTT_DISCONNECT:
+        c->info.will = false;
+        return false;
+
+    default:
+        return false;
+    }
+    return true;
+}
+
+static void conn_read(Conn *c)
+{
+    char buf[RX_CHUNK];
+
+    g_rx_us = now_us();
+    while (true) {
+        ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            g_stats.rx_bytes += n;
+            c->rx.append(buf, n);
+            continue;
+        }
+        if ((n < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            break;
+        }
+        conn_close(c, true);
+        return;
+    }
+    c->last_rx_ms = now_ms();
+
+    size_t used = 0;
+    while (true) {
+        mqtt_wire::Packet pkt;
+        int n = mqtt_wire::parse((const uint8_t *)c->rx.data() + used, c->rx.size() - used, &pkt);
+        if (n == 0) {
+            break;
+        }
+        if ((n < 0) || !handle(c, pkt)) {
+            conn_close(c, n < 0 || c->info.will);
+            return;
+        }
+        used += n;
+    }
+    c->rx.erase(0, used);
+    if (!c->tx.empty()) {
+        g_dirty.push_back(c->fd);
+    }
+}
+
+static void conn_close(Conn *c, bool send_will)
+{
+    std::set<std::string> subs = c->subs;
+    for (const std::string &f : subs) {
+        unsubscribe(c, f);
+    }
+    epoll_ctl(g_epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    g_conns.erase(c->fd);
+    if (send_will && c->connected && c->info.will) {
+        publish(c->info.will_topic, c->info.will_payload, c->info.will_retain);
+    }
+    delete c;
+}
+
+static void accept_all(int lfd)
+{
+    int one = 1;
+
+    while (true) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        Conn *c = new Conn();
+        c->fd = fd;
+        c->connected = false;
+        c->out_armed = false;
+        c->last_rx_ms = now_ms();
+        c->keepalive = 0;
+        c->tx_sent = 0;
+        g_conns[fd] = c;
+
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(g_epfd, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+/** @brief drop the connections silent for 1.5 x keep-alive (their Last-Will is published).
+*/
+static void check_keepalive()
+{
+    uint64_t now = now_ms();
+    std::vector<Conn *> dead;
+
+    for (std::unordered_map<int, Conn *>::iterator it = g_conns.begin(); it != g_conns.end(); ++it) {
+        Conn *c = it->second;
+        if ((c->keepalive != 0) && (now - c->last_rx_ms > c->keepalive * 1500ULL)) {
+            dead.push_back(c);
+        }
+    }
+    for (Conn *c : dead) {
+        conn_close(c, true);
+    }
+}
+
+static void print_stats(const char *what, double period, const Stats &last, const LatHist &lat)
+{
+    fprintf(stderr, "wdm_broker: %sconns=%zu, rx %.0f msg/s, tx %.0f msg/s, time %.0f/s, echo %.0f/s"
+            " | fwd p50 %u us, p99 %u us, max %u us\n", what, g_conns.size(),
+            (g_stats.rx_msgs - last.rx_msgs) / period, (g_stats.tx_msgs - last.tx_msgs) / period,
+            (g_stats.time_replies - last.time_replies) / period, (g_stats.echoes - last.echoes) / period,
+            lat.percentile(50), lat.percentile(99), lat.max());
+}
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "usage: %s [--port N] [--stats SEC] [--plain]\n"
+            "  --stats SEC  print the rates & the forward latency every SEC seconds\n"
+            "  --plain      plain MQTT broker: no wdm backend stand-in\n", name);
+    exit(2);
+}
+
+///////////////////////////////////////MAIN////////////////////////////////////////////////////////
+int main(int argc, char **argv)
+{
+    int port = BROKER_PORT_DEFAULT;
+    int stats_sec = 0;
+    int one = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "--port") == 0) && (i + 1 < argc)) {
+            port = atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "--stats") == 0) && (i + 1 < argc)) {
+            stats_sec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--plain") == 0) {
+            g_wdm = false;
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    int lfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) || (listen(lfd, 4096) != 0)) {
+        perror("wdm_broker: bind/listen");
+        return 1;
+    }
+
+    g_epfd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.fd = lfd;
+    epoll_ctl(g_epfd, EPOLL_CTL_ADD, lfd, &ev);
+    fprintf(stderr, "wdm_broker: listening on 127.0.0.1:%d\n", port);
+
+    uint64_t next_check = now_ms() + 1000;
+    uint64_t next_stats = now_ms() + stats_sec * 1000;
+    uint64_t start = now_ms();
+    Stats last = g_stats;
+    struct epoll_event events[EPOLL_BATCH];
+    while (!g_stop) {
+        int n = epoll_wait(g_epfd, events, EPOLL_BATCH, 100);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == lfd) {
+                accept_all(lfd);
+                continue;
+            }
+            std::unordered_map<int, Conn *>::iterator it = g_conns.find(fd);
+            if (it == g_conns.end()) {
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                conn_read(it->second);
+            } else if (events[i].events & EPOLLOUT) {
+                flush_tx(it->second);
+            }
+        }
+        // Send what was queued by this batch:
+        for (size_t i = 0; i < g_dirty.size(); i++) {
+            std::unordered_map<int, Conn *>::iterator it = g_conns.find(g_dirty[i]);
+            if ((it != g_conns.end()) && !it->second->out_armed) {
+                flush_tx(it->second);
+            }
+        }
+        g_dirty.clear();
+
+        uint64_t now = now_ms();
+        if (now >= next_check) {
+            next_check = now + 1000;
+            check_keepalive();
+        }
+        if ((stats_sec > 0) && (now >= next_stats)) {
+            next_stats = now + stats_sec * 1000;
+            print_stats("", stats_sec, last, g_lat_period);
+            last = g_stats;
+            g_lat_all.merge(g_lat_period);
+            g_lat_period.reset();
+        }
+    }
+
+    g_lat_all.merge(g_lat_period);
+    Stats zero;
+    memset(&zero, 0, sizeof(zero));
+    double elapsed = (now_ms() - start) / 1000.0;
+    print_stats("total: ", (elapsed > 0) ? elapsed : 1, zero, g_lat_all);
+    return 0;
+}
@@ -0,0 +1,340 @@
+/**	@brief implement the node runtime of the Arduino stand-in: time, GPIO, Serial, ESP, Ticker
+ *  & the node entry points called by the simulator.
+ *  Time is the host monotonic time, counted from the node boot. Ticker callbacks run when the
+ *  node waits (delay(), yield(), socket waits, between two loop()).
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <stdarg.h>
+#include <arpa/inet.h>
+#include "Arduino.h"
+#include "FS.h"
+#include "Ticker.h"
+#include "Updater.h"
+#include "sim_node.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Maximum number of active Tickers */
+#define TICKER_CNT              8
+
+/* GPIO count (0..16) */
+#define PIN_CNT                 17
+
+/* Settings of the node, in the format of old firmwares (converted by wifi_inf): magic, ssid,
+password, server, port, security, timezone */
+#define NODE_SETTINGS_FILE      "/wdm_cfg.txt"
+#define NODE_SETTINGS_FMT       "1094861636\nsim\nsimpass1\n%s\n%u\n%s\n420\n"
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+/* Set once (sim_node_attach), before the data segment is copied for the nodes */
+static const SIM_HOST_t *g_host;
+
+static SIM_NODE_CFG_t g_cfg;
+static uint64_t g_boot_us;
+static uint8_t g_pins[PIN_CNT];
+static uint8_t g_rtc_mem[512];
+static Ticker *g_tickers[TICKER_CNT];
+static SIM_SOCK_t g_socks[SIM_SOCK_CNT];
+
+volatile uint32_t GPO;
+volatile uint32_t GP16O;
+
+HardwareSerial Serial;
+EspClass ESP;
+UpdaterClass Update;
+FS SPIFFS;
+
+///////////////////////////////////////NODE ENTRY POINTS///////////////////////////////////////////
+extern "C" __attribute__((visibility("default")))
+void sim_node_attach(const SIM_HOST_t *host)
+{
+    g_host = host;
+    for (int i = 0; i < SIM_SOCK_CNT; i++) {
+        g_socks[i].fd = SIM_SOCK_FREE;
+    }
+}
+
+extern "C" __attribute__((visibility("default")))
+void sim_node_run(const SIM_NODE_CFG_t *cfg)
+{
+    char buf[160];
+
+    g_cfg = *cfg;
+    if (g_cfg.security[0] == 0) {
+        snprintf(g_cfg.security, sizeof(g_cfg.security), "sim-%u", g_cfg.index);
+    }
+    g_boot_us = g_host->now_us();
+    for (int i = 0; i < PIN_CNT; i++) {
+        g_pins[i] = HIGH;
+    }
+
+    File f = SPIFFS.open(NODE_SETTINGS_FILE, "w");
+    int n = snprintf(buf, sizeof(buf), NODE_SETTINGS_FMT, g_cfg.server, g_cfg.port, g_cfg.security);
+    f.write((const uint8_t *)buf, n);
+    f.close();
+
+    setup();
+    while (true) {
+        loop();
+        sim_node::idle();
+    }
+}
+
+extern "C" __attribute__((visibility("default")))
+uint32_t sim_node_gpo()
+{
+    return GPO | (GP16O << 16);
+}
+
+///////////////////////////////////////SIM_NODE////////////////////////////////////////////////////
+const SIM_NODE_CFG_t *sim_node::cfg()
+{
+    return &g_cfg;
+}
+
+uint64_t sim_node::now_us()
+{
+    return g_host->now_us() - g_boot_us;
+}
+
+const SIM_NET_t *sim_node::net()
+{
+    return g_host->net;
+}
+
+void sim_node::wait(int fd, uint32_t events, uint64_t deadline_us)
+{
+    uint64_t next = Ticker::run_due(now_us());
+    if ((next != 0) && (next < deadline_us)) {
+        deadline_us = next;
+    }
+    g_host->wait(fd, events, deadline_us + g_boot_us);
+    Ticker::run_due(now_us());
+}
+
+void sim_node::idle()
+{
+    int fd = -1;
+
+    for (int i = 0; i < SIM_SOCK_CNT; i++) {
+        SIM_SOCK_t *s = &g_socks[i];
+        if (s->fd == SIM_SOCK_FREE) {
+            continue;
+        }
+        s->empty_polls = 0;
+        if ((s->head != s->tail) || s->eof) {
+            // Data (or EOF) not read yet: run loop() again
+            wait(-1, 0, now_us());
+            return;
+        }
+        if (s->fd >= 0) {
+            fd = s->fd;
+        }
+    }
+    wait(fd, SIM_EV_IN, now_us() + SIM_IDLE_WAIT_US);
+}
+
+SIM_SOCK_t *sim_node::sock(int8_t id)
+{
+    return ((id >= 0) && (id < SIM_SOCK_CNT)) ? &g_socks[id] : NULL;
+}
+
+int8_t sim_node::sock_open(int fd)
+{
+    for (int8_t i = 0; i < SIM_SOCK_CNT; i++) {
+        SIM_SOCK_t *s = &g_socks[i];
+        if (s->fd == SIM_SOCK_FREE) {
+            s->fd = fd;
+            s->eof = 0;
+            s->empty_polls = 0;
+            s->head = s->tail = 0;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void sim_node::sock_close(int8_t id)
+{
+    SIM_SOCK_t *s = sock(id);
+    if (s != NULL) {
+        s->fd = SIM_SOCK_FREE;
+    }
+}
+
+///////////////////////////////////////ARDUINO/////////////////////////////////////////////////////
+uint32_t millis()
+{
+    return (uint32_t)(sim_node::now_us() / 1000);
+}
+
+uint32_t micros()
+{
+    return (uint32_t)sim_node::now_us();
+}
+
+void delay(uint32_t ms)
+{
+    uint64_t end = sim_node::now_us() + (uint64_t)ms * 1000;
+    do {
+        sim_node::wait(-1, 0, end);
+    } while (sim_node::now_us() < end);
+}
+
+/* Let the other nodes run */
+void yield()
+{
+    sim_node::wait(-1, 0, sim_node::now_us());
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if ((pin < PIN_CNT) && (mode != OUTPUT)) {
+        // Inputs are pulled up: buttons are released
+        g_pins[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin == 16) {
+        GP16O = val ? 1 : 0;
+    } else if (pin < 16) {
+        GPO = val ? (GPO | (1UL << pin)) : (GPO & ~(1UL << pin));
+    }
+    if (pin < PIN_CNT) {
+        g_pins[pin] = val ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return (pin < PIN_CNT) ? g_pins[pin] : LOW;
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+size_t Print::printf(const char *fmt, ...)
+{
+    char buf[256];
+    va_list args;
+
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return 0;
+    }
+    return write((const uint8_t *)buf, ((size_t)n < sizeof(buf)) ? n : sizeof(buf) - 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t size)
+{
+    g_host->trace((const char *)buf, size);
+    return size;
+}
+
+bool IPAddress::fromString(const char *s)
+{
+    return inet_pton(AF_INET, s, &_addr) == 1;
+}
+
+String IPAddress::toString() const
+{
+    char buf[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &_addr, buf, sizeof(buf));
+    return String(buf);
+}
+
+void String::trim()
+{
+    size_t b = _s.find_first_not_of(" \t\r\n");
+    size_t e = _s.find_last_not_of(" \t\r\n");
+    _s = (b == std::string::npos) ? std::string() : _s.substr(b, e - b + 1);
+}
+
+///////////////////////////////////////ESP/////////////////////////////////////////////////////////
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(g_rtc_mem)) {
+        return false;
+    }
+    memcpy(data, &g_rtc_mem[offset * 4], size);
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+    if (offset * 4 + size > sizeof(g_rtc_mem)) {
+        return false;
+    }
+    memcpy(&g_rtc_mem[offset * 4], data, size);
+    return true;
+}
+
+void EspClass::deepSleep(uint64_t us, int mode)
+{
+    g_host->halt("deep sleep");
+}
+
+void EspClass::restart()
+{
+    g_host->halt("restart");
+}
+
+uint32_t EspClass::getChipId()
+{
+    return g_cfg.mac[3] | ((uint32_t)g_cfg.mac[4] << 8) | ((uint32_t)g_cfg.mac[5] << 16);
+}
+
+///////////////////////////////////////TICKER//////////////////////////////////////////////////////
+void Ticker::arm(uint64_t period_us, callback_t cb, bool repeat)
+{
+    detach();
+    for (int i = 0; i < TICKER_CNT; i++) {
+        if (g_tickers[i] == NULL) {
+            g_tickers[i] = this;
+            _cb = cb;
+            _period_us = period_us;
+            _next_us = sim_node::now_us() + period_us;
+            _repeat = repeat;
+            return;
+        }
+    }
+}
+
+void Ticker::detach()
+{
+    for (int i = 0; i < TICKER_CNT; i++) {
+        if (g_tickers[i] == this) {
+            g_tickers[i] = NULL;
+        }
+    }
+    _cb = NULL;
+}
+
+uint64_t Ticker::run_due(uint64_t now_us)
+{
+    uint64_t next = 0;
+
+    for (int i = 0; i < TICKER_CNT; i++) {
+        Ticker *t = g_tickers[i];
+        if (t == NULL) {
+            continue;
+        }
+        if (t->_next_us <= now_us) {
+            callback_t cb = t->_cb;
+            if (t->_repeat) {
+                t->_next_us += t->_period_us;
+            } else {
+                t->detach();
+            }
+            cb();
+        }
+        if ((g_tickers[i] == t) && ((next == 0) || (t->_next_us < next))) {
+            next = t->_next_us;
+        }
+    }
+    return next;
+}
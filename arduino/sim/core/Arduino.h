@@ -0,0 +1,91 @@
+/** @brief Arduino/ESP8266 core stand-in for the fleet simulator: real time, POSIX sockets, the
+ *  node yields to the simulator in delay(), yield() & socket waits.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH                0x1
+#define LOW                 0x0
+#define INPUT               0x00
+#define OUTPUT              0x01
+#define INPUT_PULLUP        0x02
+#define LED_BUILTIN         2
+
+#define PROGMEM
+#define PSTR(s)             (s)
+#define F(s)                (s)
+#define pgm_read_byte(p)    (*(const uint8_t *)(p))
+#define pgm_read_byte_near(p) (*(const uint8_t *)(p))
+#define PGM_P               const char *
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+#define ICACHE_RAM_ATTR
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "Client.h"
+
+/* Sketch entry points */
+void setup();
+void loop();
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+/* GPIO output registers */
+extern volatile uint32_t GPO;
+extern volatile uint32_t GP16O;
+
+class HardwareSerial : public Stream
+{
+    public:
+        void begin(unsigned long) {}
+        using Print::write;
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t size) override;
+        int availableForWrite() override { return 128; }
+        int available() override { return 0; }
+        int read() override { return -1; }
+        int peek() override { return -1; }
+};
+extern HardwareSerial Serial;
+
+#define WAKE_RF_DEFAULT     0
+#define WAKE_RF_DISABLED    4
+
+class EspClass
+{
+    public:
+        bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+        bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+        void deepSleep(uint64_t us, int mode = WAKE_RF_DEFAULT);
+        void restart();
+        uint32_t getFreeHeap() { return 40000; }
+        uint32_t getChipId();
+        bool flashRead(uint32_t offset, uint32_t *data, size_t size) { return false; }
+        uint32_t getSketchSize() { return 0; }
+};
+extern EspClass ESP;
+
+#endif // Arduino_h
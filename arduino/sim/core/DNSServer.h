@@ -0,0 +1,27 @@
+/** @brief DNSServer stand-in: the nodes never run the AP mode in the simulator, so the captive
+ *  portal answers nothing.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef DNSServer_h
+#define DNSServer_h
+
+#include "Arduino.h"
+
+enum class DNSReplyCode
+{
+    NoError = 0,
+    ServerFailure = 2,
+    NonExistentDomain = 3
+};
+
+class DNSServer
+{
+    public:
+        void setErrorReplyCode(const DNSReplyCode &) {}
+        bool start(const uint16_t &, const String &, const IPAddress &) { return true; }
+        void processNextRequest() {}
+        void stop() {}
+};
+
+#endif
@@ -0,0 +1,333 @@
+/**	@brief implement the WiFi stand-in: WiFiClient on non-blocking POSIX sockets. The node yields
+ *  to the others while it waits for the socket, like the ESP8266 core yields to the SYS task.
+ *  When the host provides the network (SIM_NET_t, replayer), WiFiClient & WiFiUDP use it instead.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "ESP8266WiFi.h"
+#include "WiFiUdp.h"
+#include "sim_node.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Timeout of connect() & of a blocked write() (us) */
+#define SOCK_TIMEOUT_US         5000000
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+ESP8266WiFiClass WiFi;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static bool sock_ready(int fd, short events)
+{
+    struct pollfd p = { fd, events, 0 };
+    return (poll(&p, 1, 0) == 1) && (p.revents & (events | POLLERR | POLLHUP));
+}
+
+/** @brief move what the socket has to the RX buffer.
+    @return false on EOF/error.
+*/
+static bool sock_fill(SIM_SOCK_t *s)
+{
+    if (s->head == s->tail) {
+        s->head = s->tail = 0;
+    }
+    if (s->eof || (s->tail >= SIM_SOCK_RX_SZ)) {
+        return !s->eof;
+    }
+    if (s->fd == SIM_SOCK_NET) {
+        int32_t n = sim_node::net()->tcp_recv(&s->rx[s->tail], SIM_SOCK_RX_SZ - s->tail);
+        if (n > 0) {
+            s->tail += n;
+            s->empty_polls = 0;
+        } else if (n < 0) {
+            s->eof = 1;
+        }
+        return !s->eof;
+    }
+    ssize_t n = recv(s->fd, &s->rx[s->tail], SIM_SOCK_RX_SZ - s->tail, 0);
+    if (n > 0) {
+        s->tail += n;
+        s->empty_polls = 0;
+    } else if ((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))) {
+        s->eof = 1;
+    }
+    return !s->eof;
+}
+
+///////////////////////////////////////WIFI////////////////////////////////////////////////////////
+uint8_t *ESP8266WiFiClass::macAddress(uint8_t *mac)
+{
+    memcpy(mac, sim_node::cfg()->mac, 6);
+    return mac;
+}
+
+String ESP8266WiFiClass::macAddress()
+{
+    char buf[18];
+    const uint8_t *m = sim_node::cfg()->mac;
+    snprintf(buf, sizeof(buf), "%02X:%02X:%02X:%02X:%02X:%02X", m[0], m[1], m[2], m[3], m[4], m[5]);
+    return String(buf);
+}
+
+int ESP8266WiFiClass::hostByName(const char *host, IPAddress &ip)
+{
+    struct addrinfo hints;
+    struct addrinfo *res = NULL;
+
+    if (ip.fromString(host)) {
+        return 1;
+    }
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if ((getaddrinfo(host, NULL, &hints, &res) != 0) || (res == NULL)) {
+        return 0;
+    }
+    ip = IPAddress((uint32_t)((struct sockaddr_in *)res->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(res);
+    return 1;
+}
+
+///////////////////////////////////////WIFICLIENT//////////////////////////////////////////////////
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    IPAddress ip;
+    if (sim_node::net() != NULL) {
+        return connect(ip, port);
+    }
+    if (!WiFi.hostByName(host, ip)) {
+        return 0;
+    }
+    return connect(ip, port);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    struct sockaddr_in addr;
+    int one = 1;
+
+    stop();
+    if (sim_node::net() != NULL) {
+        if (!sim_node::net()->tcp_open()) {
+            return 0;
+        }
+        _sock = sim_node::sock_open(SIM_SOCK_NET);
+        return _sock >= 0;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = (uint32_t)ip;
+
+    if ((::connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) && (errno != EINPROGRESS)) {
+        close(fd);
+        return 0;
+    }
+
+    // Wait for the connection, the other nodes run meanwhile:
+    uint64_t deadline = sim_node::now_us() + SOCK_TIMEOUT_US;
+    while (!sock_ready(fd, POLLOUT)) {
+        if (sim_node::now_us() >= deadline) {
+            close(fd);
+            return 0;
+        }
+        sim_node::wait(fd, SIM_EV_OUT, deadline);
+    }
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if ((getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) || (err != 0)) {
+        close(fd);
+        return 0;
+    }
+
+    _sock = sim_node::sock_open(fd);
+    if (_sock < 0) {
+        close(fd);
+        return 0;
+    }
+    return 1;
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    size_t sent = 0;
+
+    if ((s == NULL) || s->eof) {
+        return 0;
+    }
+    if (s->fd == SIM_SOCK_NET) {
+        sim_node::net()->tcp_send(buf, size);
+        return size;
+    }
+    uint64_t deadline = sim_node::now_us() + SOCK_TIMEOUT_US;
+    while (sent < size) {
+        ssize_t n = send(s->fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)) &&
+                   (sim_node::now_us() < deadline)) {
+            sim_node::wait(s->fd, SIM_EV_OUT, deadline);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            s->eof = 1;
+            break;
+        }
+    }
+    return sent;
+}
+
+/** @brief bytes ready to be read.
+ *  @note callers poll available() in a loop (PubSubClient), so the node waits for the socket
+ *  after a few empty polls instead of spinning.
+*/
+int WiFiClient::available()
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    if (s == NULL) {
+        return 0;
+    }
+    if (s->head == s->tail) {
+        sock_fill(s);
+    }
+    if ((s->head == s->tail) && !s->eof && (++s->empty_polls > 2)) {
+        s->empty_polls = 0;
+        sim_node::wait(s->fd, SIM_EV_IN, sim_node::now_us() + SIM_POLL_WAIT_US);
+    }
+    return s->tail - s->head;
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+    return (read(&c, 1) == 1) ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    if (s == NULL) {
+        return -1;
+    }
+    if (s->head == s->tail) {
+        sock_fill(s);
+    }
+    size_t n = s->tail - s->head;
+    if (n == 0) {
+        return -1;
+    }
+    if (n > size) {
+        n = size;
+    }
+    memcpy(buf, &s->rx[s->head], n);
+    s->head += n;
+    return n;
+}
+
+int WiFiClient::peek()
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    if ((s == NULL) || ((s->head == s->tail) && !sock_fill(s)) || (s->head == s->tail)) {
+        return -1;
+    }
+    return s->rx[s->head];
+}
+
+void WiFiClient::stop()
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    if (s != NULL) {
+        if (s->fd == SIM_SOCK_NET) {
+            sim_node::net()->tcp_close();
+        } else {
+            close(s->fd);
+        }
+        sim_node::sock_close(_sock);
+    }
+    _sock = -1;
+}
+
+uint8_t WiFiClient::connected()
+{
+    SIM_SOCK_t *s = sim_node::sock(_sock);
+    if (s == NULL) {
+        return 0;
+    }
+    if ((s->head == s->tail) && !s->eof && ((s->fd == SIM_SOCK_NET) || sock_ready(s->fd, POLLIN))) {
+        sock_fill(s);
+    }
+    return !s->eof || (s->head != s->tail);
+}
+
+///////////////////////////////////////WIFIUDP/////////////////////////////////////////////////////
+uint8_t WiFiUDP::beginMulticast(IPAddress, IPAddress, uint16_t)
+{
+    return sim_node::net() != NULL;
+}
+
+int WiFiUDP::beginPacket(IPAddress, uint16_t)
+{
+    _tx_len = 0;
+    return sim_node::net() != NULL;
+}
+
+int WiFiUDP::beginPacketMulticast(IPAddress, uint16_t, IPAddress, int)
+{
+    _tx_len = 0;
+    return sim_node::net() != NULL;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t size)
+{
+    if (size > sizeof(_tx) - _tx_len) {
+        size = sizeof(_tx) - _tx_len;
+    }
+    memcpy(&_tx[_tx_len], buf, size);
+    _tx_len += size;
+    return size;
+}
+
+int WiFiUDP::endPacket()
+{
+    if (sim_node::net() == NULL) {
+        return 0;
+    }
+    sim_node::net()->udp_send(_tx, _tx_len);
+    _tx_len = 0;
+    return 1;
+}
+
+int WiFiUDP::parsePacket()
+{
+    _rx_len = _rx_pos = 0;
+    if (sim_node::net() == NULL) {
+        return 0;
+    }
+    int32_t n = sim_node::net()->udp_recv(_rx, sizeof(_rx));
+    _rx_len = (n > 0) ? n : 0;
+    return _rx_len;
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t size)
+{
+    size_t n = _rx_len - _rx_pos;
+    if (n > size) {
+        n = size;
+    }
+    memcpy(buf, &_rx[_rx_pos], n);
+    _rx_pos += n;
+    return n;
+}
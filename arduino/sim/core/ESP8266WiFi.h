@@ -0,0 +1,76 @@
+/** @brief ESP8266WiFi stand-in: the station is always connected, WiFiClient is a non-blocking
+ *  POSIX TCP socket which yields to the simulator while waiting.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef ESP8266WiFi_h
+#define ESP8266WiFi_h
+
+#include "Arduino.h"
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } WiFiMode_t;
+typedef enum { WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4,
+               WL_DISCONNECTED = 6 } wl_status_t;
+
+class ESP8266WiFiClass
+{
+    public:
+        bool mode(WiFiMode_t m) { _mode = m; return true; }
+        wl_status_t begin(const char *, const char * = NULL) { return WL_CONNECTED; }
+        bool config(IPAddress, IPAddress, IPAddress, IPAddress = (uint32_t)0, IPAddress = (uint32_t)0) { return true; }
+        bool setAutoConnect(bool) { return true; }
+        bool disconnect(bool = false) { return true; }
+        wl_status_t status() { return WL_CONNECTED; }
+        IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+        IPAddress gatewayIP() { return IPAddress(127, 0, 0, 1); }
+        IPAddress subnetMask() { return IPAddress(255, 0, 0, 0); }
+        int32_t RSSI() { return -60; }
+        uint8_t *macAddress(uint8_t *mac);
+        String macAddress();
+        bool softAP(const char *, const char * = NULL) { _mode = WIFI_AP; return true; }
+        IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+        uint8_t softAPgetStationNum() { return 0; }
+        int hostByName(const char *host, IPAddress &ip);
+
+    private:
+        WiFiMode_t _mode;
+};
+extern ESP8266WiFiClass WiFi;
+
+class WiFiClient : public Client
+{
+    public:
+        WiFiClient() : _sock(-1) {}
+
+        int connect(IPAddress ip, uint16_t port) override;
+        int connect(const char *host, uint16_t port) override;
+        using Print::write;
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t size) override;
+        int available() override;
+        int read() override;
+        int read(uint8_t *buf, size_t size) override;
+        int peek() override;
+        void flush() override {}
+        void stop() override;
+        uint8_t connected() override;
+        operator bool() override { return _sock >= 0; }
+        void setNoDelay(bool) {}
+
+    private:
+        int8_t _sock;       // Socket slot (see sim_node.h)
+};
+
+class WiFiServer
+{
+    public:
+        WiFiServer(uint16_t port) : _port(port) {}
+        void begin() {}
+        /* No HTTP clients in the simulator (nodes never stay in AP mode) */
+        WiFiClient available() { return WiFiClient(); }
+
+    private:
+        uint16_t _port;
+};
+
+#endif // ESP8266WiFi_h
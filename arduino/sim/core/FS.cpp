@@ -0,0 +1,89 @@
+/**	@brief implement the in-memory SPIFFS stand-in.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "FS.h"
+
+///////////////////////////////////////FILE////////////////////////////////////////////////////////
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    if (mode == SeekCur) {
+        pos += _pos;
+    } else if (mode == SeekEnd) {
+        pos = _data ? _data->size() - pos : 0;
+    }
+    if (!_data || (pos > _data->size())) {
+        return false;
+    }
+    _pos = pos;
+    return true;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return (read(&c, 1) == 1) ? c : -1;
+}
+
+int File::peek()
+{
+    return (_data && (_pos < _data->size())) ? (uint8_t)(*_data)[_pos] : -1;
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    if (!_data || (_pos >= _data->size())) {
+        return 0;
+    }
+    size_t n = _data->size() - _pos;
+    if (n > size) {
+        n = size;
+    }
+    memcpy(buf, _data->data() + _pos, n);
+    _pos += n;
+    return n;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    if (!_data || !_wr) {
+        return 0;
+    }
+    if (_pos + size > _data->size()) {
+        _data->resize(_pos + size);
+    }
+    memcpy(&(*_data)[_pos], buf, size);
+    _pos += size;
+    return size;
+}
+
+///////////////////////////////////////FS//////////////////////////////////////////////////////////
+File FS::open(const char *path, const char *mode)
+{
+    std::map<std::string, std::shared_ptr<std::string> >::iterator it = _files.find(path);
+
+    if (mode[0] == 'r') {
+        if (it == _files.end()) {
+            return File();
+        }
+        return File(it->second, mode[1] == '+', false);
+    }
+    if ((mode[0] == 'w') || (it == _files.end())) {
+        std::shared_ptr<std::string> data(new std::string());
+        _files[path] = data;
+        return File(data, true, false);
+    }
+    return File(it->second, true, true);
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    std::map<std::string, std::shared_ptr<std::string> >::iterator it = _files.find(from);
+    if (it == _files.end()) {
+        return false;
+    }
+    std::shared_ptr<std::string> data = it->second;
+    _files.erase(it);
+    _files[to] = data;
+    return true;
+}
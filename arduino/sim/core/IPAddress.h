@@ -0,0 +1,31 @@
+/** @brief Arduino IPAddress stand-in (IPv4).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include <stdint.h>
+#include <string.h>
+#include "WString.h"
+
+class IPAddress
+{
+    public:
+        IPAddress() : _addr(0) {}
+        IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+            : _addr(a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+        IPAddress(uint32_t addr) : _addr(addr) {}
+        IPAddress(const uint8_t *addr) { memcpy(&_addr, addr, 4); }
+
+        operator uint32_t() const { return _addr; }
+        uint8_t operator[](int i) const { return (uint8_t)(_addr >> (8 * i)); }
+        bool operator==(const IPAddress &a) const { return _addr == a._addr; }
+        bool fromString(const char *s);
+        String toString() const;
+
+    private:
+        uint32_t _addr;     // Network order, like lwIP
+};
+
+#endif
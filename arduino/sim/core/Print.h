@@ -0,0 +1,38 @@
+/** @brief Arduino Print stand-in.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Print_h
+#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+class Print
+{
+    public:
+        virtual ~Print() {}
+        virtual size_t write(uint8_t c) = 0;
+        virtual size_t write(const uint8_t *buf, size_t size) {
+            size_t n = 0;
+            while (size--) {
+                n += write(*buf++);
+            }
+            return n;
+        }
+        size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+        size_t print(const char *s) { return write(s); }
+        size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+        size_t print(char c) { return write((uint8_t)c); }
+        size_t print(int v) { return print(String(v)); }
+        size_t print(unsigned int v) { return print(String(v)); }
+        size_t println(const char *s = "") { return print(s) + print("\r\n"); }
+        size_t println(const String &s) { return print(s) + print("\r\n"); }
+        size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+        virtual int availableForWrite() { return 0; }
+        virtual void flush() {}
+};
+
+#endif
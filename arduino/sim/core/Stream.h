@@ -0,0 +1,38 @@
+/** @brief Arduino Stream stand-in.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Stream_h
+#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print
+{
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+
+        size_t readBytes(char *buf, size_t len) {
+            size_t n = 0;
+            while (n < len) {
+                int c = read();
+                if (c < 0) {
+                    break;
+                }
+                buf[n++] = (char)c;
+            }
+            return n;
+        }
+        String readStringUntil(char end) {
+            String s;
+            int c;
+            while (((c = read()) >= 0) && (c != end)) {
+                s += (char)c;
+            }
+            return s;
+        }
+};
+
+#endif
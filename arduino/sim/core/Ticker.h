@@ -0,0 +1,38 @@
+/** @brief Ticker stand-in: callbacks run in the node, when it yields (like the SYS context
+ *  callbacks of the ESP8266 core).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Ticker_h
+#define Ticker_h
+
+#include "Arduino.h"
+
+class Ticker
+{
+    public:
+        typedef void (*callback_t)();
+
+        Ticker() : _cb(NULL), _period_us(0), _next_us(0), _repeat(false) {}
+        ~Ticker() { detach(); }
+
+        void attach(float seconds, callback_t cb) { arm((uint64_t)(seconds * 1000000), cb, true); }
+        void attach_ms(uint32_t ms, callback_t cb) { arm((uint64_t)ms * 1000, cb, true); }
+        void once(float seconds, callback_t cb) { arm((uint64_t)(seconds * 1000000), cb, false); }
+        void once_ms(uint32_t ms, callback_t cb) { arm((uint64_t)ms * 1000, cb, false); }
+        void detach();
+        bool active() const { return _cb != NULL; }
+
+        /* Simulator: run the due callbacks, return the next due time (0: none) */
+        static uint64_t run_due(uint64_t now_us);
+
+    private:
+        void arm(uint64_t period_us, callback_t cb, bool repeat);
+
+        callback_t _cb;
+        uint64_t _period_us;
+        uint64_t _next_us;
+        bool _repeat;
+};
+
+#endif // Ticker_h
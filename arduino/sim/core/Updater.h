@@ -0,0 +1,23 @@
+/** @brief Updater stand-in: the simulated nodes have no flash, an update never starts (the OTA
+ *  chunks are answered with DELTA_E_IO).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Updater_h
+#define Updater_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+class UpdaterClass
+{
+    public:
+        bool begin(size_t size, int command = 0) { return false; }
+        size_t write(uint8_t *data, size_t len) { return 0; }
+        bool end(bool evenIfRemaining = false) { return false; }
+        bool isRunning() { return false; }
+        uint8_t getError() { return 0; }
+};
+extern UpdaterClass Update;
+
+#endif
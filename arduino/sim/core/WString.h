@@ -0,0 +1,59 @@
+/** @brief Arduino String stand-in (std::string based).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef WString_h
+#define WString_h
+
+#include <string>
+#include <stdio.h>
+
+class __FlashStringHelper;
+
+class String
+{
+    public:
+        String(const char *s = "") : _s(s ? s : "") {}
+        String(const std::string &s) : _s(s) {}
+        explicit String(char c) : _s(1, c) {}
+        explicit String(int v) : _s(std::to_string(v)) {}
+        explicit String(unsigned int v) : _s(std::to_string(v)) {}
+        explicit String(long v) : _s(std::to_string(v)) {}
+        explicit String(unsigned long v) : _s(std::to_string(v)) {}
+
+        const char *c_str() const { return _s.c_str(); }
+        unsigned int length() const { return _s.size(); }
+        char charAt(unsigned int i) const { return (i < _s.size()) ? _s[i] : 0; }
+        char operator[](unsigned int i) const { return charAt(i); }
+
+        int indexOf(char c, unsigned int from = 0) const { return find(_s.find(c, from)); }
+        int indexOf(const char *s, unsigned int from = 0) const { return find(_s.find(s, from)); }
+        int indexOf(const String &s, unsigned int from = 0) const { return find(_s.find(s._s, from)); }
+        String substring(unsigned int from) const { return (from < _s.size()) ? String(_s.substr(from)) : String(); }
+        String substring(unsigned int from, unsigned int to) const {
+            return (from < to && from < _s.size()) ? String(_s.substr(from, to - from)) : String();
+        }
+        bool startsWith(const String &s) const { return _s.compare(0, s._s.size(), s._s) == 0; }
+        long toInt() const { return atol(_s.c_str()); }
+        void trim();
+
+        String &operator+=(const String &s) { _s += s._s; return *this; }
+        String &operator+=(const char *s) { _s += s; return *this; }
+        String &operator+=(char c) { _s += c; return *this; }
+        bool concat(const String &s) { _s += s._s; return true; }
+
+        friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+        friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+        friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+        friend String operator+(const String &a, char b) { return String(a._s + b); }
+
+        bool operator==(const String &s) const { return _s == s._s; }
+        bool operator==(const char *s) const { return _s == s; }
+        bool operator!=(const String &s) const { return _s != s._s; }
+
+    private:
+        static int find(size_t pos) { return (pos == std::string::npos) ? -1 : (int)pos; }
+        std::string _s;
+};
+
+#endif
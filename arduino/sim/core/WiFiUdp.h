@@ -0,0 +1,39 @@
+/** @brief WiFiUDP stand-in: the simulated nodes share one host address, so they have no LAN;
+ *  joining a multicast group fails and the LAN channel of the sketch stays idle. When the host
+ *  provides the network (replayer), the datagrams go through it: one group, no addresses.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+#include "ESP8266WiFi.h"
+
+/* Largest datagram */
+#define SIM_UDP_SZ              512
+
+class WiFiUDP
+{
+    public:
+        WiFiUDP() : _rx_len(0), _rx_pos(0), _tx_len(0) {}
+
+        uint8_t begin(uint16_t) { return 0; }
+        uint8_t beginMulticast(IPAddress, IPAddress, uint16_t);
+        int beginPacket(IPAddress, uint16_t);
+        int beginPacketMulticast(IPAddress, uint16_t, IPAddress, int = 1);
+        size_t write(const uint8_t *buf, size_t size);
+        int endPacket();
+        int parsePacket();
+        int read(uint8_t *buf, size_t size);
+        IPAddress remoteIP() { return IPAddress(); }
+        uint16_t remotePort() { return 0; }
+
+    private:
+        uint8_t _rx[SIM_UDP_SZ];
+        uint16_t _rx_len;
+        uint16_t _rx_pos;
+        uint8_t _tx[SIM_UDP_SZ];
+        uint16_t _tx_len;
+};
+
+#endif
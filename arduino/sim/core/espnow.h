@@ -0,0 +1,25 @@
+/** @brief ESP-NOW stand-in: the simulated nodes have no radio, esp_now_init() fails and the
+ *  gateway of the sketch stays idle.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef espnow_h
+#define espnow_h
+
+#include <stdint.h>
+
+enum esp_now_role { ESP_NOW_ROLE_IDLE = 0, ESP_NOW_ROLE_CONTROLLER, ESP_NOW_ROLE_SLAVE, ESP_NOW_ROLE_COMBO };
+
+typedef void (*esp_now_recv_cb_t)(uint8_t *mac, uint8_t *data, uint8_t len);
+typedef void (*esp_now_send_cb_t)(uint8_t *mac, uint8_t status);
+
+inline int esp_now_init() { return -1; }
+inline int esp_now_set_self_role(uint8_t) { return -1; }
+inline int esp_now_register_recv_cb(esp_now_recv_cb_t) { return -1; }
+inline int esp_now_register_send_cb(esp_now_send_cb_t) { return -1; }
+inline int esp_now_add_peer(uint8_t *, uint8_t, uint8_t, uint8_t *, uint8_t) { return -1; }
+inline int esp_now_del_peer(uint8_t *) { return -1; }
+inline int esp_now_is_peer_exist(uint8_t *) { return 0; }
+inline int esp_now_send(uint8_t *, uint8_t *, int) { return -1; }
+
+#endif
@@ -0,0 +1,71 @@
+/** @brief define the interface between the fleet simulator (host process) and the node image
+ *  (sketch + Arduino stand-in, built as a shared object). The host swaps the node image data
+ *  segment for each node, so all the globals of the sketch & of the stand-in are per node.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _SIM_HOST_H_
+#define _SIM_HOST_H_
+
+#include <stdint.h>
+
+/* Wait events */
+#define SIM_EV_IN           0x01
+#define SIM_EV_OUT          0x04
+
+/* Network provided by the host (replayer) instead of the POSIX sockets: one MQTT connection &
+the LAN channel, as byte streams & datagrams */
+struct SIM_NET_t {
+    /* MQTT connection: open (false: refused), bytes to the node (0: none yet, < 0: closed by the
+    broker), bytes from the node, closed by the node */
+    bool (*tcp_open)();
+    int32_t (*tcp_recv)(uint8_t *buf, uint32_t size);
+    void (*tcp_send)(const uint8_t *buf, uint32_t len);
+    void (*tcp_close)();
+
+    /* LAN: next datagram to the node (0: none), datagram from the node */
+    int32_t (*udp_recv)(uint8_t *buf, uint32_t size);
+    void (*udp_send)(const uint8_t *buf, uint32_t len);
+};
+
+/* Services of the host, used by the node image */
+struct SIM_HOST_t {
+    /* Monotonic time */
+    uint64_t (*now_us)();
+
+    /* Switch to the other nodes until 'fd' has one of 'events' (fd < 0: none) or until
+    'deadline_us'. Returns in the same node. */
+    void (*wait)(int fd, uint32_t events, uint64_t deadline_us);
+
+    /* The node stops (ESP.restart(), ESP.deepSleep()): never returns */
+    void (*halt)(const char *reason);
+
+    /* Node Serial output, when tracing */
+    void (*trace)(const char *buf, uint32_t len);
+
+    /* Network of the node (NULL: POSIX sockets & no LAN) */
+    const SIM_NET_t *net;
+};
+
+/* Node identity & settings */
+struct SIM_NODE_CFG_t {
+    uint32_t index;
+    uint8_t mac[6];
+    char server[64];
+    uint16_t port;
+    char security[32];      // Empty: "sim-<index>"
+};
+
+/* Entry points of the node image */
+extern "C" {
+    /* Called once, before the data segment is copied for the nodes */
+    typedef void (*sim_node_attach_t)(const SIM_HOST_t *host);
+
+    /* Run a node (setup(), then loop() forever) */
+    typedef void (*sim_node_run_t)(const SIM_NODE_CFG_t *cfg);
+
+    /* GPIO output registers of the running node */
+    typedef uint32_t (*sim_node_gpo_t)();
+}
+
+#endif
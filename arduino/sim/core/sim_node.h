@@ -0,0 +1,58 @@
+/** @brief define the node runtime of the Arduino stand-in: time base, waits & sockets. All of
+ *  it is per node (it lives in the node image data segment).
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _SIM_NODE_H_
+#define _SIM_NODE_H_
+
+#include "Arduino.h"
+#include "sim_host.h"
+
+/* Socket slot states: free, or connected through the host network (SIM_NET_t) */
+#define SIM_SOCK_FREE           -1
+#define SIM_SOCK_NET            -2
+
+/* Sockets per node */
+#define SIM_SOCK_CNT            2
+#define SIM_SOCK_RX_SZ          512
+
+/* Wait after repeated empty polls of a socket (us) */
+#define SIM_POLL_WAIT_US        10000
+
+/* Longest idle wait between two loop() (us) */
+#define SIM_IDLE_WAIT_US        1000000
+
+struct SIM_SOCK_t {
+    int fd;             // Or SIM_SOCK_FREE / SIM_SOCK_NET
+    uint8_t eof;
+    uint8_t empty_polls;
+    uint16_t head;
+    uint16_t tail;
+    uint8_t rx[SIM_SOCK_RX_SZ];
+};
+
+class sim_node
+{
+    public:
+        static const SIM_NODE_CFG_t *cfg();
+        static uint64_t now_us();
+
+        /* Network of the host, NULL if the node uses POSIX sockets */
+        static const SIM_NET_t *net();
+
+        /* Yield to the other nodes until 'fd' has 'events' or until 'deadline_us', running the
+        due Ticker callbacks. May return early: callers check their condition again. */
+        static void wait(int fd, uint32_t events, uint64_t deadline_us);
+
+        /* Wait between two loop(): until a socket has data, a Ticker is due or for at most
+        SIM_IDLE_WAIT_US */
+        static void idle();
+
+        /* Socket slots */
+        static SIM_SOCK_t *sock(int8_t id);
+        static int8_t sock_open(int fd);
+        static void sock_close(int8_t id);
+};
+
+#endif
@@ -0,0 +1,12 @@
+/** @brief SDK stand-in (user_interface.h): the radio calls used by the sketch.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef user_interface_h
+#define user_interface_h
+
+#include <stdint.h>
+
+inline bool wifi_set_channel(uint8_t) { return false; }
+
+#endif
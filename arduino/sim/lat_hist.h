@@ -0,0 +1,98 @@
+/** @brief latency histogram for the host tools: log-linear buckets (8 per power of 2, exact
+ *  below 16), so percentiles are within 12.5% at any scale, in fixed memory.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _LAT_HIST_H_
+#define _LAT_HIST_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define LAT_HIST_SUB_BITS       3
+#define LAT_HIST_LINEAR         (2 << LAT_HIST_SUB_BITS)
+#define LAT_HIST_BUCKETS        (LAT_HIST_LINEAR + (32 - LAT_HIST_SUB_BITS - 1) * (1 << LAT_HIST_SUB_BITS))
+
+class LatHist
+{
+    public:
+        LatHist() { reset(); }
+
+        void reset() {
+            memset(_buckets, 0, sizeof(_buckets));
+            _count = 0;
+            _max = 0;
+            _sum = 0;
+        }
+
+        void add(uint32_t us) {
+            _buckets[index(us)]++;
+            _count++;
+            _sum += us;
+            if (us > _max) {
+                _max = us;
+            }
+        }
+
+        void merge(const LatHist &h) {
+            for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+                _buckets[i] += h._buckets[i];
+            }
+            _count += h._count;
+            _sum += h._sum;
+            if (h._max > _max) {
+                _max = h._max;
+            }
+        }
+
+        uint64_t count() const { return _count; }
+        uint32_t max() const { return _max; }
+        double avg() const { return _count ? (double)_sum / _count : 0; }
+
+        /* Value (us) below which 'pct' % of the samples are: upper bound of the bucket */
+        uint32_t percentile(double pct) const {
+            if (_count == 0) {
+                return 0;
+            }
+            uint64_t rank = (uint64_t)(pct / 100.0 * _count + 0.5);
+            if (rank == 0) {
+                rank = 1;
+            }
+            uint64_t n = 0;
+            for (int i = 0; i < LAT_HIST_BUCKETS; i++) {
+                n += _buckets[i];
+                if (n >= rank) {
+                    uint32_t v = upper(i);
+                    return (v < _max) ? v : _max;
+                }
+            }
+            return _max;
+        }
+
+    private:
+        static int index(uint32_t v) {
+            if (v < LAT_HIST_LINEAR) {
+                return v;
+            }
+            int k = 31 - __builtin_clz(v);
+            int sub = (v >> (k - LAT_HIST_SUB_BITS)) & ((1 << LAT_HIST_SUB_BITS) - 1);
+            return LAT_HIST_LINEAR + (k - LAT_HIST_SUB_BITS - 1) * (1 << LAT_HIST_SUB_BITS) + sub;
+        }
+
+        static uint32_t upper(int i) {
+            if (i < LAT_HIST_LINEAR) {
+                return i;
+            }
+            int k = (i - LAT_HIST_LINEAR) / (1 << LAT_HIST_SUB_BITS) + LAT_HIST_SUB_BITS + 1;
+            int sub = (i - LAT_HIST_LINEAR) % (1 << LAT_HIST_SUB_BITS);
+            uint64_t v = ((uint64_t)((1 << LAT_HIST_SUB_BITS) + sub + 1) << (k - LAT_HIST_SUB_BITS)) - 1;
+            return (v > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)v;
+        }
+
+        uint64_t _buckets[LAT_HIST_BUCKETS];
+        uint64_t _count;
+        uint64_t _sum;
+        uint32_t _max;
+};
+
+#endif
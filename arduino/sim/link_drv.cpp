@@ -0,0 +1,111 @@
+/**	@brief implement the node link driver of the session replayer: the "trace" transport, the UDP
+ *  transport of wdm_th with the trace as its server, & the STATUS reports it carries.
+ *  - The transport has the flags & the ACK wait of transport_udp: node_link::rx_packet() takes
+ *    the replies as it does on the node.
+ *  - The clock of the stand-ins moves by the time the node waits for the replies.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include <wdm_proto.h>
+#include "rtc_mem.h"
+#include "node_link.h"
+#include "transport_udp.h"
+#include "link_drv.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* STATUS opcode of node_link (see node_link.cpp) */
+#define LINK_OP_STATUS          0x02
+
+/* Maximum number of devices in a STATUS (see node_link.cpp) */
+#define LINK_DEV_CNT_MAX        10
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static const LINK_TRACE_t *g_trace;
+static uint32_t g_seq;
+
+///////////////////////////////////////TRACE TRANSPORT/////////////////////////////////////////////
+static bool trace_open()
+{
+    return true;
+}
+
+static bool trace_send(const uint8_t *frame, size_t len)
+{
+    wdm_frame::View<UdpHeader> hdr(frame, len);
+    if (hdr.valid()) {
+        g_seq = hdr.get<UDP_HDR_SEQ>();
+    }
+    g_trace->send(frame, len);
+    return true;
+}
+
+static int trace_recv(uint8_t *buf, size_t size, uint32_t timeout_ms)
+{
+    uint32_t waited = 0;
+    int len = g_trace->recv(buf, size, timeout_ms, &waited);
+    mock_time_advance(waited);
+    return len;
+}
+
+static uint8_t trace_quality()
+{
+    return 100;
+}
+
+static const TRANSPORT_t g_trace_tp = {
+    "trace", 0, UDP_ACK_MS,
+    trace_open, trace_send, trace_recv, trace_quality
+};
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void link_drv::boot(const LINK_TRACE_t *trace, const uint8_t id[], const char *security)
+{
+    g_trace = trace;
+    g_seq = 0;
+    ESP.power_on();
+    rtc_mem::reset();
+    node_link::init(id, security);
+}
+
+/** @brief the devices of the recorded STATUS go out in a new one: same packet size & content,
+ *  new sequence & FCS.
+*/
+bool link_drv::send_STATUS(const uint8_t *frame, size_t len)
+{
+    DEVICE_INFO_t dev[LINK_DEV_CNT_MAX];
+
+    wdm_frame::Reader rd(frame, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    wdm_frame::View<UdpHeader> hdr = rd.next<UdpHeader>();
+    wdm_frame::View<UdpCount> cnt = rd.next<UdpCount>();
+    if (!hdr.valid() || (hdr.get<UDP_HDR_OPCODE>() != LINK_OP_STATUS) || !cnt.valid() ||
+        (cnt.get<0>() > LINK_DEV_CNT_MAX)) {
+        return false;
+    }
+    int dev_cnt = cnt.get<0>();
+    memset(dev, 0, sizeof(dev));
+    for (int k = 0; k < dev_cnt; k++) {
+        wdm_frame::View<UdpDeviceStatus> v = rd.next<UdpDeviceStatus>();
+        if (!v.valid()) {
+            return false;
+        }
+        dev[k].offset = v.get<UDP_DEV_OFFSET>();
+        dev[k].type = v.get<UDP_DEV_TYPE>();
+        dev[k].v = (int32_t)v.get<UDP_DEV_VALUE>();
+        dev[k].r = (int8_t)v.get<UDP_DEV_RSSI>();
+        dev[k].p = v.get<UDP_DEV_POWER>();
+    }
+    return node_link::send_STATUS(&g_trace_tp, dev_cnt, dev);
+}
+
+uint32_t link_drv::seq()
+{
+    return g_seq;
+}
+
+uint16_t link_drv::ack_ms()
+{
+    return g_trace_tp.ack_ms;
+}
@@ -0,0 +1,40 @@
+/** @brief define the interface between the session replayer and the node link of wdm_th
+ *  (node_link, the successor of udp_inf): the link code is built into the replayer, on the host
+ *  stand-ins of the tests, and sends through a transport whose packets come from the trace.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _LINK_DRV_H_
+#define _LINK_DRV_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Trace side of the transport, provided by the replayer */
+struct LINK_TRACE_t {
+    /* Packet from the node */
+    void (*send)(const uint8_t *frame, size_t len);
+
+    /* Next packet to the node within 'timeout_ms': its length (0: none, -1: doesn't fit in
+    'size'), '*waited_ms' = the time it took */
+    int (*recv)(uint8_t *buf, size_t size, uint32_t timeout_ms, uint32_t *waited_ms);
+};
+
+class link_drv
+{
+    public:
+        /* Fresh node (power on): link state, identity & trace side */
+        static void boot(const LINK_TRACE_t *trace, const uint8_t id[], const char *security);
+
+        /* Send the STATUS of a recorded one (same devices) through node_link & wait for its
+        ACK: return true if ACKed, false if not or if 'frame' isn't a STATUS */
+        static bool send_STATUS(const uint8_t *frame, size_t len);
+
+        /* Sequence of the last packet sent by the node */
+        static uint32_t seq();
+
+        /* ACK wait of the transport (ms): the replies later than this are lost */
+        static uint16_t ack_ms();
+};
+
+#endif
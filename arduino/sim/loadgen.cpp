@@ -0,0 +1,607 @@
+/**	@brief MQTT load generator: N clients speaking the wdm frame format, driven from one epoll
+ *  loop. Each client connects like a node (presence Last-Will, subscription to its
+ *  wdm/dev/sub/<id> topic), then publishes on wdm/dev/pub/<id>, at configurable rates:
+ *      - OPU_STATUS (retained), fire & forget.
+ *      - OPU_TIME_GET: timed until the 'a' answer of the broker (wdm_broker backend stand-in).
+ *      - 'd' commands: timed until the broker echoes them on wdm/dev/sub/<id>.
+ *  With --qos 1, the PUBACKs are timed too. It reports the message rates & latency percentiles.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <deque>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include <wdm_proto.h>
+#include "lat_hist.h"
+#include "mqtt_wire.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define LOADGEN_PORT_DEFAULT    18830
+#define EPOLL_BATCH             256
+#define RX_CHUNK                4096
+#define KEEPALIVE_SEC           60
+
+/* Client states */
+#define CLIENT_CONNECTING       0
+#define CLIENT_HANDSHAKE        1       // Waiting for CONNACK & SUBACK
+#define CLIENT_READY            2
+#define CLIENT_CLOSED           3
+
+/* Scheduled actions */
+#define ACT_CONNECT             0
+#define ACT_STATUS              1
+#define ACT_TIME                2
+#define ACT_CMD                 3
+#define ACT_PING                4
+
+/* wdm frame (see mqtt_inf.cpp) */
+#define FRAME_MARK              0x01
+#define OPU_TIME_GET            0x41
+#define OPU_STATUS              0x42
+#define OPD_TIME                'a'
+#define OPD_COMMAND             'd'
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+struct Client {
+    int fd;
+    uint8_t state;
+    bool out_armed;
+    uint8_t id[WDM_ID_SZ];
+    std::string pub_topic;
+    std::string sub_topic;
+    std::string pres_topic;
+    std::string rx;
+    std::string tx;
+    uint32_t value;
+    uint16_t pid;
+    std::deque<uint64_t> time_pending;
+    std::deque<uint64_t> cmd_pending;
+    std::deque<std::pair<uint16_t, uint64_t> > ack_pending;
+};
+
+struct Action {
+    uint64_t at;
+    uint32_t client;
+    uint8_t act;
+    bool operator>(const Action &a) const { return at > a.at; }
+};
+
+struct Stats {
+    uint64_t connected;
+    uint64_t closed;
+    uint64_t tx_msgs;
+    uint64_t rx_msgs;
+    uint64_t status;
+    uint64_t time_req;
+    uint64_t cmd;
+};
+
+/* Latency of each timed exchange */
+struct Lat {
+    LatHist time;
+    LatHist echo;
+    LatHist ack;
+};
+
+struct Options {
+    std::string host;
+    int port;
+    uint32_t clients;
+    double duration;
+    double ramp;
+    double status_rate;
+    double time_rate;
+    double cmd_rate;
+    uint8_t qos;
+    uint8_t id_base;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static Options g_opt;
+static std::vector<Client> g_clients;
+static std::priority_queue<Action, std::vector<Action>, std::greater<Action> > g_actions;
+static int g_epfd;
+static struct sockaddr_in g_addr;
+static Stats g_stats;
+static Lat g_lat_period;
+static Lat g_lat_all;
+static volatile sig_atomic_t g_stop;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static uint64_t period_us(double rate)
+{
+    return (rate > 0) ? (uint64_t)(1000000 / rate) : 0;
+}
+
+static void schedule(uint32_t i, uint8_t act, uint64_t at)
+{
+    g_actions.push(Action { at, i, act });
+}
+
+/* First action at a random phase of its period, so the clients don't publish in bursts */
+static void schedule_first(uint32_t i, uint8_t act, double rate, uint64_t now)
+{
+    uint64_t p = period_us(rate);
+    if (p != 0) {
+        schedule(i, act, now + (uint64_t)(((double)rand() / RAND_MAX) * p));
+    }
+}
+
+static void arm(Client &c, bool out)
+{
+    struct epoll_event ev;
+    ev.events = EPOLLIN | (out ? EPOLLOUT : 0);
+    ev.data.u32 = &c - &g_clients[0];
+    epoll_ctl(g_epfd, EPOLL_CTL_MOD, c.fd, &ev);
+    c.out_armed = out;
+}
+
+static void client_close(Client &c)
+{
+    if (c.state == CLIENT_CLOSED) {
+        return;
+    }
+    epoll_ctl(g_epfd, EPOLL_CTL_DEL, c.fd, NULL);
+    close(c.fd);
+    c.state = CLIENT_CLOSED;
+    g_stats.closed++;
+}
+
+static void flush_tx(Client &c)
+{
+    while (!c.tx.empty()) {
+        ssize_t n = send(c.fd, c.tx.data(), c.tx.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+            c.tx.erase(0, n);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            break;
+        } else {
+            client_close(c);
+            return;
+        }
+    }
+    if (c.tx.empty() == c.out_armed) {
+        arm(c, !c.tx.empty());
+    }
+}
+
+static void publish(Client &c, const std::string &topic, const uint8_t *payload, uint32_t len,
+                    bool retain, uint64_t now)
+{
+    uint16_t pid = 0;
+    if (g_opt.qos) {
+        if (++c.pid == 0) {
+            c.pid = 1;
+        }
+        pid = c.pid;
+        c.ack_pending.push_back(std::make_pair(pid, now));
+    }
+    mqtt_wire::publish(c.tx, topic, payload, len, retain, g_opt.qos, pid);
+    g_stats.tx_msgs++;
+}
+
+///////////////////////////////////////ACTIONS/////////////////////////////////////////////////////
+static void act_connect(uint32_t i)
+{
+    Client &c = g_clients[i];
+    int one = 1;
+
+    c.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if ((connect(c.fd, (struct sockaddr *)&g_addr, sizeof(g_addr)) != 0) && (errno != EINPROGRESS)) {
+        close(c.fd);
+        c.state = CLIENT_CLOSED;
+        g_stats.closed++;
+        return;
+    }
+
+    // The connection completes in the background, the MQTT CONNECT is queued meanwhile:
+    char client_id[32];
+    std::string will;
+    snprintf(client_id, sizeof(client_id), "wdm-load-%u", i);
+    mqtt_wire::put_str(will, client_id);
+    mqtt_wire::put_str(will, c.pres_topic);
+    mqtt_wire::put_str(will, "0");
+    mqtt_wire::put_header(c.tx, MQTT_CONNECT << 4, 10 + will.size());
+    mqtt_wire::put_str(c.tx, "MQTT");
+    c.tx += (char)4;
+    c.tx += (char)(0x02 | 0x04 | 0x08 | 0x20);     // Clean, Will QoS 1, retained
+    mqtt_wire::put_u16(c.tx, KEEPALIVE_SEC);
+    c.tx += will;
+    mqtt_wire::subscribe(c.tx, 1, c.sub_topic);
+
+    c.state = CLIENT_CONNECTING;
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT;
+    ev.data.u32 = i;
+    epoll_ctl(g_epfd, EPOLL_CTL_ADD, c.fd, &ev);
+    c.out_armed = true;
+}
+
+static void act_status(Client &c, uint64_t now)
+{
+    uint8_t arr[MqttHeader::size + MqttCount::size + MqttDeviceStatus::size];
+    wdm_frame::Writer w(arr, sizeof(arr));
+
+    c.value ^= 1;
+    w.put<MqttHeader>(FRAME_MARK, OPU_STATUS, c.id);
+    w.put<MqttCount>(1);
+    w.put<MqttDeviceStatus>(1, 1, 0, 255, c.value, (uint32_t)time(NULL));
+    publish(c, c.pub_topic, arr, w.length(), true, now);
+    g_stats.status++;
+}
+
+static void act_time(Client &c, uint64_t now)
+{
+    uint8_t arr[MqttHeader::size + MqttTime::size];
+    wdm_frame::Writer w(arr, sizeof(arr));
+
+    w.put<MqttHeader>(FRAME_MARK, OPU_TIME_GET, c.id);
+    w.put<MqttTime>((uint32_t)time(NULL));
+    publish(c, c.pub_topic, arr, w.length(), false, now);
+    c.time_pending.push_back(now);
+    g_stats.time_req++;
+}
+
+static void act_cmd(Client &c, uint64_t now)
+{
+    uint8_t arr[MqttHeader::size + MqttCommand::size];
+    wdm_frame::Writer w(arr, sizeof(arr));
+
+    w.put<MqttHeader>(FRAME_MARK, OPD_COMMAND, c.id);
+    w.put<MqttCommand>(1, c.value ^ 1);
+    publish(c, c.pub_topic, arr, w.length(), false, now);
+    c.cmd_pending.push_back(now);
+    g_stats.cmd++;
+}
+
+static void run_action(const Action &a, uint64_t now)
+{
+    Client &c = g_clients[a.client];
+
+    if (a.act == ACT_CONNECT) {
+        act_connect(a.client);
+        return;
+    }
+    if (c.state != CLIENT_READY) {
+        return;
+    }
+    switch (a.act) {
+    case ACT_STATUS:
+        act_status(c, now);
+        schedule(a.client, a.act, a.at + period_us(g_opt.status_rate));
+        break;
+    case ACT_TIME:
+        act_time(c, now);
+        schedule(a.client, a.act, a.at + period_us(g_opt.time_rate));
+        break;
+    case ACT_CMD:
+        act_cmd(c, now);
+        schedule(a.client, a.act, a.at + period_us(g_opt.cmd_rate));
+        break;
+    case ACT_PING:
+        mqtt_wire::simple(c.tx, MQTT_PINGREQ);
+        schedule(a.client, a.act, a.at + KEEPALIVE_SEC * 1000000ULL / 2);
+        break;
+    }
+    flush_tx(c);
+}
+
+///////////////////////////////////////RX//////////////////////////////////////////////////////////
+static void on_packet(uint32_t i, const mqtt_wire::Packet &pkt, uint64_t now)
+{
+    Client &c = g_clients[i];
+
+    switch (pkt.type) {
+    case MQTT_SUBACK: {
+        // Online: presence, then the scheduled publishing
+        c.state = CLIENT_READY;
+        g_stats.connected++;
+        publish(c, c.pres_topic, (const uint8_t *)"1", 1, true, now);
+        schedule_first(i, ACT_STATUS, g_opt.status_rate, now);
+        schedule_first(i, ACT_TIME, g_opt.time_rate, now);
+        schedule_first(i, ACT_CMD, g_opt.cmd_rate, now);
+        schedule(i, ACT_PING, now + KEEPALIVE_SEC * 1000000ULL / 2);
+    } break;
+
+    case MQTT_PUBACK: {
+        uint32_t pos = 0;
+        uint16_t pid;
+        if (mqtt_wire::get_u16(pkt, pos, &pid) && !c.ack_pending.empty() &&
+            (c.ack_pending.front().first == pid)) {
+            g_lat_period.ack.add(now - c.ack_pending.front().second);
+            c.ack_pending.pop_front();
+        }
+    } break;
+
+    case MQTT_PUBLISH: {
+        mqtt_wire::Publish p;
+        g_stats.rx_msgs++;
+        if (!mqtt_wire::parse_publish(pkt, &p)) {
+            break;
+        }
+        wdm_frame::View<MqttHeader> hdr(p.payload, p.len);
+        if (!hdr.valid() || (hdr.get<MQTT_HDR_MARK>() != FRAME_MARK)) {
+            break;
+        }
+        // Answers come back in order (one connection, one broker loop):
+        uint8_t opcode = hdr.get<MQTT_HDR_OPCODE>();
+        if ((opcode == OPD_TIME) && !c.time_pending.empty()) {
+            g_lat_period.time.add(now - c.time_pending.front());
+            c.time_pending.pop_front();
+        } else if ((opcode == OPD_COMMAND) && !c.cmd_pending.empty()) {
+            g_lat_period.echo.add(now - c.cmd_pending.front());
+            c.cmd_pending.pop_front();
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+static void client_read(uint32_t i)
+{
+    Client &c = g_clients[i];
+    char buf[RX_CHUNK];
+
+    while (true) {
+        ssize_t n = recv(c.fd, buf, sizeof(buf), 0);
+        if (n > 0) {
+            c.rx.append(buf, n);
+            continue;
+        }
+        if ((n < 0) && (errno == EINTR)) {
+            continue;
+        }
+        if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+            break;
+        }
+        client_close(c);
+        return;
+    }
+
+    uint64_t now = now_us();
+    size_t used = 0;
+    while (true) {
+        mqtt_wire::Packet pkt;
+        int n = mqtt_wire::parse((const uint8_t *)c.rx.data() + used, c.rx.size() - used, &pkt);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            client_close(c);
+            return;
+        }
+        on_packet(i, pkt, now);
+        used += n;
+    }
+    c.rx.erase(0, used);
+    flush_tx(c);
+}
+
+///////////////////////////////////////REPORT//////////////////////////////////////////////////////
+static void print_lat(const char *name, const LatHist &h)
+{
+    if (h.count() == 0) {
+        return;
+    }
+    printf(" | %s p50 %.2f p90 %.2f p99 %.2f max %.2f ms", name, h.percentile(50) / 1000.0,
+           h.percentile(90) / 1000.0, h.percentile(99) / 1000.0, h.max() / 1000.0);
+}
+
+static void report(const char *what, double period, const Stats &last, const Lat &lat)
+{
+    printf("%s connected %llu, closed %llu | tx %.0f msg/s, rx %.0f msg/s",
+           what, (unsigned long long)g_stats.connected, (unsigned long long)g_stats.closed,
+           (g_stats.tx_msgs - last.tx_msgs) / period, (g_stats.rx_msgs - last.rx_msgs) / period);
+    print_lat("time", lat.time);
+    print_lat("echo", lat.echo);
+    print_lat("ack", lat.ack);
+    printf("\n");
+    fflush(stdout);
+}
+
+static void merge(Lat &to, Lat &from)
+{
+    to.time.merge(from.time);
+    to.echo.merge(from.echo);
+    to.ack.merge(from.ack);
+    from.time.reset();
+    from.echo.reset();
+    from.ack.reset();
+}
+
+///////////////////////////////////////MAIN////////////////////////////////////////////////////////
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --host IP          broker address (127.0.0.1)\n"
+        "  --port N           broker port (%d)\n"
+        "  --clients N        number of clients (100)\n"
+        "  --duration SEC     run time (10)\n"
+        "  --ramp SEC         connections spread over this time (1)\n"
+        "  --status-rate R    OPU_STATUS per client per second (1)\n"
+        "  --time-rate R      OPU_TIME_GET per client per second (0.1)\n"
+        "  --cmd-rate R       echoed commands per client per second (0.1)\n"
+        "  --qos 0|1          QoS of the publishes (0)\n"
+        "  --id-base N        4th byte of the client ids (128), to run next to wdm_sim\n",
+        name, LOADGEN_PORT_DEFAULT);
+    exit(2);
+}
+
+static void parse_args(int argc, char **argv)
+{
+    g_opt.host = "127.0.0.1";
+    g_opt.port = LOADGEN_PORT_DEFAULT;
+    g_opt.clients = 100;
+    g_opt.duration = 10;
+    g_opt.ramp = 1;
+    g_opt.status_rate = 1;
+    g_opt.time_rate = 0.1;
+    g_opt.cmd_rate = 0.1;
+    g_opt.qos = 0;
+    g_opt.id_base = 128;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--host") == 0) {
+            g_opt.host = v;
+        } else if (strcmp(a, "--port") == 0) {
+            g_opt.port = atoi(v);
+        } else if (strcmp(a, "--clients") == 0) {
+            g_opt.clients = atoi(v);
+        } else if (strcmp(a, "--duration") == 0) {
+            g_opt.duration = atof(v);
+        } else if (strcmp(a, "--ramp") == 0) {
+            g_opt.ramp = atof(v);
+        } else if (strcmp(a, "--status-rate") == 0) {
+            g_opt.status_rate = atof(v);
+        } else if (strcmp(a, "--time-rate") == 0) {
+            g_opt.time_rate = atof(v);
+        } else if (strcmp(a, "--cmd-rate") == 0) {
+            g_opt.cmd_rate = atof(v);
+        } else if (strcmp(a, "--qos") == 0) {
+            g_opt.qos = (atoi(v) != 0);
+        } else if (strcmp(a, "--id-base") == 0) {
+            g_opt.id_base = atoi(v);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (g_opt.clients == 0) {
+        usage(argv[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    parse_args(argc, argv);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    memset(&g_addr, 0, sizeof(g_addr));
+    g_addr.sin_family = AF_INET;
+    g_addr.sin_port = htons(g_opt.port);
+    if (inet_pton(AF_INET, g_opt.host.c_str(), &g_addr.sin_addr) != 1) {
+        usage(argv[0]);
+    }
+    g_epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    // Client ids: the same MAC layout as the nodes, the topics use the reversed hex form
+    uint64_t start = now_us();
+    g_clients.resize(g_opt.clients);
+    for (uint32_t i = 0; i < g_opt.clients; i++) {
+        Client &c = g_clients[i];
+        const uint8_t id[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, g_opt.id_base, (uint8_t)(i >> 8), (uint8_t)i };
+        char hex[16];
+        memcpy(c.id, id, WDM_ID_SZ);
+        snprintf(hex, sizeof(hex), "%02x%02x%02x%02x%02x%02x", id[5], id[4], id[3], id[2], id[1], id[0]);
+        c.pub_topic = std::string("wdm/dev/pub/") + hex;
+        c.sub_topic = std::string("wdm/dev/sub/") + hex;
+        c.pres_topic = std::string("wdm/dev/pres/") + hex;
+        c.fd = -1;
+        c.state = CLIENT_CLOSED;
+        c.value = 0;
+        c.pid = 0;
+        schedule(i, ACT_CONNECT, start + (uint64_t)(g_opt.ramp * 1000000 * i / g_opt.clients));
+    }
+
+    uint64_t end = start + (uint64_t)(g_opt.duration * 1000000);
+    uint64_t next_report = start + 1000000;
+    Stats last = g_stats;
+    struct epoll_event events[EPOLL_BATCH];
+    uint64_t now = now_us();
+    while (!g_stop && (now < end)) {
+        while (!g_actions.empty() && (g_actions.top().at <= now)) {
+            Action a = g_actions.top();
+            g_actions.pop();
+            run_action(a, now);
+        }
+
+        if (now >= next_report) {
+            char what[32];
+            snprintf(what, sizeof(what), "[%6.1fs]", (now - start) / 1e6);
+            report(what, 1.0, last, g_lat_period);
+            merge(g_lat_all, g_lat_period);
+            last = g_stats;
+            next_report += 1000000;
+        }
+
+        uint64_t next = std::min(next_report, end);
+        if (!g_actions.empty()) {
+            next = std::min(next, g_actions.top().at);
+        }
+        int timeout = (next > now) ? (int)((next - now + 999) / 1000) : 0;
+        int n = epoll_wait(g_epfd, events, EPOLL_BATCH, timeout);
+        for (int k = 0; k < n; k++) {
+            uint32_t i = events[k].data.u32;
+            Client &c = g_clients[i];
+            if (c.state == CLIENT_CLOSED) {
+                continue;
+            }
+            if (c.state == CLIENT_CONNECTING) {
+                c.state = CLIENT_HANDSHAKE;
+            }
+            if (events[k].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                client_read(i);
+            } else if (events[k].events & EPOLLOUT) {
+                flush_tx(c);
+            }
+        }
+        now = now_us();
+    }
+
+    merge(g_lat_all, g_lat_period);
+    Stats zero;
+    memset(&zero, 0, sizeof(zero));
+    double elapsed = (now - start) / 1e6;
+    printf("\n==== %u clients, %.1f s: status %llu, time %llu, cmd %llu ====\n", g_opt.clients, elapsed,
+           (unsigned long long)g_stats.status, (unsigned long long)g_stats.time_req,
+           (unsigned long long)g_stats.cmd);
+    report("total:", elapsed, zero, g_lat_all);
+    return 0;
+}
@@ -0,0 +1,260 @@
+/** @brief MQTT 3.1.1 wire format helpers for the host tools (broker, simulator controller):
+ *  packet framing & the few packets they build or parse. QoS 0/1 only.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _MQTT_WIRE_H_
+#define _MQTT_WIRE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/* Packet types (high nibble of the fixed header) */
+#define MQTT_CONNECT            1
+#define MQTT_CONNACK            2
+#define MQTT_PUBLISH            3
+#define MQTT_PUBACK             4
+#define MQTT_SUBSCRIBE          8
+#define MQTT_SUBACK             9
+#define MQTT_UNSUBSCRIBE        10
+#define MQTT_UNSUBACK           11
+#define MQTT_PINGREQ            12
+#define MQTT_PINGRESP           13
+#define MQTT_DISCONNECT         14
+
+/* Largest accepted packet (remaining length) */
+#define MQTT_WIRE_MAX_LEN       (64 * 1024)
+
+namespace mqtt_wire {
+
+struct Packet {
+    uint8_t type;
+    uint8_t flags;
+    const uint8_t *body;
+    uint32_t len;
+};
+
+struct Publish {
+    std::string topic;
+    const uint8_t *payload;
+    uint32_t len;
+    uint8_t qos;
+    bool retain;
+    uint16_t pid;
+};
+
+struct Connect {
+    std::string client_id;
+    uint16_t keepalive;
+    bool will;
+    std::string will_topic;
+    std::string will_payload;
+    bool will_retain;
+    std::string user;
+    std::string password;
+};
+
+/** @brief split one packet from 'buf'.
+    @return bytes used by the packet, 0 if it's not complete, -1 if it's malformed.
+*/
+inline int parse(const uint8_t *buf, size_t n, Packet *pkt)
+{
+    uint32_t len = 0;
+    size_t i = 1;
+
+    for (int shift = 0; ; shift += 7) {
+        if (i >= n) {
+            return 0;
+        }
+        if (shift > 21) {
+            return -1;
+        }
+        uint8_t b = buf[i++];
+        len |= (uint32_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0) {
+            break;
+        }
+    }
+    if (len > MQTT_WIRE_MAX_LEN) {
+        return -1;
+    }
+    if (n < i + len) {
+        return 0;
+    }
+    pkt->type = buf[0] >> 4;
+    pkt->flags = buf[0] & 0x0F;
+    pkt->body = buf + i;
+    pkt->len = len;
+    return (int)(i + len);
+}
+
+inline bool get_u16(const Packet &pkt, uint32_t &pos, uint16_t *v)
+{
+    if (pos + 2 > pkt.len) {
+        return false;
+    }
+    *v = ((uint16_t)pkt.body[pos] << 8) | pkt.body[pos + 1];
+    pos += 2;
+    return true;
+}
+
+inline bool get_str(const Packet &pkt, uint32_t &pos, std::string *s)
+{
+    uint16_t n;
+    if (!get_u16(pkt, pos, &n) || (pos + n > pkt.len)) {
+        return false;
+    }
+    s->assign((const char *)pkt.body + pos, n);
+    pos += n;
+    return true;
+}
+
+inline bool parse_publish(const Packet &pkt, Publish *p)
+{
+    uint32_t pos = 0;
+
+    p->qos = (pkt.flags >> 1) & 3;
+    p->retain = pkt.flags & 1;
+    p->pid = 0;
+    if (!get_str(pkt, pos, &p->topic) || (p->qos > 1)) {
+        return false;
+    }
+    if ((p->qos > 0) && !get_u16(pkt, pos, &p->pid)) {
+        return false;
+    }
+    p->payload = pkt.body + pos;
+    p->len = pkt.len - pos;
+    return true;
+}
+
+inline bool parse_connect(const Packet &pkt, Connect *c)
+{
+    std::string proto;
+    uint32_t pos = 0;
+
+    if (!get_str(pkt, pos, &proto) || (pos + 2 > pkt.len)) {
+        return false;
+    }
+    uint8_t flags = pkt.body[pos + 1];
+    pos += 2;
+    if (!get_u16(pkt, pos, &c->keepalive) || !get_str(pkt, pos, &c->client_id)) {
+        return false;
+    }
+    c->will = flags & 0x04;
+    c->will_retain = flags & 0x20;
+    if (c->will && (!get_str(pkt, pos, &c->will_topic) || !get_str(pkt, pos, &c->will_payload))) {
+        return false;
+    }
+    if (((flags & 0x80) && !get_str(pkt, pos, &c->user)) || ((flags & 0x40) && !get_str(pkt, pos, &c->password))) {
+        return false;
+    }
+    return true;
+}
+
+/** @brief topic filter matching, with the '+' & '#' wildcards.
+*/
+inline bool match(const std::string &filter, const std::string &topic)
+{
+    size_t f = 0;
+    size_t t = 0;
+
+    while (f < filter.size()) {
+        if (filter[f] == '#') {
+            return true;
+        }
+        if (filter[f] == '+') {
+            while ((t < topic.size()) && (topic[t] != '/')) {
+                t++;
+            }
+            f++;
+        } else {
+            if ((t >= topic.size()) || (filter[f] != topic[t])) {
+                return false;
+            }
+            f++;
+            t++;
+        }
+    }
+    return t == topic.size();
+}
+
+inline bool has_wildcard(const std::string &filter)
+{
+    return filter.find_first_of("+#") != std::string::npos;
+}
+
+///////////////////////////////////////PACKET BUILDERS/////////////////////////////////////////////
+inline void put_header(std::string &out, uint8_t type_flags, uint32_t len)
+{
+    out += (char)type_flags;
+    do {
+        uint8_t b = len & 0x7F;
+        len >>= 7;
+        out += (char)(len ? (b | 0x80) : b);
+    } while (len);
+}
+
+inline void put_u16(std::string &out, uint16_t v)
+{
+    out += (char)(v >> 8);
+    out += (char)(v & 0xFF);
+}
+
+inline void put_str(std::string &out, const std::string &s)
+{
+    put_u16(out, s.size());
+    out += s;
+}
+
+inline void connect(std::string &out, const std::string &client_id, uint16_t keepalive)
+{
+    put_header(out, MQTT_CONNECT << 4, 10 + 2 + client_id.size());
+    put_str(out, "MQTT");
+    out += (char)4;         // 3.1.1
+    out += (char)0x02;      // Clean session
+    put_u16(out, keepalive);
+    put_str(out, client_id);
+}
+
+inline void connack(std::string &out, uint8_t rc)
+{
+    put_header(out, MQTT_CONNACK << 4, 2);
+    out += (char)0;
+    out += (char)rc;
+}
+
+inline void subscribe(std::string &out, uint16_t pid, const std::string &filter)
+{
+    put_header(out, (MQTT_SUBSCRIBE << 4) | 0x02, 2 + 2 + filter.size() + 1);
+    put_u16(out, pid);
+    put_str(out, filter);
+    out += (char)0;
+}
+
+inline void ack(std::string &out, uint8_t type, uint16_t pid)
+{
+    put_header(out, (type << 4) | ((type == MQTT_UNSUBSCRIBE) ? 0x02 : 0), 2);
+    put_u16(out, pid);
+}
+
+inline void publish(std::string &out, const std::string &topic, const void *payload, uint32_t len,
+                    bool retain = false, uint8_t qos = 0, uint16_t pid = 0)
+{
+    put_header(out, (MQTT_PUBLISH << 4) | (qos << 1) | (retain ? 1 : 0),
+               2 + topic.size() + (qos ? 2 : 0) + len);
+    put_str(out, topic);
+    if (qos) {
+        put_u16(out, pid);
+    }
+    out.append((const char *)payload, len);
+}
+
+inline void simple(std::string &out, uint8_t type)
+{
+    put_header(out, type << 4, 0);
+}
+
+}
+
+#endif
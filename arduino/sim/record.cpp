@@ -0,0 +1,494 @@
+/**	@brief session recorder: an MQTT proxy between the nodes and the broker which writes the
+ *  session of one node to a trace file (trace_file.h), for wdm_replay.
+ *  - The nodes are pointed to the recorder (settings server/port), which forwards every
+ *    connection to the broker unchanged. The connection of the recorded node (--client, else
+ *    the first one) is split into MQTT packets, each one a record; its reconnections too.
+ *  - --lan: the datagrams of the LAN group (see lan_inf.h) are recorded as well, the ones sent
+ *    from the --node address as the node's own.
+ *  - --udp: a relay for the node link of wdm_th (UDP transport): the node's server is set to the
+ *    recorder, which forwards its datagrams to --server & the replies back to the node.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <string>
+#include <unordered_map>
+#include "mqtt_wire.h"
+#include "trace_file.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define RECORD_PORT_DEFAULT     18831
+#define BROKER_DEFAULT          "127.0.0.1:18830"
+#define EPOLL_BATCH             64
+#define RX_CHUNK                4096
+
+/* LAN group & port (see lan_inf.h) */
+#define LAN_GROUP               "239.255.77.1"
+#define LAN_PORT                7524
+
+/* Server of the node link (see wdm_th.ino) */
+#define SERVER_UDP_PORT         7523
+#define SERVER_DEFAULT          "127.0.0.1:7523"
+
+/* epoll tags of the listening, LAN & UDP relay sockets (connections are tagged with their fd) */
+#define LISTEN_TAG              -1
+#define LAN_TAG                 -2
+#define UDP_NODE_TAG            -3
+#define UDP_SERVER_TAG          -4
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+/* A proxied connection: node side & broker side */
+struct Pair {
+    int node_fd;
+    int broker_fd;
+    bool identified;        // CONNECT seen
+    bool recorded;
+    std::string from_node;  // Bytes not split into packets yet
+    std::string from_broker;
+};
+
+struct Options {
+    int port;
+    std::string broker;
+    std::string client;
+    std::string out;
+    bool lan;
+    in_addr_t node_ip;
+    int udp_port;
+    std::string server;
+    double duration;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static Options g_opt;
+static int g_epfd;
+static std::unordered_map<int, Pair *> g_pairs;     // By fd, both sides
+static Pair *g_rec;                                 // Connection of the recorded node
+static trace_file::Writer g_trace;
+static uint64_t g_start;
+static uint64_t g_bytes;
+static volatile sig_atomic_t g_stop;
+
+/* UDP relay: node side, server side, & the node address (from its last datagram) */
+static int g_udp_node_fd = -1;
+static int g_udp_server_fd = -1;
+static struct sockaddr_in g_udp_node;
+static bool g_udp_node_known;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void record(uint8_t type, const void *data, size_t len)
+{
+    g_trace.add(type, now_us(), data, len);
+    g_bytes += len;
+}
+
+static bool send_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(fd, buf, len, MSG_NOSIGNAL);
+        if (n > 0) {
+            buf += n;
+            len -= n;
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static struct sockaddr_in parse_addr(const std::string &s, int default_port)
+{
+    struct sockaddr_in addr;
+    size_t colon = s.find(':');
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((colon == std::string::npos) ? default_port : atoi(s.c_str() + colon + 1));
+    inet_pton(AF_INET, s.substr(0, colon).c_str(), &addr.sin_addr);
+    return addr;
+}
+
+static int connect_broker()
+{
+    struct sockaddr_in addr = parse_addr(g_opt.broker, 1883);
+    int one = 1;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+static void watch(int fd, int tag)
+{
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = (uint64_t)(int64_t)tag;
+    epoll_ctl(g_epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static void pair_close(Pair *p, bool by_node)
+{
+    if (p == g_rec) {
+        record(by_node ? TRACE_MQTT_CLOSE_TX : TRACE_MQTT_CLOSE_RX, NULL, 0);
+        fprintf(stderr, "wdm_record: %s closed the connection\n", by_node ? "node" : "broker");
+        g_rec = NULL;
+    }
+    g_pairs.erase(p->node_fd);
+    g_pairs.erase(p->broker_fd);
+    close(p->node_fd);
+    close(p->broker_fd);
+    delete p;
+}
+
+/** @brief split the new bytes into packets, record the ones of the recorded node.
+    @return false if the stream isn't MQTT.
+*/
+static bool split(Pair *p, bool from_node)
+{
+    std::string &buf = from_node ? p->from_node : p->from_broker;
+    size_t used = 0;
+
+    while (true) {
+        mqtt_wire::Packet pkt;
+        int n = mqtt_wire::parse((const uint8_t *)buf.data() + used, buf.size() - used, &pkt);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        if (from_node && !p->identified) {
+            mqtt_wire::Connect c;
+            p->identified = true;
+            if ((pkt.type == MQTT_CONNECT) && mqtt_wire::parse_connect(pkt, &c)) {
+                fprintf(stderr, "wdm_record: %s connected\n", c.client_id.c_str());
+            }
+            if ((pkt.type == MQTT_CONNECT) && mqtt_wire::parse_connect(pkt, &c) && (g_rec == NULL) &&
+                (g_opt.client.empty() || (c.client_id == g_opt.client))) {
+                // The first node recorded is the one followed across its reconnections:
+                g_opt.client = c.client_id;
+                p->recorded = true;
+                g_rec = p;
+                fprintf(stderr, "wdm_record: recording %s\n", c.client_id.c_str());
+            }
+        }
+        if (p->recorded) {
+            record(from_node ? TRACE_MQTT_TX : TRACE_MQTT_RX, buf.data() + used, n);
+        }
+        used += n;
+    }
+    buf.erase(0, used);
+    return true;
+}
+
+static void accept_all(int lfd)
+{
+    int one = 1;
+
+    while (true) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        int bfd = connect_broker();
+        if (bfd < 0) {
+            fprintf(stderr, "wdm_record: can't connect to the broker %s\n", g_opt.broker.c_str());
+            close(fd);
+            continue;
+        }
+        Pair *p = new Pair();
+        p->node_fd = fd;
+        p->broker_fd = bfd;
+        p->identified = false;
+        p->recorded = false;
+        g_pairs[fd] = p;
+        g_pairs[bfd] = p;
+        watch(fd, fd);
+        watch(bfd, bfd);
+    }
+}
+
+static void forward(int fd)
+{
+    char buf[RX_CHUNK];
+    std::unordered_map<int, Pair *>::iterator it = g_pairs.find(fd);
+    if (it == g_pairs.end()) {
+        return;
+    }
+    Pair *p = it->second;
+    bool from_node = (fd == p->node_fd);
+
+    ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if ((n < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))) {
+        return;
+    }
+    if (n <= 0) {
+        pair_close(p, from_node);
+        return;
+    }
+    if (!send_all(from_node ? p->broker_fd : p->node_fd, buf, n)) {
+        pair_close(p, !from_node);
+        return;
+    }
+    (from_node ? p->from_node : p->from_broker).append(buf, n);
+    if (!split(p, from_node)) {
+        fprintf(stderr, "wdm_record: not an MQTT stream\n");
+        pair_close(p, from_node);
+    }
+}
+
+static int lan_open()
+{
+    struct sockaddr_in addr;
+    struct ip_mreq mreq;
+    int one = 1;
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(LAN_PORT);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    inet_pton(AF_INET, LAN_GROUP, &mreq.imr_multiaddr);
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if ((bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0)) {
+        perror("wdm_record: LAN group");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void lan_read(int fd)
+{
+    uint8_t buf[2048];
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+
+    ssize_t n = recvfrom(fd, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+    if (n > 0) {
+        record((from.sin_addr.s_addr == g_opt.node_ip) ? TRACE_LAN_TX : TRACE_LAN_RX, buf, n);
+    }
+}
+
+static bool udp_open()
+{
+    struct sockaddr_in addr;
+    int one = 1;
+
+    g_udp_node_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    setsockopt(g_udp_node_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(g_opt.udp_port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(g_udp_node_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("wdm_record: UDP relay");
+        return false;
+    }
+
+    // The server side is connected: only the server replies are read on it
+    addr = parse_addr(g_opt.server, SERVER_UDP_PORT);
+    g_udp_server_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (connect(g_udp_server_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("wdm_record: UDP server");
+        return false;
+    }
+    return true;
+}
+
+/** @brief relay one datagram: node -> server (TX), server -> node (RX).
+*/
+static void udp_relay(bool from_node)
+{
+    uint8_t buf[2048];
+    struct sockaddr_in from;
+    socklen_t from_len = sizeof(from);
+
+    if (from_node) {
+        ssize_t n = recvfrom(g_udp_node_fd, buf, sizeof(buf), MSG_DONTWAIT, (struct sockaddr *)&from, &from_len);
+        if (n <= 0) {
+            return;
+        }
+        if ((g_opt.node_ip != INADDR_NONE) && (from.sin_addr.s_addr != g_opt.node_ip)) {
+            return;
+        }
+        g_udp_node = from;
+        g_udp_node_known = true;
+        record(TRACE_UDP_TX, buf, n);
+        send(g_udp_server_fd, buf, n, 0);
+    } else {
+        ssize_t n = recv(g_udp_server_fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if ((n <= 0) || !g_udp_node_known) {
+            return;
+        }
+        record(TRACE_UDP_RX, buf, n);
+        sendto(g_udp_node_fd, buf, n, 0, (struct sockaddr *)&g_udp_node, sizeof(g_udp_node));
+    }
+}
+
+static void on_signal(int)
+{
+    g_stop = 1;
+}
+
+///////////////////////////////////////MAIN////////////////////////////////////////////////////////
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options] --out TRACE\n"
+        "  --port N          port the nodes connect to (%d)\n"
+        "  --broker IP:PORT  broker the connections are forwarded to (%s)\n"
+        "  --client ID       MQTT client id of the node to record (the first one to connect)\n"
+        "  --lan             record the LAN group datagrams too\n"
+        "  --node IP         address of the node on the LAN: its datagrams are its own (TX)\n"
+        "  --udp PORT        relay & record the node link (wdm_th UDP transport) on PORT\n"
+        "  --server IP:PORT  server the node link datagrams are relayed to (%s)\n"
+        "  --duration SEC    stop after SEC seconds (SIGINT otherwise)\n",
+        name, RECORD_PORT_DEFAULT, BROKER_DEFAULT, SERVER_DEFAULT);
+    exit(2);
+}
+
+static void parse_args(int argc, char **argv)
+{
+    g_opt.port = RECORD_PORT_DEFAULT;
+    g_opt.broker = BROKER_DEFAULT;
+    g_opt.lan = false;
+    g_opt.node_ip = INADDR_NONE;
+    g_opt.udp_port = 0;
+    g_opt.server = SERVER_DEFAULT;
+    g_opt.duration = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strcmp(a, "--lan") == 0) {
+            g_opt.lan = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--port") == 0) {
+            g_opt.port = atoi(v);
+        } else if (strcmp(a, "--broker") == 0) {
+            g_opt.broker = v;
+        } else if (strcmp(a, "--client") == 0) {
+            g_opt.client = v;
+        } else if (strcmp(a, "--node") == 0) {
+            g_opt.node_ip = inet_addr(v);
+        } else if (strcmp(a, "--udp") == 0) {
+            g_opt.udp_port = atoi(v);
+        } else if (strcmp(a, "--server") == 0) {
+            g_opt.server = v;
+        } else if (strcmp(a, "--out") == 0) {
+            g_opt.out = v;
+        } else if (strcmp(a, "--duration") == 0) {
+            g_opt.duration = atof(v);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (g_opt.out.empty()) {
+        usage(argv[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int one = 1;
+
+    parse_args(argc, argv);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    int lfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(g_opt.port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if ((bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0) || (listen(lfd, 64) != 0)) {
+        perror("wdm_record: bind/listen");
+        return 1;
+    }
+
+    g_start = now_us();
+    if (!g_trace.open(g_opt.out.c_str(), g_start)) {
+        perror(g_opt.out.c_str());
+        return 1;
+    }
+    g_epfd = epoll_create1(EPOLL_CLOEXEC);
+    watch(lfd, LISTEN_TAG);
+    int ufd = -1;
+    if (g_opt.lan) {
+        ufd = lan_open();
+        if (ufd < 0) {
+            return 1;
+        }
+        watch(ufd, LAN_TAG);
+    }
+    if (g_opt.udp_port != 0) {
+        if (!udp_open()) {
+            return 1;
+        }
+        watch(g_udp_node_fd, UDP_NODE_TAG);
+        watch(g_udp_server_fd, UDP_SERVER_TAG);
+        fprintf(stderr, "wdm_record: node link port %d -> server %s\n", g_opt.udp_port, g_opt.server.c_str());
+    }
+    fprintf(stderr, "wdm_record: port %d -> broker %s, trace %s\n", g_opt.port,
+            g_opt.broker.c_str(), g_opt.out.c_str());
+
+    uint64_t end = (g_opt.duration > 0) ? g_start + (uint64_t)(g_opt.duration * 1000000) : 0;
+    struct epoll_event events[EPOLL_BATCH];
+    while (!g_stop && ((end == 0) || (now_us() < end))) {
+        int n = epoll_wait(g_epfd, events, EPOLL_BATCH, 100);
+        for (int i = 0; i < n; i++) {
+            int tag = (int)(int64_t)events[i].data.u64;
+            if (tag == LISTEN_TAG) {
+                accept_all(lfd);
+            } else if (tag == LAN_TAG) {
+                lan_read(ufd);
+            } else if ((tag == UDP_NODE_TAG) || (tag == UDP_SERVER_TAG)) {
+                udp_relay(tag == UDP_NODE_TAG);
+            } else {
+                forward(tag);
+            }
+        }
+        g_trace.flush();
+    }
+
+    g_trace.close();
+    fprintf(stderr, "wdm_record: %llu records, %llu bytes in %.1f s\n",
+            (unsigned long long)g_trace.count(), (unsigned long long)g_bytes,
+            (now_us() - g_start) / 1e6);
+    return 0;
+}
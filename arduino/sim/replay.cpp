@@ -0,0 +1,897 @@
+/**	@brief session replayer: runs one wdm_onoff node (the node image of wdm_sim) on a recorded
+ *  session (trace_file.h, see wdm_record) at full speed, and reports the CPU time & the heap
+ *  allocations of the node for each message it receives, so changes of PubSubClient, mqtt_inf or
+ *  lan_inf can be compared on real traffic.
+ *  - The replayer is the network of the node (SIM_NET_t): the MQTT connection & the LAN.
+ *  - Time is virtual: when the node waits, the clock jumps to the next record or to the end of
+ *    the wait. A record is delivered when it is due and the node waits; MQTT records wait for
+ *    the node to be connected.
+ *  - One record is delivered per wait: the node run which follows, until it waits again, is the
+ *    cost of that message (PubSubClient, the sketch callbacks & the rest of that loop()). The
+ *    runs without a message are the "loop" row, the first one (setup()) the "boot" row.
+ *  - The packets the node sends are counted per kind, next to the recorded ones.
+ *  - --link: the node link of wdm_th (node_link, UDP transport) is replayed instead, built into
+ *    the replayer (link_drv.h): each recorded STATUS is sent again, the recorded replies are
+ *    delivered within the ACK wait of the transport, the ACK moved to the new sequence.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <dlfcn.h>
+#include <link.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+#include <wdm_proto.h>
+#include <wdm_siphash.h>
+#include "lat_hist.h"
+#include "link_drv.h"
+#include "mqtt_wire.h"
+#include "trace_file.h"
+#include "core/sim_host.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Stack of the node coroutine */
+#define NODE_STACK_SZ           (64 * 1024)
+
+/* Virtual time of the node boot (us) */
+#define REPLAY_BOOT_US          1000000
+
+/* Time a wait without deadline (yield()) takes (us) */
+#define REPLAY_YIELD_US         100
+
+/* An MQTT record held longer than this, the node not being connected, is dropped (us) */
+#define REPLAY_HOLD_US          60000000
+
+/* wdm frame (see mqtt_inf.cpp) */
+#define FRAME_MARK              0x01
+
+/* ACK opcode of the node link server (see node_link.cpp) */
+#define LINK_OP_ACK             0x02
+
+using namespace wdm_proto;
+using trace_file::Record;
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+/* Cost of one kind of node run */
+struct RunStats {
+    uint64_t count;
+    uint64_t cpu_ns;
+    uint64_t allocs;
+    uint64_t alloc_bytes;
+    LatHist hist;           // CPU ns per run
+};
+
+/* Packets of one kind sent by the node */
+struct TxCount {
+    uint64_t recorded;
+    uint64_t replayed;
+};
+
+struct Options {
+    std::string trace;
+    std::string lib;
+    std::string csv;
+    uint32_t repeat;
+    uint8_t mac[6];
+    bool mac_set;
+    std::string security;
+    bool serial;
+    bool link;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static Options g_opt;
+static std::vector<Record> g_records;
+
+/* Node image & coroutine */
+static sim_node_run_t g_node_run;
+static uint8_t *g_seg;
+static size_t g_seg_sz;
+static uint8_t *g_pristine;
+static uint8_t *g_stack;
+static ucontext_t g_node_ctx;
+static ucontext_t g_main_ctx;
+static SIM_NODE_CFG_t g_cfg;
+static const char *g_halt_reason;
+
+/* Replay state */
+static uint64_t g_now;
+static size_t g_next;               // Next record
+static bool g_anchored;
+static int64_t g_offset;            // Virtual time - trace time
+static bool g_tcp_open;
+static bool g_tcp_eof;
+static std::string g_tcp_rx;
+static size_t g_tcp_rx_pos;
+static std::deque<std::string> g_lan_rx;
+
+/* Node link replay: the recorded STATUS being replayed & its replies */
+static wdm_siphash::Key g_key;
+static uint8_t g_link_id[WDM_ID_SZ];
+static uint64_t g_link_t0;          // Trace time of the STATUS
+static uint32_t g_link_seq;         // Its recorded sequence
+static size_t g_link_rx;            // Next reply
+static size_t g_link_end;           // Next STATUS
+static uint32_t g_link_waited;      // ms, since the STATUS
+
+/* What the node sent during the current run */
+static std::string g_tcp_tx;
+static std::vector<std::string> g_lan_tx;
+static std::vector<std::string> g_udp_tx;
+
+/* Report */
+static std::map<std::string, RunStats> g_rx_stats;
+static std::map<std::string, TxCount> g_tx_counts;
+static RunStats g_loop;
+static RunStats g_boot;
+static uint64_t g_opens;
+static uint64_t g_closes;
+static uint64_t g_dropped;
+static uint64_t g_link_acked;
+static uint64_t g_link_acked_rec;
+
+/* Current run */
+static RunStats *g_run;
+static uint64_t g_run_t0;
+static bool g_counting;
+static uint64_t g_allocs;
+static uint64_t g_alloc_bytes;
+
+///////////////////////////////////////HEAP ACCOUNTING/////////////////////////////////////////////
+/* malloc() & co are interposed: the allocations of the node runs are counted */
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *p, size_t size);
+}
+
+static inline void heap_count(size_t size)
+{
+    if (g_counting) {
+        g_allocs++;
+        g_alloc_bytes += size;
+    }
+}
+
+extern "C" void *malloc(size_t size)
+{
+    heap_count(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    heap_count(n * size);
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size)
+{
+    heap_count(size);
+    return __libc_realloc(p, size);
+}
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static uint64_t cpu_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t wall_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static std::string opcode_str(uint8_t op)
+{
+    char buf[8];
+    snprintf(buf, sizeof(buf), ((op >= 0x20) && (op < 0x7F)) ? "'%c'" : "0x%02X", op);
+    return buf;
+}
+
+/** @brief kind of an MQTT packet: its type, & the wdm opcode of a PUBLISH.
+*/
+static std::string mqtt_kind(const uint8_t *data, size_t len)
+{
+    static const char *NAMES[16] = { "0", "CONNECT", "CONNACK", "PUBLISH", "PUBACK", "PUBREC",
+        "PUBREL", "PUBCOMP", "SUBSCRIBE", "SUBACK", "UNSUBSCRIBE", "UNSUBACK", "PINGREQ",
+        "PINGRESP", "DISCONNECT", "15" };
+    mqtt_wire::Packet pkt;
+    mqtt_wire::Publish p;
+
+    if (mqtt_wire::parse(data, len, &pkt) <= 0) {
+        return "mqtt ?";
+    }
+    std::string kind = std::string("mqtt ") + NAMES[pkt.type];
+    if ((pkt.type == MQTT_PUBLISH) && mqtt_wire::parse_publish(pkt, &p) && (p.len >= 2)) {
+        kind += (p.payload[0] == FRAME_MARK) ? " " + opcode_str(p.payload[1]) : " link";
+    }
+    return kind;
+}
+
+/** @brief kind of a datagram of the LAN or of the node link: its opcode.
+*/
+static std::string udp_kind(const char *medium, const uint8_t *data, size_t len)
+{
+    wdm_frame::View<UdpHeader> hdr(data, len);
+    return std::string(medium) + (hdr.valid() ? " " + opcode_str(hdr.get<UDP_HDR_OPCODE>()) : " ?");
+}
+
+static std::string record_kind(const Record &r)
+{
+    const uint8_t *data = (const uint8_t *)r.data.data();
+    switch (r.type) {
+    case TRACE_MQTT_RX:
+    case TRACE_MQTT_TX:
+        return mqtt_kind(data, r.data.size());
+    case TRACE_LAN_RX:
+    case TRACE_LAN_TX:
+        return udp_kind("lan", data, r.data.size());
+    case TRACE_UDP_RX:
+    case TRACE_UDP_TX:
+        return udp_kind("udp", data, r.data.size());
+    default:
+        return "mqtt close";
+    }
+}
+
+///////////////////////////////////////NODE RUNS///////////////////////////////////////////////////
+static void run_begin(RunStats *s)
+{
+    g_run = s;
+    g_allocs = 0;
+    g_alloc_bytes = 0;
+    g_counting = true;
+    g_run_t0 = cpu_ns();
+}
+
+/** @brief account the run which ends & count what the node sent during it.
+*/
+static void run_end()
+{
+    uint64_t t = cpu_ns() - g_run_t0;
+    g_counting = false;
+    if (g_run == NULL) {
+        return;
+    }
+    g_run->count++;
+    g_run->cpu_ns += t;
+    g_run->allocs += g_allocs;
+    g_run->alloc_bytes += g_alloc_bytes;
+    g_run->hist.add((t > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)t);
+    g_run = NULL;
+
+    size_t used = 0;
+    while (true) {
+        mqtt_wire::Packet pkt;
+        int n = mqtt_wire::parse((const uint8_t *)g_tcp_tx.data() + used, g_tcp_tx.size() - used, &pkt);
+        if (n <= 0) {
+            break;
+        }
+        g_tx_counts[mqtt_kind((const uint8_t *)g_tcp_tx.data() + used, n)].replayed++;
+        used += n;
+    }
+    g_tcp_tx.erase(0, used);
+    for (size_t i = 0; i < g_lan_tx.size(); i++) {
+        g_tx_counts[udp_kind("lan", (const uint8_t *)g_lan_tx[i].data(), g_lan_tx[i].size())].replayed++;
+    }
+    g_lan_tx.clear();
+    for (size_t i = 0; i < g_udp_tx.size(); i++) {
+        g_tx_counts[udp_kind("udp", (const uint8_t *)g_udp_tx[i].data(), g_udp_tx[i].size())].replayed++;
+    }
+    g_udp_tx.clear();
+}
+
+static void deliver(const Record &r)
+{
+    switch (r.type) {
+    case TRACE_MQTT_RX:
+        g_tcp_rx.append(r.data);
+        break;
+    case TRACE_MQTT_CLOSE_RX:
+        g_tcp_eof = true;
+        break;
+    case TRACE_LAN_RX:
+        g_lan_rx.push_back(r.data);
+        break;
+    }
+}
+
+///////////////////////////////////////HOST SERVICES///////////////////////////////////////////////
+static uint64_t host_now_us()
+{
+    return g_now;
+}
+
+/** @brief the node waits: deliver the next record if it's due by 'deadline_us', else move the
+ *  clock to the deadline. The trace is over: back to main().
+*/
+static void host_wait(int fd, uint32_t events, uint64_t deadline_us)
+{
+    run_end();
+    if (deadline_us <= g_now) {
+        deadline_us = g_now + REPLAY_YIELD_US;
+    }
+
+    while (g_next < g_records.size()) {
+        const Record &r = g_records[g_next];
+        if (!trace_file::is_rx(r.type) || (r.type == TRACE_UDP_RX)) {
+            g_next++;
+            continue;
+        }
+        if (!g_anchored) {
+            g_offset = (int64_t)g_now - (int64_t)r.t_us;
+            g_anchored = true;
+        }
+        uint64_t due = r.t_us + g_offset;
+        if (due > deadline_us) {
+            break;
+        }
+        if ((r.type != TRACE_LAN_RX) && !g_tcp_open) {
+            if (g_now < due + REPLAY_HOLD_US) {
+                break;
+            }
+            g_dropped++;
+            g_next++;
+            continue;
+        }
+        g_now = std::max(g_now, due);
+        deliver(r);
+        g_next++;
+        run_begin(&g_rx_stats[record_kind(r)]);
+        return;
+    }
+
+    if (g_next >= g_records.size()) {
+        swapcontext(&g_node_ctx, &g_main_ctx);
+    }
+    g_now = std::max(g_now, deadline_us);
+    run_begin(&g_loop);
+}
+
+static void host_halt(const char *reason)
+{
+    run_end();
+    g_halt_reason = reason;
+    swapcontext(&g_node_ctx, &g_main_ctx);
+}
+
+static void host_trace(const char *buf, uint32_t len)
+{
+    if (g_opt.serial) {
+        fwrite(buf, 1, len, stderr);
+    }
+}
+
+static bool net_tcp_open()
+{
+    g_tcp_open = true;
+    g_tcp_eof = false;
+    g_tcp_rx.clear();
+    g_tcp_rx_pos = 0;
+    g_opens++;
+    return true;
+}
+
+static int32_t net_tcp_recv(uint8_t *buf, uint32_t size)
+{
+    size_t n = g_tcp_rx.size() - g_tcp_rx_pos;
+    if (n == 0) {
+        return g_tcp_eof ? -1 : 0;
+    }
+    if (n > size) {
+        n = size;
+    }
+    memcpy(buf, g_tcp_rx.data() + g_tcp_rx_pos, n);
+    g_tcp_rx_pos += n;
+    if (g_tcp_rx_pos == g_tcp_rx.size()) {
+        g_tcp_rx.clear();
+        g_tcp_rx_pos = 0;
+    }
+    return n;
+}
+
+/* The host buffers are not counted as node allocations */
+static void net_tcp_send(const uint8_t *buf, uint32_t len)
+{
+    bool counting = g_counting;
+    g_counting = false;
+    g_tcp_tx.append((const char *)buf, len);
+    g_counting = counting;
+}
+
+static void net_tcp_close()
+{
+    g_tcp_open = false;
+    g_closes++;
+}
+
+static int32_t net_udp_recv(uint8_t *buf, uint32_t size)
+{
+    if (g_lan_rx.empty()) {
+        return 0;
+    }
+    bool counting = g_counting;
+    g_counting = false;
+    size_t n = std::min<size_t>(g_lan_rx.front().size(), size);
+    memcpy(buf, g_lan_rx.front().data(), n);
+    g_lan_rx.pop_front();
+    g_counting = counting;
+    return n;
+}
+
+static void net_udp_send(const uint8_t *buf, uint32_t len)
+{
+    bool counting = g_counting;
+    g_counting = false;
+    g_lan_tx.push_back(std::string((const char *)buf, len));
+    g_counting = counting;
+}
+
+static const SIM_NET_t g_net = { net_tcp_open, net_tcp_recv, net_tcp_send, net_tcp_close,
+                                 net_udp_recv, net_udp_send };
+static const SIM_HOST_t g_host = { host_now_us, host_wait, host_halt, host_trace, &g_net };
+
+static void node_main()
+{
+    g_node_run(&g_cfg);
+    host_halt("returned");
+}
+
+///////////////////////////////////////NODE LINK///////////////////////////////////////////////////
+/* The host buffers are not counted as node allocations */
+static void link_send(const uint8_t *frame, size_t len)
+{
+    bool counting = g_counting;
+    g_counting = false;
+    g_udp_tx.push_back(std::string((const char *)frame, len));
+    g_counting = counting;
+}
+
+/** @brief a recorded reply as the server would send it to the replayed node: the ACK of the
+ *  recorded STATUS acknowledges the new sequence, & is signed again if it was signed.
+*/
+static size_t link_reply(const std::string &rec, uint8_t *buf, size_t size)
+{
+    const uint8_t *data = (const uint8_t *)rec.data();
+    size_t len = rec.size();
+
+    wdm_frame::View<UdpHeader> hdr(data, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    wdm_frame::View<UdpAck> ack(hdr.tail(), hdr.valid() ? hdr.tail_len() : 0);
+    if (ack.valid() && (hdr.get<UDP_HDR_OPCODE>() == LINK_OP_ACK) && (ack.get<UDP_ACK_SEQ>() == g_link_seq) &&
+        wdm_siphash::verify(g_key, data, len - UDP_FCS_SZ, &data[len - UDP_FCS_SZ])) {
+        wdm_frame::Writer w(buf, size);
+        w.put<UdpHeader>(hdr.get<UDP_HDR_MARKER>(), hdr.get<UDP_HDR_SEQ>(), hdr.get<UDP_HDR_ID>(),
+                         hdr.get<UDP_HDR_OPCODE>());
+        w.put<UdpAck>(link_drv::seq(), ack.get<UDP_ACK_OP>());
+        size_t n = w.length();
+        uint8_t *fcs = w.reserve(UDP_FCS_SZ);
+        if (w.ok()) {
+            wdm_siphash::sign(g_key, buf, n, fcs);
+            return w.length();
+        }
+    }
+    if (len > size) {
+        return 0;
+    }
+    memcpy(buf, data, len);
+    return len;
+}
+
+/** @brief the node waits for a reply: the next recorded one, if it came within the wait.
+*/
+static int link_recv(uint8_t *buf, size_t size, uint32_t timeout_ms, uint32_t *waited_ms)
+{
+    bool counting = g_counting;
+    g_counting = false;
+    int ret = 0;
+    *waited_ms = timeout_ms;
+
+    while (g_link_rx < g_link_end) {
+        const Record &r = g_records[g_link_rx];
+        if (r.type != TRACE_UDP_RX) {
+            g_link_rx++;
+            continue;
+        }
+        uint32_t due = (uint32_t)((r.t_us - g_link_t0) / 1000);
+        if (due > g_link_waited + timeout_ms) {
+            break;
+        }
+        *waited_ms = (due > g_link_waited) ? due - g_link_waited : 0;
+        g_link_rx++;
+        if (r.data.size() > size) {
+            ret = -1;
+        } else {
+            ret = (int)link_reply(r.data, buf, size);
+        }
+        break;
+    }
+    g_link_waited += *waited_ms;
+    g_counting = counting;
+    return ret;
+}
+
+static const LINK_TRACE_t g_link_trace = { link_send, link_recv };
+
+/** @brief was the recorded STATUS at 'idx' ACKed in time, in the trace?
+*/
+static bool link_acked_rec(size_t idx, size_t end, uint32_t seq)
+{
+    for (size_t i = idx + 1; i < end; i++) {
+        const Record &r = g_records[i];
+        if ((r.type != TRACE_UDP_RX) || ((r.t_us - g_records[idx].t_us) / 1000 > link_drv::ack_ms())) {
+            continue;
+        }
+        wdm_frame::View<UdpHeader> hdr((const uint8_t *)r.data.data(), r.data.size());
+        wdm_frame::View<UdpAck> ack(hdr.tail(), hdr.valid() ? hdr.tail_len() : 0);
+        if (ack.valid() && (hdr.get<UDP_HDR_OPCODE>() == LINK_OP_ACK) && (ack.get<UDP_ACK_SEQ>() == seq)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief replay the node link once, on a freshly booted node: each recorded STATUS is one run.
+*/
+static void link_pass()
+{
+    g_udp_tx.clear();
+    run_begin(&g_boot);
+    link_drv::boot(&g_link_trace, g_link_id, g_opt.security.c_str());
+    run_end();
+
+    for (size_t i = 0; i < g_records.size(); i++) {
+        const Record &r = g_records[i];
+        if (r.type != TRACE_UDP_TX) {
+            continue;
+        }
+        wdm_frame::View<UdpHeader> hdr((const uint8_t *)r.data.data(), r.data.size());
+        if (!hdr.valid()) {
+            continue;
+        }
+        g_link_end = i + 1;
+        while ((g_link_end < g_records.size()) && (g_records[g_link_end].type != TRACE_UDP_TX)) {
+            g_link_end++;
+        }
+        g_link_t0 = r.t_us;
+        g_link_seq = hdr.get<UDP_HDR_SEQ>();
+        g_link_rx = i + 1;
+        g_link_waited = 0;
+
+        run_begin(&g_rx_stats[record_kind(r)]);
+        bool acked = link_drv::send_STATUS((const uint8_t *)r.data.data(), r.data.size());
+        run_end();
+        g_link_acked += acked;
+        g_link_acked_rec += link_acked_rec(i, g_link_end, g_link_seq);
+    }
+}
+
+///////////////////////////////////////NODE IMAGE//////////////////////////////////////////////////
+static int find_segment(struct dl_phdr_info *info, size_t, void *arg)
+{
+    struct link_map *lm = (struct link_map *)arg;
+
+    if (info->dlpi_addr != lm->l_addr) {
+        return 0;
+    }
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        if ((ph->p_type == PT_LOAD) && (ph->p_flags & PF_W)) {
+            g_seg = (uint8_t *)(info->dlpi_addr + ph->p_vaddr);
+            g_seg_sz = ph->p_memsz;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static bool load_image(const char *path)
+{
+    void *h = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (h == NULL) {
+        fprintf(stderr, "dlopen: %s\n", dlerror());
+        return false;
+    }
+    sim_node_attach_t attach = (sim_node_attach_t)dlsym(h, "sim_node_attach");
+    g_node_run = (sim_node_run_t)dlsym(h, "sim_node_run");
+    struct link_map *lm = NULL;
+    if ((attach == NULL) || (g_node_run == NULL) || (dlinfo(h, RTLD_DI_LINKMAP, &lm) != 0)) {
+        fprintf(stderr, "%s: not a node image\n", path);
+        return false;
+    }
+    attach(&g_host);
+
+    dl_iterate_phdr(find_segment, lm);
+    if (g_seg == NULL) {
+        fprintf(stderr, "%s: no data segment\n", path);
+        return false;
+    }
+    g_pristine = (uint8_t *)malloc(g_seg_sz);
+    memcpy(g_pristine, g_seg, g_seg_sz);
+    g_stack = (uint8_t *)mmap(NULL, NODE_STACK_SZ + 4096, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    mprotect(g_stack, 4096, PROT_NONE);
+    return true;
+}
+
+/** @brief replay the whole trace once, on a freshly booted node.
+*/
+static void replay_pass()
+{
+    memcpy(g_seg, g_pristine, g_seg_sz);
+    g_now = REPLAY_BOOT_US;
+    g_next = 0;
+    g_anchored = false;
+    g_tcp_open = false;
+    g_tcp_eof = false;
+    g_tcp_rx.clear();
+    g_tcp_rx_pos = 0;
+    g_tcp_tx.clear();
+    g_lan_rx.clear();
+    g_lan_tx.clear();
+    g_halt_reason = NULL;
+
+    getcontext(&g_node_ctx);
+    g_node_ctx.uc_stack.ss_sp = g_stack + 4096;
+    g_node_ctx.uc_stack.ss_size = NODE_STACK_SZ;
+    g_node_ctx.uc_link = NULL;
+    makecontext(&g_node_ctx, node_main, 0);
+
+    run_begin(&g_boot);
+    swapcontext(&g_main_ctx, &g_node_ctx);
+    run_end();
+}
+
+/** @brief node identity from the recorded CONNECT: client "wdm-<id>" (MAC, last byte first),
+ *  password = security. The node link id is the one of the first recorded packet of the node.
+*/
+static void identify()
+{
+    for (size_t i = 0; i < g_records.size(); i++) {
+        const Record &r = g_records[i];
+        wdm_frame::View<UdpHeader> hdr((const uint8_t *)r.data.data(), r.data.size());
+        if ((r.type == TRACE_UDP_TX) && hdr.valid()) {
+            memcpy(g_link_id, hdr.get<UDP_HDR_ID>(), WDM_ID_SZ);
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < g_records.size(); i++) {
+        const Record &r = g_records[i];
+        mqtt_wire::Packet pkt;
+        mqtt_wire::Connect c;
+        if ((r.type != TRACE_MQTT_TX) ||
+            (mqtt_wire::parse((const uint8_t *)r.data.data(), r.data.size(), &pkt) <= 0) ||
+            (pkt.type != MQTT_CONNECT) || !mqtt_wire::parse_connect(pkt, &c)) {
+            continue;
+        }
+        unsigned int m[6];
+        if (!g_opt.mac_set && (sscanf(c.client_id.c_str(), "wdm-%2x%2x%2x%2x%2x%2x",
+                                      &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) == 6)) {
+            for (int k = 0; k < 6; k++) {
+                g_opt.mac[k] = m[5 - k];
+            }
+            g_opt.mac_set = true;
+        }
+        if (g_opt.security.empty()) {
+            g_opt.security = c.password;
+        }
+        return;
+    }
+}
+
+///////////////////////////////////////REPORT//////////////////////////////////////////////////////
+static void print_row(FILE *csv, const std::string &name, const RunStats &s)
+{
+    if (s.count == 0) {
+        return;
+    }
+    printf("  %-22s %8llu %10.0f %10u %10u %8.2f %9.0f\n", name.c_str(), (unsigned long long)s.count,
+           (double)s.cpu_ns / s.count, s.hist.percentile(50), s.hist.percentile(99),
+           (double)s.allocs / s.count, (double)s.alloc_bytes / s.count);
+    if (csv != NULL) {
+        fprintf(csv, "%s,%llu,%.0f,%u,%u,%.2f,%.0f\n", name.c_str(), (unsigned long long)s.count,
+                (double)s.cpu_ns / s.count, s.hist.percentile(50), s.hist.percentile(99),
+                (double)s.allocs / s.count, (double)s.alloc_bytes / s.count);
+    }
+}
+
+static void report(double wall_s)
+{
+    uint64_t msgs = 0;
+    uint64_t rx_ns = 0;
+    FILE *csv = NULL;
+
+    if (!g_opt.csv.empty()) {
+        csv = fopen(g_opt.csv.c_str(), "w");
+        if (csv == NULL) {
+            perror(g_opt.csv.c_str());
+        } else {
+            fprintf(csv, "kind,count,cpu_ns_avg,cpu_ns_p50,cpu_ns_p99,allocs,alloc_bytes\n");
+        }
+    }
+    for (std::map<std::string, RunStats>::iterator it = g_rx_stats.begin(); it != g_rx_stats.end(); ++it) {
+        msgs += it->second.count;
+        rx_ns += it->second.cpu_ns;
+    }
+
+    printf("\n==== %s: %zu records over %.1f s, %u pass(es) in %.2f s ====\n", g_opt.trace.c_str(),
+           g_records.size(), g_records.empty() ? 0 : g_records.back().t_us / 1e6, g_opt.repeat, wall_s);
+    if (g_opt.link) {
+        printf("node link: %.1f STATUS ACKed, %.1f in the trace\n", (double)g_link_acked / g_opt.repeat,
+               (double)g_link_acked_rec / g_opt.repeat);
+    } else {
+        printf("node: %llu connections, %llu closed by the node, %llu records dropped%s%s\n",
+               (unsigned long long)g_opens, (unsigned long long)g_closes, (unsigned long long)g_dropped,
+               g_halt_reason ? ", halted: " : "", g_halt_reason ? g_halt_reason : "");
+    }
+    printf("messages: %llu, %.0f CPU ns/msg on average\n\n", (unsigned long long)msgs,
+           msgs ? (double)rx_ns / msgs : 0);
+    printf("  %-22s %8s %10s %10s %10s %8s %9s\n", "run", "count", "cpu ns", "p50", "p99", "allocs",
+           "bytes");
+    for (std::map<std::string, RunStats>::iterator it = g_rx_stats.begin(); it != g_rx_stats.end(); ++it) {
+        print_row(csv, it->first, it->second);
+    }
+    print_row(csv, "loop", g_loop);
+    print_row(csv, "boot", g_boot);
+
+    printf("\n  %-22s %10s %10s\n", "sent", "recorded", "replayed");
+    for (std::map<std::string, TxCount>::iterator it = g_tx_counts.begin(); it != g_tx_counts.end(); ++it) {
+        printf("  %-22s %10llu %10.1f\n", it->first.c_str(), (unsigned long long)it->second.recorded,
+               (double)it->second.replayed / g_opt.repeat);
+    }
+    if (csv != NULL) {
+        fclose(csv);
+    }
+}
+
+///////////////////////////////////////MAIN////////////////////////////////////////////////////////
+static std::string exe_dir()
+{
+    char buf[512];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) {
+        return ".";
+    }
+    buf[n] = 0;
+    char *p = strrchr(buf, '/');
+    if (p != NULL) {
+        *p = 0;
+    }
+    return buf;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options] TRACE\n"
+        "  --repeat N       replay the trace N times, each on a freshly booted node (1)\n"
+        "  --mac MAC        MAC of the node (from the recorded client id; --link: the node id)\n"
+        "  --security KEY   security setting of the node (from the recorded password)\n"
+        "  --link           replay the node link of wdm_th (UDP records) instead of the node image\n"
+        "  --csv FILE       write the per-message costs to FILE\n"
+        "  --lib PATH       node image (libwdm_onoff.so next to the replayer)\n"
+        "  --serial         print the Serial output of the node\n", name);
+    exit(2);
+}
+
+static void parse_args(int argc, char **argv)
+{
+    g_opt.repeat = 1;
+    g_opt.lib = exe_dir() + "/libwdm_onoff.so";
+    g_opt.mac_set = false;
+    g_opt.serial = false;
+    g_opt.link = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (a[0] != '-') {
+            g_opt.trace = a;
+            continue;
+        }
+        if (strcmp(a, "--serial") == 0) {
+            g_opt.serial = true;
+            continue;
+        }
+        if (strcmp(a, "--link") == 0) {
+            g_opt.link = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--repeat") == 0) {
+            g_opt.repeat = atoi(v);
+        } else if (strcmp(a, "--mac") == 0) {
+            unsigned int m[6];
+            if (sscanf(v, "%x:%x:%x:%x:%x:%x", &m[0], &m[1], &m[2], &m[3], &m[4], &m[5]) != 6) {
+                usage(argv[0]);
+            }
+            for (int k = 0; k < 6; k++) {
+                g_opt.mac[k] = m[k];
+            }
+            g_opt.mac_set = true;
+        } else if (strcmp(a, "--security") == 0) {
+            g_opt.security = v;
+        } else if (strcmp(a, "--csv") == 0) {
+            g_opt.csv = v;
+        } else if (strcmp(a, "--lib") == 0) {
+            g_opt.lib = v;
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (g_opt.trace.empty() || (g_opt.repeat == 0)) {
+        usage(argv[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    parse_args(argc, argv);
+    if (!trace_file::load(g_opt.trace.c_str(), g_records)) {
+        fprintf(stderr, "%s: not a trace\n", g_opt.trace.c_str());
+        return 1;
+    }
+    identify();
+    for (size_t i = 0; i < g_records.size(); i++) {
+        const Record &r = g_records[i];
+        bool link_tx = (r.type == TRACE_UDP_TX);
+        if ((r.type == TRACE_MQTT_TX) || (r.type == TRACE_LAN_TX) || link_tx) {
+            if (link_tx == g_opt.link) {
+                g_tx_counts[record_kind(r)].recorded++;
+            }
+        }
+    }
+    if (g_opt.link) {
+        if (g_opt.mac_set) {
+            memcpy(g_link_id, g_opt.mac, WDM_ID_SZ);
+        }
+        g_key = wdm_siphash::derive(g_opt.security.c_str());
+        fprintf(stderr, "node link %02x%02x%02x%02x%02x%02x, security \"%s\"\n", g_link_id[0],
+                g_link_id[1], g_link_id[2], g_link_id[3], g_link_id[4], g_link_id[5], g_opt.security.c_str());
+        uint64_t start = wall_us();
+        for (uint32_t k = 0; k < g_opt.repeat; k++) {
+            link_pass();
+        }
+        report((wall_us() - start) / 1e6);
+        fflush(stdout);
+        _exit(0);
+    }
+    if (!load_image(g_opt.lib.c_str())) {
+        return 1;
+    }
+
+    memset(&g_cfg, 0, sizeof(g_cfg));
+    const uint8_t mac[6] = { 0x5c, 0xcf, 0x7f, 0x00, 0x00, 0x00 };
+    memcpy(g_cfg.mac, g_opt.mac_set ? g_opt.mac : mac, 6);
+    snprintf(g_cfg.server, sizeof(g_cfg.server), "replay");
+    g_cfg.port = 1883;
+    snprintf(g_cfg.security, sizeof(g_cfg.security), "%s", g_opt.security.c_str());
+    fprintf(stderr, "node %02x%02x%02x%02x%02x%02x, security \"%s\", node image data+bss %zu B\n",
+            g_cfg.mac[0], g_cfg.mac[1], g_cfg.mac[2], g_cfg.mac[3], g_cfg.mac[4], g_cfg.mac[5],
+            g_cfg.security, g_seg_sz);
+
+    uint64_t start = wall_us();
+    for (uint32_t k = 0; k < g_opt.repeat; k++) {
+        replay_pass();
+    }
+    report((wall_us() - start) / 1e6);
+    fflush(stdout);
+    // The node image is left as it is: no static destructors.
+    _exit(0);
+}
@@ -0,0 +1,873 @@
+/**	@brief fleet simulator: runs many wdm_onoff nodes in one process against a local broker and
+ *  reports the publish rate, the end-to-end command latency & the memory used per node.
+ *  - The sketch & the Arduino stand-in (core/) are built as one shared object (the node image).
+ *  - Each node is a coroutine with its own stack & its own copy of the node image data segment:
+ *    the copy is swapped in when the node runs, so the sketch globals are per node.
+ *  - One epoll loop schedules the nodes (socket events & deadlines) & the controller, an MQTT
+ *    client which sends toggle commands to random nodes & times their STATUS answer.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <dlfcn.h>
+#include <errno.h>
+#include <link.h>
+#include <malloc.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <deque>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wdm_proto.h>
+#include "lat_hist.h"
+#include "mqtt_wire.h"
+#include "core/sim_host.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define SIM_PORT_DEFAULT        18830
+
+/* Stack of each node coroutine */
+#define NODE_STACK_SZ           (64 * 1024)
+
+/* Node states */
+#define NODE_READY              0
+#define NODE_WAITING            1
+#define NODE_HALTED             2
+
+/* epoll tag of the controller socket (node sockets are tagged with the node index) */
+#define CTL_TAG                 0xFFFFFFFFu
+
+/* A command without STATUS answer after this time is lost (us) */
+#define CMD_TIMEOUT_US          5000000
+
+/* wdm frame (see mqtt_inf.cpp) */
+#define FRAME_MARK              0x01
+#define OPU_TIME_GET            0x41
+#define OPU_STATUS              0x42
+#define OPU_EVENT               0x43
+#define OPD_COMMAND             'd'
+
+#define EPOLL_BATCH             256
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+struct Node {
+    SIM_NODE_CFG_t cfg;
+    uint8_t *data;          // Data segment of the node image, while the node is not live
+    uint8_t *stack;
+    ucontext_t ctx;
+    uint8_t state;
+    int wait_fd;
+    uint32_t wait_seq;
+    uint64_t runs;
+    int64_t heap_cur;
+    int64_t heap_peak;
+    const char *halt_reason;
+};
+
+struct Deadline {
+    uint64_t at;
+    uint32_t node;
+    uint32_t seq;
+    bool operator>(const Deadline &d) const { return at > d.at; }
+};
+
+/* Node, as seen by the controller */
+struct CtlNode {
+    uint8_t id[WDM_ID_SZ];
+    std::string sub_topic;
+    uint32_t value;
+    bool online;
+    uint8_t pending_cmd;
+    uint64_t pending_us;    // 0: no command pending
+};
+
+struct CtlStats {
+    uint64_t pub;
+    uint64_t status;
+    uint64_t time_get;
+    uint64_t event;
+    uint64_t cmd_sent;
+    uint64_t cmd_ok;
+    uint64_t cmd_lost;
+};
+
+struct Options {
+    uint32_t nodes;
+    double duration;
+    double cmd_rate;
+    double ramp;
+    int port;
+    std::string broker;
+    std::string lib;
+    int trace;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static Options g_opt;
+
+/* Node image */
+static sim_node_run_t g_node_run;
+static uint8_t *g_seg;
+static size_t g_seg_sz;
+static uint8_t *g_pristine;
+
+/* Scheduler */
+static std::vector<Node> g_nodes;
+static int g_cur = -1;      // Running node
+static int g_live = -1;     // Node whose data is in the segment
+static ucontext_t g_sched_ctx;
+static std::deque<uint32_t> g_ready;
+static std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline> > g_deadlines;
+static int g_epfd;
+
+/* Controller */
+static int g_ctl_fd = -1;
+static std::string g_ctl_rx;
+static std::vector<CtlNode> g_ctl_nodes;
+static std::unordered_map<std::string, uint32_t> g_ctl_index;
+static CtlStats g_ctl;
+static LatHist g_lat_all;
+static LatHist g_lat_period;
+
+static pid_t g_broker_pid;
+
+///////////////////////////////////////HEAP ACCOUNTING/////////////////////////////////////////////
+/* malloc() & co are interposed: the memory allocated while a node runs is counted for it */
+extern "C" {
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *p, size_t size);
+    void __libc_free(void *p);
+}
+
+static inline void heap_count(void *p, int sign)
+{
+    if ((g_cur >= 0) && (p != NULL)) {
+        Node &n = g_nodes[g_cur];
+        n.heap_cur += sign * (int64_t)malloc_usable_size(p);
+        if (n.heap_cur < 0) {
+            n.heap_cur = 0;
+        }
+        if (n.heap_cur > n.heap_peak) {
+            n.heap_peak = n.heap_cur;
+        }
+    }
+}
+
+extern "C" void *malloc(size_t size)
+{
+    void *p = __libc_malloc(size);
+    heap_count(p, 1);
+    return p;
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    void *p = __libc_calloc(n, size);
+    heap_count(p, 1);
+    return p;
+}
+
+extern "C" void *realloc(void *p, size_t size)
+{
+    heap_count(p, -1);
+    void *q = __libc_realloc(p, size);
+    heap_count(q ? q : p, 1);
+    return q;
+}
+
+extern "C" void free(void *p)
+{
+    heap_count(p, -1);
+    __libc_free(p);
+}
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static uint64_t now_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void make_ready(uint32_t i)
+{
+    Node &n = g_nodes[i];
+    n.state = NODE_READY;
+    n.wait_seq++;
+    n.wait_fd = -1;
+    g_ready.push_back(i);
+}
+
+/** @brief run a node until it waits or halts.
+*/
+static void node_switch(uint32_t i)
+{
+    Node &n = g_nodes[i];
+
+    if (g_live != (int)i) {
+        if (g_live >= 0) {
+            memcpy(g_nodes[g_live].data, g_seg, g_seg_sz);
+        }
+        memcpy(g_seg, n.data, g_seg_sz);
+        g_live = i;
+    }
+    n.runs++;
+    g_cur = i;
+    swapcontext(&g_sched_ctx, &n.ctx);
+    g_cur = -1;
+}
+
+///////////////////////////////////////HOST SERVICES///////////////////////////////////////////////
+static void host_wait(int fd, uint32_t events, uint64_t deadline_us)
+{
+    uint32_t i = g_cur;
+    Node &n = g_nodes[i];
+
+    // Scheduler bookkeeping is not counted for the node (g_cur is set again when it resumes):
+    g_cur = -1;
+    n.wait_seq++;
+    if (deadline_us <= now_us()) {
+        n.state = NODE_READY;
+        n.wait_fd = -1;
+        g_ready.push_back(i);
+    } else {
+        n.state = NODE_WAITING;
+        n.wait_fd = fd;
+        g_deadlines.push(Deadline { deadline_us, i, n.wait_seq });
+        if (fd >= 0) {
+            struct epoll_event ev;
+            ev.events = EPOLLONESHOT | ((events & SIM_EV_IN) ? EPOLLIN : 0) |
+                        ((events & SIM_EV_OUT) ? EPOLLOUT : 0);
+            ev.data.u64 = ((uint64_t)fd << 32) | i;
+            if ((epoll_ctl(g_epfd, EPOLL_CTL_MOD, fd, &ev) != 0) && (errno == ENOENT)) {
+                epoll_ctl(g_epfd, EPOLL_CTL_ADD, fd, &ev);
+            }
+        }
+    }
+    swapcontext(&n.ctx, &g_sched_ctx);
+}
+
+static void host_halt(const char *reason)
+{
+    uint32_t i = g_cur;
+    Node &n = g_nodes[i];
+
+    g_cur = -1;
+    n.state = NODE_HALTED;
+    n.halt_reason = reason;
+    fprintf(stderr, "\nnode %u halted: %s\n", i, reason);
+    swapcontext(&n.ctx, &g_sched_ctx);
+}
+
+static void host_trace(const char *buf, uint32_t len)
+{
+    if (g_cur == g_opt.trace) {
+        fwrite(buf, 1, len, stderr);
+    }
+}
+
+static uint64_t host_now_us()
+{
+    return now_us();
+}
+
+static const SIM_HOST_t g_host = { host_now_us, host_wait, host_halt, host_trace, NULL };
+
+static void node_main()
+{
+    Node &n = g_nodes[g_cur];
+    g_node_run(&n.cfg);
+    host_halt("returned");
+}
+
+///////////////////////////////////////NODE IMAGE//////////////////////////////////////////////////
+static int find_segment(struct dl_phdr_info *info, size_t, void *arg)
+{
+    struct link_map *lm = (struct link_map *)arg;
+
+    if (info->dlpi_addr != lm->l_addr) {
+        return 0;
+    }
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        if ((ph->p_type == PT_LOAD) && (ph->p_flags & PF_W)) {
+            g_seg = (uint8_t *)(info->dlpi_addr + ph->p_vaddr);
+            g_seg_sz = ph->p_memsz;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static bool load_image(const char *path)
+{
+    void *h = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (h == NULL) {
+        fprintf(stderr, "dlopen: %s\n", dlerror());
+        return false;
+    }
+    sim_node_attach_t attach = (sim_node_attach_t)dlsym(h, "sim_node_attach");
+    g_node_run = (sim_node_run_t)dlsym(h, "sim_node_run");
+    struct link_map *lm = NULL;
+    if ((attach == NULL) || (g_node_run == NULL) || (dlinfo(h, RTLD_DI_LINKMAP, &lm) != 0)) {
+        fprintf(stderr, "%s: not a node image\n", path);
+        return false;
+    }
+    attach(&g_host);
+
+    dl_iterate_phdr(find_segment, lm);
+    if (g_seg == NULL) {
+        fprintf(stderr, "%s: no data segment\n", path);
+        return false;
+    }
+    g_pristine = (uint8_t *)malloc(g_seg_sz);
+    memcpy(g_pristine, g_seg, g_seg_sz);
+    return true;
+}
+
+static void node_create(uint32_t i, const char *server, uint16_t port, uint64_t boot_us)
+{
+    Node &n = g_nodes[i];
+
+    memset(&n.cfg, 0, sizeof(n.cfg));
+    n.cfg.index = i;
+    const uint8_t mac[6] = { 0x5c, 0xcf, 0x7f, (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i };
+    memcpy(n.cfg.mac, mac, 6);
+    snprintf(n.cfg.server, sizeof(n.cfg.server), "%s", server);
+    n.cfg.port = port;
+
+    n.data = (uint8_t *)malloc(g_seg_sz);
+    memcpy(n.data, g_pristine, g_seg_sz);
+
+    // Stack, with a guard page:
+    n.stack = (uint8_t *)mmap(NULL, NODE_STACK_SZ + 4096, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    mprotect(n.stack, 4096, PROT_NONE);
+    getcontext(&n.ctx);
+    n.ctx.uc_stack.ss_sp = n.stack + 4096;
+    n.ctx.uc_stack.ss_size = NODE_STACK_SZ;
+    n.ctx.uc_link = NULL;
+    makecontext(&n.ctx, node_main, 0);
+
+    n.state = NODE_WAITING;
+    n.wait_fd = -1;
+    n.wait_seq = 0;
+    n.runs = 0;
+    n.heap_cur = 0;
+    n.heap_peak = 0;
+    n.halt_reason = NULL;
+    g_deadlines.push(Deadline { boot_us, i, 0 });
+}
+
+/** @brief stack high-water mark: the stack is zeroed at start, scan for the deepest written byte.
+*/
+static uint32_t stack_used(const Node &n)
+{
+    const uint8_t *p = n.stack + 4096;
+    const uint8_t *end = p + NODE_STACK_SZ;
+    while ((p < end) && (*p == 0)) {
+        p++;
+    }
+    return end - p;
+}
+
+///////////////////////////////////////BROKER/////////////////////////////////////////////////////
+static std::string exe_dir()
+{
+    char buf[512];
+    ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+    if (n <= 0) {
+        return ".";
+    }
+    buf[n] = 0;
+    char *p = strrchr(buf, '/');
+    if (p != NULL) {
+        *p = 0;
+    }
+    return buf;
+}
+
+static void start_broker(int port)
+{
+    std::string path = exe_dir() + "/wdm_broker";
+    char port_str[16];
+    snprintf(port_str, sizeof(port_str), "%d", port);
+
+    g_broker_pid = fork();
+    if (g_broker_pid == 0) {
+        execl(path.c_str(), path.c_str(), "--port", port_str, (char *)NULL);
+        perror("exec wdm_broker");
+        _exit(1);
+    }
+}
+
+static void stop_broker()
+{
+    if (g_broker_pid > 0) {
+        kill(g_broker_pid, SIGTERM);
+        waitpid(g_broker_pid, NULL, 0);
+    }
+}
+
+///////////////////////////////////////CONTROLLER//////////////////////////////////////////////////
+static void ctl_send(const std::string &pkt)
+{
+    size_t sent = 0;
+    while (sent < pkt.size()) {
+        ssize_t n = send(g_ctl_fd, pkt.data() + sent, pkt.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += n;
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            fprintf(stderr, "controller: send failed\n");
+            return;
+        }
+    }
+}
+
+static bool ctl_connect(const char *host, int port)
+{
+    struct sockaddr_in addr;
+    int one = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, host, &addr.sin_addr);
+
+    // The broker may still be starting:
+    for (int i = 0; i < 50; i++) {
+        g_ctl_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (connect(g_ctl_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            break;
+        }
+        close(g_ctl_fd);
+        g_ctl_fd = -1;
+        usleep(100000);
+    }
+    if (g_ctl_fd < 0) {
+        fprintf(stderr, "controller: can't connect to %s:%d\n", host, port);
+        return false;
+    }
+    setsockopt(g_ctl_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::string pkt;
+    mqtt_wire::connect(pkt, "wdm-sim-ctl", 60);
+    mqtt_wire::subscribe(pkt, 1, "wdm/dev/pub/+");
+    mqtt_wire::subscribe(pkt, 2, "wdm/dev/pres/+");
+    ctl_send(pkt);
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = CTL_TAG;
+    epoll_ctl(g_epfd, EPOLL_CTL_ADD, g_ctl_fd, &ev);
+    return true;
+}
+
+static CtlNode *ctl_node(const std::string &topic, const std::string &prefix)
+{
+    std::string hex = topic.substr(prefix.size());
+    std::unordered_map<std::string, uint32_t>::iterator it = g_ctl_index.find(hex);
+    if (it != g_ctl_index.end()) {
+        return &g_ctl_nodes[it->second];
+    }
+    CtlNode c;
+    memset(c.id, 0, sizeof(c.id));
+    c.sub_topic = "wdm/dev/sub/" + hex;
+    c.value = 0;
+    c.online = false;
+    c.pending_cmd = 0;
+    c.pending_us = 0;
+    g_ctl_index[hex] = g_ctl_nodes.size();
+    g_ctl_nodes.push_back(c);
+    return &g_ctl_nodes.back();
+}
+
+static void ctl_on_publish(const mqtt_wire::Publish &p)
+{
+    static const std::string PUB = "wdm/dev/pub/";
+    static const std::string PRES = "wdm/dev/pres/";
+
+    if (p.topic.compare(0, PRES.size(), PRES) == 0) {
+        ctl_node(p.topic, PRES)->online = (p.len == 1) && (p.payload[0] == '1');
+        return;
+    }
+    if (p.topic.compare(0, PUB.size(), PUB) != 0) {
+        return;
+    }
+    g_ctl.pub++;
+
+    wdm_frame::View<MqttHeader> hdr(p.payload, p.len);
+    if (!hdr.valid() || (hdr.get<MQTT_HDR_MARK>() != FRAME_MARK)) {
+        return;
+    }
+    CtlNode *c = ctl_node(p.topic, PUB);
+    memcpy(c->id, hdr.get<MQTT_HDR_ID>(), WDM_ID_SZ);
+
+    switch (hdr.get<MQTT_HDR_OPCODE>()) {
+    case OPU_TIME_GET:
+        g_ctl.time_get++;
+        break;
+
+    case OPU_EVENT:
+        g_ctl.event++;
+        break;
+
+    case OPU_STATUS: {
+        g_ctl.status++;
+        wdm_frame::Reader rd(hdr.tail(), hdr.tail_len());
+        wdm_frame::View<MqttCount> cnt = rd.next<MqttCount>();
+        for (uint8_t k = 0; cnt.valid() && (k < cnt.get<0>()); k++) {
+            wdm_frame::View<MqttDeviceStatus> st = rd.next<MqttDeviceStatus>();
+            if (!st.valid()) {
+                break;
+            }
+            if (st.get<MQTT_DEV_OFFSET>() != 1) {
+                continue;
+            }
+            c->value = st.get<MQTT_DEV_VALUE>();
+            if ((c->pending_us != 0) && (c->value == c->pending_cmd)) {
+                uint32_t lat = now_us() - c->pending_us;
+                g_lat_all.add(lat);
+                g_lat_period.add(lat);
+                g_ctl.cmd_ok++;
+                c->pending_us = 0;
+            }
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+static void ctl_read()
+{
+    char buf[4096];
+
+    while (true) {
+        ssize_t n = recv(g_ctl_fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) {
+            g_ctl_rx.append(buf, n);
+        } else if ((n < 0) && (errno == EINTR)) {
+            continue;
+        } else {
+            if ((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK))) {
+                fprintf(stderr, "controller: connection lost\n");
+                epoll_ctl(g_epfd, EPOLL_CTL_DEL, g_ctl_fd, NULL);
+            }
+            break;
+        }
+    }
+
+    size_t used = 0;
+    while (true) {
+        mqtt_wire::Packet pkt;
+        int n = mqtt_wire::parse((const uint8_t *)g_ctl_rx.data() + used, g_ctl_rx.size() - used, &pkt);
+        if (n <= 0) {
+            break;
+        }
+        mqtt_wire::Publish p;
+        if ((pkt.type == MQTT_PUBLISH) && mqtt_wire::parse_publish(pkt, &p)) {
+            ctl_on_publish(p);
+        }
+        used += n;
+    }
+    g_ctl_rx.erase(0, used);
+}
+
+/** @brief send a toggle command to a random online node which has no command pending.
+*/
+static void ctl_command()
+{
+    if (g_ctl_nodes.empty()) {
+        return;
+    }
+    for (int tries = 0; tries < 8; tries++) {
+        CtlNode &c = g_ctl_nodes[rand() % g_ctl_nodes.size()];
+        if (!c.online || (c.pending_us != 0)) {
+            continue;
+        }
+        uint8_t arr[MqttHeader::size + MqttCommand::size];
+        wdm_frame::Writer w(arr, sizeof(arr));
+        c.pending_cmd = c.value ? 0 : 1;
+        w.put<MqttHeader>(FRAME_MARK, OPD_COMMAND, c.id);
+        w.put<MqttCommand>(1, c.pending_cmd);
+
+        std::string pkt;
+        mqtt_wire::publish(pkt, c.sub_topic, arr, w.length());
+        c.pending_us = now_us();
+        ctl_send(pkt);
+        g_ctl.cmd_sent++;
+        return;
+    }
+}
+
+static void ctl_expire(uint64_t now)
+{
+    for (CtlNode &c : g_ctl_nodes) {
+        if ((c.pending_us != 0) && (now > c.pending_us + CMD_TIMEOUT_US)) {
+            c.pending_us = 0;
+            g_ctl.cmd_lost++;
+        }
+    }
+}
+
+///////////////////////////////////////REPORT//////////////////////////////////////////////////////
+static double percentile(const LatHist &h, double pct)
+{
+    return h.percentile(pct) / 1000.0;
+}
+
+static void report_period(double t, double period, const CtlStats &last)
+{
+    uint32_t online = 0;
+    uint32_t halted = 0;
+
+    for (const CtlNode &c : g_ctl_nodes) {
+        online += c.online;
+    }
+    for (const Node &n : g_nodes) {
+        halted += (n.state == NODE_HALTED);
+    }
+    printf("[%6.1fs] online %u/%zu, halted %u | pub %.1f/s (status %.1f/s) | cmd %llu sent, %llu ok, %llu lost"
+           " | lat p50 %.2f ms, p99 %.2f ms\n",
+           t, online, g_nodes.size(), halted,
+           (g_ctl.pub - last.pub) / period, (g_ctl.status - last.status) / period,
+           (unsigned long long)(g_ctl.cmd_sent - last.cmd_sent),
+           (unsigned long long)(g_ctl.cmd_ok - last.cmd_ok),
+           (unsigned long long)(g_ctl.cmd_lost - last.cmd_lost),
+           percentile(g_lat_period, 50), percentile(g_lat_period, 99));
+    fflush(stdout);
+    g_lat_period.reset();
+}
+
+static void report_final(double elapsed)
+{
+    uint64_t runs = 0;
+    int64_t heap_sum = 0;
+    int64_t heap_max = 0;
+    uint64_t stack_sum = 0;
+    uint32_t stack_max = 0;
+
+    for (const Node &n : g_nodes) {
+        uint32_t s = stack_used(n);
+        runs += n.runs;
+        heap_sum += n.heap_peak;
+        heap_max = std::max(heap_max, n.heap_peak);
+        stack_sum += s;
+        stack_max = std::max(stack_max, s);
+    }
+    size_t cnt = g_nodes.size();
+
+    printf("\n==== %zu nodes, %.1f s ====\n", cnt, elapsed);
+    printf("publish:  %llu msgs, %.1f msg/s (status %llu, time %llu, event %llu)\n",
+           (unsigned long long)g_ctl.pub, g_ctl.pub / elapsed, (unsigned long long)g_ctl.status,
+           (unsigned long long)g_ctl.time_get, (unsigned long long)g_ctl.event);
+    printf("commands: %llu sent, %llu ok, %llu lost\n", (unsigned long long)g_ctl.cmd_sent,
+           (unsigned long long)g_ctl.cmd_ok, (unsigned long long)g_ctl.cmd_lost);
+    printf("latency:  p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           percentile(g_lat_all, 50), percentile(g_lat_all, 90), percentile(g_lat_all, 99),
+           g_lat_all.max() / 1000.0);
+    printf("memory per node: data+bss %zu B, heap peak avg %lld B / max %lld B, stack avg %llu B / max %u B\n",
+           g_seg_sz, (long long)(heap_sum / (int64_t)cnt), (long long)heap_max,
+           (unsigned long long)(stack_sum / cnt), stack_max);
+    printf("scheduler: %llu node runs, %.0f/s\n", (unsigned long long)runs, runs / elapsed);
+}
+
+///////////////////////////////////////MAIN////////////////////////////////////////////////////////
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  --nodes N        number of nodes (100)\n"
+        "  --duration SEC   simulated time (10)\n"
+        "  --cmd-rate N     toggle commands per second (10)\n"
+        "  --ramp SEC       nodes boot spread over this time (1)\n"
+        "  --port N         port of the local broker (%d)\n"
+        "  --broker IP:PORT use this broker instead of starting wdm_broker\n"
+        "  --lib PATH       node image (libwdm_onoff.so next to the simulator)\n"
+        "  --trace N        print the Serial output of node N\n", name, SIM_PORT_DEFAULT);
+    exit(2);
+}
+
+static void parse_args(int argc, char **argv)
+{
+    g_opt.nodes = 100;
+    g_opt.duration = 10;
+    g_opt.cmd_rate = 10;
+    g_opt.ramp = 1;
+    g_opt.port = SIM_PORT_DEFAULT;
+    g_opt.lib = exe_dir() + "/libwdm_onoff.so";
+    g_opt.trace = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        const char *v = argv[++i];
+        if (strcmp(a, "--nodes") == 0) {
+            g_opt.nodes = atoi(v);
+        } else if (strcmp(a, "--duration") == 0) {
+            g_opt.duration = atof(v);
+        } else if (strcmp(a, "--cmd-rate") == 0) {
+            g_opt.cmd_rate = atof(v);
+        } else if (strcmp(a, "--ramp") == 0) {
+            g_opt.ramp = atof(v);
+        } else if (strcmp(a, "--port") == 0) {
+            g_opt.port = atoi(v);
+        } else if (strcmp(a, "--broker") == 0) {
+            g_opt.broker = v;
+        } else if (strcmp(a, "--lib") == 0) {
+            g_opt.lib = v;
+        } else if (strcmp(a, "--trace") == 0) {
+            g_opt.trace = atoi(v);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if (g_opt.nodes == 0) {
+        usage(argv[0]);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string host = "127.0.0.1";
+    int port;
+
+    parse_args(argc, argv);
+    signal(SIGPIPE, SIG_IGN);
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    if (g_opt.broker.empty()) {
+        port = g_opt.port;
+        start_broker(port);
+    } else {
+        size_t colon = g_opt.broker.find(':');
+        host = g_opt.broker.substr(0, colon);
+        port = (colon == std::string::npos) ? 1883 : atoi(g_opt.broker.c_str() + colon + 1);
+    }
+
+    g_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (!load_image(g_opt.lib.c_str()) || !ctl_connect(host.c_str(), port)) {
+        stop_broker();
+        return 1;
+    }
+
+    uint64_t start = now_us();
+    uint64_t end = start + (uint64_t)(g_opt.duration * 1000000);
+    g_nodes.resize(g_opt.nodes);
+    for (uint32_t i = 0; i < g_opt.nodes; i++) {
+        node_create(i, host.c_str(), port, start + (uint64_t)(g_opt.ramp * 1000000 * i / g_opt.nodes));
+    }
+    fprintf(stderr, "%u nodes, node image data+bss %zu B, broker %s:%d\n", g_opt.nodes, g_seg_sz,
+            host.c_str(), port);
+
+    uint64_t cmd_period = (g_opt.cmd_rate > 0) ? (uint64_t)(1000000 / g_opt.cmd_rate) : 0;
+    uint64_t next_cmd = start + (uint64_t)(g_opt.ramp * 1000000) + 1000000;
+    uint64_t next_report = start + 1000000;
+    uint64_t next_ping = start + 30000000;
+    CtlStats last = g_ctl;
+    struct epoll_event events[EPOLL_BATCH];
+
+    uint64_t now = now_us();
+    while (now < end) {
+        // Due deadlines:
+        while (!g_deadlines.empty() && (g_deadlines.top().at <= now)) {
+            Deadline d = g_deadlines.top();
+            g_deadlines.pop();
+            Node &n = g_nodes[d.node];
+            if ((n.state == NODE_WAITING) && (n.wait_seq == d.seq)) {
+                make_ready(d.node);
+            }
+        }
+
+        // Run the nodes ready now (the ones they make ready run on the next round):
+        for (size_t cnt = g_ready.size(); cnt > 0; cnt--) {
+            uint32_t i = g_ready.front();
+            g_ready.pop_front();
+            if (g_nodes[i].state == NODE_READY) {
+                node_switch(i);
+            }
+        }
+
+        // Controller:
+        now = now_us();
+        if (cmd_period && (now >= next_cmd)) {
+            while (next_cmd <= now) {
+                ctl_command();
+                next_cmd += cmd_period;
+            }
+        }
+        if (now >= next_ping) {
+            std::string pkt;
+            mqtt_wire::simple(pkt, MQTT_PINGREQ);
+            ctl_send(pkt);
+            next_ping = now + 30000000;
+        }
+        if (now >= next_report) {
+            ctl_expire(now);
+            report_period((now - start) / 1e6, 1.0, last);
+            last = g_ctl;
+            next_report += 1000000;
+        }
+
+        // Wait for sockets, up to the next deadline:
+        int timeout = 0;
+        if (g_ready.empty()) {
+            uint64_t next = std::min(next_report, end);
+            if (cmd_period) {
+                next = std::min(next, next_cmd);
+            }
+            if (!g_deadlines.empty()) {
+                next = std::min(next, g_deadlines.top().at);
+            }
+            timeout = (next > now) ? (int)((next - now + 999) / 1000) : 0;
+        }
+        int n = epoll_wait(g_epfd, events, EPOLL_BATCH, timeout);
+        for (int k = 0; k < n; k++) {
+            uint32_t tag = (uint32_t)events[k].data.u64;
+            if (tag == CTL_TAG) {
+                ctl_read();
+                continue;
+            }
+            int fd = (int)(events[k].data.u64 >> 32);
+            Node &node = g_nodes[tag];
+            if ((node.state == NODE_WAITING) && (node.wait_fd == fd)) {
+                make_ready(tag);
+            }
+        }
+        now = now_us();
+    }
+
+    report_final((now - start) / 1e6);
+    stop_broker();
+    fflush(stdout);
+    // The node images are left as they are: no static destructors.
+    _exit(0);
+}
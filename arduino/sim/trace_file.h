@@ -0,0 +1,164 @@
+/** @brief session trace file of the host tools (wdm_record writes it, wdm_replay reads it): the
+ *  byte streams between one node and the broker / the LAN / its UDP server, with their timestamps.
+ *      File = ["WDMT"][version(1)] + records
+ *      Record = [type(1)][dt(v)][len(v)][data(len)]
+ *  dt: microseconds since the previous record, (v): unsigned LEB128. An MQTT record holds one
+ *  whole packet, a LAN or UDP record one datagram.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _TRACE_FILE_H_
+#define _TRACE_FILE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#define TRACE_MAGIC             "WDMT"
+#define TRACE_VERSION           1
+
+/* Record types: RX = to the node, TX = from the node */
+#define TRACE_MQTT_RX           0
+#define TRACE_MQTT_TX           1
+#define TRACE_LAN_RX            2
+#define TRACE_LAN_TX            3
+#define TRACE_MQTT_CLOSE_RX     4       // Connection closed by the broker (no data)
+#define TRACE_MQTT_CLOSE_TX     5       // Connection closed by the node (no data)
+#define TRACE_UDP_RX            6       // Node link (wdm_th UDP transport): from the server
+#define TRACE_UDP_TX            7       // Node link: from the node
+#define TRACE_TYPE_CNT          8
+
+namespace trace_file {
+
+struct Record {
+    uint8_t type;
+    uint64_t t_us;          // Since the start of the recording
+    std::string data;
+};
+
+inline bool is_rx(uint8_t type) {
+    return (type == TRACE_MQTT_RX) || (type == TRACE_LAN_RX) || (type == TRACE_MQTT_CLOSE_RX) ||
+           (type == TRACE_UDP_RX);
+}
+
+inline void put_varint(std::string &out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((char)v);
+}
+
+inline bool get_varint(FILE *f, uint64_t *v) {
+    *v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(f);
+        if (c == EOF) {
+            return false;
+        }
+        *v |= (uint64_t)(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+class Writer
+{
+    public:
+        Writer() : _f(NULL), _last(0), _count(0) {}
+        ~Writer() { close(); }
+
+        /* Create the file: 'start_us' is the start of the recording */
+        bool open(const char *path, uint64_t start_us) {
+            _f = fopen(path, "wb");
+            if (_f == NULL) {
+                return false;
+            }
+            _last = start_us;
+            fwrite(TRACE_MAGIC, 1, 4, _f);
+            fputc(TRACE_VERSION, _f);
+            return true;
+        }
+
+        void add(uint8_t type, uint64_t t_us, const void *data, size_t len) {
+            if (_f == NULL) {
+                return;
+            }
+            if (t_us < _last) {
+                t_us = _last;
+            }
+            std::string hdr(1, (char)type);
+            put_varint(hdr, t_us - _last);
+            put_varint(hdr, len);
+            fwrite(hdr.data(), 1, hdr.size(), _f);
+            fwrite(data, 1, len, _f);
+            _last = t_us;
+            _count++;
+        }
+
+        void flush() {
+            if (_f != NULL) {
+                fflush(_f);
+            }
+        }
+
+        void close() {
+            if (_f != NULL) {
+                fclose(_f);
+                _f = NULL;
+            }
+        }
+
+        uint64_t count() const { return _count; }
+
+    private:
+        FILE *_f;
+        uint64_t _last;
+        uint64_t _count;
+};
+
+/** @brief read a whole trace.
+    @return false if it can't be read or isn't a trace; a truncated last record is dropped.
+*/
+inline bool load(const char *path, std::vector<Record> &records)
+{
+    char magic[5];
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    if ((fread(magic, 1, 5, f) != 5) || (memcmp(magic, TRACE_MAGIC, 4) != 0) ||
+        (magic[4] != TRACE_VERSION)) {
+        fclose(f);
+        return false;
+    }
+
+    uint64_t t = 0;
+    while (true) {
+        int type = fgetc(f);
+        uint64_t dt, len;
+        if ((type == EOF) || (type >= TRACE_TYPE_CNT) || !get_varint(f, &dt) ||
+            !get_varint(f, &len) || (len > (1 << 20))) {
+            break;
+        }
+        Record r;
+        r.type = type;
+        t += dt;
+        r.t_us = t;
+        r.data.resize(len);
+        if ((len > 0) && (fread(&r.data[0], 1, len, f) != len)) {
+            break;
+        }
+        records.push_back(r);
+    }
+    fclose(f);
+    return true;
+}
+
+} // namespace trace_file
+
+#endif
@@ -0,0 +1,15 @@
+/** @brief prototypes of the wdm_onoff.ino functions: the Arduino IDE generates them when it
+ *  converts the sketch to C++, the simulator build includes this header instead.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _WDM_ONOFF_PROTO_H_
+#define _WDM_ONOFF_PROTO_H_
+
+#include <stdint.h>
+
+void timer_1s();
+int capture_button();
+void led_write(uint8_t state);
+
+#endif
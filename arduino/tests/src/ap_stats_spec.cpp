@@ -0,0 +1,103 @@
+#include "Arduino.h"
+#include "ap_stats.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+int test_check() {
+    IT("resets the stats of another SSID");
+    AP_STATS_t st;
+    memset(&st, 0, sizeof(st));
+    ap_stats::check(&st, "home");
+    ap_stats::update(&st, true, 400);
+    ap_stats::check(&st, "home");
+    IS_TRUE(st.tries == 1);
+    ap_stats::check(&st, "office");
+    IS_TRUE(st.tries == 0);
+    IS_TRUE(st.connect_ms == 0);
+    END_IT
+}
+
+int test_update() {
+    IT("averages the connect time & keeps the last results");
+    AP_STATS_t st;
+    memset(&st, 0, sizeof(st));
+    ap_stats::update(&st, true, 800);
+    IS_TRUE(st.connect_ms == 800);
+    ap_stats::update(&st, true, 400);
+    IS_TRUE(st.connect_ms == 700);
+    st.channel = 6;
+    ap_stats::update(&st, false, 0);
+    IS_TRUE(st.channel == 0);
+    IS_TRUE(st.connect_ms == 700);
+    IS_TRUE(ap_stats::success_cnt(&st) == 2);
+    for (int i = 0; i < 10; i++) {
+        ap_stats::update(&st, false, 0);
+    }
+    IS_TRUE(st.tries == AP_STATS_HISTORY);
+    IS_TRUE(ap_stats::success_cnt(&st) == 0);
+    END_IT
+}
+
+int test_timeout() {
+    IT("gives a known profile a few times its connect time");
+    AP_STATS_t st;
+    memset(&st, 0, sizeof(st));
+    IS_TRUE(ap_stats::timeout_ms(&st) == AP_STATS_TIMEOUT_MS);
+    ap_stats::update(&st, true, 100);
+    IS_TRUE(ap_stats::timeout_ms(&st) == AP_STATS_TIMEOUT_MIN_MS);
+    memset(&st, 0, sizeof(st));
+    ap_stats::update(&st, true, 600);
+    IS_TRUE(ap_stats::timeout_ms(&st) == 600 * AP_STATS_TIMEOUT_FACTOR);
+    memset(&st, 0, sizeof(st));
+    ap_stats::update(&st, true, 4000);
+    IS_TRUE(ap_stats::timeout_ms(&st) == AP_STATS_TIMEOUT_MS);
+    END_IT
+}
+
+int test_sort() {
+    IT("orders the profiles by expected connect time");
+    AP_STATS_t tbl[4];
+    uint8_t order[4];
+    memset(tbl, 0, sizeof(tbl));
+
+    // 0: dead, 1: fast but fails 1 in 2, 2: never tried, 3: slower but reliable
+    ap_stats::update(&tbl[0], false, 0);
+    ap_stats::update(&tbl[0], false, 0);
+    ap_stats::update(&tbl[1], true, 300);
+    ap_stats::update(&tbl[1], false, 0);
+    ap_stats::update(&tbl[3], true, 1500);
+    ap_stats::update(&tbl[3], true, 1500);
+
+    IS_TRUE(ap_stats::sort(tbl, 4, 0x0F, order) == 4);
+    IS_TRUE(order[0] == 1);     // 300 + 1000
+    IS_TRUE(order[1] == 3);     // 1500
+    IS_TRUE(order[2] == 2);     // unknown
+    IS_TRUE(order[3] == 0);     // dead: last
+
+    IS_TRUE(ap_stats::sort(tbl, 4, 0x05, order) == 2);
+    IS_TRUE(order[0] == 2);
+    IS_TRUE(order[1] == 0);
+    END_IT
+}
+
+int test_sort_stable() {
+    IT("keeps the profile order for equal costs");
+    AP_STATS_t tbl[3];
+    uint8_t order[3];
+    memset(tbl, 0, sizeof(tbl));
+    IS_TRUE(ap_stats::sort(tbl, 3, 0x07, order) == 3);
+    IS_TRUE((order[0] == 0) && (order[1] == 1) && (order[2] == 2));
+    END_IT
+}
+
+int main() {
+    SUITE("AP profile statistics");
+
+    test_check();
+    test_update();
+    test_timeout();
+    test_sort();
+    test_sort_stable();
+
+    FINISH
+}
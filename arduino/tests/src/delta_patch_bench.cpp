@@ -0,0 +1,106 @@
+/* Delta OTA: patch size & apply throughput of the node's applier (delta_patch), for pairs of
+firmware images. Without arguments the pair is this program & a copy with the edits of a small
+change (a block inserted, one removed, the addresses after the insert moved).
+Build & run: make bench; other pairs: bin/delta_patch_bench OLD.bin NEW.bin [OLD NEW]... */
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "delta_patch.h"
+#include "../../tools/wdm_delta/delta_diff.h"
+
+/* Patch bytes per feed() (an OTA chunk) & minimum time measured per pair */
+#define FEED_SZ         512
+#define MIN_SEC         0.5
+
+typedef std::vector<uint8_t> Image;
+
+static const Image *g_old;
+static uint32_t g_written;
+
+static bool read_old(uint32_t offset, uint8_t *buf, size_t len) {
+    memcpy(buf, g_old->data() + offset, len);
+    return true;
+}
+
+static bool write_new(const uint8_t *buf, size_t len) {
+    g_written += len;
+    return true;
+}
+
+static bool load(const char *path, Image &img) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    uint8_t tmp[4096];
+    size_t n;
+    while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) {
+        img.insert(img.end(), tmp, tmp + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static Image next_build(const Image &img) {
+    Image out(img.begin(), img.begin() + img.size() / 3);
+    for (int k = 0; k < 300; k++) {
+        out.push_back((uint8_t)(k * 37));
+    }
+    out.insert(out.end(), img.begin() + img.size() / 3, img.begin() + img.size() / 2);
+    out.insert(out.end(), img.begin() + img.size() / 2 + 200, img.end());
+    for (size_t k = img.size() / 3; k < out.size(); k += 16) {
+        out[k] += 3;
+    }
+    return out;
+}
+
+static bool run(const char *name, const Image &a, const Image &b) {
+    auto t0 = std::chrono::steady_clock::now();
+    Image patch = delta_diff(a, b);
+    auto t1 = std::chrono::steady_clock::now();
+
+    uint32_t loops = 0;
+    double sec = 0;
+    g_old = &a;
+    while (sec < MIN_SEC) {
+        g_written = 0;
+        delta_patch::begin(read_old, write_new);
+        for (size_t k = 0; k < patch.size(); k += FEED_SZ) {
+            delta_patch::feed(&patch[k], (patch.size() - k < FEED_SZ) ? patch.size() - k : FEED_SZ);
+        }
+        if ((delta_patch::status() != DELTA_DONE) || (g_written != b.size())) {
+            printf("%s: patch failed (status %d)!\n", name, delta_patch::status());
+            return false;
+        }
+        loops++;
+        sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+    }
+
+    printf("  %-24s %9zu %9zu %8zu %6.2f%% %9.1f %9.1f\n", name, a.size(), b.size(), patch.size(),
+           100.0 * patch.size() / b.size(), std::chrono::duration<double, std::milli>(t1 - t0).count(),
+           (double)b.size() * loops / sec / 1e6);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    printf("Delta patch: size & apply throughput (new image MB/s, host; the node's flash is the bound)\n");
+    printf("  %-24s %9s %9s %8s %7s %9s %9s\n", "pair", "old", "new", "patch", "ratio", "diff ms", "MB/s");
+
+    if (argc < 3) {
+        Image a;
+        if (!load("/proc/self/exe", a)) {
+            return 1;
+        }
+        return run("self -> small change", a, next_build(a)) ? 0 : 1;
+    }
+    for (int k = 1; k + 1 < argc; k += 2) {
+        Image a;
+        Image b;
+        if (!load(argv[k], a) || !load(argv[k + 1], b) || !run(argv[k + 1], a, b)) {
+            return 1;
+        }
+    }
+    return 0;
+}
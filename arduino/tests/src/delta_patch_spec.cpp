@@ -0,0 +1,168 @@
+#include <vector>
+#include "delta_patch.h"
+#include "wdm_delta.h"
+#include "../../tools/wdm_delta/delta_diff.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+typedef std::vector<uint8_t> Image;
+
+static const Image *g_old;
+static Image g_new;
+static size_t g_max_read;
+static size_t g_max_write;
+static bool g_bad_offset;
+
+static bool read_old(uint32_t offset, uint8_t *buf, size_t len) {
+    g_bad_offset |= (offset % DELTA_SRC_SZ) != 0;
+    g_max_read = (len > g_max_read) ? len : g_max_read;
+    if (offset + len > g_old->size()) {
+        return false;
+    }
+    memcpy(buf, g_old->data() + offset, len);
+    return true;
+}
+
+static bool write_new(const uint8_t *buf, size_t len) {
+    g_max_write = (len > g_max_write) ? len : g_max_write;
+    g_new.insert(g_new.end(), buf, buf + len);
+    return true;
+}
+
+/* Feed 'patch' in pieces of 'piece' bytes: return the last status */
+static int8_t apply(const Image &old_img, const Image &patch, size_t piece) {
+    int8_t st = DELTA_OK;
+    g_old = &old_img;
+    g_new.clear();
+    g_max_read = g_max_write = 0;
+    g_bad_offset = false;
+    delta_patch::begin(read_old, write_new);
+    for (size_t k = 0; (k < patch.size()) && (st == DELTA_OK); k += piece) {
+        st = delta_patch::feed(&patch[k], (patch.size() - k < piece) ? patch.size() - k : piece);
+    }
+    return st;
+}
+
+/* Something like code: random words & calls to a few addresses */
+static Image image(size_t size, uint32_t seed) {
+    Image img(size);
+    for (size_t k = 0; k < size; k++) {
+        seed = seed * 1103515245 + 12345;
+        img[k] = (k % 16 < 4) ? (uint8_t)(0x40 + (k >> 10)) : (uint8_t)(seed >> 16);
+    }
+    return img;
+}
+
+/* The next build: a block inserted, one removed, the addresses after the insert moved */
+static Image next_build(const Image &img) {
+    Image out(img.begin(), img.begin() + img.size() / 3);
+    Image added = image(300, 7);
+    out.insert(out.end(), added.begin(), added.end());
+    out.insert(out.end(), img.begin() + img.size() / 3, img.begin() + img.size() / 2);
+    out.insert(out.end(), img.begin() + img.size() / 2 + 200, img.end());
+    for (size_t k = img.size() / 3; k < out.size(); k += 16) {
+        out[k] += 3;
+    }
+    return out;
+}
+
+int test_crc() {
+    IT("uses the IEEE CRC-32");
+    IS_TRUE(wdm_delta::crc32(0, (const uint8_t *)"123456789", 9) == 0xcbf43926);
+    uint32_t crc = wdm_delta::crc32(0, (const uint8_t *)"1234", 4);
+    IS_TRUE(wdm_delta::crc32(crc, (const uint8_t *)"56789", 5) == 0xcbf43926);
+    END_IT
+}
+
+int test_round_trip() {
+    IT("rebuilds the new image, whatever the piece size, with bounded blocks");
+    Image a = image(20000, 1);
+    Image b = next_build(a);
+    Image patch = delta_diff(a, b);
+    IS_TRUE(patch.size() < b.size() / 4);
+
+    static const size_t PIECES[] = { 1, 7, 512, 100000 };
+    for (size_t i = 0; i < sizeof(PIECES) / sizeof(PIECES[0]); i++) {
+        IS_TRUE(apply(a, patch, PIECES[i]) == DELTA_DONE);
+        IS_TRUE(g_new == b);
+        IS_TRUE(delta_patch::written() == b.size());
+        IS_TRUE(g_max_read <= DELTA_SRC_SZ);
+        IS_TRUE(g_max_write <= DELTA_OUT_SZ);
+        IS_FALSE(g_bad_offset);
+    }
+    END_IT
+}
+
+int test_unrelated() {
+    IT("handles unrelated & empty old images");
+    Image a = image(5000, 1);
+    Image b = image(3000, 2);
+    Image patch = delta_diff(a, b);
+    IS_TRUE(apply(a, patch, 512) == DELTA_DONE);
+    IS_TRUE(g_new == b);
+
+    Image none;
+    patch = delta_diff(none, b);
+    IS_TRUE(apply(none, patch, 512) == DELTA_DONE);
+    IS_TRUE(g_new == b);
+    END_IT
+}
+
+int test_wrong_base() {
+    IT("refuses a patch made against another image before writing");
+    Image a = image(10000, 1);
+    Image b = next_build(a);
+    Image patch = delta_diff(a, b);
+    Image other = a;
+    other[5000] ^= 1;
+
+    IS_TRUE(apply(other, patch, 512) == DELTA_E_BASE);
+    IS_TRUE(g_new.empty());
+    END_IT
+}
+
+int test_corrupt() {
+    IT("rejects corrupt patches");
+    Image a = image(10000, 1);
+    Image b = next_build(a);
+    Image patch = delta_diff(a, b);
+
+    // Header
+    Image p = patch;
+    p[0] ^= 1;
+    IS_TRUE(apply(a, p, 512) == DELTA_E_FORMAT);
+
+    // Any byte of the ops: an invalid op, or a new image which fails its CRC
+    int crc_fails = 0;
+    for (size_t k = wdm_delta::DeltaHeader::size; k < patch.size(); k++) {
+        p = patch;
+        p[k] ^= 0x10;
+        int8_t st = apply(a, p, 512);
+        IS_TRUE((st == DELTA_E_FORMAT) || (st == DELTA_E_CRC) || (st == DELTA_OK));
+        crc_fails += (st == DELTA_E_CRC);
+    }
+    IS_TRUE(crc_fails > 0);
+
+    // Op too long for the new image
+    p = Image(patch.begin(), patch.begin() + wdm_delta::DeltaHeader::size);
+    uint8_t op[] = { DELTA_OP_INSERT, 0xff, 0xff, 0x03 };
+    p.insert(p.end(), op, op + sizeof(op));
+    IS_TRUE(apply(a, p, 512) == DELTA_E_FORMAT);
+
+    // Truncated: no END
+    p = Image(patch.begin(), patch.end() - 1);
+    IS_TRUE(apply(a, p, 512) == DELTA_OK);
+    END_IT
+}
+
+int main() {
+    SUITE("Delta patch");
+
+    test_crc();
+    test_round_trip();
+    test_unrelated();
+    test_wrong_base();
+    test_corrupt();
+
+    FINISH
+}
@@ -0,0 +1,128 @@
+#include "Arduino.h"
+#include "dlog.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+static const char FMT_A[] = "\r\n%s: cnt=%u";
+static const char FMT_B[] = " -> %d";
+
+static uint32_t u32_at(const std::string &s, size_t i) {
+    return (uint8_t)s[i] | ((uint8_t)s[i + 1] << 8) | ((uint8_t)s[i + 2] << 16) | ((uint32_t)(uint8_t)s[i + 3] << 24);
+}
+
+/* Drain everything, return the frames */
+static std::string drain() {
+    Serial.output.clear();
+    Serial.tx_room = 1 << 20;
+    dlog::idle();
+    return Serial.output;
+}
+
+int test_entry_format() {
+    IT("records the format address & packed arguments");
+    dlog::init();
+    drain();
+
+    mock_time_advance(5);
+    uint32_t now = millis();
+    dlog::log(FMT_A, "abc", 7u);
+    std::string f = drain();
+
+    // [sync][len][fmt(4)][ms(4)]["abc": n(1) + 3][7(4)][sum]
+    IS_TRUE(f.size() == 1 + 9 + 4 + 4 + 1);
+    IS_TRUE((uint8_t)f[0] == DLOG_SYNC);
+    IS_TRUE((uint8_t)f[1] == 9 + 4 + 4);
+    IS_TRUE(u32_at(f, 2) == (uint32_t)(uintptr_t)FMT_A);
+    IS_TRUE(u32_at(f, 6) == now);
+    IS_TRUE(f[10] == 3);
+    IS_TRUE(f.compare(11, 3, "abc") == 0);
+    IS_TRUE(u32_at(f, 14) == 7);
+
+    uint8_t sum = 0;
+    for (size_t i = 1; i < f.size() - 1; i++) {
+        sum += f[i];
+    }
+    IS_TRUE((uint8_t)f[f.size() - 1] == sum);
+    END_IT
+}
+
+int test_deferred() {
+    IT("writes nothing to Serial until drained");
+    dlog::init();
+    drain();
+
+    Serial.output.clear();
+    DLOG(FMT_B, -1);
+    IS_TRUE(Serial.output.empty());
+    IS_TRUE(dlog::pending() == 9 + 4);
+
+    std::string f = drain();
+    IS_TRUE(u32_at(f, 10) == 0xFFFFFFFF);
+    IS_TRUE(dlog::pending() == 0);
+    END_IT
+}
+
+int test_idle_fifo() {
+    IT("only drains what the TX FIFO takes when idle");
+    dlog::init();
+    drain();
+
+    dlog::log(FMT_B, 1);
+    dlog::log(FMT_B, 2);
+    Serial.output.clear();
+    Serial.tx_room = 9 + 4 + 2;     // One frame
+    dlog::idle();
+    IS_TRUE(Serial.output.size() == 9 + 4 + 2);
+    IS_TRUE(dlog::pending() == 9 + 4);
+
+    Serial.tx_room = 0;
+    dlog::flush();
+    IS_TRUE(dlog::pending() == 0);
+    END_IT
+}
+
+int test_overflow() {
+    IT("drops the oldest entries & reports them");
+    dlog::init();
+    drain();
+
+    int n = DLOG_BUF_SZ / 13 + 5;
+    for (int i = 0; i < n; i++) {
+        dlog::log(FMT_B, i);
+    }
+    IS_TRUE(dlog::pending() <= DLOG_BUF_SZ);
+
+    std::string f = drain();
+    // First frame: lost count
+    IS_TRUE((uint8_t)f[1] == 13);
+    uint32_t lost = u32_at(f, 10);
+    IS_TRUE(lost >= 5);
+    // Then the newest entries, in order, the first one being 'lost':
+    IS_TRUE(u32_at(f, 15 + 10) == lost);
+    IS_TRUE(u32_at(f, f.size() - 5) == (uint32_t)(n - 1));
+    END_IT
+}
+
+int test_long_string() {
+    IT("truncates long strings");
+    dlog::init();
+    drain();
+
+    dlog::log("%s", "0123456789012345678901234567890123456789");
+    std::string f = drain();
+    IS_TRUE(f[10] == DLOG_STR_MAX);
+    IS_TRUE((uint8_t)f[1] == 9 + 1 + DLOG_STR_MAX);
+    END_IT
+}
+
+int main() {
+    SUITE("Deferred log");
+
+    test_entry_format();
+    test_deferred();
+    test_idle_fifo();
+    test_overflow();
+    test_long_string();
+
+    FINISH
+}
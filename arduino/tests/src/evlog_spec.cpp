@@ -0,0 +1,84 @@
+#include "Arduino.h"
+#include <vector>
+#include "FS.h"
+#include "device.h"
+#include "mtime.h"
+#include "mqtt_inf.h"
+#include "evlog.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+/* Time & MQTT doubles: record the events sent, 'g_budget' publishes accepted */
+static uint32_t g_budget;
+static std::vector<uint32_t> g_sent;
+
+uint32_t mtime::get_local_unix() { return 1790000000; }
+bool mqtt_inf::send_EVENT(int ev_cnt, const EVENT_INFO_t *ev_list) {
+    if (g_budget == 0) {
+        return false;
+    }
+    g_budget--;
+    for (int k = 0; k < ev_cnt; k++) {
+        g_sent.push_back(ev_list[k].detail);
+    }
+    return true;
+}
+
+/* Events 0..cnt-1 pushed offline: the RAM buffer spills to flash */
+static void push_offline(uint32_t cnt) {
+    SPIFFS.format();
+    evlog::init();
+    g_budget = 0;
+    g_sent.clear();
+    for (uint32_t k = 0; k < cnt; k++) {
+        evlog::push(1, k);
+    }
+}
+
+int test_spill() {
+    IT("keeps the oldest events in flash when the RAM buffer is full");
+    push_offline(EVLOG_RAM_CNT + 2 * EVLOG_BATCH_CNT);
+    IS_TRUE(evlog::count() == EVLOG_RAM_CNT + 2 * EVLOG_BATCH_CNT);
+    IS_TRUE(SPIFFS.exists("/events.bin"));
+
+    g_budget = 100;
+    while (!evlog::flush()) {
+    }
+    IS_TRUE(g_sent.size() == EVLOG_RAM_CNT + 2 * EVLOG_BATCH_CNT);
+    IS_TRUE(g_sent.front() == 0);
+    IS_TRUE(g_sent.back() == EVLOG_RAM_CNT + 2 * EVLOG_BATCH_CNT - 1);
+    IS_FALSE(SPIFFS.exists("/events.bin"));
+    END_IT
+}
+
+int test_spill_reboot() {
+    IT("doesn't send the spilled events again after a reboot");
+    push_offline(EVLOG_RAM_CNT + 3 * EVLOG_BATCH_CNT);
+
+    // One batch sent from flash, then reboot: the RAM events are lost
+    g_budget = 1;
+    IS_FALSE(evlog::flush());
+    IS_TRUE(g_sent.size() == EVLOG_BATCH_CNT);
+    g_sent.clear();
+    evlog::init();
+    IS_TRUE(evlog::count() == 2 * EVLOG_BATCH_CNT);
+    g_budget = 100;
+    while (!evlog::flush()) {
+    }
+    IS_TRUE(g_sent.size() == 2 * EVLOG_BATCH_CNT);
+    IS_TRUE(g_sent.front() == EVLOG_BATCH_CNT);
+
+    // All sent: nothing after the next reboot
+    evlog::init();
+    IS_TRUE(evlog::count() == 0);
+    IS_FALSE(SPIFFS.exists("/events.rd"));
+    END_IT
+}
+
+int main()
+{
+    SUITE("Event log");
+    test_spill();
+    test_spill_reboot();
+    FINISH
+}
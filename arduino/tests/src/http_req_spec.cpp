@@ -0,0 +1,115 @@
+#include "Arduino.h"
+#include "http_req.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+static HTTP_REQ_t g_req;
+
+/* Feed 'text' in chunks of 'chunk' bytes, return the last result */
+static int8_t feed_str(const char *text, size_t chunk) {
+    size_t len = strlen(text);
+    int8_t res = HTTP_REQ_MORE;
+
+    http_req::init(&g_req);
+    for (size_t i = 0; (i < len) && (res == HTTP_REQ_MORE); i += chunk) {
+        size_t n = (len - i < chunk) ? len - i : chunk;
+        res = http_req::feed(&g_req, (const uint8_t *)text + i, n);
+    }
+    return res;
+}
+
+int test_request() {
+    IT("parses the request-line & splits path and query");
+    const char *text = "GET /cfg?ssid=a&tz=420 HTTP/1.1\r\nHost: 192.168.4.1\r\nAccept: */*\r\n\r\n";
+    size_t chunks[] = { 1, 3, 64, 1000 };
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        IS_TRUE(feed_str(text, chunks[i]) == HTTP_REQ_DONE);
+        IS_TRUE(g_req.method == HTTP_METHOD_GET);
+        IS_TRUE(strcmp(http_req::path(&g_req), "/cfg") == 0);
+        IS_TRUE(strcmp(http_req::query(&g_req), "ssid=a&tz=420") == 0);
+        IS_TRUE(g_req.hdr_cnt == 2);
+    }
+
+    IS_TRUE(feed_str("GET / HTTP/1.0\n\n", 64) == HTTP_REQ_DONE);
+    IS_TRUE(strcmp(http_req::path(&g_req), "/") == 0);
+    IS_TRUE(strcmp(http_req::query(&g_req), "") == 0);
+
+    IS_TRUE(feed_str("POST /cfg HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_DONE);
+    IS_TRUE(g_req.method == HTTP_METHOD_OTHER);
+    END_IT
+}
+
+int test_incomplete() {
+    IT("waits for the end of the headers");
+    IS_TRUE(feed_str("GET /cfg HTTP/1.1\r\nHost: x\r\n", 64) == HTTP_REQ_MORE);
+    IS_TRUE(http_req::feed(&g_req, (const uint8_t *)"\r", 1) == HTTP_REQ_MORE);
+    IS_TRUE(http_req::feed(&g_req, (const uint8_t *)"\nbody", 5) == HTTP_REQ_DONE);
+    END_IT
+}
+
+int test_malformed() {
+    IT("rejects malformed request-lines");
+    IS_TRUE(feed_str("get / HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET  / HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET cfg HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET /\x01 HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET / HTTP/1.1\rX\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET / FTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    IS_TRUE(feed_str("GET / HTTP/2.0\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 505);
+    IS_TRUE(feed_str("PROPPATCH / HTTP/1.1\r\n\r\n", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 501);
+    END_IT
+}
+
+int test_limits() {
+    IT("limits the target & headers");
+    static char text[4096];
+
+    strcpy(text, "GET /");
+    memset(text + 5, 'a', HTTP_REQ_TARGET_SZ);
+    strcpy(text + 5 + HTTP_REQ_TARGET_SZ, " HTTP/1.1\r\n\r\n");
+    IS_TRUE(feed_str(text, 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 414);
+
+    strcpy(text, "GET / HTTP/1.1\r\nX: ");
+    memset(text + 19, 'a', HTTP_REQ_HDR_LINE_MAX);
+    strcpy(text + 19 + HTTP_REQ_HDR_LINE_MAX, "\r\n\r\n");
+    IS_TRUE(feed_str(text, 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 431);
+
+    strcpy(text, "GET / HTTP/1.1\r\n");
+    for (int i = 0; i <= HTTP_REQ_HDR_CNT; i++) {
+        strcat(text, "X: 1\r\n");
+    }
+    strcat(text, "\r\n");
+    IS_TRUE(feed_str(text, 64) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 431);
+    END_IT
+}
+
+int test_error_stops() {
+    IT("ignores bytes after an error");
+    IS_TRUE(feed_str("GET x", 64) == HTTP_REQ_ERROR);
+    IS_TRUE(http_req::feed(&g_req, (const uint8_t *)" HTTP/1.1\r\n\r\n", 13) == HTTP_REQ_ERROR);
+    IS_TRUE(g_req.status == 400);
+    END_IT
+}
+
+int main() {
+    SUITE("HTTP request parser");
+
+    test_request();
+    test_incomplete();
+    test_malformed();
+    test_limits();
+    test_error_stops();
+
+    FINISH
+}
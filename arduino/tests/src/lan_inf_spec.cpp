@@ -0,0 +1,147 @@
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <wdm_proto.h>
+#include <wdm_siphash.h>
+#include "device.h"
+#include "mtime.h"
+#include "rules.h"
+#include "wifi_inf.h"
+#include "lan_inf.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using namespace wdm_proto;
+
+static const uint8_t NODE_ID[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x0a, 0x0b, 0x0c };
+static const char *SECURITY = "wdm-secret";
+static const uint32_t NOW = 1790000000;
+
+/* Device, time, settings & rules doubles: g_now is the local time (UTC + timezone) */
+static DEVICE_INFO_t g_devs[2];
+static int g_control_calls;
+static uint32_t g_now;
+static ROM_SETTINGS_t g_settings;
+
+uint8_t device::count() { return 2; }
+const DEVICE_INFO_t *device::get_status() { return g_devs; }
+void device::control_mask(uint16_t mask, uint16_t cmds) { g_control_calls++; }
+uint8_t mtime::is_valid() { return (g_now != 0) ? 1 : 0; }
+uint32_t mtime::get_local_unix() { return g_now; }
+const ROM_SETTINGS_t *wifi_inf::get_settings() { return &g_settings; }
+uint8_t rules::sample(const uint8_t th_id[], uint8_t offset, int32_t value) { return 0; }
+
+/* A signed packet from the LAN */
+static std::string packet(const uint8_t id[], uint32_t seq, uint8_t opcode) {
+    uint8_t arr[64];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    w.put<UdpHeader>(UDP_MARKER, seq, id, opcode);
+    if (opcode == 'd') {
+        w.put<UdpCommand>(1, 1);
+    } else {
+        w.put<UdpCount>(0);
+    }
+    size_t n = w.length();
+    wdm_siphash::sign(wdm_siphash::derive(SECURITY), arr, n, w.reserve(UDP_FCS_SZ));
+    return std::string((const char *)arr, w.length());
+}
+
+/* Deliver a command: true if it was executed */
+static bool command(uint32_t seq) {
+    int calls = g_control_calls;
+    WiFiUDP::inbox.push_back(packet(NODE_ID, seq, 'd'));
+    lan_inf::manager();
+    return g_control_calls == calls + 1;
+}
+
+/* One boot of the node, 'now' = 0: time not synchronized yet */
+static void boot(uint32_t now) {
+    g_now = now;
+    memcpy(WiFi.mac_addr, NODE_ID, WDM_ID_SZ);
+    WiFi.wl_status = WL_CONNECTED;
+    WiFiUDP::inbox.clear();
+    lan_inf::start(SECURITY);
+    lan_inf::manager();
+}
+
+int test_command_once() {
+    IT("executes a signed command once");
+    boot(NOW);
+    IS_TRUE(command(NOW));
+    IS_FALSE(command(NOW));
+    IS_TRUE(command(NOW + 1));
+    IS_FALSE(command(NOW));
+
+    // Unsigned:
+    std::string pkt = packet(NODE_ID, NOW + 2, 'd');
+    pkt[pkt.size() - 1] ^= 1;
+    WiFiUDP::inbox.push_back(pkt);
+    int calls = g_control_calls;
+    lan_inf::manager();
+    IS_TRUE(g_control_calls == calls);
+    END_IT
+}
+
+int test_command_slot() {
+    IT("keeps the sequence of the commands when other senders fill the table");
+    boot(NOW);
+    IS_TRUE(command(NOW));
+
+    // Sensor packets of the local links (e.g. the ESP-NOW gateway): twice the table
+    for (uint8_t k = 0; k < 2 * LAN_PEER_CNT; k++) {
+        uint8_t id[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x01, 0x00, k };
+        std::string pkt = packet(id, 1, 0x02);
+        IS_TRUE(lan_inf::verify((const uint8_t *)pkt.data(), pkt.size()));
+    }
+    IS_FALSE(command(NOW));
+    END_IT
+}
+
+int test_command_window() {
+    IT("drops a captured command after a reboot, once the time is synchronized");
+    boot(NOW);
+    IS_TRUE(command(NOW - 10));
+
+    // Reboot: the sequence is lost, the command is only accepted within the window
+    boot(NOW + 60);
+    IS_TRUE(command(NOW - 10));
+    boot(NOW + LAN_CMD_WINDOW_S);
+    IS_FALSE(command(NOW - 10));
+    IS_TRUE(command(NOW + LAN_CMD_WINDOW_S));
+
+    // Before the time is known, only the sequence is checked
+    boot(0);
+    IS_TRUE(command(NOW - 10));
+    IS_FALSE(command(NOW - 10));
+    END_IT
+}
+
+int test_command_timezone() {
+    IT("compares the command time with UTC, not the local time");
+    // UTC+7: the local time is 7 h ahead of the sender
+    g_settings.timezone = 7 * 60;
+    boot(NOW + 7 * 3600);
+    IS_TRUE(command(NOW - 10));
+    boot(NOW + 7 * 3600 + LAN_CMD_WINDOW_S);
+    IS_FALSE(command(NOW - 10));
+
+    // UTC-7: the window doesn't grow by 7 h
+    g_settings.timezone = -7 * 60;
+    boot(NOW - 7 * 3600);
+    IS_TRUE(command(NOW - 10));
+    boot(NOW - 7 * 3600 + LAN_CMD_WINDOW_S);
+    IS_FALSE(command(NOW - 10));
+    IS_TRUE(command(NOW + LAN_CMD_WINDOW_S));
+    g_settings.timezone = 0;
+    END_IT
+}
+
+int main()
+{
+    SUITE("lan_inf");
+    test_command_once();
+    test_command_slot();
+    test_command_window();
+    test_command_timezone();
+    FINISH
+}
@@ -0,0 +1,95 @@
+/** @brief host mock of the ESP8266 Arduino core: only what the tested sketch modules use.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include "Print.h"           // PubSubClient test library (BDD_PATH)
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH                0x1
+#define LOW                 0x0
+#define INPUT               0x00
+#define OUTPUT              0x01
+#define INPUT_PULLUP        0x02
+
+#define PROGMEM
+#define PSTR(s)             (s)
+#define F(s)                (s)
+#define pgm_read_byte(p)    (*(const uint8_t *)(p))
+#define pgm_read_byte_near(p) pgm_read_byte(p)
+#define ICACHE_RAM_ATTR
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void noInterrupts();
+void interrupts();
+
+/* Move the virtual clock */
+void mock_time_advance(uint32_t ms);
+
+class HardwareSerial
+{
+    public:
+        void begin(unsigned long) {}
+        /* Output is printed only when the TRACE environment variable is set */
+        int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+        size_t print(const char *s) { return printf("%s", s); }
+        size_t println(const char *s) { return printf("%s\r\n", s); }
+        int available() { return 0; }
+        int read() { return -1; }
+        int availableForWrite() { return tx_room; }
+        size_t write(const uint8_t *buf, size_t n) {
+            output.append((const char *)buf, n);
+            tx_room = ((int)n < tx_room) ? tx_room - (int)n : 0;
+            return n;
+        }
+        void flush() {}
+
+        /* Mock state: what was written (write() only), free space of the TX FIFO */
+        std::string output;
+        int tx_room = 128;
+};
+extern HardwareSerial Serial;
+
+#define RTC_USER_MEM_SZ     512
+
+#define WAKE_RF_DEFAULT     0
+#define WAKE_RF_DISABLED    4
+
+class EspClass
+{
+    public:
+        bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+        bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+        void deepSleep(uint64_t us, int mode = WAKE_RF_DEFAULT);
+        void restart();
+        uint32_t getFreeHeap() { return 32768; }
+
+        /* Mock state: RTC user memory survives restart()/deepSleep(), not power_on() */
+        void power_on();
+        uint8_t rtc_mem[RTC_USER_MEM_SZ];
+        uint32_t rtc_read_cnt;
+        uint32_t rtc_write_cnt;
+        uint32_t rtc_write_bytes;
+        uint64_t sleep_us;
+        uint32_t restart_cnt;
+};
+extern EspClass ESP;
+
+#endif // Arduino_h
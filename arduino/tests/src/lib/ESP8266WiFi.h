@@ -0,0 +1,26 @@
+/** @brief host mock of the ESP8266WiFi library.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef ESP8266WiFi_h
+#define ESP8266WiFi_h
+
+#include "Arduino.h"
+#include "IPAddress.h"      // PubSubClient test library (BDD_PATH)
+
+#define WL_CONNECTED        3
+
+class ESP8266WiFiClass
+{
+    public:
+        uint8_t *macAddress(uint8_t *mac) { memcpy(mac, mac_addr, 6); return mac; }
+        uint8_t status() { return wl_status; }
+        IPAddress localIP() { return IPAddress(192, 168, 1, 2); }
+
+        /* Mock state */
+        uint8_t mac_addr[6];
+        uint8_t wl_status;
+};
+extern ESP8266WiFiClass WiFi;
+
+#endif // ESP8266WiFi_h
@@ -0,0 +1,56 @@
+/** @brief host mock of the SPIFFS file system: files are kept in memory.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef FS_h
+#define FS_h
+
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <memory>
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File
+{
+    public:
+        File() : _pos(0), _wr(false) {}
+        File(std::shared_ptr<std::string> data, bool wr, bool append)
+            : _data(data), _pos(append ? data->size() : 0), _wr(wr) {}
+
+        operator bool() const { return (bool)_data; }
+        size_t size() const { return _data ? _data->size() : 0; }
+        size_t position() const { return _pos; }
+        bool seek(uint32_t pos, SeekMode mode = SeekSet);
+        int available() { return _data ? (int)(_data->size() - _pos) : 0; }
+        int read();
+        size_t read(uint8_t *buf, size_t size);
+        size_t readBytes(char *buf, size_t size) { return read((uint8_t *)buf, size); }
+        size_t write(uint8_t c) { return write(&c, 1); }
+        size_t write(const uint8_t *buf, size_t size);
+        void flush() {}
+        void close() { _data.reset(); }
+
+    private:
+        std::shared_ptr<std::string> _data;
+        size_t _pos;
+        bool _wr;
+};
+
+class FS
+{
+    public:
+        bool begin() { return true; }
+        File open(const char *path, const char *mode);
+        bool exists(const char *path) { return _files.count(path) != 0; }
+        bool remove(const char *path) { return _files.erase(path) != 0; }
+        bool rename(const char *from, const char *to);
+        bool format() { _files.clear(); return true; }
+
+        /* Mock state */
+        std::map<std::string, std::shared_ptr<std::string> > _files;
+};
+extern FS SPIFFS;
+
+#endif // FS_h
@@ -0,0 +1,179 @@
+/** @brief implement the host mock of the ESP8266 Arduino core.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#include <stdarg.h>
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "FS.h"
+#include "WiFiUdp.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+ESP8266WiFiClass WiFi;
+FS SPIFFS;
+
+static uint64_t g_time_us;
+
+///////////////////////////////////////CORE////////////////////////////////////////////////////////
+uint32_t millis() { return (uint32_t)(g_time_us / 1000); }
+uint32_t micros() { return (uint32_t)g_time_us; }
+void delay(uint32_t ms) { g_time_us += (uint64_t)ms * 1000; }
+void yield() {}
+void mock_time_advance(uint32_t ms) { g_time_us += (uint64_t)ms * 1000; }
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void noInterrupts() {}
+void interrupts() {}
+
+int HardwareSerial::printf(const char *fmt, ...)
+{
+    if (!getenv("TRACE")) {
+        return 0;
+    }
+    va_list ap;
+    va_start(ap, fmt);
+    int ret = vprintf(fmt, ap);
+    va_end(ap);
+    return ret;
+}
+
+///////////////////////////////////////ESP/////////////////////////////////////////////////////////
+/* Same limits as the core: offset is in 4-byte blocks, the size must fit in the 512 bytes */
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size)
+{
+    if ((offset * 4 + size > RTC_USER_MEM_SZ) || (size & 3)) {
+        return false;
+    }
+    memcpy(data, &rtc_mem[offset * 4], size);
+    rtc_read_cnt++;
+    return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size)
+{
+    if ((offset * 4 + size > RTC_USER_MEM_SZ) || (size & 3)) {
+        return false;
+    }
+    memcpy(&rtc_mem[offset * 4], data, size);
+    rtc_write_cnt++;
+    rtc_write_bytes += size;
+    return true;
+}
+
+void EspClass::deepSleep(uint64_t us, int)
+{
+    sleep_us = us;
+}
+
+void EspClass::restart()
+{
+    restart_cnt++;
+}
+
+void EspClass::power_on()
+{
+    // RTC memory content is random after power on
+    for (int i = 0; i < RTC_USER_MEM_SZ; i++) {
+        rtc_mem[i] = (uint8_t)rand();
+    }
+    rtc_read_cnt = rtc_write_cnt = rtc_write_bytes = 0;
+    sleep_us = 0;
+    restart_cnt = 0;
+}
+
+///////////////////////////////////////WIFI UDP////////////////////////////////////////////////////
+std::deque<std::string> WiFiUDP::inbox;
+std::vector<std::string> WiFiUDP::sent;
+
+int WiFiUDP::parsePacket()
+{
+    if (inbox.empty()) {
+        return 0;
+    }
+    _rx = inbox.front();
+    inbox.pop_front();
+    return (int)_rx.size();
+}
+
+int WiFiUDP::read(uint8_t *buf, size_t size)
+{
+    if (size > _rx.size()) {
+        size = _rx.size();
+    }
+    memcpy(buf, _rx.data(), size);
+    _rx.erase(0, size);
+    return (int)size;
+}
+
+///////////////////////////////////////SPIFFS//////////////////////////////////////////////////////
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    if (mode == SeekCur) {
+        pos += _pos;
+    } else if (mode == SeekEnd) {
+        pos = _data ? _data->size() - pos : 0;
+    }
+    if (!_data || pos > _data->size()) {
+        return false;
+    }
+    _pos = pos;
+    return true;
+}
+
+int File::read()
+{
+    uint8_t c;
+    return (read(&c, 1) == 1) ? c : -1;
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    if (!_data || _pos >= _data->size()) {
+        return 0;
+    }
+    if (size > _data->size() - _pos) {
+        size = _data->size() - _pos;
+    }
+    memcpy(buf, _data->data() + _pos, size);
+    _pos += size;
+    return size;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    if (!_data || !_wr) {
+        return 0;
+    }
+    if (_pos + size > _data->size()) {
+        _data->resize(_pos + size);
+    }
+    memcpy(&(*_data)[_pos], buf, size);
+    _pos += size;
+    return size;
+}
+
+File FS::open(const char *path, const char *mode)
+{
+    std::map<std::string, std::shared_ptr<std::string> >::iterator it = _files.find(path);
+    if (mode[0] == 'r') {
+        return (it == _files.end()) ? File() : File(it->second, mode[1] == '+', false);
+    }
+    if ((it == _files.end()) || (mode[0] == 'w')) {
+        _files[path] = std::make_shared<std::string>();
+    }
+    return File(_files[path], true, mode[0] == 'a');
+}
+
+bool FS::rename(const char *from, const char *to)
+{
+    std::map<std::string, std::shared_ptr<std::string> >::iterator it = _files.find(from);
+    if (it == _files.end()) {
+        return false;
+    }
+    _files[to] = it->second;
+    _files.erase(it);
+    return true;
+}
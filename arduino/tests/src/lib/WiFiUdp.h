@@ -0,0 +1,36 @@
+/** @brief host mock of the WiFiUdp library: the datagrams go through queues of the mock, shared
+ *  by all the sockets.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include <deque>
+#include <vector>
+
+class WiFiUDP
+{
+    public:
+        uint8_t beginMulticast(IPAddress, IPAddress, uint16_t) { return 1; }
+        int beginPacket(IPAddress, uint16_t) { _tx.clear(); return 1; }
+        int beginPacketMulticast(IPAddress, uint16_t, IPAddress) { _tx.clear(); return 1; }
+        size_t write(const uint8_t *buf, size_t size) { _tx.append((const char *)buf, size); return size; }
+        int endPacket() { sent.push_back(_tx); return 1; }
+        int parsePacket();
+        int read(uint8_t *buf, size_t size);
+        IPAddress remoteIP() { return IPAddress(192, 168, 1, 10); }
+        uint16_t remotePort() { return 40000; }
+
+        /* Mock state: datagrams to receive, datagrams sent */
+        static std::deque<std::string> inbox;
+        static std::vector<std::string> sent;
+
+    private:
+        std::string _tx;
+        std::string _rx;
+};
+
+#endif // WiFiUdp_h
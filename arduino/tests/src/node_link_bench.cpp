@@ -0,0 +1,65 @@
+/* Cost of the node protocol on top of any transport: one STATUS + its ACK through the loopback
+transport (packet, SipHash FCS & check at both ends), for a few device counts. The time on air
+is the transport's; this is the CPU time the node spends per report. Build & run: make bench */
+#include <stdio.h>
+#include <chrono>
+#include "Arduino.h"
+#include "rtc_mem.h"
+#include "node_link.h"
+#include "transport_loop.h"
+#include "wdm_proto.h"
+#include "wdm_siphash.h"
+
+#define LOOPS           200000
+
+using namespace wdm_proto;
+
+static const uint8_t ID[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+static wdm_siphash::Key g_key;
+static size_t g_len;
+
+/* Gateway: check the packet & ACK it */
+static void peer(const uint8_t *frame, size_t len) {
+    g_len = len;
+    if (!wdm_siphash::verify(g_key, frame, len - UDP_FCS_SZ, &frame[len - UDP_FCS_SZ])) {
+        return;
+    }
+    wdm_frame::View<UdpHeader> hdr(frame, len - UDP_FCS_SZ);
+    uint8_t arr[UdpHeader::size + UdpAck::size + UDP_FCS_SZ];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    w.put<UdpHeader>(0xa8, hdr.get<UDP_HDR_SEQ>(), ID, 0x02);
+    w.put<UdpAck>(hdr.get<UDP_HDR_SEQ>(), hdr.get<UDP_HDR_OPCODE>());
+    size_t n = w.length();
+    wdm_siphash::sign(g_key, arr, n, w.reserve(UDP_FCS_SZ));
+    transport_loop::inject(arr, w.length());
+}
+
+int main() {
+    static const int DEV_CNT[] = { 1, 4, 10 };
+    DEVICE_INFO_t dev[10];
+
+    ESP.power_on();
+    rtc_mem::reset();
+    node_link::init(ID, "wdm-secret");
+    g_key = wdm_siphash::derive("wdm-secret");
+    transport_loop::setup(peer);
+    memset(dev, 0, sizeof(dev));
+
+    printf("STATUS + ACK over the loopback transport\n");
+    printf("  %4s %7s %10s\n", "devs", "bytes", "ns/report");
+    for (size_t i = 0; i < sizeof(DEV_CNT) / sizeof(DEV_CNT[0]); i++) {
+        uint32_t acked = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t n = 0; n < LOOPS; n++) {
+            acked += node_link::send_STATUS(&transport_loop::ops, DEV_CNT[i], dev);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        if (acked != LOOPS) {
+            printf("%u reports not ACKed!\n", LOOPS - acked);
+            return 1;
+        }
+        printf("  %4d %7zu %10.0f\n", DEV_CNT[i], g_len,
+               std::chrono::duration<double, std::nano>(t1 - t0).count() / LOOPS);
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "Arduino.h"
+#include "FS.h"
+#include "rtc_mem.h"
+#include "node_link.h"
+#include "transport_loop.h"
+#include "wdm_proto.h"
+#include "wdm_siphash.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using namespace wdm_proto;
+
+static const uint8_t ID[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+static const char *SECURITY = "wdm-secret";
+
+/* The other end (a gateway): ACK every STATUS, or answer what the test asks for */
+enum { PEER_ACK, PEER_ACK_OTHER_SEQ, PEER_ACK_BAD_FCS };
+static uint8_t g_peer_mode;
+static uint32_t g_peer_seq;
+static bool g_peer_fcs_ok;
+
+static void peer(const uint8_t *frame, size_t len) {
+    wdm_siphash::Key key = wdm_siphash::derive(SECURITY);
+    wdm_frame::View<UdpHeader> hdr(frame, len - UDP_FCS_SZ);
+    g_peer_seq = hdr.get<UDP_HDR_SEQ>();
+    g_peer_fcs_ok = wdm_siphash::verify(key, frame, len - UDP_FCS_SZ, &frame[len - UDP_FCS_SZ]);
+
+    uint8_t arr[UdpHeader::size + UdpAck::size + UDP_FCS_SZ];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    w.put<UdpHeader>(0xa8, 1, ID, 0x02);
+    w.put<UdpAck>(g_peer_seq + ((g_peer_mode == PEER_ACK_OTHER_SEQ) ? 1 : 0), hdr.get<UDP_HDR_OPCODE>());
+    size_t n = w.length();
+    wdm_siphash::sign(key, arr, n, w.reserve(UDP_FCS_SZ));
+    if (g_peer_mode == PEER_ACK_BAD_FCS) {
+        arr[sizeof(arr) - 1] ^= 1;
+    }
+    transport_loop::inject(arr, w.length());
+}
+
+/* One wake-up of the node */
+static void boot() {
+    rtc_mem::reset();
+    node_link::init(ID, SECURITY);
+}
+
+static DEVICE_INFO_t dev() {
+    DEVICE_INFO_t d;
+    memset(&d, 0, sizeof(d));
+    d.offset = 1;
+    d.type = DEV_TYPE_TEMPERATURE;
+    d.v = 253;
+    return d;
+}
+
+int test_ack() {
+    IT("sends a signed STATUS & takes its ACK");
+    ESP.power_on();
+    boot();
+    DEVICE_INFO_t d = dev();
+    g_peer_mode = PEER_ACK;
+    transport_loop::setup(peer);
+
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    IS_TRUE(g_peer_fcs_ok);
+    IS_TRUE(transport_loop::sent() == 1);
+    END_IT
+}
+
+int test_wrong_ack() {
+    IT("ignores the ACK of another packet & unsigned ACKs");
+    ESP.power_on();
+    boot();
+    DEVICE_INFO_t d = dev();
+    transport_loop::setup(peer);
+
+    g_peer_mode = PEER_ACK_OTHER_SEQ;
+    IS_FALSE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    g_peer_mode = PEER_ACK_BAD_FCS;
+    IS_FALSE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    g_peer_mode = PEER_ACK;
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    END_IT
+}
+
+int test_lost() {
+    IT("fails when the packet is lost");
+    ESP.power_on();
+    boot();
+    DEVICE_INFO_t d = dev();
+    g_peer_mode = PEER_ACK;
+    transport_loop::setup(peer, 2);
+
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    IS_FALSE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    IS_TRUE(transport_loop::dropped() == 1);
+    IS_TRUE(transport_loop::ops.quality() == 50);
+    END_IT
+}
+
+int test_sequence() {
+    IT("keeps the sequence increasing across sleeps & power losses");
+    SPIFFS.format();
+    ESP.power_on();
+    boot();
+    DEVICE_INFO_t d = dev();
+    g_peer_mode = PEER_ACK;
+    transport_loop::setup(peer);
+
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    uint32_t s1 = g_peer_seq;
+
+    // Deep sleep: from RTC memory
+    rtc_mem::store();
+    boot();
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    IS_TRUE(g_peer_seq == s1 + 1);
+
+    // Power loss: after the block reserved in flash
+    ESP.power_on();
+    boot();
+    IS_TRUE(node_link::send_STATUS(&transport_loop::ops, 1, &d));
+    IS_TRUE(g_peer_seq > s1 + 1);
+    IS_TRUE(g_peer_seq >= LINK_SEQ_BLOCK);
+    END_IT
+}
+
+int main() {
+    SUITE("Node link");
+
+    test_ack();
+    test_wrong_ack();
+    test_lost();
+    test_sequence();
+
+    FINISH
+}
@@ -0,0 +1,73 @@
+#include "Arduino.h"
+#include "perf.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+int test_buckets() {
+    IT("puts samples in log2 buckets");
+    IS_TRUE(perf::bucket(0) == 0);
+    IS_TRUE(perf::bucket(63) == 0);
+    IS_TRUE(perf::bucket(64) == 1);
+    IS_TRUE(perf::bucket(127) == 1);
+    IS_TRUE(perf::bucket(128) == 2);
+    IS_TRUE(perf::bucket(1000) == 4);
+    IS_TRUE(perf::bucket(0xFFFFFFFF) == PERF_BUCKET_CNT - 1);
+    END_IT
+}
+
+int test_add() {
+    IT("counts samples, max & sum");
+    perf::reset();
+    perf::add(PERF_LOOP, 100);
+    perf::add(PERF_LOOP, 3000000);
+    const PERF_HIST_t *p = perf::get(PERF_LOOP);
+    IS_TRUE(p->count == 2);
+    IS_TRUE(p->max == 3000000);
+    IS_TRUE(p->sum == 3000100);
+    IS_TRUE(p->buckets[1] == 1);
+    IS_TRUE(p->buckets[PERF_BUCKET_CNT - 1] == 1);
+    IS_TRUE(perf::get(PERF_PUBLISH)->count == 0);
+    END_IT
+}
+
+int test_start_end() {
+    IT("measures a probe between start() & end()");
+    perf::reset();
+    perf::end(PERF_CMD);
+    IS_TRUE(perf::get(PERF_CMD)->count == 0);
+
+    perf::start(PERF_CMD);
+    mock_time_advance(5);
+    perf::end(PERF_CMD);
+    perf::end(PERF_CMD);
+    IS_TRUE(perf::get(PERF_CMD)->count == 1);
+    IS_TRUE(perf::get(PERF_CMD)->max == 5000);
+
+    perf::start(PERF_CMD);
+    perf::cancel(PERF_CMD);
+    perf::end(PERF_CMD);
+    IS_TRUE(perf::get(PERF_CMD)->count == 1);
+    END_IT
+}
+
+int test_saturation() {
+    IT("saturates bucket counts");
+    perf::reset();
+    for (int i = 0; i < 70000; i++) {
+        perf::add(PERF_MQTT_LOOP, 10);
+    }
+    IS_TRUE(perf::get(PERF_MQTT_LOOP)->buckets[0] == 0xFFFF);
+    IS_TRUE(perf::get(PERF_MQTT_LOOP)->count == 70000);
+    END_IT
+}
+
+int main() {
+    SUITE("Performance probes");
+
+    test_buckets();
+    test_add();
+    test_start_end();
+    test_saturation();
+
+    FINISH
+}
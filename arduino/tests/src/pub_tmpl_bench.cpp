@@ -0,0 +1,96 @@
+/* Cost of one STATUS publish (10 devices) up to the network client: the frame built on the stack
+& PubSubClient::publish() (strlen, topic & payload copied into its buffer, header) vs the publish
+template (data written in place, one write). The client only counts the bytes.
+Build & run: make bench */
+#include <stdio.h>
+#include <chrono>
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "PubSubClient.h"
+#include "pub_tmpl.h"
+#include "wdm_proto.h"
+
+#define LOOPS           1000000
+#define DEV_CNT         10
+#define TOPIC_SZ        32
+
+using namespace wdm_proto;
+
+class SinkClient : public Client
+{
+    public:
+        size_t bytes = 0;
+        uint32_t writes = 0;
+        int connect(IPAddress ip, uint16_t port) { return 1; }
+        int connect(const char *host, uint16_t port) { return 1; }
+        size_t write(uint8_t b) { bytes++; writes++; return 1; }
+        size_t write(const uint8_t *buf, size_t size) { bytes += size; writes++; return size; }
+        int available() { return 0; }
+        int read() { return -1; }
+        int read(uint8_t *buf, size_t size) { return -1; }
+        int peek() { return -1; }
+        void flush() {}
+        void stop() {}
+        uint8_t connected() { return 1; }
+        operator bool() { return true; }
+};
+
+static const char *TOPIC = "wdm/dev/pub/5ccf7f010203";
+
+/* The frame of each device */
+static void put_devices(wdm_frame::Writer &w) {
+    uint8_t *p_cnt = w.put<MqttCount>(0);
+    for (uint8_t k = 0; k < DEV_CNT; k++) {
+        w.put<MqttDeviceStatus>(k + 1, 1, 0, 0, k & 1, 1760000000);
+    }
+    MqttCount::put(p_cnt, DEV_CNT);
+}
+
+static bool send_publish(PubSubClient &client) {
+    uint8_t arr[MqttHeader::size + MqttCount::size + DEV_CNT * MqttDeviceStatus::size];
+    uint8_t id[8];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    w.put<MqttHeader>(0x01, 0x42, WiFi.macAddress(id));
+    put_devices(w);
+    return client.publish(TOPIC, arr, w.length(), true);
+}
+
+static bool send_template(PubSubClient &client, PUB_TMPL_t *t) {
+    wdm_frame::Writer w(pub_tmpl::data(t), pub_tmpl::data_max(t));
+    put_devices(w);
+    return pub_tmpl::send(client, t, w.length());
+}
+
+template <typename F> static double run(const char *name, SinkClient &sink, F send) {
+    sink.bytes = sink.writes = 0;
+    uint32_t ok = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < LOOPS; n++) {
+        ok += send();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / LOOPS;
+    printf("  %-10s %7.1f ns/publish, %zu bytes & %u writes/publish%s\n", name, ns,
+           sink.bytes / LOOPS, sink.writes / LOOPS, (ok == LOOPS) ? "" : " (FAILED)");
+    return ns;
+}
+
+int main() {
+    static uint8_t buf[PUB_TMPL_SIZE(TOPIC_SZ, MqttHeader::size + MqttCount::size + DEV_CNT * MqttDeviceStatus::size)];
+    static const uint8_t MAC[6] = { 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+    SinkClient sink;
+    PubSubClient client(sink);
+    PUB_TMPL_t t;
+    uint8_t prefix[MqttHeader::size];
+
+    memcpy(WiFi.mac_addr, MAC, 6);
+    client.setServer("127.0.0.1", 1883);
+    MqttHeader::put(prefix, 0x01, 0x42, MAC);
+    pub_tmpl::init(&t, buf, sizeof(buf), TOPIC, prefix, sizeof(prefix), true);
+
+    printf("STATUS publish, %u devices\n", DEV_CNT);
+    double a = run("publish", sink, [&]() { return send_publish(client); });
+    double b = run("template", sink, [&]() { return send_template(client, &t); });
+    printf("template vs publish: %.2fx faster\n", a / b);
+    return 0;
+}
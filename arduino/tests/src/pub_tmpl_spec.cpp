@@ -0,0 +1,168 @@
+#include "Arduino.h"
+#include "PubSubClient.h"
+#include "ShimClient.h"
+#include "pub_tmpl.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+static const char *TOPIC = "wdm/dev/pub/5ccf7f010203";
+static const uint8_t PREFIX[] = { 0x01, 0x42, 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+
+static byte server[] = { 172, 16, 0, 2 };
+
+static void connect(ShimClient &shim, PubSubClient &client) {
+    byte connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    shim.setAllowConnect(true);
+    shim.respond(connack, 4);
+    client.connect("wdm-test");
+}
+
+/* Expect the packet PubSubClient::publish() makes of the same message (false if the library
+   doesn't make that one). QoS1: the first msgId of a new connection, 2 */
+static bool expect_publish(ShimClient &shim, const uint8_t *data, size_t len, bool retained,
+                           uint8_t qos = 0) {
+    static uint8_t payload[512];
+    static uint8_t packet[600];
+    memcpy(payload, PREFIX, sizeof(PREFIX));
+    memcpy(&payload[sizeof(PREFIX)], data, len);
+
+    ShimClient ref;
+    PubSubClient client(server, 1883, ref);
+    connect(ref, client);
+    size_t pos = 0;
+    size_t rl = 2 + strlen(TOPIC) + ((qos == 1) ? 2 : 0) + sizeof(PREFIX) + len;
+    packet[pos++] = 0x30 | (retained ? 1 : 0) | ((qos == 1) ? 2 : 0);
+    if (rl < 0x80) {
+        packet[pos++] = rl;
+    } else {
+        packet[pos++] = (rl & 0x7f) | 0x80;
+        packet[pos++] = rl >> 7;
+    }
+    packet[pos++] = 0;
+    packet[pos++] = strlen(TOPIC);
+    memcpy(&packet[pos], TOPIC, strlen(TOPIC));
+    pos += strlen(TOPIC);
+    if (qos == 1) {
+        packet[pos++] = 0;
+        packet[pos++] = 2;
+    }
+    memcpy(&packet[pos], payload, sizeof(PREFIX) + len);
+    pos += sizeof(PREFIX) + len;
+
+    // Same bytes as the library's own encoder
+    ref.expect(packet, pos);
+    client.publish(TOPIC, payload, sizeof(PREFIX) + len, retained, qos);
+    shim.expect(packet, pos);
+    return !ref.error();
+}
+
+int test_short() {
+    IT("sends the same packet as publish(), 1-byte remaining length");
+    static uint8_t buf[PUB_TMPL_SIZE(32, 8 + 64)];
+    PUB_TMPL_t t;
+    ShimClient shim;
+    PubSubClient client(server, 1883, shim);
+    connect(shim, client);
+
+    IS_TRUE(pub_tmpl::init(&t, buf, sizeof(buf), TOPIC, PREFIX, sizeof(PREFIX), true));
+    // The topic room left unused, less the msgId room (QoS1 only, unused here)
+    IS_TRUE(pub_tmpl::data_max(&t) == 64 + 32 - strlen(TOPIC) + 2);
+    uint8_t data[] = { 1, 2, 3, 4, 5 };
+    memcpy(pub_tmpl::data(&t), data, sizeof(data));
+    IS_TRUE(expect_publish(shim, data, sizeof(data), true));
+    IS_TRUE(pub_tmpl::send(client, &t, sizeof(data)));
+    IS_FALSE(shim.error());
+
+    // Again, shorter: only the length changes
+    IS_TRUE(expect_publish(shim, data, 2, true));
+    IS_TRUE(pub_tmpl::send(client, &t, 2));
+    IS_FALSE(shim.error());
+
+    // Not retained
+    pub_tmpl::set_retained(&t, false);
+    IS_TRUE(expect_publish(shim, data, 2, false));
+    IS_TRUE(pub_tmpl::send(client, &t, 2));
+    IS_FALSE(shim.error());
+    END_IT
+}
+
+int test_long() {
+    IT("sends the same packet as publish(), 2-byte remaining length");
+    static uint8_t buf[PUB_TMPL_SIZE(32, 8 + 300)];
+    PUB_TMPL_t t;
+    ShimClient shim;
+    PubSubClient client(server, 1883, shim);
+    connect(shim, client);
+
+    IS_TRUE(pub_tmpl::init(&t, buf, sizeof(buf), TOPIC, PREFIX, sizeof(PREFIX)));
+    uint8_t data[200];
+    for (size_t k = 0; k < sizeof(data); k++) {
+        data[k] = k;
+    }
+    memcpy(pub_tmpl::data(&t), data, sizeof(data));
+    IS_TRUE(expect_publish(shim, data, sizeof(data), false));
+    IS_TRUE(pub_tmpl::send(client, &t, sizeof(data)));
+    IS_FALSE(shim.error());
+
+    // Back to a short packet
+    IS_TRUE(expect_publish(shim, data, 10, false));
+    IS_TRUE(pub_tmpl::send(client, &t, 10));
+    IS_FALSE(shim.error());
+    END_IT
+}
+
+int test_qos1() {
+    IT("sends the same packet as publish(..., 1), queued until the PUBACK");
+    static uint8_t buf[PUB_TMPL_SIZE(32, 8 + 64)];
+    PUB_TMPL_t t;
+    ShimClient shim;
+    PubSubClient client(server, 1883, shim);
+    connect(shim, client);
+
+    IS_TRUE(pub_tmpl::init(&t, buf, sizeof(buf), TOPIC, PREFIX, sizeof(PREFIX), true, 1));
+    IS_TRUE(pub_tmpl::data_max(&t) == 64 + 32 - strlen(TOPIC));
+    uint8_t data[] = { 1, 2, 3, 4, 5 };
+    memcpy(pub_tmpl::data(&t), data, sizeof(data));
+    IS_TRUE(expect_publish(shim, data, sizeof(data), true, 1));
+    IS_TRUE(pub_tmpl::send(client, &t, sizeof(data)));
+    IS_FALSE(shim.error());
+    IS_TRUE(client.pendingPublishes() == 1);
+
+    // The template keeps msgId 0: the next one gets its own id from the queue
+    IS_TRUE(pub_tmpl::send(client, &t, sizeof(data)));
+    IS_TRUE(client.pendingPublishes() == 2);
+
+    byte puback[] = { 0x40, 0x02, 0x00, 0x02 };
+    shim.respond(puback, 4);
+    client.loop();
+    IS_TRUE(client.pendingPublishes() == 1);
+    END_IT
+}
+
+int test_limits() {
+    IT("refuses what doesn't fit & sends nothing when not connected");
+    static uint8_t buf[PUB_TMPL_SIZE(32, 8 + 16)];
+    PUB_TMPL_t t;
+    ShimClient shim;
+    PubSubClient client(server, 1883, shim);
+
+    IS_FALSE(pub_tmpl::init(&t, buf, 20, TOPIC, PREFIX, sizeof(PREFIX)));
+    IS_FALSE(pub_tmpl::send(client, &t, 0));
+
+    IS_TRUE(pub_tmpl::init(&t, buf, sizeof(buf), TOPIC, PREFIX, sizeof(PREFIX)));
+    IS_FALSE(pub_tmpl::send(client, &t, 4));
+    connect(shim, client);
+    IS_FALSE(pub_tmpl::send(client, &t, pub_tmpl::data_max(&t) + 1));
+    END_IT
+}
+
+int main() {
+    SUITE("Publish templates");
+
+    test_short();
+    test_long();
+    test_qos1();
+    test_limits();
+
+    FINISH
+}
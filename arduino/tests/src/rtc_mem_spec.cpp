@@ -0,0 +1,162 @@
+#include "Arduino.h"
+#include "rtc_mem.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+struct A_t {
+    uint32_t cnt;
+    uint8_t ssid[5];
+};
+
+struct B_t {
+    uint16_t x;
+    uint16_t y;
+};
+
+/* One "boot": registers the regions as a sketch would do it in setup() */
+static A_t a;
+static B_t b;
+static int8_t id_a, id_b;
+
+void boot(uint8_t version_a = 1) {
+    rtc_mem::reset();
+    id_a = rtc_mem::add("a", version_a, &a, sizeof(a));
+    id_b = rtc_mem::add("b", 1, &b, sizeof(b));
+}
+
+int test_power_on() {
+    IT("starts with zeroed regions after power on");
+    ESP.power_on();
+    memset(&a, 0x55, sizeof(a));
+    boot();
+
+    IS_TRUE(id_a == 0);
+    IS_TRUE(id_b == 1);
+    IS_FALSE(rtc_mem::is_valid(id_a));
+    IS_FALSE(rtc_mem::is_valid(id_b));
+    IS_TRUE(a.cnt == 0);
+    IS_TRUE(b.x == 0);
+    END_IT
+}
+
+int test_round_trip() {
+    IT("restores regions after a deep sleep");
+    ESP.power_on();
+    boot();
+    a.cnt = 1234;
+    memcpy(a.ssid, "wdm01", 5);
+    b.x = 7;
+    b.y = 8;
+    IS_TRUE(rtc_mem::store() == 2);
+
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    boot();
+    IS_TRUE(rtc_mem::is_valid(id_a));
+    IS_TRUE(rtc_mem::is_valid(id_b));
+    IS_TRUE(a.cnt == 1234);
+    IS_TRUE(memcmp(a.ssid, "wdm01", 5) == 0);
+    IS_TRUE(b.x == 7);
+    IS_TRUE(b.y == 8);
+    END_IT
+}
+
+int test_single_read() {
+    IT("reads the RTC memory once for all regions");
+    ESP.power_on();
+    boot();
+    IS_TRUE(ESP.rtc_read_cnt == 1);
+    END_IT
+}
+
+int test_dirty_only() {
+    IT("writes only the changed regions");
+    ESP.power_on();
+    boot();
+    rtc_mem::store();
+
+    boot();
+    ESP.rtc_write_cnt = 0;
+    IS_TRUE(rtc_mem::store() == 0);
+    IS_TRUE(ESP.rtc_write_cnt == 0);
+
+    b.y++;
+    ESP.rtc_write_bytes = 0;
+    IS_TRUE(rtc_mem::store() == 1);
+    IS_TRUE(ESP.rtc_write_cnt == 1);
+    IS_TRUE(ESP.rtc_write_bytes == (RTC_MEM_HDR_BLOCKS + 1) * 4);
+    END_IT
+}
+
+int test_version_change() {
+    IT("drops a region whose version changed");
+    ESP.power_on();
+    boot();
+    a.cnt = 99;
+    b.x = 5;
+    rtc_mem::store();
+
+    boot(2);
+    IS_FALSE(rtc_mem::is_valid(id_a));
+    IS_TRUE(a.cnt == 0);
+    IS_TRUE(rtc_mem::is_valid(id_b));
+    IS_TRUE(b.x == 5);
+
+    // The new version is written back even if the content is still zero:
+    IS_TRUE(rtc_mem::store() == 1);
+    boot(2);
+    IS_TRUE(rtc_mem::is_valid(id_a));
+    END_IT
+}
+
+int test_corruption() {
+    IT("drops a region whose content is corrupted");
+    ESP.power_on();
+    boot();
+    b.x = 5;
+    rtc_mem::store();
+
+    // First data byte of region "b": after region "a" (2 + 3 blocks) & "b" header
+    ESP.rtc_mem[(RTC_MEM_BASE + 2 + 3 + 2) * 4] ^= 0x01;
+    boot();
+    IS_TRUE(rtc_mem::is_valid(id_a));
+    IS_FALSE(rtc_mem::is_valid(id_b));
+    IS_TRUE(b.x == 0);
+    END_IT
+}
+
+int test_no_room() {
+    IT("refuses a region which doesn't fit");
+    static uint8_t big[RTC_MEM_BLOCKS * 4];
+    ESP.power_on();
+    boot();
+    IS_TRUE(rtc_mem::add("big", 1, big, sizeof(big)) == -1);
+    END_IT
+}
+
+int test_outside_boot_cause() {
+    IT("keeps out of the boot cause & OTA blocks");
+    ESP.power_on();
+    uint8_t low[RTC_MEM_BASE * 4];
+    memcpy(low, ESP.rtc_mem, sizeof(low));
+    boot();
+    a.cnt = 1;
+    rtc_mem::store();
+    IS_TRUE(memcmp(low, ESP.rtc_mem, sizeof(low)) == 0);
+    END_IT
+}
+
+int main() {
+    SUITE("RTC memory");
+
+    test_power_on();
+    test_round_trip();
+    test_single_read();
+    test_dirty_only();
+    test_version_change();
+    test_corruption();
+    test_no_room();
+    test_outside_boot_cause();
+
+    FINISH
+}
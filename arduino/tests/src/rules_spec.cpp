@@ -0,0 +1,172 @@
+#include "Arduino.h"
+#include "FS.h"
+#include <wdm_proto.h>
+#include "device.h"
+#include "evlog.h"
+#include "rules.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using namespace wdm_proto;
+
+/* Device & Event log doubles: record what the rules do */
+static uint16_t g_mask, g_cmds;
+static int g_control_calls, g_events;
+
+uint8_t device::count() { return 4; }
+void device::control_mask(uint16_t mask, uint16_t cmds) { g_mask = mask; g_cmds = cmds; g_control_calls++; }
+void evlog::push(uint8_t type, uint32_t detail) { g_events++; }
+
+static const uint8_t TH_ID[WDM_ID_SZ] = { 1, 2, 3, 4, 5, 6 };
+static const uint8_t OTHER_ID[WDM_ID_SZ] = { 1, 2, 3, 4, 5, 7 };
+
+static uint8_t g_buf[256];
+static wdm_frame::Writer g_w(g_buf, sizeof(g_buf));
+
+static void table_begin(uint8_t cnt) {
+    g_w = wdm_frame::Writer(g_buf, sizeof(g_buf));
+    g_w.put<MqttCount>(cnt);
+}
+
+static void table_rule(uint8_t id, uint8_t flags, uint8_t op, int32_t thr, uint16_t hyst, uint8_t offset, uint8_t cmd) {
+    g_w.put<MqttRule>(id, flags, TH_ID, 1, op, (uint32_t)thr, hyst, offset, cmd);
+}
+
+static void reset_calls() {
+    g_mask = g_cmds = 0;
+    g_control_calls = g_events = 0;
+}
+
+int test_set() {
+    IT("decodes, validates & stores the rule table");
+    SPIFFS.format();
+    table_begin(2);
+    table_rule(7, RULE_F_ENABLE, RULE_OP_ABOVE, 280, 10, 1, 1);
+    table_rule(8, RULE_F_ENABLE | RULE_F_REVERT, RULE_OP_BELOW, 150, 5, 2, 1);
+    IS_TRUE(rules::set(g_buf, g_w.length()));
+    IS_TRUE(rules::count() == 2);
+    IS_TRUE(rules::get(1)->threshold == 150);
+    IS_TRUE(rules::get(1)->state == RULE_STATE_UNKNOWN);
+
+    // Truncated, bad op, bad offset: the table is kept
+    IS_TRUE(!rules::set(g_buf, g_w.length() - 1));
+    table_begin(1);
+    table_rule(9, RULE_F_ENABLE, 3, 0, 0, 1, 1);
+    IS_TRUE(!rules::set(g_buf, g_w.length()));
+    table_begin(1);
+    table_rule(9, RULE_F_ENABLE, RULE_OP_ABOVE, 0, 0, 5, 1);
+    IS_TRUE(!rules::set(g_buf, g_w.length()));
+    IS_TRUE(rules::count() == 2);
+
+    // Reloaded after a reboot:
+    rules::init();
+    IS_TRUE(rules::count() == 2);
+    IS_TRUE(rules::get(0)->id == 7);
+    IS_TRUE(rules::get(1)->hyst == 5);
+    END_IT
+}
+
+int test_store_cut() {
+    IT("keeps a complete rule table when a store is cut by a power loss");
+    SPIFFS.format();
+    table_begin(1);
+    table_rule(7, RULE_F_ENABLE, RULE_OP_ABOVE, 280, 10, 1, 1);
+    IS_TRUE(rules::set(g_buf, g_w.length()));
+    IS_FALSE(SPIFFS.exists("/wdm_rules.bin.tmp"));
+
+    // Cut while writing the new table: the last one is loaded
+    SPIFFS._files["/wdm_rules.bin.tmp"] = std::make_shared<std::string>("\x01\x02");
+    rules::init();
+    IS_TRUE(rules::count() == 1);
+    IS_FALSE(SPIFFS.exists("/wdm_rules.bin.tmp"));
+
+    // Cut before the rename: the new table is complete, it's loaded
+    table_begin(2);
+    table_rule(7, RULE_F_ENABLE, RULE_OP_ABOVE, 280, 10, 1, 1);
+    table_rule(8, RULE_F_ENABLE, RULE_OP_BELOW, 150, 5, 2, 1);
+    IS_TRUE(rules::set(g_buf, g_w.length()));
+    SPIFFS.rename("/wdm_rules.bin", "/wdm_rules.bin.tmp");
+    rules::init();
+    IS_TRUE(rules::count() == 2);
+    IS_TRUE(SPIFFS.exists("/wdm_rules.bin"));
+    END_IT
+}
+
+int test_load_short() {
+    IT("loads no rule from an empty or short file");
+    SPIFFS.format();
+    SPIFFS._files["/wdm_rules.bin"] = std::make_shared<std::string>();
+    rules::init();
+    IS_TRUE(rules::count() == 0);
+    SPIFFS._files["/wdm_rules.bin"] = std::make_shared<std::string>("\x57\x52\x55", 3);
+    rules::init();
+    IS_TRUE(rules::count() == 0);
+    END_IT
+}
+
+int test_hysteresis() {
+    IT("acts when the condition changes, with hysteresis");
+    table_begin(1);
+    table_rule(7, RULE_F_ENABLE, RULE_OP_ABOVE, 280, 10, 1, 1);
+    rules::set(g_buf, g_w.length());
+    reset_calls();
+
+    IS_TRUE(rules::sample(TH_ID, 1, 250) == 1);     // Unknown -> false: nothing to do
+    IS_TRUE(g_control_calls == 0);
+    IS_TRUE(rules::sample(TH_ID, 1, 281) == 1);
+    IS_TRUE((g_control_calls == 1) && (g_mask == 0x01) && (g_cmds == 0x01));
+    IS_TRUE(g_events == 1);
+    IS_TRUE(rules::sample(TH_ID, 1, 300) == 0);
+    IS_TRUE(rules::sample(TH_ID, 1, 271) == 0);     // In the band
+    IS_TRUE(rules::sample(TH_ID, 1, 269) == 1);     // No revert: nothing to do
+    IS_TRUE(g_control_calls == 1);
+    IS_TRUE(rules::sample(TH_ID, 1, 275) == 0);
+    IS_TRUE(rules::sample(TH_ID, 1, 290) == 1);
+    IS_TRUE(g_control_calls == 2);
+    END_IT
+}
+
+int test_revert() {
+    IT("reverts the command & switches devices together");
+    table_begin(3);
+    table_rule(1, RULE_F_ENABLE | RULE_F_REVERT, RULE_OP_BELOW, -50, 20, 2, 1);
+    table_rule(2, RULE_F_ENABLE | RULE_F_REVERT, RULE_OP_BELOW, -40, 0, 3, 0);
+    table_rule(3, 0, RULE_OP_BELOW, 0, 0, 4, 1);    // Disabled
+    rules::set(g_buf, g_w.length());
+    reset_calls();
+
+    IS_TRUE(rules::sample(TH_ID, 1, -60) == 2);
+    IS_TRUE((g_control_calls == 1) && (g_mask == 0x06) && (g_cmds == 0x02));
+    IS_TRUE(rules::sample(TH_ID, 1, -35) == 1);     // Rule 1 in its band
+    IS_TRUE((g_control_calls == 2) && (g_mask == 0x04) && (g_cmds == 0x04));
+    IS_TRUE(rules::sample(TH_ID, 1, -29) == 1);
+    IS_TRUE((g_control_calls == 3) && (g_mask == 0x02) && (g_cmds == 0x00));
+    END_IT
+}
+
+int test_source() {
+    IT("only uses the samples of the rule's source");
+    table_begin(1);
+    table_rule(7, RULE_F_ENABLE, RULE_OP_ABOVE, 280, 10, 1, 1);
+    rules::set(g_buf, g_w.length());
+    reset_calls();
+
+    IS_TRUE(rules::sample(OTHER_ID, 1, 300) == 0);
+    IS_TRUE(rules::sample(TH_ID, 2, 300) == 0);
+    IS_TRUE(g_control_calls == 0);
+    IS_TRUE(rules::get(0)->state == RULE_STATE_UNKNOWN);
+    END_IT
+}
+
+int main() {
+    SUITE("Rule engine");
+
+    test_set();
+    test_store_cut();
+    test_load_short();
+    test_hysteresis();
+    test_revert();
+    test_source();
+
+    FINISH
+}
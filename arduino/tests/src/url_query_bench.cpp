@@ -0,0 +1,120 @@
+/* Compare the URL query parser with the get_param()/parse_percent() pair it replaced in httpd: one
+strstr() per parameter, then a left shift of the rest of the value for each '%xx'. The old decode
+time grows with the square of the number of escapes, the new one is linear. Build & run: make bench */
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include "url_query.h"
+
+#define LOOPS_BYTES     20000000    // Bytes parsed per measure
+
+/* httpd::parse_percent, before */
+__attribute__((noinline)) static void parse_percent_old(char *p_str) {
+    char *ptr = p_str;
+    int32_t h = -1, l = -1, sz = strlen(p_str);
+    while (*ptr != 0) {
+        if (*ptr == '%') {
+            h = *(ptr + 1);
+            l = *(ptr + 2);
+            h = ((h >= 'A') && (h <= 'F')) ? h - 'A' + 10 : ((h >= '0') && (h <= '9')) ? h - '0' : -1;
+            l = ((l >= 'A') && (l <= 'F')) ? l - 'A' + 10 : ((l >= '0') && (l <= '9')) ? l - '0' : -1;
+            if ((h >= 0) && (l >= 0)) {
+                *ptr = (h << 4) | l;
+                char *p2;
+                for (p2 = ptr + 1; p2 - p_str < sz - 2; p2++) {
+                    *p2 = *(p2 + 2);
+                }
+                *p2 = 0;
+                sz -= 2;
+            }
+        }
+        ptr++;
+    }
+}
+
+/* httpd::get_param, before (without the value size limit) */
+static uint32_t get_param_old(const char *req, const char *name, char *val) {
+    const char *p = strstr(req, name);
+    if (p == NULL) {
+        return 0;
+    }
+    p += strlen(name);
+    const char *p2 = strchr(p, '&');
+    if (p2 == NULL) {
+        p2 = p + strlen(p);
+    }
+    memcpy(val, p, p2 - p);
+    val[p2 - p] = 0;
+    return p2 - p;
+}
+
+static const char *KEYS_OLD[] = { "ssid=", "password=", "server=", "port=", "security=", "tz=" };
+static const char *KEYS[] = { "ssid", "password", "server", "port", "security", "tz" };
+
+__attribute__((noinline)) static uint32_t provision_old(const char *query) {
+    static char val[4096];
+    uint32_t sum = 0;
+    for (int k = 0; k < 6; k++) {
+        if (get_param_old(query, KEYS_OLD[k], val) > 0) {
+            parse_percent_old(val);
+            sum += strlen(val);
+        }
+    }
+    return sum;
+}
+
+__attribute__((noinline)) static uint32_t provision_new(const char *query) {
+    static char buf[4096];
+    URL_QUERY_t q;
+    uint32_t sum = 0;
+    uint16_t len;
+    strcpy(buf, query);
+    url_query::parse(&q, buf);
+    for (int k = 0; k < 6; k++) {
+        if (url_query::get(&q, KEYS[k], &len) != NULL) {
+            sum += len;
+        }
+    }
+    return sum;
+}
+
+/* Provisioning query with 'esc' escapes in both the ssid & the password */
+static std::string make_query(uint32_t esc) {
+    std::string v;
+    for (uint32_t i = 0; i < esc; i++) {
+        v += (i & 1) ? "%2F" : "a%20";
+    }
+    return "ssid=" + v + "&password=" + v + "&server=broker.local&port=1883&security=none&tz=420";
+}
+
+template <typename F> static double run(F f, const std::string &query) {
+    uint32_t loops = LOOPS_BYTES / query.size();
+    uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = 0; n < loops; n++) {
+        sink += f(query.c_str());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (sink == 0) {
+        printf("!");
+    }
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / loops;
+}
+
+int main() {
+    static const uint32_t ESC[] = { 0, 8, 32, 128, 512 };
+
+    printf("Provisioning query, N escapes in ssid & password: ns/query (ns/byte)\n");
+    printf("  %5s %6s %18s %18s\n", "N", "bytes", "get_param", "url_query");
+    for (size_t i = 0; i < sizeof(ESC) / sizeof(ESC[0]); i++) {
+        std::string q = make_query(ESC[i]);
+        if (provision_old(q.c_str()) != provision_new(q.c_str())) {
+            printf("url_query output differs from get_param()!\n");
+            return 1;
+        }
+        double t0 = run(provision_old, q);
+        double t1 = run(provision_new, q);
+        printf("  %5u %6zu %9.0f (%5.2f) %9.0f (%5.2f)\n", ESC[i], q.size(), t0, t0 / q.size(), t1, t1 / q.size());
+    }
+    return 0;
+}
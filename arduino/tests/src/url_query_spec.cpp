@@ -0,0 +1,95 @@
+#include "Arduino.h"
+#include "url_query.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+static URL_QUERY_t g_q;
+static char g_buf[512];
+
+static uint8_t parse(const char *str) {
+    strcpy(g_buf, str);
+    return url_query::parse(&g_q, g_buf);
+}
+
+static bool has(const char *key, const char *val) {
+    uint16_t len = 0;
+    const char *p = url_query::get(&g_q, key, &len);
+    return (p != NULL) && (len == strlen(val)) && (strcmp(p, val) == 0);
+}
+
+int test_split() {
+    IT("splits the query into key/value pairs");
+    IS_TRUE(parse("ssid=home&password=12345678&port=1883&tz=420") == 4);
+    IS_TRUE(has("ssid", "home"));
+    IS_TRUE(has("password", "12345678"));
+    IS_TRUE(has("port", "1883"));
+    IS_TRUE(has("tz", "420"));
+    IS_TRUE(!has("server", ""));
+    IS_TRUE(!has("tz=", "420"));
+    END_IT
+}
+
+int test_empty() {
+    IT("handles empty & missing values");
+    IS_TRUE(parse("") == 0);
+    IS_TRUE(parse("&&") == 0);
+    IS_TRUE(parse("a&b=&=c&&d=1") == 4);
+    IS_TRUE(has("a", ""));
+    IS_TRUE(has("b", ""));
+    IS_TRUE(has("", "c"));
+    IS_TRUE(has("d", "1"));
+    END_IT
+}
+
+int test_decode() {
+    IT("decodes %xx in either case & '+'");
+    IS_TRUE(parse("ssid=my+home%20net&password=a%2Fb%2fc%3d%26&k%65y=%7E") == 3);
+    IS_TRUE(has("ssid", "my home net"));
+    IS_TRUE(has("password", "a/b/c=&"));
+    IS_TRUE(has("key", "~"));
+    IS_TRUE(parse("a=b=c") == 1);
+    IS_TRUE(has("a", "b=c"));
+    END_IT
+}
+
+int test_invalid_escape() {
+    IT("keeps invalid escapes as is");
+    IS_TRUE(parse("a=%&b=%4&c=%G1&d=100%") == 4);
+    IS_TRUE(has("a", "%"));
+    IS_TRUE(has("b", "%4"));
+    IS_TRUE(has("c", "%G1"));
+    IS_TRUE(has("d", "100%"));
+
+    uint16_t len = 0;
+    IS_TRUE(parse("a=x%00y") == 1);
+    IS_TRUE(url_query::get(&g_q, "a", &len) != NULL);
+    IS_TRUE(len == 3);
+    END_IT
+}
+
+int test_table_full() {
+    IT("ignores the params which don't fit");
+    uint16_t len;
+    char text[256] = "";
+    for (int i = 0; i <= URL_QUERY_PARAM_CNT; i++) {
+        sprintf(text + strlen(text), "%sk%d=%d", i ? "&" : "", i, i);
+    }
+    IS_TRUE(parse(text) == URL_QUERY_PARAM_CNT);
+    sprintf(text, "k%d", URL_QUERY_PARAM_CNT - 1);
+    IS_TRUE(url_query::get(&g_q, text, &len) != NULL);
+    sprintf(text, "k%d", URL_QUERY_PARAM_CNT);
+    IS_TRUE(url_query::get(&g_q, text, &len) == NULL);
+    END_IT
+}
+
+int main() {
+    SUITE("URL query");
+
+    test_split();
+    test_empty();
+    test_decode();
+    test_invalid_escape();
+    test_table_full();
+
+    FINISH
+}
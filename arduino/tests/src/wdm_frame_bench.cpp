@@ -0,0 +1,140 @@
+/* Compare the frame codec with the hand-written encoders/decoders it replaced. Fields are put/got
+at constant offsets, so "encode layout" (Layout::put only) must run as fast as the hand-written
+code; Writer/Reader add one bounds check per item, not per field. Build & run: make bench */
+#include <stdio.h>
+#include <chrono>
+#include "wdm_proto.h"
+
+using namespace wdm_frame;
+using namespace wdm_proto;
+
+#define DEV_CNT     10
+#define LOOPS       2000000
+
+struct DEVICE_INFO_t {
+    uint8_t offset, type, r, p;
+    uint32_t v;
+};
+
+static DEVICE_INFO_t g_dev[DEV_CNT];
+static const uint8_t ID[WDM_ID_SZ] = { 1, 2, 3, 4, 5, 6 };
+
+static void u32_to_buf(uint32_t u32, uint8_t buf[]) {
+    buf[0] = u32;
+    buf[1] = u32 >> 8;
+    buf[2] = u32 >> 16;
+    buf[3] = u32 >> 24;
+}
+
+static uint32_t buf_to_u32(const uint8_t buf[]) {
+    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+/* mqtt_inf::send_STATUS, before the codec */
+__attribute__((noinline)) static uint32_t encode_hand(uint8_t *arr, uint32_t now) {
+    uint8_t i = 0;
+    arr[i++] = 0x01;
+    arr[i++] = 0x42;
+    memcpy(&arr[i], ID, 6);
+    i += 6;
+    arr[i++] = DEV_CNT;
+    for (int k = 0; k < DEV_CNT; k++) {
+        const DEVICE_INFO_t *p_dev = &g_dev[k];
+        arr[i++] = p_dev->offset;
+        arr[i++] = p_dev->type;
+        arr[i++] = p_dev->r;
+        arr[i++] = p_dev->p;
+        u32_to_buf(p_dev->v, &arr[i]);
+        i += 4;
+        u32_to_buf(now, &arr[i]);
+        i += 4;
+    }
+    return i;
+}
+
+__attribute__((noinline)) static uint32_t encode_codec(uint8_t *arr, uint32_t now) {
+    Writer w(arr, MqttHeader::size + MqttCount::size + DEV_CNT * MqttDeviceStatus::size);
+    w.put<MqttHeader>(0x01, 0x42, ID);
+    w.put<MqttCount>(DEV_CNT);
+    for (int k = 0; k < DEV_CNT; k++) {
+        const DEVICE_INFO_t *p_dev = &g_dev[k];
+        w.put<MqttDeviceStatus>(p_dev->offset, p_dev->type, p_dev->r, p_dev->p, p_dev->v, now);
+    }
+    return w.length();
+}
+
+/* Layout::put only: the per-field cost */
+__attribute__((noinline)) static uint32_t encode_layout(uint8_t *arr, uint32_t now) {
+    uint32_t i = 0;
+    MqttHeader::put(arr, 0x01, 0x42, ID);
+    i += MqttHeader::size;
+    MqttCount::put(&arr[i], DEV_CNT);
+    i += MqttCount::size;
+    for (int k = 0; k < DEV_CNT; k++) {
+        const DEVICE_INFO_t *p_dev = &g_dev[k];
+        MqttDeviceStatus::put(&arr[i], p_dev->offset, p_dev->type, p_dev->r, p_dev->p, p_dev->v, now);
+        i += MqttDeviceStatus::size;
+    }
+    return i;
+}
+
+/* Sum of all fields of a STATUS frame */
+__attribute__((noinline)) static uint32_t decode_hand(const uint8_t *arr, uint32_t len) {
+    uint32_t sum = 0;
+    uint32_t i = 8;
+    uint8_t cnt = arr[i++];
+    for (int k = 0; k < cnt; k++) {
+        sum += arr[i] + arr[i + 1] + arr[i + 2] + arr[i + 3];
+        sum += buf_to_u32(&arr[i + 4]) + buf_to_u32(&arr[i + 8]);
+        i += 12;
+    }
+    return sum;
+}
+
+__attribute__((noinline)) static uint32_t decode_codec(const uint8_t *arr, uint32_t len) {
+    uint32_t sum = 0;
+    Reader rd(arr, len);
+    rd.next<MqttHeader>();
+    uint8_t cnt = rd.next<MqttCount>().get<0>();
+    for (int k = 0; k < cnt; k++) {
+        View<MqttDeviceStatus> v = rd.next<MqttDeviceStatus>();
+        sum += v.get<MQTT_DEV_OFFSET>() + v.get<MQTT_DEV_TYPE>() + v.get<MQTT_DEV_RSSI>() + v.get<MQTT_DEV_POWER>();
+        sum += v.get<MQTT_DEV_VALUE>() + v.get<MQTT_DEV_TIME>();
+    }
+    return sum;
+}
+
+template <typename F> static double run(F f, const char *name) {
+    auto t0 = std::chrono::steady_clock::now();
+    uint32_t sink = 0;
+    for (uint32_t n = 0; n < LOOPS; n++) {
+        sink += f(n);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / LOOPS;
+    printf("  %-14s %7.1f ns/frame (sink=%u)\n", name, ns, sink);
+    return ns;
+}
+
+int main() {
+    static uint8_t a[256], b[256];
+    for (int k = 0; k < DEV_CNT; k++) {
+        g_dev[k] = { (uint8_t)(k + 1), 4, 200, 100, (uint32_t)k * 1000 };
+    }
+
+    uint32_t la = encode_hand(a, 12345);
+    uint32_t lb = encode_codec(b, 12345);
+    if ((la != lb) || memcmp(a, b, la) || (encode_layout(b, 12345) != la) || memcmp(a, b, la) || (decode_hand(a, la) != decode_codec(a, la))) {
+        printf("codec output differs from the hand-written code!\n");
+        return 1;
+    }
+
+    printf("STATUS frame, %d devices, %u bytes\n", DEV_CNT, la);
+    double e0 = run([&](uint32_t n) { return encode_hand(a, n); }, "encode hand");
+    double el = run([&](uint32_t n) { return encode_layout(b, n); }, "encode layout");
+    double e1 = run([&](uint32_t n) { return encode_codec(b, n); }, "encode codec");
+    double d0 = run([&](uint32_t n) { a[20] = n; return decode_hand(a, la); }, "decode hand");
+    double d1 = run([&](uint32_t n) { a[20] = n; return decode_codec(a, la); }, "decode codec");
+    printf("vs hand: encode layout %.2f, encode codec %.2f, decode codec %.2f\n", el / e0, e1 / e0, d1 / d0);
+    return 0;
+}
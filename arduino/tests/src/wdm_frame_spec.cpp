@@ -0,0 +1,115 @@
+#include "wdm_proto.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using namespace wdm_frame;
+using namespace wdm_proto;
+
+static const uint8_t ID[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+
+/* Sizes & offsets are compile-time constants */
+static_assert(MqttHeader::size == 8, "mqtt header");
+static_assert(MqttDeviceStatus::size == 12, "mqtt status");
+static_assert(UdpHeader::size == 12, "udp header");
+static_assert(UdpDeviceStatus::size == 8, "udp status");
+static_assert(Field<MQTT_DEV_VALUE, MqttDeviceStatus>::offset == 4, "mqtt value offset");
+static_assert(Field<UDP_DEV_VALUE, UdpDeviceStatus>::offset == 2, "udp value offset");
+
+int test_encode_mqtt_status() {
+    IT("encodes the MQTT device status like the hand-written code");
+    uint8_t buf[MqttDeviceStatus::size];
+    const uint8_t expected[] = { 3, 4, 0xC8, 100, 0x78, 0x56, 0x34, 0x12, 0x04, 0x03, 0x02, 0x01 };
+
+    MqttDeviceStatus::put(buf, 3, 4, 0xC8, 100, 0x12345678, 0x01020304);
+    IS_TRUE(memcmp(buf, expected, sizeof(expected)) == 0);
+    END_IT
+}
+
+int test_encode_udp_status() {
+    IT("encodes the UDP device status like the hand-written code");
+    uint8_t buf[UdpDeviceStatus::size];
+    const uint8_t expected[] = { 3, 4, 0x78, 0x56, 0x34, 0x12, 0xC8, 100 };
+
+    UdpDeviceStatus::put(buf, 3, 4, 0x12345678, 0xC8, 100);
+    IS_TRUE(memcmp(buf, expected, sizeof(expected)) == 0);
+    END_IT
+}
+
+int test_decode_header() {
+    IT("decodes a header in place");
+    uint8_t buf[UdpHeader::size + UdpAck::size];
+    Writer w(buf, sizeof(buf));
+    w.put<UdpHeader>(0xa8, 0xAABBCCDD, ID, 0x02);
+    w.put<UdpAck>(7, 0x02);
+    IS_TRUE(w.ok());
+    IS_TRUE(w.length() == sizeof(buf));
+
+    View<UdpHeader> hdr(buf, sizeof(buf));
+    IS_TRUE(hdr.valid());
+    IS_TRUE(hdr.get<UDP_HDR_MARKER>() == 0xa8);
+    IS_TRUE(hdr.get<UDP_HDR_SEQ>() == 0xAABBCCDD);
+    IS_TRUE(hdr.get<UDP_HDR_ID>() == &buf[5]);
+    IS_TRUE(hdr.get<UDP_HDR_OPCODE>() == 0x02);
+    IS_TRUE(hdr.tail() == &buf[UdpHeader::size]);
+    IS_TRUE(hdr.tail_len() == UdpAck::size);
+
+    View<UdpAck> ack(hdr.tail(), hdr.tail_len());
+    IS_TRUE(ack.valid());
+    IS_TRUE(ack.get<UDP_ACK_SEQ>() == 7);
+    END_IT
+}
+
+int test_short_frame() {
+    IT("rejects frames shorter than the layout");
+    uint8_t buf[MqttHeader::size] = { 0x01, 'm' };
+
+    View<MqttHeader> hdr(buf, sizeof(buf));
+    IS_TRUE(hdr.valid());
+    IS_TRUE(hdr.tail_len() == 0);
+    IS_FALSE(View<MqttCommandMask>(hdr.tail(), hdr.tail_len()).valid());
+    IS_FALSE(View<MqttHeader>(buf, sizeof(buf) - 1).valid());
+    END_IT
+}
+
+int test_reader() {
+    IT("reads a list of items up to the last complete one");
+    const uint8_t buf[] = { 1, 1, 2, 0, 3 };
+    Reader rd(buf, sizeof(buf));
+    int cnt = 0;
+
+    for (View<MqttCommand> v = rd.next<MqttCommand>(); v.valid(); v = rd.next<MqttCommand>()) {
+        IS_TRUE(v.get<MQTT_CMD_OFFSET>() == cnt + 1);
+        cnt++;
+    }
+    IS_TRUE(cnt == 2);
+    IS_TRUE(rd.left() == 0);
+    END_IT
+}
+
+int test_writer_overflow() {
+    IT("stops writing on overflow");
+    uint8_t buf[MqttHeader::size + 4];
+    memset(buf, 0xEE, sizeof(buf));
+    Writer w(buf, MqttHeader::size + 2);
+
+    IS_TRUE(w.put<MqttHeader>(0x01, 'a', ID) == buf);
+    IS_TRUE(w.put<MqttTime>(1) == NULL);
+    IS_FALSE(w.ok());
+    IS_TRUE(w.put<MqttCommand>(1, 1) == NULL);
+    IS_TRUE(w.length() == MqttHeader::size);
+    IS_TRUE(buf[MqttHeader::size] == 0xEE);
+    END_IT
+}
+
+int main() {
+    SUITE("Frame codec");
+
+    test_encode_mqtt_status();
+    test_encode_udp_status();
+    test_decode_header();
+    test_short_frame();
+    test_reader();
+    test_writer_overflow();
+
+    FINISH
+}
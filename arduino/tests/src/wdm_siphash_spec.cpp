@@ -0,0 +1,70 @@
+#include "wdm_siphash.h"
+#include "wdm_proto.h"
+#include "BDDTest.h"
+#include "trace.h"
+
+using namespace wdm_proto;
+
+/* Key of the reference vectors: 00 01 .. 0f */
+static const wdm_siphash::Key REF_KEY = { 0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL };
+
+int test_reference_vectors() {
+    IT("matches the SipHash-2-4 reference vectors");
+    uint8_t msg[64];
+    for (int i = 0; i < 64; i++) {
+        msg[i] = i;
+    }
+
+    IS_TRUE(wdm_siphash::hash(REF_KEY, msg, 0) == 0x726fdb47dd0e0e31ULL);
+    IS_TRUE(wdm_siphash::hash(REF_KEY, msg, 15) == 0xa129ca6149be45e5ULL);
+    IS_TRUE(wdm_siphash::hash(REF_KEY, msg, 63) == 0x958a324ceb064572ULL);
+    END_IT
+}
+
+int test_derive() {
+    IT("derives distinct keys from distinct secrets");
+    wdm_siphash::Key a = wdm_siphash::derive("wdm-secret");
+    wdm_siphash::Key b = wdm_siphash::derive("wdm-secret");
+    wdm_siphash::Key c = wdm_siphash::derive("wdm-secreT");
+
+    IS_TRUE((a.k0 == b.k0) && (a.k1 == b.k1));
+    IS_TRUE((a.k0 != c.k0) && (a.k1 != c.k1));
+    IS_TRUE(a.k0 != a.k1);
+    END_IT
+}
+
+int test_sign_packet() {
+    IT("signs a LAN packet in its FCS & rejects any change");
+    static const uint8_t ID[WDM_ID_SZ] = { 0x5c, 0xcf, 0x7f, 0x01, 0x02, 0x03 };
+    wdm_siphash::Key key = wdm_siphash::derive("wdm-secret");
+    uint8_t buf[UdpHeader::size + UdpCommand::size + UDP_FCS_SZ];
+    size_t len = sizeof(buf) - UDP_FCS_SZ;
+    wdm_frame::Writer w(buf, sizeof(buf));
+
+    w.put<UdpHeader>(0xa8, 1000, ID, 'd');
+    w.put<UdpCommand>(1, 1);
+    wdm_siphash::sign(key, buf, len, w.reserve(UDP_FCS_SZ));
+    IS_TRUE(w.ok());
+    IS_TRUE(wdm_siphash::verify(key, buf, len, &buf[len]));
+
+    // Any bit of the packet or of the tag:
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] ^= 0x10;
+        IS_FALSE(wdm_siphash::verify(key, buf, len, &buf[len]));
+        buf[i] ^= 0x10;
+    }
+
+    // Another key:
+    IS_FALSE(wdm_siphash::verify(wdm_siphash::derive("other"), buf, len, &buf[len]));
+    END_IT
+}
+
+int main() {
+    SUITE("LAN packet MAC");
+
+    test_reference_vectors();
+    test_derive();
+    test_sign_packet();
+
+    FINISH
+}
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+"""Decode the deferred log (dlog) output of the WDM firmwares.
+
+The firmware only sends the address of each format string; the strings are taken from the
+firmware ELF file (Arduino: "Sketch > Export compiled binary", or the build folder).
+
+    # After a build: extract the format strings (keep the .json with the released firmware)
+    dlog_decode.py extract wdm_th.ino.elf -o wdm_th.dlog.json
+
+    # Decode a Serial capture (binary frames mixed with text are fine), or a live port
+    dlog_decode.py decode wdm_th.dlog.json capture.bin
+    dlog_decode.py decode wdm_th.ino.elf /dev/ttyUSB0 --baud 74880
+
+Frame: [0xD1][len(1)][fmt(4)][ms(4)][args()][sum(1)], see dlog.h.
+"""
+import argparse
+import bisect
+import json
+import re
+import struct
+import sys
+
+DLOG_SYNC = 0xD1
+DLOG_HDR_SZ = 9
+
+# Sections holding string literals (ESP8266: .rodata in DRAM, .irom0.text for PROGMEM)
+STRING_SECTIONS = ('.rodata', '.irom0.text', '.irom.text', '.flash.rodata')
+
+CONV_RE = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t|L)?([diouxXcspfFeEgGaA%])')
+
+
+def elf_strings(path):
+    """Return {address: string} for the NUL-terminated strings of the ELF string sections."""
+    data = open(path, 'rb').read()
+    if data[:4] != b'\x7fELF':
+        raise ValueError('%s: not an ELF file' % path)
+    is64 = data[4] == 2
+    end = '<' if data[5] == 1 else '>'
+    if is64:
+        shoff, = struct.unpack_from(end + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', data, 0x3A)
+    else:
+        shoff, = struct.unpack_from(end + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + 'HHH', data, 0x2E)
+
+    sections = []
+    for i in range(shnum):
+        off = shoff + i * shentsize
+        if is64:
+            name, typ, _, addr, offset, size = struct.unpack_from(end + 'IIQQQQ', data, off)
+        else:
+            name, typ, _, addr, offset, size = struct.unpack_from(end + 'IIIIII', data, off)
+        sections.append((name, typ, addr, offset, size))
+    names_off = sections[shstrndx][3]
+
+    strings = {}
+    for name, typ, addr, offset, size in sections:
+        sname = data[names_off + name:data.index(b'\0', names_off + name)].decode()
+        if typ == 8 or not (sname in STRING_SECTIONS or sname.startswith('.rodata.')):  # 8: NOBITS
+            continue
+        blob = data[offset:offset + size]
+        pos = 0
+        for chunk in blob.split(b'\0'):
+            # Non-text bytes may precede a string: it's found as a suffix by Formats.get()
+            if chunk:
+                strings[addr + pos] = chunk.decode('latin-1')
+            pos += len(chunk) + 1
+    return strings
+
+
+def load_strings(path):
+    if path.endswith('.json'):
+        return {int(k, 16): v for k, v in json.load(open(path)).items()}
+    return elf_strings(path)
+
+
+class Formats:
+    def __init__(self, strings):
+        self.addrs = sorted(strings)
+        self.strings = strings
+
+    def get(self, addr):
+        """The string at 'addr': the compiler may point inside a merged (longer) string."""
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        if i < 0:
+            return None
+        start = self.addrs[i]
+        s = self.strings[start]
+        return s[addr - start:] if addr - start < len(s) else None
+
+
+def format_entry(fmt, args):
+    """printf-like formatting from the packed arguments, see dlog::pack()."""
+    out = []
+    pos = 0
+    last = 0
+    for m in CONV_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        try:
+            if width == '*':
+                width = str(struct.unpack_from('<i', args, pos)[0])
+                pos += 4
+            if prec == '*':
+                prec = str(struct.unpack_from('<i', args, pos)[0])
+                pos += 4
+            spec = '%' + flags + (width or '') + ('.' + prec if prec is not None else '')
+            if conv == 's':
+                n = args[pos]
+                val = args[pos + 1:pos + 1 + n].decode('ascii', 'replace')
+                if pos + 1 + n > len(args):
+                    raise IndexError
+                pos += 1 + n
+                out.append((spec + 's') % val)
+            elif conv in 'fFeEgGaA':
+                val, = struct.unpack_from('<d', args, pos)
+                pos += 8
+                out.append((spec + conv.replace('a', 'e').replace('A', 'E')) % val)
+            else:
+                if length == 'll':
+                    val, = struct.unpack_from('<Q', args, pos)
+                    pos += 8
+                    bits = 64
+                else:
+                    val, = struct.unpack_from('<I', args, pos)
+                    pos += 4
+                    bits = 32
+                if conv in 'di' and val >= 1 << (bits - 1):
+                    val -= 1 << bits
+                if conv == 'c':
+                    out.append((spec + 'c') % chr(val & 0xFF))
+                elif conv == 'p':
+                    out.append('0x%08x' % val)
+                else:
+                    out.append((spec + ('d' if conv in 'diu' else conv)) % val)
+        except (IndexError, struct.error):
+            out.append('<?>')   # Truncated entry (DLOG_ENTRY_MAX)
+            pos = len(args)
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def frames(stream, live=False):
+    """Yield the entries found in a byte stream, skipping anything which is not a valid frame."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if live:
+                continue
+            break
+        buf += chunk
+        while True:
+            i = buf.find(bytes([DLOG_SYNC]))
+            if i < 0:
+                buf.clear()
+                break
+            del buf[:i]
+            if len(buf) < 2:
+                break
+            n = buf[1]
+            if n < DLOG_HDR_SZ:
+                del buf[:1]
+                continue
+            if len(buf) < n + 2:
+                break
+            entry = bytes(buf[1:n + 1])
+            if sum(entry) & 0xFF != buf[n + 1]:
+                del buf[:1]
+                continue
+            del buf[:n + 2]
+            yield entry
+
+
+def decode(formats, stream, out, live=False):
+    for entry in frames(stream, live):
+        fmt_addr, ms = struct.unpack_from('<II', entry, 1)
+        fmt = formats.get(fmt_addr)
+        if fmt is None:
+            text = '\n<unknown format 0x%08x> %s' % (fmt_addr, entry[DLOG_HDR_SZ:].hex())
+        else:
+            text = format_entry(fmt, entry[DLOG_HDR_SZ:])
+        text = text.replace('\r\n', '\n')
+        if text.startswith('\n'):
+            text = '\n[%8u] ' % ms + text[1:]
+        out.write(text)
+        out.flush()
+    out.write('\n')
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = ap.add_subparsers(dest='cmd', required=True)
+    p = sub.add_parser('extract', help='extract the format strings of a firmware ELF')
+    p.add_argument('elf')
+    p.add_argument('-o', '--output', required=True)
+    p = sub.add_parser('decode', help='decode a capture file or serial port')
+    p.add_argument('strings', help='firmware .elf or extracted .json')
+    p.add_argument('input', help='capture file, serial port or - for stdin')
+    p.add_argument('--baud', type=int, default=115200)
+    args = ap.parse_args()
+
+    if args.cmd == 'extract':
+        strings = elf_strings(args.elf)
+        json.dump({'%08x' % k: v for k, v in sorted(strings.items())}, open(args.output, 'w'), indent=0)
+        print('%d strings' % len(strings))
+        return
+
+    formats = Formats(load_strings(args.strings))
+    if args.input == '-':
+        stream = sys.stdin.buffer
+    elif args.input.startswith('/dev/') or args.input.upper().startswith('COM'):
+        import serial  # pyserial
+        decode(formats, serial.Serial(args.input, args.baud, timeout=0.1), sys.stdout, live=True)
+        return
+    else:
+        stream = open(args.input, 'rb')
+    decode(formats, stream, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,276 @@
+/**	@brief implement the delta patch encoder.
+ *  - Index: every position of the old image, sorted by its next 8 bytes.
+ *  - Scan of the new image: at each position, the longest match among a few candidates, the
+ *    distance of the previous block first (the common case: the code after an edit only moved).
+ *    Short matches elsewhere are not worth an op.
+ *  - A block is extended both ways while matches outnumber mismatches (score +1/-1, cut at the
+ *    best score), so a function whose calls all moved stays one DIFF op.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <string.h>
+#include <algorithm>
+#include <wdm_delta.h>
+#include "delta_diff.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define KEY_SZ                  8
+#define MIN_MATCH               16      // Exact match to start a block at a new distance
+#define MAX_CAND                32      // Index entries tried per position
+#define EXTEND_CUT              64      // Extension stops this far below its best score
+#define ZERO_RUN_MIN            3       // Shorter unchanged runs stay inside a diff run
+
+using namespace wdm_delta;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static inline uint64_t key_at(const uint8_t *p) {
+    uint64_t k;
+    memcpy(&k, p, KEY_SZ);
+    return k;
+}
+
+static void put_v(std::vector<uint8_t> &out, uint32_t v) {
+    uint8_t b[DELTA_VARINT_MAX];
+    out.insert(out.end(), b, b + put_varint(b, v));
+}
+
+namespace {
+
+class Encoder
+{
+    public:
+        Encoder(const std::vector<uint8_t> &o, const std::vector<uint8_t> &n) : old_img(o), new_img(n) {
+            build_index();
+        }
+
+        void run(std::vector<uint8_t> &out, DELTA_STATS_t *st);
+
+    private:
+        const std::vector<uint8_t> &old_img;
+        const std::vector<uint8_t> &new_img;
+        std::vector<uint32_t> index;        // Old positions, sorted by key
+
+        void build_index();
+        bool find(uint32_t i, int64_t dist, uint32_t *src, uint32_t *len) const;
+        uint32_t match_len(uint32_t src, uint32_t i) const;
+        uint32_t extend_fwd(uint32_t i, uint32_t src, uint32_t end) const;
+        uint32_t extend_back(uint32_t i, uint32_t src, uint32_t lo) const;
+        void put_diff(std::vector<uint8_t> &out, uint32_t i, uint32_t src, uint32_t len, uint32_t *changed) const;
+};
+
+} // namespace
+
+void Encoder::build_index()
+{
+    if (old_img.size() < KEY_SZ) {
+        return;
+    }
+    const uint8_t *o = old_img.data();
+    index.resize(old_img.size() - KEY_SZ + 1);
+    for (uint32_t p = 0; p < index.size(); p++) {
+        index[p] = p;
+    }
+    std::stable_sort(index.begin(), index.end(), [o](uint32_t a, uint32_t b) {
+        return memcmp(o + a, o + b, KEY_SZ) < 0;
+    });
+}
+
+uint32_t Encoder::match_len(uint32_t src, uint32_t i) const
+{
+    uint32_t n = 0;
+    while ((src + n < old_img.size()) && (i + n < new_img.size()) && (old_img[src + n] == new_img[i + n])) {
+        n++;
+    }
+    return n;
+}
+
+/** @brief longest match of new[i..] in the old image: at distance 'dist' (i + dist = src) if it
+ *  matches at least KEY_SZ bytes, else the best indexed one of MIN_MATCH bytes or more (exact, or
+ *  extended as a block when shorter: every few bytes of moved code differ).
+*/
+bool Encoder::find(uint32_t i, int64_t dist, uint32_t *src, uint32_t *len) const
+{
+    if (i + KEY_SZ > new_img.size()) {
+        return false;
+    }
+    int64_t s = (int64_t)i + dist;
+    if ((s >= 0) && (s + KEY_SZ <= (int64_t)old_img.size())) {
+        uint32_t n = match_len((uint32_t)s, i);
+        if (n >= KEY_SZ) {
+            *src = (uint32_t)s;
+            *len = n;
+            return true;
+        }
+    }
+
+    const uint8_t *o = old_img.data();
+    const uint8_t *k = &new_img[i];
+    std::vector<uint32_t>::const_iterator it = std::lower_bound(index.begin(), index.end(), k,
+        [o](uint32_t a, const uint8_t *key) { return memcmp(o + a, key, KEY_SZ) < 0; });
+    uint32_t best = 0;
+    uint32_t best_block = 0;
+    uint32_t block_src = 0;
+    for (int c = 0; (c < MAX_CAND) && (it != index.end()) && (key_at(o + *it) == key_at(k)); c++, it++) {
+        uint32_t n = match_len(*it, i);
+        if (n > best) {
+            best = n;
+            *src = *it;
+        }
+        if (best < MIN_MATCH) {
+            uint32_t b = extend_fwd(i, *it, i + n) - i;
+            if (b > best_block) {
+                best_block = b;
+                block_src = *it;
+            }
+        }
+    }
+    if ((best < MIN_MATCH) && (best_block >= MIN_MATCH)) {
+        best = best_block;
+        *src = block_src;
+    }
+    *len = best;
+    return best >= MIN_MATCH;
+}
+
+/** @brief extend the block new[i..end) = old[src..) forward: return the new end.
+*/
+uint32_t Encoder::extend_fwd(uint32_t i, uint32_t src, uint32_t end) const
+{
+    int score = 0;
+    int best = 0;
+    uint32_t best_end = end;
+
+    for (uint32_t j = end; (j < new_img.size()) && (src + (j - i) < old_img.size()); j++) {
+        score += (new_img[j] == old_img[src + (j - i)]) ? 1 : -1;
+        if (score > best) {
+            best = score;
+            best_end = j + 1;
+        } else if (score < best - EXTEND_CUT) {
+            break;
+        }
+    }
+    return best_end;
+}
+
+/** @brief extend the block starting at new[i] = old[src] backward, not below new[lo]: return the
+ *  new start.
+*/
+uint32_t Encoder::extend_back(uint32_t i, uint32_t src, uint32_t lo) const
+{
+    int score = 0;
+    int best = 0;
+    uint32_t best_start = i;
+
+    for (uint32_t k = 1; (k <= i - lo) && (k <= src); k++) {
+        score += (new_img[i - k] == old_img[src - k]) ? 1 : -1;
+        if (score > best) {
+            best = score;
+            best_start = i - k;
+        } else if (score < best - EXTEND_CUT) {
+            break;
+        }
+    }
+    return best_start;
+}
+
+/** @brief DIFF runs of new[i..i+len) - old[src..): [zeros(v)][n(v)][n x diff(1)]..., the op ends
+ *  on the last diff byte or after the trailing zeros.
+*/
+void Encoder::put_diff(std::vector<uint8_t> &out, uint32_t i, uint32_t src, uint32_t len, uint32_t *changed) const
+{
+    uint32_t k = 0;
+    while (k < len) {
+        uint32_t z = 0;
+        while ((k + z < len) && (new_img[i + k + z] == old_img[src + k + z])) {
+            z++;
+        }
+        put_v(out, z);
+        k += z;
+        if (k == len) {
+            break;
+        }
+
+        // Diff run: up to the next ZERO_RUN_MIN unchanged bytes (or the end)
+        uint32_t n = 0;
+        uint32_t zeros = 0;
+        while ((k + n < len) && (zeros < ZERO_RUN_MIN)) {
+            zeros = (new_img[i + k + n] == old_img[src + k + n]) ? zeros + 1 : 0;
+            n++;
+        }
+        if (zeros < ZERO_RUN_MIN) {
+            zeros = 0;              // Ended by the end of the block
+        }
+        n -= zeros;
+        put_v(out, n);
+        for (uint32_t j = 0; j < n; j++) {
+            uint8_t d = new_img[i + k + j] - old_img[src + k + j];
+            out.push_back(d);
+            *changed += (d != 0);
+        }
+        k += n;
+    }
+}
+
+void Encoder::run(std::vector<uint8_t> &out, DELTA_STATS_t *st)
+{
+    uint32_t i = 0;
+    uint32_t lit = 0;               // Start of the bytes not covered yet
+    uint32_t last_src = 0;          // Old position after the last DIFF op
+    int64_t dist = 0;
+
+    while (i < new_img.size()) {
+        uint32_t src;
+        uint32_t len;
+        if (!find(i, dist, &src, &len)) {
+            i++;
+            continue;
+        }
+        uint32_t start = extend_back(i, src, lit);
+        src -= i - start;
+        uint32_t end = extend_fwd(start, src, i + len);
+
+        if (start > lit) {
+            out.push_back(DELTA_OP_INSERT);
+            put_v(out, start - lit);
+            out.insert(out.end(), new_img.begin() + lit, new_img.begin() + start);
+            st->insert_ops++;
+            st->insert_bytes += start - lit;
+        }
+        out.push_back(DELTA_OP_DIFF);
+        put_v(out, end - start);
+        put_v(out, zigzag((int32_t)((int64_t)src - last_src)));
+        put_diff(out, start, src, end - start, &st->changed_bytes);
+        st->diff_ops++;
+        st->diff_bytes += end - start;
+
+        last_src = src + (end - start);
+        dist = (int64_t)src - start;
+        i = lit = end;
+    }
+    if (lit < new_img.size()) {
+        out.push_back(DELTA_OP_INSERT);
+        put_v(out, new_img.size() - lit);
+        out.insert(out.end(), new_img.begin() + lit, new_img.end());
+        st->insert_ops++;
+        st->insert_bytes += new_img.size() - lit;
+    }
+    out.push_back(DELTA_OP_END);
+}
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+std::vector<uint8_t> delta_diff(const std::vector<uint8_t> &old_img, const std::vector<uint8_t> &new_img,
+                                DELTA_STATS_t *stats)
+{
+    DELTA_STATS_t st;
+    memset(&st, 0, sizeof(st));
+
+    std::vector<uint8_t> out(DeltaHeader::size);
+    DeltaHeader::put(out.data(), DELTA_MAGIC, DELTA_VERSION, 0, 0,
+                     old_img.size(), crc32(0, old_img.data(), old_img.size()),
+                     new_img.size(), crc32(0, new_img.data(), new_img.size()));
+    Encoder(old_img, new_img).run(out, &st);
+    if (stats != NULL) {
+        *stats = st;
+    }
+    return out;
+}
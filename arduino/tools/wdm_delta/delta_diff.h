@@ -0,0 +1,28 @@
+/** @brief delta patch encoder (host): the patch which turns one firmware image into another, in
+ *  the format of wdm_delta.h.
+ *  Two builds of a sketch are mostly the same code at other addresses: the encoder finds the
+ *  blocks of the new image which are in the old one (exact 8-byte anchors), then extends each
+ *  block while most bytes still match at the same distance. Inside a block only the changed bytes
+ *  (e.g. the moved addresses) are stored; what is left is inserted as is.
+ *  @date
+ *      - 2026_10_19: Create.
+*/
+#ifndef _DELTA_DIFF_H_
+#define _DELTA_DIFF_H_
+
+#include <stdint.h>
+#include <vector>
+
+struct DELTA_STATS_t {
+    uint32_t diff_ops;
+    uint32_t diff_bytes;            // New bytes made from old ones...
+    uint32_t changed_bytes;         // ...of which changed
+    uint32_t insert_ops;
+    uint32_t insert_bytes;          // New bytes carried in the patch
+};
+
+/* Make the patch from 'old_img' to 'new_img' */
+std::vector<uint8_t> delta_diff(const std::vector<uint8_t> &old_img, const std::vector<uint8_t> &new_img,
+                                DELTA_STATS_t *stats = NULL);
+
+#endif
@@ -0,0 +1,128 @@
+/**	@brief wdm_delta: make & check the delta patches of the firmware OTA (see wdm_delta.h).
+ *
+ *      # Patch from the running image to the new one ("Sketch > Export compiled binary")
+ *      wdm_delta diff wdm_onoff-1.4.bin wdm_onoff-1.5.bin -o wdm_onoff-1.4-1.5.wdmp
+ *
+ *      # Rebuild the new image from the old one & the patch
+ *      wdm_delta apply wdm_onoff-1.4.bin wdm_onoff-1.4-1.5.wdmp -o check.bin
+ *
+ *  'diff' checks its patch with the node's own applier (wdm_onoff/delta_patch.cpp), fed in
+ *  MQTT-sized pieces, before it writes it.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <wdm_delta.h>
+#include "delta_patch.h"
+#include "delta_diff.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Patch bytes per feed() when checking (an OTA chunk) */
+#define FEED_SZ                 512
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static const std::vector<uint8_t> *g_old;
+static std::vector<uint8_t> g_new;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+static bool load(const char *path, std::vector<uint8_t> &buf) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    uint8_t tmp[4096];
+    size_t n;
+    buf.clear();
+    while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) {
+        buf.insert(buf.end(), tmp, tmp + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool save(const char *path, const std::vector<uint8_t> &buf) {
+    FILE *f = fopen(path, "wb");
+    if ((f == NULL) || (fwrite(buf.data(), 1, buf.size(), f) != buf.size())) {
+        perror(path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        return false;
+    }
+    return fclose(f) == 0;
+}
+
+static bool read_old(uint32_t offset, uint8_t *buf, size_t len) {
+    if (offset + len > g_old->size()) {
+        return false;
+    }
+    memcpy(buf, g_old->data() + offset, len);
+    return true;
+}
+
+static bool write_new(const uint8_t *buf, size_t len) {
+    g_new.insert(g_new.end(), buf, buf + len);
+    return true;
+}
+
+/* Apply 'patch' to 'old_img' with the node's applier: return its status, the image in g_new */
+static int8_t apply(const std::vector<uint8_t> &old_img, const std::vector<uint8_t> &patch) {
+    g_old = &old_img;
+    g_new.clear();
+    delta_patch::begin(read_old, write_new);
+    for (size_t k = 0; k < patch.size(); k += FEED_SZ) {
+        size_t n = (patch.size() - k < FEED_SZ) ? patch.size() - k : FEED_SZ;
+        int8_t st = delta_patch::feed(&patch[k], n);
+        if (st != DELTA_OK) {
+            return st;
+        }
+    }
+    return delta_patch::status();
+}
+
+static int usage() {
+    fprintf(stderr, "usage: wdm_delta diff OLD.bin NEW.bin -o PATCH\n"
+                    "       wdm_delta apply OLD.bin PATCH -o NEW.bin\n");
+    return 2;
+}
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+    std::vector<uint8_t> a;
+    std::vector<uint8_t> b;
+
+    if ((argc != 6) || (strcmp(argv[4], "-o") != 0)) {
+        return usage();
+    }
+    if (!load(argv[2], a) || !load(argv[3], b)) {
+        return 1;
+    }
+
+    if (strcmp(argv[1], "diff") == 0) {
+        DELTA_STATS_t st;
+        std::vector<uint8_t> patch = delta_diff(a, b, &st);
+        int8_t ret = apply(a, patch);
+        if ((ret != DELTA_DONE) || (g_new != b)) {
+            fprintf(stderr, "wdm_delta: the patch doesn't apply (status %d)!\n", ret);
+            return 1;
+        }
+        printf("old %zu B, new %zu B -> patch %zu B (%.1f%% of the new image)\n",
+               a.size(), b.size(), patch.size(), 100.0 * patch.size() / (b.size() ? b.size() : 1));
+        printf("  diff: %u ops, %u B (%u changed), insert: %u ops, %u B\n",
+               st.diff_ops, st.diff_bytes, st.changed_bytes, st.insert_ops, st.insert_bytes);
+        return save(argv[5], patch) ? 0 : 1;
+    }
+    if (strcmp(argv[1], "apply") == 0) {
+        int8_t ret = apply(a, b);
+        if (ret != DELTA_DONE) {
+            fprintf(stderr, "wdm_delta: patch failed (status %d)!\n", ret);
+            return 1;
+        }
+        return save(argv[5], g_new) ? 0 : 1;
+    }
+    return usage();
+}
@@ -0,0 +1,150 @@
+/**	@brief implement the Config log: settings are stored as a sequence of small CRC-framed
+ *  records appended to one SPIFFS file. Updating a setting appends one record instead of
+ *  re-writing the whole file; the file is compacted (re-written with only the current state)
+ *  when it grows over CFGLOG_COMPACT_SIZE.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "FS.h"
+#include "esp8266_mlib.h"
+#include "cfglog.h"
+
+//#define DB      Serial.printf
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Log file & temporary file used while compacting */
+const char *CFGLOG_FILE_NAME = "/cfg.log";
+const char *CFGLOG_TMP_FILE_NAME = "/cfg.tmp";
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static File g_file;
+static uint32_t g_size;
+static cfglog::snapshot_cb_t g_snapshot;
+static uint8_t g_compacting;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+/** @brief replay all valid records.
+    @return number of replayed records.
+    @note a torn record (power lost while writing) ends the log: the log is then compacted so
+    new records are not appended after the broken one.
+*/
+uint32_t cfglog::load(replay_cb_t replay, snapshot_cb_t snapshot)
+{
+    uint8_t rec[CFGLOG_OVERHEAD + CFGLOG_DATA_SZ];
+    uint32_t cnt = 0;
+    uint32_t pos = 0;
+    bool torn = false;
+
+    g_snapshot = snapshot;
+
+    // Finish an interrupted compaction:
+    if (SPIFFS.exists(CFGLOG_TMP_FILE_NAME)) {
+        if (SPIFFS.exists(CFGLOG_FILE_NAME)) {
+            SPIFFS.remove(CFGLOG_TMP_FILE_NAME);
+        } else {
+            SPIFFS.rename(CFGLOG_TMP_FILE_NAME, CFGLOG_FILE_NAME);
+        }
+    }
+
+    File f = SPIFFS.open(CFGLOG_FILE_NAME, "r");
+    if (f) {
+        uint32_t sz = f.size();
+        while (pos + CFGLOG_OVERHEAD <= sz) {
+            if ((f.read(rec, 3) != 3) || (rec[0] != CFGLOG_SYNC) || (rec[2] > CFGLOG_DATA_SZ)) {
+                torn = true;
+                break;
+            }
+            uint8_t len = rec[2];
+            if (f.read(&rec[3], len + 2) != (size_t)(len + 2)) {
+                torn = true;
+                break;
+            }
+            uint16_t crc = esp8266_mlib::crc16(&rec[1], len + 2);
+            if (crc != esp8266_mlib::buf_to_u16(&rec[3 + len])) {
+                torn = true;
+                break;
+            }
+            replay(rec[1], &rec[3], len);
+            pos += CFGLOG_OVERHEAD + len;
+            cnt++;
+        }
+        if (pos != sz) {
+            torn = true;
+        }
+        f.close();
+    }
+    DB("\r\n%s: cnt=%u, size=%u, torn=%u", __FUNCTION__, cnt, pos, torn);
+
+    if (torn) {
+        compact();
+    }
+    return cnt;
+}
+
+bool cfglog::append(uint8_t type, const void *data, uint8_t len)
+{
+    uint8_t rec[CFGLOG_OVERHEAD + CFGLOG_DATA_SZ];
+
+    if ((len > CFGLOG_DATA_SZ) || (!g_file && !open_log())) {
+        return false;
+    }
+
+    rec[0] = CFGLOG_SYNC;
+    rec[1] = type;
+    rec[2] = len;
+    memcpy(&rec[3], data, len);
+    esp8266_mlib::u16_to_buf(esp8266_mlib::crc16(&rec[1], len + 2), &rec[3 + len]);
+    if (g_file.write(rec, CFGLOG_OVERHEAD + len) != (size_t)(CFGLOG_OVERHEAD + len)) {
+        DB("\r\n%s: write failed!", __FUNCTION__);
+        return false;
+    }
+    g_file.flush();
+    g_size += CFGLOG_OVERHEAD + len;
+
+    if (!g_compacting && (g_size > CFGLOG_COMPACT_SIZE)) {
+        compact();
+    }
+    return true;
+}
+
+/** @brief write the current state to a new file, then replace the log by it.
+*/
+bool cfglog::compact()
+{
+    DB("\r\n%s: size=%u", __FUNCTION__, g_size);
+    if (g_snapshot == NULL) {
+        return false;
+    }
+    if (g_file) {
+        g_file.close();
+    }
+    g_file = SPIFFS.open(CFGLOG_TMP_FILE_NAME, "w");
+    if (!g_file) {
+        return open_log();
+    }
+    g_size = 0;
+    g_compacting = 1;
+    g_snapshot();
+    g_compacting = 0;
+    g_file.close();
+
+    SPIFFS.remove(CFGLOG_FILE_NAME);
+    SPIFFS.rename(CFGLOG_TMP_FILE_NAME, CFGLOG_FILE_NAME);
+    return open_log();
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool cfglog::open_log()
+{
+    g_file = SPIFFS.open(CFGLOG_FILE_NAME, "a");
+    if (!g_file) {
+        DB("\r\n%s: open file failed!", __FUNCTION__);
+        return false;
+    }
+    g_size = g_file.size();
+    return true;
+}
@@ -0,0 +1,44 @@
+/** @brief define Constants, Prototypes for the Config log module: an append-only record log
+ *  used to store settings in flash.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _CFGLOG_H_
+#define _CFGLOG_H_
+
+#include "Arduino.h"
+
+/* Maximum record data size */
+#define CFGLOG_DATA_SZ              64
+
+/* The log is compacted when the file grows over this size (bytes) */
+#define CFGLOG_COMPACT_SIZE         4096
+
+/* Record framing: [sync(1)][type(1)][len(1)][data(len)][crc16(2)] */
+#define CFGLOG_SYNC                 0xA5
+#define CFGLOG_OVERHEAD             5
+
+class cfglog
+{
+    public:
+        /* Called for every valid record, in write order */
+        typedef void (*replay_cb_t)(uint8_t type, const uint8_t *data, uint8_t len);
+
+        /* Must re-write the whole current state using append() */
+        typedef void (*snapshot_cb_t)();
+
+        /* Replay the log into RAM, then keep it open for appending */
+        static uint32_t load(replay_cb_t replay, snapshot_cb_t snapshot);
+
+        /* Append one record */
+        static bool append(uint8_t type, const void *data, uint8_t len);
+
+        /* Re-write the log with only the current state */
+        static bool compact();
+
+    private:
+        static bool open_log();
+};
+
+#endif
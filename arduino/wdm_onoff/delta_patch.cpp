@@ -0,0 +1,333 @@
+/**	@brief implement the Delta patch applier.
+ *  A state machine over the patch bytes: a varint or a run may be split anywhere between two
+ *  feed() calls. The old image is read through a one-block cache (most DIFF ops read it in
+ *  sequence), the output is written in DELTA_OUT_SZ blocks and its CRC kept on the way.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include <string.h>
+#include <wdm_delta.h>
+#include "delta_patch.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Parser states */
+#define ST_HDR                      0
+#define ST_OP                       1
+#define ST_DIFF_LEN                 2
+#define ST_DIFF_SRC                 3
+#define ST_ZEROS                    4
+#define ST_NDIFF                    5
+#define ST_DIFF                     6
+#define ST_INSERT_LEN               7
+#define ST_INSERT                   8
+#define ST_END                      9
+
+#define SRC_NONE                    0xFFFFFFFF
+
+using namespace wdm_delta;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static DELTA_READ_t g_read;
+static DELTA_WRITE_t g_write;
+static uint8_t g_state;
+static int8_t g_status;
+
+/* Header */
+static uint8_t g_hdr[DeltaHeader::size];
+static uint8_t g_hdr_len;
+static uint32_t g_old_size;
+static uint32_t g_new_size;
+static uint32_t g_new_crc;
+
+/* Current op */
+static uint32_t g_left;             // Bytes of the op still to produce
+static uint32_t g_run;              // Diff/insert bytes still to read
+static uint32_t g_varint;
+static uint8_t g_varint_shift;
+
+/* Old image: next byte & cache */
+static uint32_t g_src;
+static uint32_t g_cache_base;
+static uint32_t g_cache[DELTA_SRC_SZ / 4];
+
+/* New image: bytes produced, output block & CRC of the bytes written */
+static uint32_t g_out_pos;
+static uint8_t g_out[DELTA_OUT_SZ];
+static uint16_t g_out_len;
+static uint32_t g_crc;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void delta_patch::begin(DELTA_READ_t read_old, DELTA_WRITE_t write_new)
+{
+    g_read = read_old;
+    g_write = write_new;
+    g_state = ST_HDR;
+    g_status = DELTA_OK;
+    g_hdr_len = 0;
+    g_old_size = g_new_size = g_new_crc = 0;
+    g_left = g_run = 0;
+    g_varint = 0;
+    g_varint_shift = 0;
+    g_src = 0;
+    g_cache_base = SRC_NONE;
+    g_out_pos = 0;
+    g_out_len = 0;
+    g_crc = 0;
+}
+
+int8_t delta_patch::feed(const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    while ((i < len) && (g_status == DELTA_OK)) {
+        switch (g_state) {
+        case ST_HDR: {
+            size_t n = DeltaHeader::size - g_hdr_len;
+            if (n > len - i) {
+                n = len - i;
+            }
+            memcpy(&g_hdr[g_hdr_len], &data[i], n);
+            g_hdr_len += n;
+            i += n;
+            if (g_hdr_len == DeltaHeader::size) {
+                g_status = check_header();
+                g_state = ST_OP;
+            }
+        } break;
+
+        case ST_OP: {
+            uint8_t op = data[i++];
+            if (op == DELTA_OP_END) {
+                g_status = finish();
+                g_state = ST_END;
+            } else if (op == DELTA_OP_DIFF) {
+                g_state = ST_DIFF_LEN;
+            } else if (op == DELTA_OP_INSERT) {
+                g_state = ST_INSERT_LEN;
+            } else {
+                g_status = DELTA_E_FORMAT;
+            }
+        } break;
+
+        case ST_DIFF_LEN:
+        case ST_INSERT_LEN: {
+            if (!varint(data[i++])) {
+                break;
+            }
+            if ((g_varint == 0) || (g_varint > g_new_size - g_out_pos)) {
+                g_status = DELTA_E_FORMAT;
+                break;
+            }
+            g_left = g_run = g_varint;
+            g_state = (g_state == ST_DIFF_LEN) ? ST_DIFF_SRC : ST_INSERT;
+        } break;
+
+        case ST_DIFF_SRC: {
+            if (!varint(data[i++])) {
+                break;
+            }
+            int64_t src = (int64_t)g_src + unzigzag(g_varint);
+            if ((src < 0) || (src + g_left > g_old_size)) {
+                g_status = DELTA_E_FORMAT;
+                break;
+            }
+            g_src = (uint32_t)src;
+            g_state = ST_ZEROS;
+        } break;
+
+        case ST_ZEROS: {
+            if (!varint(data[i++])) {
+                break;
+            }
+            if (g_varint > g_left) {
+                g_status = DELTA_E_FORMAT;
+                break;
+            }
+            if (!copy_old(NULL, g_varint)) {
+                g_status = DELTA_E_IO;
+                break;
+            }
+            g_left -= g_varint;
+            g_state = (g_left == 0) ? ST_OP : ST_NDIFF;
+        } break;
+
+        case ST_NDIFF: {
+            if (!varint(data[i++])) {
+                break;
+            }
+            if ((g_varint == 0) || (g_varint > g_left)) {
+                g_status = DELTA_E_FORMAT;
+                break;
+            }
+            g_run = g_varint;
+            g_state = ST_DIFF;
+        } break;
+
+        case ST_DIFF:
+        case ST_INSERT: {
+            uint32_t n = g_run;
+            if (n > len - i) {
+                n = len - i;
+            }
+            bool ok = (g_state == ST_DIFF) ? copy_old(&data[i], n) : put(&data[i], NULL, n);
+            if (!ok) {
+                g_status = DELTA_E_IO;
+                break;
+            }
+            i += n;
+            g_run -= n;
+            g_left -= n;
+            if (g_run == 0) {
+                g_state = (g_left == 0) ? ST_OP : ST_ZEROS;
+            }
+        } break;
+
+        default:
+            g_status = DELTA_E_FORMAT;
+            break;
+        }
+    }
+    return g_status;
+}
+
+int8_t delta_patch::status() {
+    return g_status;
+}
+
+uint32_t delta_patch::new_size() {
+    return g_new_size;
+}
+
+uint32_t delta_patch::written() {
+    return g_out_pos - g_out_len;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/** @brief decode the header & check the old image against its CRC (read once, block by block).
+*/
+int8_t delta_patch::check_header()
+{
+    wdm_frame::View<DeltaHeader> hdr(g_hdr, sizeof(g_hdr));
+    if ((hdr.get<DELTA_HDR_MAGIC>() != DELTA_MAGIC) || (hdr.get<DELTA_HDR_VERSION>() != DELTA_VERSION) ||
+        (hdr.get<DELTA_HDR_NEW_SIZE>() == 0)) {
+        return DELTA_E_FORMAT;
+    }
+    g_old_size = hdr.get<DELTA_HDR_OLD_SIZE>();
+    g_new_size = hdr.get<DELTA_HDR_NEW_SIZE>();
+    g_new_crc = hdr.get<DELTA_HDR_NEW_CRC>();
+
+    uint32_t crc = 0;
+    for (uint32_t base = 0; base < g_old_size; base += DELTA_SRC_SZ) {
+        uint32_t n = (g_old_size - base < DELTA_SRC_SZ) ? g_old_size - base : DELTA_SRC_SZ;
+        if (!g_read(base, (uint8_t *)g_cache, n)) {
+            return DELTA_E_IO;
+        }
+        g_cache_base = base;
+        crc = crc32(crc, (const uint8_t *)g_cache, n);
+    }
+    return (crc == hdr.get<DELTA_HDR_OLD_CRC>()) ? DELTA_OK : DELTA_E_BASE;
+}
+
+/** @brief DELTA_OP_END: write the last block, check the size & CRC of the new image.
+*/
+int8_t delta_patch::finish()
+{
+    if (!flush()) {
+        return DELTA_E_IO;
+    }
+    if (g_out_pos != g_new_size) {
+        return DELTA_E_FORMAT;
+    }
+    return (g_crc == g_new_crc) ? DELTA_DONE : DELTA_E_CRC;
+}
+
+/** @brief add one byte to the varint being read: return true once it is complete.
+ *  An overlong varint ends the patch (g_status).
+*/
+bool delta_patch::varint(uint8_t b)
+{
+    if (g_varint_shift == 0) {
+        g_varint = 0;
+    }
+    if (g_varint_shift >= 7 * DELTA_VARINT_MAX) {
+        g_status = DELTA_E_FORMAT;
+        return false;
+    }
+    g_varint |= (uint32_t)(b & 0x7f) << g_varint_shift;
+    if (b & 0x80) {
+        g_varint_shift += 7;
+        return false;
+    }
+    g_varint_shift = 0;
+    return true;
+}
+
+/** @brief output 'n' bytes of the old image from g_src, plus 'diff' if not NULL.
+*/
+bool delta_patch::copy_old(const uint8_t *diff, uint32_t n)
+{
+    while (n > 0) {
+        uint32_t base = g_src - (g_src % DELTA_SRC_SZ);
+        if (base != g_cache_base) {
+            uint32_t sz = (g_old_size - base < DELTA_SRC_SZ) ? g_old_size - base : DELTA_SRC_SZ;
+            if (!g_read(base, (uint8_t *)g_cache, sz)) {
+                g_cache_base = SRC_NONE;
+                return false;
+            }
+            g_cache_base = base;
+        }
+        uint32_t k = base + DELTA_SRC_SZ - g_src;
+        if (k > n) {
+            k = n;
+        }
+        if (!put((const uint8_t *)g_cache + (g_src - base), diff, k)) {
+            return false;
+        }
+        g_src += k;
+        n -= k;
+        if (diff != NULL) {
+            diff += k;
+        }
+    }
+    return true;
+}
+
+/** @brief output 'n' bytes: src[] (+ diff[] if not NULL).
+*/
+bool delta_patch::put(const uint8_t *src, const uint8_t *diff, size_t n)
+{
+    while (n > 0) {
+        size_t k = DELTA_OUT_SZ - g_out_len;
+        if (k > n) {
+            k = n;
+        }
+        uint8_t *p = &g_out[g_out_len];
+        if (diff != NULL) {
+            for (size_t j = 0; j < k; j++) {
+                p[j] = src[j] + diff[j];
+            }
+            diff += k;
+        } else {
+            memcpy(p, src, k);
+        }
+        g_out_len += k;
+        g_out_pos += k;
+        src += k;
+        n -= k;
+        if ((g_out_len == DELTA_OUT_SZ) && !flush()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool delta_patch::flush()
+{
+    if (g_out_len == 0) {
+        return true;
+    }
+    g_crc = crc32(g_crc, g_out, g_out_len);
+    bool ok = g_write(g_out, g_out_len);
+    g_out_len = 0;
+    return ok;
+}
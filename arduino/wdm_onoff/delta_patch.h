@@ -0,0 +1,58 @@
+/** @brief define Constants, Types & Prototypes for the Delta patch applier: rebuilds the new
+ *  firmware image from the running one and a patch (format: see wdm_delta.h) received in pieces
+ *  of any size. RAM: one block of the old image & one block of output, whatever the image size.
+ *  No Arduino dependency: the host tool (tools/wdm_delta) checks its patches with this code.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _DELTA_PATCH_H_
+#define _DELTA_PATCH_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Block of the old image read at once & block of the new image written at once (bytes) */
+#define DELTA_SRC_SZ                256
+#define DELTA_OUT_SZ                256
+
+/* Status */
+#define DELTA_OK                    0       // More patch bytes are needed
+#define DELTA_DONE                  1       // New image complete & checked
+#define DELTA_E_FORMAT              -1      // Invalid patch
+#define DELTA_E_BASE                -2      // The patch is not made against the running image
+#define DELTA_E_IO                  -3      // Read/write callback failed
+#define DELTA_E_CRC                 -4      // New image doesn't match the patch
+
+/* Read 'len' bytes of the old image at 'offset' (a multiple of DELTA_SRC_SZ): 'buf' is aligned
+   on 4 bytes and has room for 'len' rounded up to 4 */
+typedef bool (*DELTA_READ_t)(uint32_t offset, uint8_t *buf, size_t len);
+
+/* Write the next 'len' bytes of the new image */
+typedef bool (*DELTA_WRITE_t)(const uint8_t *buf, size_t len);
+
+class delta_patch
+{
+    public:
+        /* Start a new patch */
+        static void begin(DELTA_READ_t read_old, DELTA_WRITE_t write_new);
+
+        /* Apply the next bytes of the patch: return the status (DELTA_OK: go on) */
+        static int8_t feed(const uint8_t *data, size_t len);
+
+        static int8_t status();
+
+        /* Size of the new image (0 until the header is received) & bytes of it written */
+        static uint32_t new_size();
+        static uint32_t written();
+
+    private:
+        static int8_t check_header();
+        static int8_t finish();
+        static bool varint(uint8_t b);
+        static bool copy_old(const uint8_t *diff, uint32_t n);
+        static bool put(const uint8_t *src, const uint8_t *diff, size_t n);
+        static bool flush();
+};
+
+#endif
@@ -4,42 +4,127 @@
 #include "esp8266_mlib.h"
 #include "mtime.h"
 #include "mqtt_inf.h"
+#include "lan_inf.h"
+#include "evlog.h"
+#include "cfglog.h"
 #include "device.h"
+#include "perf.h"
+#include "dlog.h"
 
-#define DB      Serial.printf
+#define DB      DLOG
 #define ERR     Serial.printf
 #ifndef DB
   #define DB
 #endif
 
 ///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
-/* Device config storage file */
-const char *DEVICE_FILE_NAME = "/device.cfg";
-
-/* Schedules storage file */
-const char *SCHEDULE_FILE_NAME = "/schedule.cfg";
-
-/* Maximum schedule file content size */
-#define FILE_CONTENT_LIMIT			256
-
-/* Maximum Number of devices for a Node: use for multiple projects, for each project, developer
-should set the 'g_device_count' for the real number of devices. */
-#define DEVICE_COUNT                10
+/* Config log record types */
+#define REC_DEV_ENABLE              1   // [offset(1)][enable(1)]
+#define REC_SCHEDULE                2   // [offset(1)][slot(1)][id(1)][enable(1)][days(1)][time(2)][cmd(1)]
 
 /* Maximum number of schedules */
 #define SCHD_CNT			10
 
+/* Period of the STATUS heartbeat (seconds) */
+#define DEVICE_HEARTBEAT_SEC        (15 * 60)
+
 
 ///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
 static DEVICE_INFO_t g_device_list[DEVICE_COUNT];
 
+/* Output pin of each device */
+static const uint8_t g_pin_map[] = DEVICE_PIN_MAP;
+static_assert(sizeof(g_pin_map) <= DEVICE_COUNT, "DEVICE_PIN_MAP has more pins than DEVICE_COUNT");
+
 /* Number of devices for this Node */
-static uint8_t g_device_count = 1;
+static const uint8_t g_device_count = sizeof(g_pin_map);
 
-// File buffer:
-static uint8_t g_file_buf[FILE_CONTENT_LIMIT];
+/* A change was sent alone (not retained): the full state is sent at the next manager() call */
+static bool g_state_dirty;
 
 ///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+/** @brief drive the output pins of all devices in 'mask' at once.
+ *  @note GPIO0..15 are switched together by a single write to the GPO register, GPIO16 has its
+ *  own register and is switched right after.
+*/
+static void write_outputs(uint16_t mask, uint16_t cmds) {
+    uint32_t set_mask = 0;
+    uint32_t clr_mask = 0;
+    int16_t gpio16 = -1;
+
+    for (int i = 0; i < g_device_count; i++) {
+        if (mask & (1 << i)) {
+            uint8_t level = ((cmds >> i) & 1) ^ ((DEVICE_PIN_ACTIVE_LOW >> i) & 1);
+            uint8_t pin = g_pin_map[i];
+            if (pin == 16) {
+                gpio16 = level;
+            } else if (level) {
+                set_mask |= (1UL << pin);
+            } else {
+                clr_mask |= (1UL << pin);
+            }
+        }
+    }
+
+    noInterrupts();
+    GPO = (GPO & ~clr_mask) | set_mask;
+    if (gpio16 >= 0) {
+        GP16O = gpio16;
+    }
+    interrupts();
+
+    // Command -> actuation latency (only if a command is pending):
+    perf::end(PERF_CMD);
+}
+
+/** @brief append the schedule at 'slot' of a device to the config log.
+*/
+static void log_schedule(uint8_t offset, uint8_t slot, const SCHD_INFO_t *p_sch) {
+    uint8_t rec[8];
+
+    rec[0] = offset;
+    rec[1] = slot;
+    rec[2] = p_sch->id;
+    rec[3] = p_sch->enable;
+    rec[4] = p_sch->days;
+    esp8266_mlib::u16_to_buf(p_sch->time, &rec[5]);
+    rec[7] = p_sch->cmd;
+    cfglog::append(REC_SCHEDULE, rec, sizeof(rec));
+}
+
+/** @brief compare two schedules field by field (not memcmp: the padding bytes may differ).
+*/
+static bool schedule_equal(const SCHD_INFO_t *a, const SCHD_INFO_t *b) {
+    return (a->id == b->id) && (a->enable == b->enable) && (a->days == b->days) &&
+           (a->time == b->time) && (a->cmd == b->cmd);
+}
+
+static void log_enable(uint8_t offset, uint8_t enable) {
+    uint8_t rec[2] = { offset, enable };
+    cfglog::append(REC_DEV_ENABLE, rec, sizeof(rec));
+}
+
+/** @brief apply one config log record.
+*/
+static void replay_record(uint8_t type, const uint8_t *data, uint8_t len) {
+    uint8_t offset = data[0];
+    if ((offset == 0) || (offset > g_device_count)) {
+        return;
+    }
+    DEVICE_CONFIG_t *p_cfg = &g_device_list[offset - 1].config;
+
+    if ((type == REC_DEV_ENABLE) && (len == 2)) {
+        p_cfg->enable = data[1];
+    } else if ((type == REC_SCHEDULE) && (len == 8) && (data[1] < DEVICE_SCHEDULE_CNT)) {
+        SCHD_INFO_t *p_sch = &p_cfg->schedules[data[1]];
+        p_sch->id = data[2];
+        p_sch->enable = data[3];
+        p_sch->days = data[4];
+        p_sch->time = esp8266_mlib::buf_to_u16((uint8_t *)&data[5]);
+        p_sch->cmd = data[7];
+    }
+}
+
 /** @brief this function is called at the second=0 of every minute and only once per minute. If not,
  *  the schedule's command may be executed multiple times.
 */
@@ -48,6 +133,7 @@ static void check_schedule(DEVICE_INFO_t *p_dev, uint8_t today, uint16_t now_min
         SCHD_INFO_t *p_sch = &p_dev->config.schedules[i];
         if ((p_sch->id != 0) && (p_sch->enable != 0) && (p_sch->days & today)) {
             if (p_sch->time == now_min) {
+                evlog::push(EV_TYPE_SCHEDULE, ((uint32_t)p_sch->id << 16) | (p_dev->offset << 8) | p_sch->cmd);
                 device::control(p_dev->offset, p_sch->cmd);
             }
         }
@@ -56,6 +142,12 @@ static void check_schedule(DEVICE_INFO_t *p_dev, uint8_t today, uint16_t now_min
 
 ///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
 void device::init() {
+    // Outputs: all OFF
+    for (int i = 0; i < g_device_count; i++) {
+        pinMode(g_pin_map[i], OUTPUT);
+    }
+    write_outputs((1 << g_device_count) - 1, 0);
+
 	// Load Device settings:
     for (int i = 0; i < g_device_count; i++) {
         DEVICE_INFO_t *p_dev = &g_device_list[i];
@@ -68,16 +160,19 @@ void device::init() {
     }
 	
 	// Load Schedules:
-	
+	load_settings();
 }
 
 // This function is called every 1s.
 void device::manager() {
-	static uint32_t cnt_1min;
+	static uint32_t cnt_heartbeat;
 
-    // Auto send STATUS to server every 1 minutes:
-    if (++cnt_1min >= 60) {
-        cnt_1min = 0;
+    // Heartbeat: the state is retained by the broker and the presence is handled by the
+    // MQTT Last-Will, so a full STATUS is only sent as a slow refresh, or after changes (the
+    // changes of one second in one packet).
+    if (g_state_dirty || (++cnt_heartbeat >= DEVICE_HEARTBEAT_SEC)) {
+        cnt_heartbeat = 0;
+        g_state_dirty = false;
         mqtt_inf::send_STATUS(g_device_count, g_device_list);
     }
 
@@ -101,38 +196,68 @@ const DEVICE_INFO_t *device::get_status()
     return g_device_list;
 }
 
+/** @brief update the config of a device.
+ *  @note only the changed parts are stored: one record per changed schedule.
+*/
 void device::config(uint8_t offset, const DEVICE_CONFIG_t *cfg) {
 	if ((offset > 0) && (offset <= g_device_count)) {
-        memcpy(&g_device_list[offset - 1].config, cfg, sizeof(DEVICE_CONFIG_t));
-        store_settings();
+        DEVICE_CONFIG_t *p_cfg = &g_device_list[offset - 1].config;
+        if (p_cfg->enable != cfg->enable) {
+            log_enable(offset, cfg->enable);
+        }
+        for (int i = 0; i < DEVICE_SCHEDULE_CNT; i++) {
+            if (!schedule_equal(&p_cfg->schedules[i], &cfg->schedules[i])) {
+                log_schedule(offset, i, &cfg->schedules[i]);
+            }
+        }
+        memcpy(p_cfg, cfg, sizeof(DEVICE_CONFIG_t));
     }	
 }
 
 void device::control(uint8_t offset, uint8_t cmd) {    
     if ((offset > 0) && (offset <= g_device_count)) {
-        DEVICE_INFO_t *p_dev = &g_device_list[offset - 1];
-        DB("\r\n%s: offset=%u, cmd=%u", __FUNCTION__, offset, cmd);
-        if (cmd > 1) {
-            cmd = 1;
+        control_mask(1 << (offset - 1), (cmd ? 1 : 0) << (offset - 1));
+    }
+}
+
+/** @brief switch a group of devices at once.
+ *  @param mask: bit (offset - 1) is set for each device to control.
+ *  @param cmds: bit (offset - 1) is the new state of the device.
+ *  @note all changed outputs are switched together and reported in one STATUS packet (to the
+ *  server & to the LAN, whatever the source of the command).
+*/
+void device::control_mask(uint16_t mask, uint16_t cmds) {
+    uint16_t changed = 0;
+
+    mask &= (1 << g_device_count) - 1;
+    DB("\r\n%s: mask=%04Xh, cmds=%04Xh", __FUNCTION__, mask, cmds);
+    for (int i = 0; i < g_device_count; i++) {
+        if (mask & (1 << i)) {
+            DEVICE_INFO_t *p_dev = &g_device_list[i];
+            uint8_t cmd = (cmds >> i) & 1;
+            if (p_dev->v != cmd) {
+                p_dev->v = cmd;
+                p_dev->t = mtime::get_local_unix();
+                changed |= (1 << i);
+            }
         }
-        if (p_dev->v != cmd) {
-            DB(" -> status changed!");
-            p_dev->v = cmd;
-            p_dev->t = mtime::get_local_unix();
-            switch (offset) {
-            case 1:
-                digitalWrite(LED_BUILTIN, !cmd);
-                break;
-            
-            case 2:
-                break;
-
-            default:
-                break;
+    }
+
+    if (changed != 0) {
+        DB(" -> status changed: %04Xh", changed);
+        write_outputs(changed, cmds);
+
+        for (int i = 0; i < g_device_count; i++) {
+            if (changed & (1 << i)) {
+                evlog::push(EV_TYPE_CONTROL, (g_device_list[i].offset << 8) | g_device_list[i].v);
             }
+        }
 
-            // Send status to Server:
-            mqtt_inf::send_STATUS(1, p_dev);
+        // Send status to Server & to the LAN, then the full state (retained) to the Server:
+        mqtt_inf::send_STATUS(g_device_count, g_device_list, changed);
+        lan_inf::send_STATUS(g_device_count, g_device_list, changed);
+        if (changed != (1 << g_device_count) - 1) {
+            g_state_dirty = true;
         }
     }
 }
@@ -154,22 +279,27 @@ DB("\r\n%s: offset=%u, v=%u -> cmd=%u", __FUNCTION__, offset, p_dev->v, cmd);
 ///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
 /**
  * Load settings from ROM memory (Non-volatile).
- * File format (text):
- *  Line-0: [MagicNumber][LF]
- *  Line-1: [ScheduleCount][LF]		<= 10
- *  Line-2: [Schedule-1][LF]
- *  Line-3: [Schedule-2][LF]
- *  Line-4: [Schedule-3][LF]
-....
+ * The settings are stored in the config log (see cfglog), as records:
+ *  REC_DEV_ENABLE: [offset(1)][enable(1)]
+ *  REC_SCHEDULE:   [offset(1)][slot(1)][id(1)][enable(1)][days(1)][time(2)][cmd(1)]
+ * Records are replayed in order, the last one for a device/slot wins.
 */
 void device::load_settings() {
-    //uint32_t sz = esp8266_mlib::load_file(DEVICE_FILE_NAME, g_file_buf, FILE_CONTENT_LIMIT);
-	
-	
+    uint32_t cnt = cfglog::load(replay_record, store_settings);
+    DB("\r\n%s: cnt=%u", __FUNCTION__, cnt);
 }
 
+/**
+ * Store all settings: called by the config log when it is compacted.
+*/
 void device::store_settings() {
-	
+    for (int i = 0; i < g_device_count; i++) {
+        DEVICE_INFO_t *p_dev = &g_device_list[i];
+        log_enable(p_dev->offset, p_dev->config.enable);
+        for (int k = 0; k < DEVICE_SCHEDULE_CNT; k++) {
+            if (p_dev->config.schedules[k].id != 0) {
+                log_schedule(p_dev->offset, k, &p_dev->config.schedules[k]);
+            }
+        }
+    }
 }
-
-
@@ -8,6 +8,22 @@
 
 
 
+/* Maximum Number of devices for a Node: use for multiple projects, for each project, developer
+should set the DEVICE_PIN_MAP for the real devices. */
+#define DEVICE_COUNT                10
+
+/* Output pins: the output of device at 'offset' is driven by DEVICE_PIN_MAP[offset - 1].
+Devices listed in DEVICE_PIN_ACTIVE_LOW (bit 'offset - 1') are ON when the pin is LOW. */
+#ifndef DEVICE_PIN_MAP
+#define DEVICE_PIN_MAP              { LED_BUILTIN }
+#ifndef DEVICE_PIN_ACTIVE_LOW
+#define DEVICE_PIN_ACTIVE_LOW       0x0001      // The built-in LED is ON when LOW
+#endif
+#endif
+#ifndef DEVICE_PIN_ACTIVE_LOW
+#define DEVICE_PIN_ACTIVE_LOW       0x0000
+#endif
+
 /* Maximum schedules per device */
 #define DEVICE_SCHEDULE_CNT			10
 
@@ -39,6 +55,13 @@ struct DEVICE_INFO_t {
 
 
 
+/* Event types */
+#define EV_TYPE_CONTROL             1   // detail = [0][0][offset][cmd]
+#define EV_TYPE_SCHEDULE            2   // detail = [0][schd_id][offset][cmd]
+#define EV_TYPE_BUTTON              3   // detail = button event (see capture_button())
+#define EV_TYPE_RULE                4   // detail = [0][rule_id][offset][cmd]
+#define EV_TYPE_OTA                 5   // detail = update status (DELTA_*, see delta_patch.h)
+
 struct EVENT_INFO_t {
     uint8_t type;
     uint32_t time; 
@@ -57,6 +80,7 @@ class device
         static const DEVICE_INFO_t *get_status();
         static void config(uint8_t offset, const DEVICE_CONFIG_t *cfg);		
 		static void control(uint8_t offset, uint8_t cmd);
+		static void control_mask(uint16_t mask, uint16_t cmds);
         static void toggle(uint8_t offset);
 		
     private:
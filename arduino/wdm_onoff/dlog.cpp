@@ -0,0 +1,141 @@
+/**	@brief implement the Deferred log: entries are packed in a byte ring buffer, the oldest
+ *  entries are dropped on overflow (and counted). Draining sends each entry as one binary frame,
+ *  so the host decoder can re-synchronize after lost bytes or the ROM boot messages.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "dlog.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Internal entries (decoded like the other ones) */
+static const char DLOG_BOOT_FMT[] = "\r\n[boot]";
+static const char DLOG_LOST_FMT[] = "\r\n[dlog] %u entries lost";
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+struct DLOG_RING_t {
+    uint16_t head;      // Write position
+    uint16_t tail;      // Read position (oldest entry)
+    uint16_t used;      // Bytes in the buffer
+    uint16_t lost;      // Entries dropped since the last drain
+    uint8_t buf[DLOG_BUF_SZ];
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static DLOG_RING_t g_ring;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void dlog::init()
+{
+    log(DLOG_BOOT_FMT);
+}
+
+void dlog::idle()
+{
+    while (drain_one(false)) {
+    }
+}
+
+void dlog::flush()
+{
+    while (drain_one(true)) {
+    }
+}
+
+uint16_t dlog::pending()
+{
+    return g_ring.used;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+void dlog::write(const uint8_t *e, uint8_t n)
+{
+    // Drop the oldest entries:
+    while (DLOG_BUF_SZ - g_ring.used < n) {
+        uint8_t len = g_ring.buf[g_ring.tail];
+        g_ring.tail = (g_ring.tail + len) % DLOG_BUF_SZ;
+        g_ring.used -= len;
+        g_ring.lost++;
+    }
+
+    uint16_t first = DLOG_BUF_SZ - g_ring.head;
+    if (first >= n) {
+        memcpy(&g_ring.buf[g_ring.head], e, n);
+    } else {
+        memcpy(&g_ring.buf[g_ring.head], e, first);
+        memcpy(g_ring.buf, &e[first], n - first);
+    }
+    g_ring.head = (g_ring.head + n) % DLOG_BUF_SZ;
+    g_ring.used += n;
+}
+
+/** @brief send the oldest entry (or the lost entries count) to Serial.
+    @param block: false -> only if the Serial TX FIFO has room for the whole frame.
+    @return true if a frame was sent.
+*/
+bool dlog::drain_one(bool block)
+{
+    uint8_t frame[DLOG_ENTRY_MAX + 2];
+    uint8_t *e = &frame[1];
+    uint8_t n;
+
+    if (g_ring.lost > 0) {
+        n = DLOG_HDR_SZ + 4;
+        put_u32(&e[1], (uint32_t)(uintptr_t)DLOG_LOST_FMT);
+        put_u32(&e[5], millis());
+        put_u32(&e[9], g_ring.lost);
+        e[0] = n;
+    } else if (g_ring.used > 0) {
+        n = g_ring.buf[g_ring.tail];
+        for (uint8_t i = 0; i < n; i++) {
+            e[i] = g_ring.buf[(g_ring.tail + i) % DLOG_BUF_SZ];
+        }
+    } else {
+        return false;
+    }
+
+    if (!block && (Serial.availableForWrite() < n + 2)) {
+        return false;
+    }
+
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        sum += e[i];
+    }
+    frame[0] = DLOG_SYNC;
+    frame[n + 1] = sum;
+    Serial.write(frame, n + 2);
+
+    if (g_ring.lost > 0) {
+        g_ring.lost = 0;
+    } else {
+        g_ring.tail = (g_ring.tail + n) % DLOG_BUF_SZ;
+        g_ring.used -= n;
+    }
+    return true;
+}
+
+void dlog::pack_one(uint8_t *e, uint8_t &n, const char *s)
+{
+    if (s == NULL) {
+        s = "(null)";
+    }
+    if (n >= DLOG_ENTRY_MAX) {
+        return;
+    }
+    uint8_t len = strnlen(s, DLOG_STR_MAX);
+    if (len > DLOG_ENTRY_MAX - n - 1) {
+        len = DLOG_ENTRY_MAX - n - 1;
+    }
+    e[n++] = len;
+    memcpy(&e[n], s, len);
+    n += len;
+}
+
+void dlog::pack_raw(uint8_t *e, uint8_t &n, const void *v, uint8_t sz)
+{
+    if (n + sz <= DLOG_ENTRY_MAX) {
+        memcpy(&e[n], v, sz);
+        n += sz;
+    }
+}
@@ -0,0 +1,224 @@
+/**	@brief implement the Event log: events are kept in a RAM ring buffer (optionally spilled to
+ *  flash when it is full) until they are sent to the server.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "FS.h"
+#include "esp8266_mlib.h"
+#include "mtime.h"
+#include "mqtt_inf.h"
+#include "evlog.h"
+
+//#define DB      Serial.printf
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Spilled events storage file, & the number of them already sent: [count(4)] */
+const char *EVLOG_FILE_NAME = "/events.bin";
+const char *EVLOG_RD_FILE_NAME = "/events.rd";
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+/* RAM ring buffer */
+static EVENT_INFO_t g_ring[EVLOG_RAM_CNT];
+static uint8_t g_head;
+static uint8_t g_cnt;
+
+/* Events stored in the spill file, and number of them already sent */
+static uint32_t g_spill_cnt;
+static uint32_t g_spill_rd;
+
+/* Events lost on overflow */
+static uint32_t g_dropped;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void evlog::init() {
+    g_head = 0;
+    g_cnt = 0;
+    g_spill_cnt = 0;
+    g_spill_rd = 0;
+
+#if EVLOG_SPILL_ENABLE
+    // Events spilled before the last reboot are still pending:
+    File f = SPIFFS.open(EVLOG_FILE_NAME, "r");
+    if (f) {
+        g_spill_cnt = f.size() / EVLOG_EVENT_SZ;
+        f.close();
+    }
+    // Those sent before the reboot are skipped:
+    esp8266_mlib::recover_data(EVLOG_RD_FILE_NAME);
+    f = SPIFFS.open(EVLOG_RD_FILE_NAME, "r");
+    if (f) {
+        uint8_t buf[4];
+        if (f.read(buf, sizeof(buf)) == sizeof(buf)) {
+            g_spill_rd = esp8266_mlib::buf_to_u32(buf);
+        }
+        f.close();
+        if (g_spill_rd >= g_spill_cnt) {
+            // All sent, the files were being removed:
+            SPIFFS.remove(EVLOG_FILE_NAME);
+            SPIFFS.remove(EVLOG_RD_FILE_NAME);
+            g_spill_cnt = 0;
+            g_spill_rd = 0;
+        }
+    }
+#endif
+    DB("\r\n%s: spill_cnt=%u, spill_rd=%u", __FUNCTION__, g_spill_cnt, g_spill_rd);
+}
+
+void evlog::push(uint8_t type, uint32_t detail) {
+    if (g_cnt >= EVLOG_RAM_CNT) {
+        spill();
+    }
+    if (g_cnt >= EVLOG_RAM_CNT) {
+        // Overwrite the oldest event:
+        g_head = (g_head + 1) % EVLOG_RAM_CNT;
+        g_cnt--;
+        g_dropped++;
+    }
+
+    EVENT_INFO_t *p_ev = &g_ring[(g_head + g_cnt) % EVLOG_RAM_CNT];
+    p_ev->type = type;
+    p_ev->time = mtime::get_local_unix();
+    p_ev->detail = detail;
+    g_cnt++;
+    DB("\r\n%s: type=%u, detail=%08lXh -> cnt=%u", __FUNCTION__, type, detail, g_cnt);
+}
+
+/** @brief send pending events, oldest first, using at most EVLOG_FLUSH_LIMIT publishes.
+    @return true if all events are sent.
+*/
+bool evlog::flush() {
+    EVENT_INFO_t batch[EVLOG_BATCH_CNT];
+
+    for (int n = 0; n < EVLOG_FLUSH_LIMIT; n++) {
+        if (g_spill_rd < g_spill_cnt) {
+            if (!flush_spill()) {
+                return false;
+            }
+            continue;
+        }
+        if (g_cnt == 0) {
+            return true;
+        }
+
+        uint8_t k = 0;
+        while ((k < EVLOG_BATCH_CNT) && (k < g_cnt)) {
+            batch[k] = g_ring[(g_head + k) % EVLOG_RAM_CNT];
+            k++;
+        }
+        if (!mqtt_inf::send_EVENT(k, batch)) {
+            return false;
+        }
+        g_head = (g_head + k) % EVLOG_RAM_CNT;
+        g_cnt -= k;
+    }
+    return count() == 0;
+}
+
+uint32_t evlog::count() {
+    return g_cnt + (g_spill_cnt - g_spill_rd);
+}
+
+uint32_t evlog::dropped() {
+    return g_dropped;
+}
+
+void evlog::pack(const EVENT_INFO_t *ev, uint8_t buf[]) {
+    buf[0] = ev->type;
+    esp8266_mlib::u32_to_buf(ev->time, &buf[1]);
+    esp8266_mlib::u32_to_buf(ev->detail, &buf[5]);
+}
+
+void evlog::unpack(const uint8_t buf[], EVENT_INFO_t *ev) {
+    ev->type = buf[0];
+    ev->time = esp8266_mlib::buf_to_u32((uint8_t *)&buf[1]);
+    ev->detail = esp8266_mlib::buf_to_u32((uint8_t *)&buf[5]);
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/**
+ * Move the oldest EVLOG_BATCH_CNT events from RAM to the spill file.
+ * File format (binary): [Event-1(9)][Event-2(9)]...
+*/
+void evlog::spill() {
+#if EVLOG_SPILL_ENABLE
+    uint8_t buf[EVLOG_BATCH_CNT * EVLOG_EVENT_SZ];
+    uint8_t k = 0;
+
+    if ((g_spill_cnt + EVLOG_BATCH_CNT) * EVLOG_EVENT_SZ > EVLOG_SPILL_LIMIT) {
+        return;
+    }
+    for (k = 0; k < EVLOG_BATCH_CNT; k++) {
+        pack(&g_ring[(g_head + k) % EVLOG_RAM_CNT], &buf[k * EVLOG_EVENT_SZ]);
+    }
+
+    File f = SPIFFS.open(EVLOG_FILE_NAME, "a");
+    if (!f) {
+        DB("\r\n%s: open file failed!", __FUNCTION__);
+        return;
+    }
+    f.write(buf, sizeof(buf));
+    f.close();
+
+    g_head = (g_head + EVLOG_BATCH_CNT) % EVLOG_RAM_CNT;
+    g_cnt -= EVLOG_BATCH_CNT;
+    g_spill_cnt += EVLOG_BATCH_CNT;
+    DB("\r\n%s: spill_cnt=%u", __FUNCTION__, g_spill_cnt);
+#endif
+}
+
+/**
+ * Send one batch of events from the spill file, remove the file when all are sent. The number
+ * of events sent is stored after each batch, so they aren't sent again after a reboot.
+*/
+bool evlog::flush_spill() {
+#if EVLOG_SPILL_ENABLE
+    EVENT_INFO_t batch[EVLOG_BATCH_CNT];
+    uint8_t buf[EVLOG_BATCH_CNT * EVLOG_EVENT_SZ];
+    uint32_t k = g_spill_cnt - g_spill_rd;
+
+    if (k > EVLOG_BATCH_CNT) {
+        k = EVLOG_BATCH_CNT;
+    }
+
+    File f = SPIFFS.open(EVLOG_FILE_NAME, "r");
+    if (!f) {
+        // File lost: forget about it.
+        g_dropped += g_spill_cnt - g_spill_rd;
+        SPIFFS.remove(EVLOG_RD_FILE_NAME);
+        g_spill_cnt = 0;
+        g_spill_rd = 0;
+        return true;
+    }
+    f.seek(g_spill_rd * EVLOG_EVENT_SZ, SeekSet);
+    k = f.read(buf, k * EVLOG_EVENT_SZ) / EVLOG_EVENT_SZ;
+    f.close();
+    if (k == 0) {
+        g_dropped += g_spill_cnt - g_spill_rd;
+        g_spill_rd = g_spill_cnt;
+    }
+
+    for (uint32_t i = 0; i < k; i++) {
+        unpack(&buf[i * EVLOG_EVENT_SZ], &batch[i]);
+    }
+    if ((k > 0) && !mqtt_inf::send_EVENT(k, batch)) {
+        return false;
+    }
+
+    g_spill_rd += k;
+    if (g_spill_rd >= g_spill_cnt) {
+        SPIFFS.remove(EVLOG_FILE_NAME);
+        SPIFFS.remove(EVLOG_RD_FILE_NAME);
+        g_spill_cnt = 0;
+        g_spill_rd = 0;
+    } else {
+        uint8_t rd[4];
+        esp8266_mlib::u32_to_buf(g_spill_rd, rd);
+        esp8266_mlib::save_data(EVLOG_RD_FILE_NAME, rd, sizeof(rd));
+    }
+#endif
+    return true;
+}
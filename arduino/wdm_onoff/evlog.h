@@ -0,0 +1,56 @@
+/** @brief define Constants, Prototypes for the Event log module.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _EVLOG_H_
+#define _EVLOG_H_
+
+#include "device.h"
+
+/* Number of events kept in RAM */
+#define EVLOG_RAM_CNT               32
+
+/* Maximum events per EVENT publish */
+#define EVLOG_BATCH_CNT             8
+
+/* Maximum EVENT publishes per flush() call */
+#define EVLOG_FLUSH_LIMIT           4
+
+/* Spill events to flash when the RAM buffer is full: 0 = disabled, 1 = enabled */
+#ifndef EVLOG_SPILL_ENABLE
+#define EVLOG_SPILL_ENABLE          1
+#endif
+
+/* Maximum size of the spill file (bytes) */
+#define EVLOG_SPILL_LIMIT           2048
+
+/* Size of one event when packed: [type(1)][time(4)][detail(4)] */
+#define EVLOG_EVENT_SZ              9
+
+class evlog
+{
+    public:
+        static void init();
+
+        /* Record an event, stamped with the current local time */
+        static void push(uint8_t type, uint32_t detail);
+
+        /* Send pending events to server in batches, return true if nothing left */
+        static bool flush();
+
+        /* Number of pending events (RAM + flash) */
+        static uint32_t count();
+
+        /* Number of events lost because both RAM & flash were full */
+        static uint32_t dropped();
+
+        static void pack(const EVENT_INFO_t *ev, uint8_t buf[]);
+        static void unpack(const uint8_t buf[], EVENT_INFO_t *ev);
+
+    private:
+        static void spill();
+        static bool flush_spill();
+};
+
+#endif
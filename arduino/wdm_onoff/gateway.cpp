@@ -0,0 +1,109 @@
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+#include <wdm_proto.h>
+#include "lan_inf.h"
+#include "rules.h"
+#include "transport_espnow.h"
+#include "transport_mqtt.h"
+#include "gateway.h"
+#include "dlog.h"
+
+#define DB        DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+// Opcodes of the node protocol:
+#define OPU_STATUS              0x02
+#define OPH_ACK                 0x02
+
+/* Gateway states */
+#define GW_STATE_IDLE           0       // Waiting for the station to connect
+#define GW_STATE_RUN            1
+#define GW_STATE_FAILED         2
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static uint8_t g_state;
+static const TRANSPORT_t *g_nodes = &transport_espnow::ops;
+static const TRANSPORT_t *g_server = &transport_mqtt::ops;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void gateway::manager()
+{
+    uint8_t buf[ESPNOW_FRAME_MAX];
+
+    if (g_state == GW_STATE_IDLE) {
+        // ESP-NOW uses the channel of the AP: start once connected
+        if (WiFi.status() != WL_CONNECTED) {
+            return;
+        }
+        transport_espnow::setup(true, NULL, 0);
+        g_state = g_nodes->open() ? GW_STATE_RUN : GW_STATE_FAILED;
+        DB("\r\n%s: %s, state=%u", __FUNCTION__, g_nodes->name, g_state);
+    }
+    if (g_state != GW_STATE_RUN) {
+        return;
+    }
+
+    for (int k = 0; k < GATEWAY_RX_BUDGET; k++) {
+        int len = g_nodes->recv(buf, sizeof(buf), 0);
+        if (len == 0) {
+            break;
+        }
+        if (len > 0) {
+            rx_packet(buf, len);
+        }
+    }
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/** @brief Process RX packet.
+ *  @note packet format: [marker(1)][sequence(4)][id(6)][opcode(1)][data()][FCS(8)]
+ *      OPU_STATUS: data() = [DevCnt(1)=N][N x UdpDeviceStatus]
+*/
+void gateway::rx_packet(const uint8_t *buf, size_t len)
+{
+    wdm_frame::View<UdpHeader> hdr(buf, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    if (!hdr.valid() || (hdr.get<UDP_HDR_MARKER>() != UDP_MARKER) || !lan_inf::verify(buf, len)) {
+        return;
+    }
+    const uint8_t *id = hdr.get<UDP_HDR_ID>();
+    uint8_t opcode = hdr.get<UDP_HDR_OPCODE>();
+    uint32_t seq = hdr.get<UDP_HDR_SEQ>();
+    DB("\r\n%s: id=..%02X, op=%02Xh, seq=%u, len=%u", __FUNCTION__, id[5], opcode, seq, (unsigned)len);
+    if (opcode != OPU_STATUS) {
+        return;
+    }
+
+    // Rules:
+    wdm_frame::Reader rd(hdr.tail(), hdr.tail_len());
+    wdm_frame::View<UdpCount> v = rd.next<UdpCount>();
+    uint8_t cnt = v.valid() ? v.get<0>() : 0;
+    for (uint8_t k = 0; k < cnt; k++) {
+        wdm_frame::View<UdpDeviceStatus> dev = rd.next<UdpDeviceStatus>();
+        if (!dev.valid()) {
+            break;
+        }
+        rules::sample(id, dev.get<UDP_DEV_OFFSET>(), (int32_t)dev.get<UDP_DEV_VALUE>());
+    }
+
+    // Server: the packet as is (signed by the node). Not relayed (server link down): no ACK, the
+    // node falls back to its other transports
+    if (!g_server->send(buf, len)) {
+        DB("\r\n%s: relay failed", __FUNCTION__);
+        return;
+    }
+
+    // ACK: the node goes back to sleep as soon as it has it
+    uint8_t arr[UdpHeader::size + UdpAck::size + UDP_FCS_SZ];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    w.put<UdpHeader>(UDP_MARKER, seq, id, OPH_ACK);
+    w.put<UdpAck>(seq, opcode);
+    w.reserve(UDP_FCS_SZ);
+    lan_inf::sign(arr, w.length());
+    transport_espnow::set_peer(transport_espnow::rx_peer());
+    g_nodes->send(arr, w.length());
+}
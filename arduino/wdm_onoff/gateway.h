@@ -0,0 +1,27 @@
+/** @brief define Constants, Prototypes for the ESP-NOW gateway: battery nodes (wdm_th) send their
+ *  STATUS to this mains powered node without joining the AP. The samples feed the rule engine &
+ *  are relayed as is to the server (transport_mqtt); the sender gets its ACK only once the packet
+ *  is relayed.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _GATEWAY_H_
+#define _GATEWAY_H_
+
+#include "Arduino.h"
+
+/* Packets handled per manager() call */
+#define GATEWAY_RX_BUDGET           4
+
+class gateway
+{
+    public:
+        /* Receive the pending packets: non-blocking, called from loop() */
+        static void manager();
+
+    private:
+        static void rx_packet(const uint8_t *buf, size_t len);
+};
+
+#endif
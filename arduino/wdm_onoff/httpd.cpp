@@ -1,221 +1,275 @@
 #include "Arduino.h"
 #include <ESP8266WiFi.h>
+#include <DNSServer.h>
 #include "esp8266_mlib.h"
+#include "http_req.h"
+#include "url_query.h"
 #include "httpd.h"
+#include "dlog.h"
 
 
-#define DB      Serial.printf
+#define DB      DLOG
 #ifndef DB
   #define DB
 #endif
 
 ///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* A request must be complete within this time (ms) */
+#define HTTPD_REQ_TIMEOUT_MS        3000
+
+/* DNS port (captive portal) */
+#define HTTPD_DNS_PORT              53
+
+/* RX/TX chunks (stack) */
+#define HTTPD_RX_CHUNK              64
+#define HTTPD_TX_CHUNK              64
+
+/* Responses */
+static const char HTML_DEFAULT_HDR[] PROGMEM =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/html\r\n"
+    "Connection: close\r\n"   // the connection will be closed after completion of the response
+    "\r\n"
+    "MAC address: ";
+static const char HTML_DEFAULT_FORMAT[] PROGMEM =
+    "\r\n"
+    "Format: /cfg?ssid=p1&password=p2&server=p3&security=p4\r\n";
+static const char HTML_CFG_HDR[] PROGMEM =
+    "HTTP/1.1 200 nOt Found\r\n"
+    "Content-Type: text/html\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "<!DOCTYPE HTML>"
+    "<html>"
+    "Config Result: ";
+static const char HTML_CFG_END[] PROGMEM = "</html>\r\n";
+static const char HTML_ERROR_HDR[] PROGMEM =
+    "\r\n"
+    "Content-Type: text/html\r\n"
+    "Connection: close\r\n"
+    "\r\n";
 
 ///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
 /* HTTP server */
 WiFiServer server(80);
 
+/* Captive portal: every name resolves to the AP address */
+static DNSServer g_dns;
+
+/* Current client (one at a time, the next ones wait in the backlog) & its request */
+static WiFiClient g_client;
+static HTTP_REQ_t g_req;
+static uint32_t g_req_ms;
+
 ///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
 void httpd::init()
 {
 	server.begin();	
+    g_dns.setErrorReplyCode(DNSReplyCode::NoError);
+    g_dns.start(HTTPD_DNS_PORT, "*", WiFi.softAPIP());
 }
 
 /**
- * Implement HTTP server to get configuration from HTTP client.
- * Return 1 if having new configuration, 0 if not.
+ * Run the HTTP server & the DNS responder without blocking: each call handles the pending events
+ * (DNS query, new client, received data, request timeout) & returns.
+ * Return HTTPD_EV_CONFIG if having new configuration, HTTPD_EV_ACTIVITY if something was handled,
+ * HTTPD_EV_NONE if not.
 */
-uint32_t httpd::get_config(ROM_SETTINGS_t *settings)
+uint8_t httpd::poll(ROM_SETTINGS_t *settings)
 {
-    WiFiClient client = server.available();
-	String req = "";
-
-    // wait for a client (web browser) to connect
-    if (client) {
-        DB("\r\n[Client connected]");
-        while (client.connected())
-        {
-            // read line by line what the client (web browser) is requesting
-            if (client.available())
-            {
-                char c = client.read();
-                req += c;
-                if (c == '\n') {                    
-                    if (req.indexOf("GET /cfg?") != -1) {
-                        char sbuf[64];
-                        uint32_t val_sz = 0;
-                        uint32_t param_cnt = 0;
-    
-                        val_sz = get_param(req.c_str(), "ssid=", sbuf, 64);
-                        if ((val_sz > 0) && (val_sz < CFG_SSID_SZ)) {
-                            parse_percent(sbuf);
-                            sprintf(settings->ssid, sbuf, val_sz);
-                            param_cnt++;
-                        }
-                        val_sz = get_param(req.c_str(), "password=", sbuf, 64);
-                        if ((val_sz >= 8) && (val_sz < CFG_PASSWORD_SZ)) {
-                            parse_percent(sbuf);
-                            sprintf(settings->password, sbuf, val_sz);
-                            param_cnt++;
-                        }
-                        val_sz = get_param(req.c_str(), "server=", sbuf, 64);
-                        if ((val_sz > 0) && (val_sz < CFG_SERVER_SZ)) {
-                            parse_percent(sbuf);
-                            sprintf(settings->server_addr, sbuf, val_sz);
-                            param_cnt++;
-                        }
-						val_sz = get_param(req.c_str(), "port=", sbuf, 64);
-                        if ((val_sz > 0) && (val_sz < 10)) {
-                            settings->server_port = atoi(sbuf);
-                            param_cnt++;
-                        }
-                        val_sz = get_param(req.c_str(), "security=", sbuf, 64);
-                        if ((val_sz > 0) && (val_sz < CFG_SECURITY_SZ)) {
-                            parse_percent(sbuf);
-                            sprintf(settings->security, sbuf, val_sz);
-                            param_cnt++;
-                        }                        
-						val_sz = get_param(req.c_str(), "tz=", sbuf, 64);
-                        if ((val_sz > 0) && (val_sz < 10)) {
-                            settings->timezone = atoi(sbuf);
-                            param_cnt++;
-                        }
-						
-                        DB(" -> param_cnt=%d", param_cnt);
-    
-                        // Send result to client:
-                        client.print(htmlCfg(param_cnt >= 5));
-                        if (param_cnt >= 5) {
-                            delay(1000);
-                            return 1;
-                        }
-                        break;
-                    } else {
-                        client.print(htmlDefault());
-                        delay(100);         
-                        break;
-                    }
-                }
-            }
+    uint8_t ev = HTTPD_EV_NONE;
+
+    g_dns.processNextRequest();
+
+    if (!g_client.connected()) {
+        WiFiClient client = server.available();
+        if (client) {
+            on_accept(client);
+            ev = HTTPD_EV_ACTIVITY;
         }
-        req = "";
     }
-    return 0;
+
+    if (g_client.connected()) {
+        if (g_client.available() > 0) {
+            ev = on_data(settings) ? HTTPD_EV_CONFIG : HTTPD_EV_ACTIVITY;
+        } else if (millis() - g_req_ms >= HTTPD_REQ_TIMEOUT_MS) {
+            DB(" -> timeout");
+            send_error(g_client, 408);
+            g_client.stop();
+        }
+    }
+    return ev;
 }
 
-// prepare a web page to be send to a client (web browser)
-String httpd::htmlDefault()
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+void httpd::on_accept(WiFiClient &client)
 {
-    String htmlPage =
-    String("HTTP/1.1 200 OK\r\n") +
-            "Content-Type: text/html\r\n" +
-            "Connection: close\r\n" +  // the connection will be closed after completion of the response
-            "\r\n" +
-            "MAC address: " + String(WiFi.macAddress()) + "\r\n" +
-            "Format: /cfg?ssid=p1&password=p2&server=p3&security=p4" + "\r\n";
-    return htmlPage;
+    DB("\r\n[Client connected]");
+    g_client = client;
+    g_req_ms = millis();
+    http_req::init(&g_req);
 }
 
-String httpd::htmlCfg(bool result)
+/**
+ * Parse the received data: once the request is complete (or wrong) send the response & close.
+ * The request is parsed as it arrives, in chunks, by http_req: nothing is allocated, and a request
+ * which is malformed, too big or too slow is answered with an error.
+ * Return 1 if having new configuration, 0 if not.
+*/
+uint32_t httpd::on_data(ROM_SETTINGS_t *settings)
 {
-    String htmlPage =
-     String("HTTP/1.1 200 nOt Found\r\n") +
-            "Content-Type: text/html\r\n" +
-            "Connection: close\r\n" +  // the connection will be closed after completion of the response
-            "\r\n" +
-            "<!DOCTYPE HTML>" +
-            "<html>" +
-            "Config Result: ";
+    HTTP_REQ_t *req = &g_req;
+    uint8_t buf[HTTPD_RX_CHUNK];
+    int8_t res = HTTP_REQ_MORE;
+    uint32_t ret = 0;
 
-    if (result) {
-      htmlPage += "SUCCESS";   
+    int n = g_client.available();
+    n = g_client.read(buf, (n < (int)sizeof(buf)) ? n : sizeof(buf));
+    if (n > 0) {
+        res = http_req::feed(req, buf, n);
+    }
+    if (res == HTTP_REQ_MORE) {
+        return 0;
+    }
+
+    if (res == HTTP_REQ_ERROR) {
+        send_error(g_client, req->status);
+    } else if (req->method != HTTP_METHOD_GET) {
+        send_error(g_client, 405);
+    } else if (strcmp(http_req::path(req), "/cfg") == 0) {
+        ret = handle_cfg(settings);
     } else {
-      htmlPage += "ERROR";
+        // Any other page, including the connectivity checks of phones (captive portal):
+        send_default(g_client);
     }
-    htmlPage += String("</html>\r\n");
-    return htmlPage;
+    g_client.stop();
+    return ret;
 }
 
-/** @brief replace the '%xx' by a ASCII character.
-    @param *ptr the string to be parsed.
+/**
+ * Read the settings from the query of '/cfg' & send the result.
+ * Return 1 if having new configuration, 0 if not.
 */
-void httpd::parse_percent(char *p_str)
+uint32_t httpd::handle_cfg(ROM_SETTINGS_t *settings)
 {
-    char x = 0;
-    char *p2 = NULL;
-    char *ptr = p_str;
-    int32_t h = -1, l = -1, sz = 0;
-    #ifdef _DB_PARSE_
-        printf("\r\nParse%%: INPUT=[%s] ", p_str);
-    #endif
-
-    sz = strlen(p_str);
-    while (*ptr != 0) {
-        if (*ptr == '%') {
-            h = *(ptr + 1);
-            l = *(ptr + 2);
-            if ((h >= 'A') && (h <= 'F')) {
-                h = h - 'A' + 10;
-            } else if ((h >= '0') && (h <= '9')) {
-                h = h - '0';
-            } else {
-                h = -1;
-            }
-            if ((l >= 'A') && (l <= 'F')) {
-                l = l - 'A' + 10;
-            } else if ((l >= '0') && (l <= '9')) {
-                l = l - '0';
-            } else {
-                l = -1;
-            }
-            if ((h >= 0) && (l >= 0)) {
-                x = (h << 4) | l;
-
-            #ifdef _DB_PARSE_
-                printf(" [X=%c(%02Xh)]", x, x);
-            #endif
-
-                *ptr = x;
-                for (p2 = ptr + 1; p2 - p_str < sz - 2; p2++) {
-                    *p2 = *(p2 + 2);
-                }
-                *p2 = 0;
-                sz -= 2;
-            }
-
-        #ifdef _DB_PARSE_
-            printf(" ->STR=[%s] ", p_str);
-        #endif
-        }
-        ptr++;
+    URL_QUERY_t query;
+    int32_t num = 0;
+    uint32_t param_cnt = 0;
+
+    url_query::parse(&query, http_req::query(&g_req));
+    param_cnt += get_param(&query, "ssid", settings->ssid, 1, CFG_SSID_SZ);
+    param_cnt += get_param(&query, "password", settings->password, 8, CFG_PASSWORD_SZ);
+    param_cnt += get_param(&query, "server", settings->server_addr, 1, CFG_SERVER_SZ);
+    if (get_number(&query, "port", &num)) {
+        settings->server_port = num;
+        param_cnt++;
     }
+    param_cnt += get_param(&query, "security", settings->security, 1, CFG_SECURITY_SZ);
+    if (get_number(&query, "tz", &num)) {
+        settings->timezone = num;
+        param_cnt++;
+    }
+
+    DB(" -> param_cnt=%d", param_cnt);
 
-    #ifdef _DB_PARSE_
-        printf(" ->OUTPUT=[%s] ", p_str);
-    #endif
+    // Send result to client:
+    // The caller reboots later, from its loop, once the response is sent
+    send_cfg(g_client, param_cnt >= 5);
+    return (param_cnt >= 5) ? 1 : 0;
 }
 
-uint8_t httpd::get_param(const char *req, const char *pName, char *val, char val_sz)
+/** @brief send a string from flash, in chunks through a small stack buffer.
+*/
+void httpd::send_P(WiFiClient &client, PGM_P str)
 {
-    uint8_t ret = 0;
-    const char *p = strstr(req, pName);
-
-    DB("\r\n%s: pName=%s, val_sz=%u", __FUNCTION__, pName, val_sz); 
-    if (p != NULL) {
-        p += strlen(pName);
-        const char *p2 = strchr(p, '&');
-        if (p2 == NULL) {
-            p2 = strchr(p, ' ');
-        }
-        if (p2 != NULL) {
-            int sz = p2 - p;
-            if (sz < val_sz) {
-            memcpy(val, p, sz);
-            val[sz] = 0;
-            ret = sz;
-            }  
-        }
+    char buf[HTTPD_TX_CHUNK];
+    size_t left = strlen_P(str);
+
+    while (left > 0) {
+        size_t n = (left < sizeof(buf)) ? left : sizeof(buf);
+        memcpy_P(buf, str, n);
+        client.write((const uint8_t *)buf, n);
+        str += n;
+        left -= n;
     }
-    DB(" -> ret=%u, val=[%s]", ret, val);
-    return ret;
+}
+
+// send the default web page to a client (web browser)
+void httpd::send_default(WiFiClient &client)
+{
+    uint8_t mac[6];
+    char mac_str[18];
+
+    WiFi.macAddress(mac);
+    snprintf(mac_str, sizeof(mac_str), "%02X:%02X:%02X:%02X:%02X:%02X",
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    send_P(client, HTML_DEFAULT_HDR);
+    client.write((const uint8_t *)mac_str, strlen(mac_str));
+    send_P(client, HTML_DEFAULT_FORMAT);
+}
+
+void httpd::send_cfg(WiFiClient &client, bool result)
+{
+    send_P(client, HTML_CFG_HDR);
+    if (result) {
+        send_P(client, PSTR("SUCCESS"));
+    } else {
+        send_P(client, PSTR("ERROR"));
+    }
+    send_P(client, HTML_CFG_END);
+}
+
+void httpd::send_error(WiFiClient &client, uint16_t status)
+{
+    char line[16];
+    PGM_P reason;
+
+    switch (status) {
+    case 400: reason = PSTR("Bad Request"); break;
+    case 405: reason = PSTR("Method Not Allowed"); break;
+    case 408: reason = PSTR("Request Timeout"); break;
+    case 414: reason = PSTR("URI Too Long"); break;
+    case 431: reason = PSTR("Request Header Fields Too Large"); break;
+    case 501: reason = PSTR("Not Implemented"); break;
+    case 505: reason = PSTR("HTTP Version Not Supported"); break;
+    default: reason = PSTR("Error"); break;
+    }
+    DB("\r\n%s: status=%u", __FUNCTION__, status);
+
+    snprintf(line, sizeof(line), "HTTP/1.1 %u ", status);
+    client.write((const uint8_t *)line, strlen(line));
+    send_P(client, reason);
+    send_P(client, HTML_ERROR_HDR);
+}
+
+/** @brief copy the string param 'key' to 'val' if its length is in [min_len, val_sz).
+    Return 1 if copied, 0 if not.
+*/
+uint8_t httpd::get_param(const URL_QUERY_t *q, const char *key, char *val, uint16_t min_len, uint16_t val_sz)
+{
+    uint16_t len = 0;
+    const char *p = url_query::get(q, key, &len);
+
+    DB("\r\n%s: key=%s, len=%u", __FUNCTION__, key, len);
+    if ((p == NULL) || (len < min_len) || (len >= val_sz)) {
+        return 0;
+    }
+    memcpy(val, p, len + 1);
+    return 1;
+}
+
+/** @brief read the integer param 'key' (at most 9 characters) to 'val'.
+    Return 1 if read, 0 if not.
+*/
+uint8_t httpd::get_number(const URL_QUERY_t *q, const char *key, int32_t *val)
+{
+    uint16_t len = 0;
+    const char *p = url_query::get(q, key, &len);
+
+    if ((p == NULL) || (len == 0) || (len >= 10)) {
+        return 0;
+    }
+    *val = atoi(p);
+    return 1;
 }
@@ -1,6 +1,7 @@
 /** @brief define Constants, Prototypes for the WIFI config module.
  *  @date
  *      - 2019_05_05: Create.
+ *      - 2026_10_19: Non-blocking poll() & DNS captive portal.
  * 
 */
 #ifndef _HTTPD_H_
@@ -8,19 +9,31 @@
 
 #include <ESP8266WiFi.h>
 #include "wifi_inf.h"
+#include "url_query.h"
+
+/* poll() events */
+#define HTTPD_EV_NONE           0
+#define HTTPD_EV_ACTIVITY       1   // A DNS query, a client or data was handled
+#define HTTPD_EV_CONFIG         2   // New settings received
 
 class httpd
 {
     public:
+        /* Start the WebServer & the DNS captive portal (AP mode) */
 		static void init(void);
-        /* Start a WebServer & wait for user settings */
-        static uint32_t get_config(ROM_SETTINGS_t *settings);
+        /* Handle the pending events & return at once: HTTPD_EV_xxx */
+        static uint8_t poll(ROM_SETTINGS_t *settings);
 	
 	private:
-		static String htmlDefault();
-		static String htmlCfg(bool result);
-		static void parse_percent(char *p_str);
-		static uint8_t get_param(const char *req, const char *pName, char *val, char val_sz);
+		static void on_accept(WiFiClient &client);
+		static uint32_t on_data(ROM_SETTINGS_t *settings);
+		static uint32_t handle_cfg(ROM_SETTINGS_t *settings);
+		static void send_P(WiFiClient &client, PGM_P str);
+		static void send_default(WiFiClient &client);
+		static void send_cfg(WiFiClient &client, bool result);
+		static void send_error(WiFiClient &client, uint16_t status);
+		static uint8_t get_param(const URL_QUERY_t *q, const char *key, char *val, uint16_t min_len, uint16_t val_sz);
+		static uint8_t get_number(const URL_QUERY_t *q, const char *key, int32_t *val);
 };
 
 #endif
@@ -0,0 +1,319 @@
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <wdm_proto.h>
+#include <wdm_siphash.h>
+#include "esp8266_mlib.h"
+#include "mtime.h"
+#include "wifi_inf.h"
+#include "device.h"
+#include "perf.h"
+#include "rules.h"
+#include "lan_inf.h"
+#include "dlog.h"
+
+#define DB        DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define LAN_PACKET_SIZE_MAX     128
+
+/* Version of the LAN protocol, in the announce */
+#define LAN_PROTO_VERSION       1
+
+// Opcodes (both directions):
+#define LAN_OP_STATUS           0x02    // Node -> group: state of the devices
+#define LAN_OP_ACK              0x03    // Node -> sender of a command
+#define LAN_OP_ANNOUNCE         0x10    // Node -> group: id & capabilities
+#define LAN_OP_DISCOVER         0x11    // App -> group: every node announces itself
+#define LAN_OP_CMD              'd'     // App -> node (id = target): same data as MQTT 'd'
+
+/* Packets handled per manager() call */
+#define LAN_RX_BUDGET           4
+
+struct LAN_PEER_t {
+    uint8_t id[WDM_ID_SZ];
+    uint32_t seq;
+};
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static WiFiUDP g_udp;
+static bool g_joined;
+static wdm_siphash::Key g_key;
+static uint32_t g_seq;
+static uint32_t g_announce_ms;
+
+/* Last sequence of each sender; replaced round robin */
+static LAN_PEER_t g_peers[LAN_PEER_CNT];
+static uint8_t g_peer_next;
+
+/* Last sequence of the commands: never replaced by the senders */
+static uint32_t g_cmd_seq;
+
+static uint8_t g_rx[LAN_PACKET_SIZE_MAX];
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+/** @brief start a packet: [marker(1)][sequence(4)][id(6)][opcode(1)].
+ *  @note the sequence follows the local time, so it keeps increasing across reboots once the
+ *  time is synchronized.
+*/
+static void begin_packet(wdm_frame::Writer &w, uint8_t opcode) {
+    uint32_t now = mtime::get_local_unix();
+    g_seq = (now > g_seq) ? now : g_seq + 1;
+    w.put<UdpHeader>(UDP_MARKER, g_seq, esp8266_mlib::get_id(), opcode);
+}
+
+/** @brief sign & send a packet: to the group, or to 'ip':'port' if given.
+*/
+static bool end_packet(wdm_frame::Writer &w, const IPAddress *ip = NULL, uint16_t port = LAN_PORT) {
+    if (!g_joined || (w.reserve(UDP_FCS_SZ) == NULL)) {
+        return false;
+    }
+    lan_inf::sign((uint8_t *)w.data(), w.length());
+
+    int ok = (ip == NULL) ? g_udp.beginPacketMulticast(LAN_GROUP, port, WiFi.localIP())
+                          : g_udp.beginPacket(*ip, port);
+    if (ok) {
+        g_udp.write(w.data(), w.length());
+        ok = g_udp.endPacket();
+    }
+    return ok != 0;
+}
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void lan_inf::start(const char *security)
+{
+    DB("\r\n%s: port=%u", __FUNCTION__, LAN_PORT);
+    g_key = wdm_siphash::derive(security);
+    g_joined = false;
+    memset(g_peers, 0, sizeof(g_peers));
+    g_cmd_seq = 0;
+}
+
+void lan_inf::manager()
+{
+    if (WiFi.status() != WL_CONNECTED) {
+        g_joined = false;
+        return;
+    }
+    if (!g_joined) {
+        // (Re)join the group on the current address:
+        g_joined = g_udp.beginMulticast(WiFi.localIP(), LAN_GROUP, LAN_PORT) != 0;
+        DB("\r\n%s: join=%u", __FUNCTION__, g_joined);
+        if (!g_joined) {
+            return;
+        }
+        send_ANNOUNCE();
+    }
+
+    for (int k = 0; k < LAN_RX_BUDGET; k++) {
+        int len = g_udp.parsePacket();
+        if (len <= 0) {
+            break;
+        }
+        if (len > LAN_PACKET_SIZE_MAX) {
+            // Dropped by the next parsePacket()
+            DB("\r\n%s: too long (%d)", __FUNCTION__, len);
+            continue;
+        }
+        rx_packet(g_rx, g_udp.read(g_rx, len));
+    }
+
+    if (millis() - g_announce_ms >= LAN_ANNOUNCE_MS) {
+        send_ANNOUNCE();
+    }
+}
+
+/** @brief send LAN_OP_ANNOUNCE to the group.
+ *  @note data() = [proto(1)][DevCnt(1)=N][N x [offset(1)][type(1)]]
+*/
+void lan_inf::send_ANNOUNCE()
+{
+    uint8_t arr[LAN_PACKET_SIZE_MAX];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    const DEVICE_INFO_t *dev_list = device::get_status();
+    uint8_t dev_cnt = device::count();
+
+    g_announce_ms = millis();
+    begin_packet(w, LAN_OP_ANNOUNCE);
+    w.put<LanAnnounce>(LAN_PROTO_VERSION, dev_cnt);
+    for (uint8_t k = 0; k < dev_cnt; k++) {
+        w.put<LanCapability>(dev_list[k].offset, dev_list[k].type);
+    }
+    end_packet(w);
+}
+
+/** @brief send LAN_OP_STATUS to the group: the devices in 'mask'.
+ *  @note data() = [DevCnt(1)=N][N x UdpDeviceStatus]
+*/
+void lan_inf::send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list, uint16_t mask)
+{
+    uint8_t arr[LAN_PACKET_SIZE_MAX];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    uint8_t cnt = 0;
+
+    if (!g_joined) {
+        return;
+    }
+    begin_packet(w, LAN_OP_STATUS);
+    uint8_t *p_cnt = w.reserve(UdpCount::size);
+    for (int k = 0; k < dev_cnt; k++) {
+        if (mask & (1 << k)) {
+            const DEVICE_INFO_t *p_dev = &dev_list[k];
+            w.put<UdpDeviceStatus>(p_dev->offset, p_dev->type, p_dev->v, p_dev->r, p_dev->p);
+            cnt++;
+        }
+    }
+    if (p_cnt != NULL) {
+        UdpCount::put(p_cnt, cnt);
+    }
+
+    DB("\r\n%s: cnt=%d, len=%u", __FUNCTION__, cnt, (unsigned)w.length());
+    end_packet(w);
+}
+
+/** @brief check a packet received from the LAN or another local link (e.g. ESP-NOW): its FCS
+ *  & its sequence (replay).
+ *  @note packet format: [marker(1)][sequence(4)][id(6)][opcode(1)][data()][FCS(8)]
+*/
+bool lan_inf::verify(const uint8_t *buf, size_t len)
+{
+    wdm_frame::View<UdpHeader> hdr(buf, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    if (!hdr.valid()) {
+        return false;
+    }
+    if (!wdm_siphash::verify(g_key, buf, len - UDP_FCS_SZ, &buf[len - UDP_FCS_SZ])) {
+        DB("\r\n%s: invalid FCS, op=%02Xh", __FUNCTION__, hdr.get<UDP_HDR_OPCODE>());
+        return false;
+    }
+    if (!check_seq(hdr.get<UDP_HDR_ID>(), hdr.get<UDP_HDR_SEQ>())) {
+        DB("\r\n%s: replay, seq=%u", __FUNCTION__, hdr.get<UDP_HDR_SEQ>());
+        return false;
+    }
+    return true;
+}
+
+/** @brief write the FCS of a packet: its last UDP_FCS_SZ bytes.
+*/
+void lan_inf::sign(uint8_t *buf, size_t len)
+{
+    wdm_siphash::sign(g_key, buf, len - UDP_FCS_SZ, &buf[len - UDP_FCS_SZ]);
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/** @brief Process RX packet.
+ *  @note packet format: [marker(1)][sequence(4)][id(6)][opcode(1)][data()][FCS(8)]
+*/
+void lan_inf::rx_packet(uint8_t *buf, size_t len)
+{
+    wdm_frame::View<UdpHeader> hdr(buf, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    if (!hdr.valid() || (hdr.get<UDP_HDR_MARKER>() != UDP_MARKER)) {
+        return;
+    }
+    const uint8_t *id = hdr.get<UDP_HDR_ID>();
+    const uint8_t *data = hdr.tail();
+    size_t data_len = hdr.tail_len();
+    uint8_t opcode = hdr.get<UDP_HDR_OPCODE>();
+    uint32_t seq = hdr.get<UDP_HDR_SEQ>();
+
+    // Our own multicast (loopback) or a command for another node:
+    bool own = (memcmp(id, esp8266_mlib::get_id(), WDM_ID_SZ) == 0);
+    if (own != (opcode == LAN_OP_CMD)) {
+        return;
+    }
+    if (!verify(buf, len)) {
+        return;
+    }
+    DB("\r\n%s: op=%02Xh, seq=%u, len=%u", __FUNCTION__, opcode, seq, (unsigned)len);
+
+    switch (opcode) {
+    case LAN_OP_DISCOVER:
+        send_ANNOUNCE();
+        send_STATUS(device::count(), device::get_status());
+        break;
+
+    case LAN_OP_CMD: {
+        // data() = [offset(1)][cmd(1)] x N, id = this node
+        perf::start(PERF_CMD);
+        uint16_t mask = 0;
+        uint16_t cmds = 0;
+        wdm_frame::Reader rd(data, data_len);
+        for (wdm_frame::View<UdpCommand> v = rd.next<UdpCommand>(); v.valid(); v = rd.next<UdpCommand>()) {
+            uint8_t offset = v.get<UDP_CMD_OFFSET>();
+            if ((offset > 0) && (offset <= DEVICE_COUNT)) {
+                mask |= (1 << (offset - 1));
+                if (v.get<UDP_CMD_CMD>()) {
+                    cmds |= (1 << (offset - 1));
+                } else {
+                    cmds &= ~(1 << (offset - 1));
+                }
+            }
+        }
+        // The new state goes to the server & to the group:
+        device::control_mask(mask, cmds);
+        perf::cancel(PERF_CMD);
+
+        uint8_t arr[UdpHeader::size + UdpAck::size + UDP_FCS_SZ];
+        wdm_frame::Writer w(arr, sizeof(arr));
+        begin_packet(w, LAN_OP_ACK);
+        w.put<UdpAck>(seq, opcode);
+        IPAddress ip = g_udp.remoteIP();
+        end_packet(w, &ip, g_udp.remotePort());
+    } break;
+
+    case LAN_OP_STATUS: {
+        // data() = [DevCnt(1)=N][N x UdpDeviceStatus]: samples of a sensor node
+        wdm_frame::Reader rd(data, data_len);
+        wdm_frame::View<UdpCount> v = rd.next<UdpCount>();
+        uint8_t cnt = v.valid() ? v.get<0>() : 0;
+        for (uint8_t k = 0; k < cnt; k++) {
+            wdm_frame::View<UdpDeviceStatus> dev = rd.next<UdpDeviceStatus>();
+            if (!dev.valid()) {
+                break;
+            }
+            rules::sample(id, dev.get<UDP_DEV_OFFSET>(), (int32_t)dev.get<UDP_DEV_VALUE>());
+        }
+    } break;
+
+    default:
+        break;
+    }
+}
+
+/** @brief replay check: the sequence must increase for each header id (the sender, or this node
+ *  for the commands: all the commands sent to it share one sequence, in its own slot).
+ *  @return true if the packet is new (the sequence is recorded).
+*/
+bool lan_inf::check_seq(const uint8_t id[], uint32_t seq)
+{
+    if (memcmp(id, esp8266_mlib::get_id(), WDM_ID_SZ) == 0) {
+        // Command: sequence = UTC time of the sender, within the window once the time is known
+        // (the local time is UTC + timezone)
+        uint32_t utc = mtime::get_local_unix() - wifi_inf::get_settings()->timezone * 60;
+        if (mtime::is_valid() && ((int32_t)(seq - (utc - LAN_CMD_WINDOW_S)) < 0)) {
+            return false;
+        }
+        if ((g_cmd_seq != 0) && ((int32_t)(seq - g_cmd_seq) <= 0)) {
+            return false;
+        }
+        g_cmd_seq = seq;
+        return true;
+    }
+    for (int k = 0; k < LAN_PEER_CNT; k++) {
+        if (memcmp(g_peers[k].id, id, WDM_ID_SZ) == 0) {
+            if ((int32_t)(seq - g_peers[k].seq) <= 0) {
+                return false;
+            }
+            g_peers[k].seq = seq;
+            return true;
+        }
+    }
+    memcpy(g_peers[g_peer_next].id, id, WDM_ID_SZ);
+    g_peers[g_peer_next].seq = seq;
+    g_peer_next = (g_peer_next + 1) % LAN_PEER_CNT;
+    return true;
+}
@@ -0,0 +1,55 @@
+/** @brief define Constants, Prototypes for the LAN interface module: discovery & control of the
+ *  node on the local network (UDP multicast), next to the MQTT connection: apps on the LAN and
+ *  sensor nodes keep working when the server can't be reached.
+ *  Packets use the UDP framing (see wdm_proto.h), the FCS is a SipHash-2-4 tag keyed with the
+ *  'security' setting: unsigned packets are dropped.
+ *  Replay: the sequence must increase for each header id (e.g. unix time, then a counter); the
+ *  last one is kept in RAM, so the first packet of each id after a reboot is accepted.
+ *  Commands (id = this node) have their own slot, and their sequence is the unix time (UTC) of
+ *  the sender: once the time is synchronized, the ones older than LAN_CMD_WINDOW_S are dropped, so
+ *  a captured command can't be replayed after a reboot.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _LAN_INF_H_
+#define _LAN_INF_H_
+
+#include "device.h"
+
+/* Multicast group & port */
+#define LAN_GROUP                   IPAddress(239, 255, 77, 1)
+#define LAN_PORT                    7524
+
+/* Period of the announce (ms) */
+#define LAN_ANNOUNCE_MS             (60 * 1000UL)
+
+/* Header ids tracked for the replay check */
+#define LAN_PEER_CNT                8
+
+/* Age of the oldest command accepted (s), once the time is synchronized */
+#define LAN_CMD_WINDOW_S            300
+
+class lan_inf
+{
+    public:
+        /* Start the LAN channel: joins the group once the station is connected */
+        static void start(const char *security);
+
+        /* Receive the pending packets & announce the node: non-blocking, called from loop() */
+        static void manager();
+
+        /* Transmission functions (multicast) */
+        static void send_ANNOUNCE();
+        static void send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list, uint16_t mask = 0xFFFF);
+
+        /* Packets of the local links (LAN, ESP-NOW): check FCS & sequence, sign */
+        static bool verify(const uint8_t *buf, size_t len);
+        static void sign(uint8_t *buf, size_t len);
+
+    private:
+        static void rx_packet(uint8_t *buf, size_t len);
+        static bool check_seq(const uint8_t id[], uint32_t seq);
+};
+
+#endif
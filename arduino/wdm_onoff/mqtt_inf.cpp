@@ -1,13 +1,21 @@
 #include "Arduino.h"
 #include <ESP8266WiFi.h>
 #include <PubSubClient.h>
+#include <ArduinoJson.h>
+#include <wdm_proto.h>
 #include "esp8266_mlib.h"
 #include "mtime.h"
 #include "device.h"
 #include "wifi_inf.h"
+#include "evlog.h"
+#include "perf.h"
+#include "rules.h"
+#include "ota.h"
+#include "pub_tmpl.h"
 #include "mqtt_inf.h"
+#include "dlog.h"
 
-#define DB        Serial.printf
+#define DB        DLOG
 #define DB_print  Serial.print
 #define ERR       Serial.printf
 #ifndef DB
@@ -22,16 +30,38 @@
 #define USERNAME_SZ         32
 #define PASSWORD_SZ         32
 #define TOPIC_SZ            32
-#define SERVER_SZ           64
+#define SERVER_SZ           CFG_SERVER_SZ
 
-// Frame parameters:
+// Frame parameters (layouts: see wdm_proto.h):
 #define FRAME_MARK          0x01
-#define FRAME_ID_OFFSET     2
-#define FRAME_DATA_OFFSET   8
 
 // Opcodes:
 #define OPU_TIME_GET        0x41
 #define OPU_STATUS          0x42
+#define OPU_EVENT           0x43
+#define OPU_PERF            0x44
+#define OPU_OTA             0x45
+
+// Config document (opcode 'c'): {"offset", "en", "name", "disp",
+//      "sch": [DEVICE_SCHEDULE_CNT x [id, enable, days, time, cmd]]}
+// Strings are not copied (decoded in place in the RX buffer), so only the nodes are counted.
+#define CONFIG_DOC_SIZE     (JSON_OBJECT_SIZE(5) + JSON_ARRAY_SIZE(DEVICE_SCHEDULE_CNT) + \
+                             DEVICE_SCHEDULE_CNT * JSON_ARRAY_SIZE(5))
+
+// First byte of a rule table in a 'c' packet (a config document starts with a MsgPack map)
+#define RULE_TABLE_MARK     'R'
+
+// Node packets (UDP framing, first byte UDP_MARKER, see transport_mqtt): carried as is
+#define LINK_PACKET_SIZE    128
+
+// Delay before a new connection attempt, after a failed one
+#define RECONNECT_DELAY_MS  1000
+
+// Presence payloads (retained, published on the presence topic):
+#define PRESENCE_ONLINE     "1"
+#define PRESENCE_OFFLINE    "0"
+
+using namespace wdm_proto;
 
 ///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
 static WiFiClient espClient;
@@ -43,6 +73,23 @@ static char mqtt_server[SERVER_SZ] = "smtvietnam.net";
 static uint16_t mqtt_port;
 static char mqtt_sub_topic[TOPIC_SZ] = "wdm/dev/sub/1";
 static char mqtt_pub_topic[TOPIC_SZ] = "wdm/dev/pub/1";
+static char mqtt_pres_topic[TOPIC_SZ] = "wdm/dev/pres/1";
+static char mqtt_diag_topic[TOPIC_SZ] = "wdm/dev/diag/1";
+static char mqtt_link_topic[TOPIC_SZ] = "wdm/dev/link/1";
+
+/* Publish templates of the periodic messages (pub topic) */
+static uint8_t g_status_buf[PUB_TMPL_SIZE(TOPIC_SZ, MqttHeader::size + MqttCount::size +
+                                          DEVICE_COUNT * MqttDeviceStatus::size)];
+static uint8_t g_time_buf[PUB_TMPL_SIZE(TOPIC_SZ, MqttHeader::size + MqttTime::size)];
+static PUB_TMPL_t g_status_tmpl;
+static PUB_TMPL_t g_time_tmpl;
+
+/* Last node packet received (transport_mqtt) */
+static uint8_t g_link_rx[LINK_PACKET_SIZE];
+static uint8_t g_link_rx_len;
+
+/* No connection attempt before this time (millis) */
+static uint32_t g_reconnect_ms;
 
 ///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
 void mqtt_inf::start(const char *id, const char *security, const char *server, uint16_t port)
@@ -59,27 +106,57 @@ void mqtt_inf::start(const char *id, const char *security, const char *server, u
     
     snprintf(mqtt_sub_topic, TOPIC_SZ, "wdm/dev/sub/%s", id);
     snprintf(mqtt_pub_topic, TOPIC_SZ, "wdm/dev/pub/%s", id);
+    snprintf(mqtt_pres_topic, TOPIC_SZ, "wdm/dev/pres/%s", id);
+    snprintf(mqtt_diag_topic, TOPIC_SZ, "wdm/dev/diag/%s", id);
+    snprintf(mqtt_link_topic, TOPIC_SZ, "wdm/dev/link/%s", id);
 
     client.setServer(mqtt_server, mqtt_port);
     client.setCallback(mqtt_rx_callback);
+
+    // Templates: topic & frame prefix encoded once
+    uint8_t prefix[MqttHeader::size];
+    MqttHeader::put(prefix, FRAME_MARK, OPU_STATUS, esp8266_mlib::get_id());
+    pub_tmpl::init(&g_status_tmpl, g_status_buf, sizeof(g_status_buf), mqtt_pub_topic, prefix, sizeof(prefix), true, 1);
+    MqttHeader::put(prefix, FRAME_MARK, OPU_TIME_GET, esp8266_mlib::get_id());
+    pub_tmpl::init(&g_time_tmpl, g_time_buf, sizeof(g_time_buf), mqtt_pub_topic, prefix, sizeof(prefix));
     
-    DB("\r\n -> client=%s, account=%s/%s, sub=%s, pub=%s", 
-        mqtt_client, mqtt_username, mqtt_password, mqtt_sub_topic, mqtt_pub_topic);
+    DB("\r\n -> client=%s, account=%s/%s, sub=%s, pub=%s, pres=%s", 
+        mqtt_client, mqtt_username, mqtt_password, mqtt_sub_topic, mqtt_pub_topic, mqtt_pres_topic);
 }
 
+/** @brief keep the MQTT connection alive.
+ *  @note the broker publishes PRESENCE_OFFLINE (retained) on the presence topic when the
+ *  connection is lost (Last-Will), so the server does not need periodic STATUS to detect dead
+ *  nodes. After (re)connecting, the presence and the current state are published retained.
+ *  The CONNACK is awaited by client.loop(), so the node keeps running during the broker round
+ *  trip, and a failed attempt is retried after RECONNECT_DELAY_MS without blocking.
+*/
 void mqtt_inf::manager()
 {
-	if (!client.connected()) {
-        DB("\r\nReconnect MQTT...");
-        if (client.connect(mqtt_client, mqtt_username, mqtt_password)) {
+    if (client.state() == MQTT_CONNECTING) {
+        if (client.loop()) {
             DB(" -> connected");
             client.subscribe(mqtt_sub_topic);
-        } else {
+            publish(mqtt_pres_topic, (const uint8_t *)PRESENCE_ONLINE, strlen(PRESENCE_ONLINE), true);
+            send_STATUS(device::count(), device::get_status());
+        } else if (client.state() != MQTT_CONNECTING) {
             DB(" -> failed, rc=%d", client.state());
-            delay(1000);
+            g_reconnect_ms = millis() + RECONNECT_DELAY_MS;
+        }
+    } else if (!client.connected()) {
+        if ((int32_t)(millis() - g_reconnect_ms) < 0) {
+            return;
+        }
+        DB("\r\nReconnect MQTT...");
+        if (!client.beginConnect(mqtt_client, mqtt_username, mqtt_password,
+                                 mqtt_pres_topic, 1, true, PRESENCE_OFFLINE)) {
+            DB(" -> failed, rc=%d", client.state());
+            g_reconnect_ms = millis() + RECONNECT_DELAY_MS;
         }
     } else {
+        uint32_t t0 = micros();
         client.loop();
+        perf::stop(PERF_MQTT_LOOP, t0);
     }
 }
 
@@ -87,57 +164,179 @@ bool mqtt_inf::is_connected() {
 	return client.connected();	
 }
 
-void mqtt_inf::send_TIME_GET(const uint8_t id[], uint32_t now) {
-	uint8_t arr[64];
-	uint8_t i = 0;
+void mqtt_inf::send_TIME_GET(uint32_t now) {
+	wdm_frame::Writer w(pub_tmpl::data(&g_time_tmpl), pub_tmpl::data_max(&g_time_tmpl));
 
-    arr[i++] = FRAME_MARK;
-    arr[i++] = OPU_TIME_GET;
-    memcpy(&arr[i], id, 6);
-    i += 6;
-    esp8266_mlib::u32_to_buf(now, &arr[i]);
-    i += 4;
+	w.put<MqttTime>(now);
 
-	DB("\r\n%s: len=%d", __FUNCTION__, i);
-	client.publish(mqtt_pub_topic, arr, i);
+	DB("\r\n%s: len=%d", __FUNCTION__, w.length());
+	publish(&g_time_tmpl, w.length());
 }
 
 /** @brief send OPU_STATUS packet to Server.
+ *  @param mask: only the devices having bit (index) set are sent.
  *  @note data()        = [DevCnt(1)=M][DeviceStatusList(M x 12)]
         DeviceStatus(12)= [offset(1)][type(1)][rssi(1)][power(1)][value(4)][time(4)]
+        Only the full state (every device in 'mask') is retained, so the broker always holds the
+        whole state of the node; the changes of some devices are sent not retained.
+        Sent with QoS1, through the in-flight window of PubSubClient. Not queued while offline:
+        the full state is sent again on reconnect.
+        Only data() is written: the rest is in the template.
 */
-void mqtt_inf::send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list)
+void mqtt_inf::send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list, uint16_t mask)
 {
-    uint8_t arr[128];
-    const uint8_t *id = esp8266_mlib::get_id();
-	uint8_t i = 0;
+    wdm_frame::Writer w(pub_tmpl::data(&g_status_tmpl), pub_tmpl::data_max(&g_status_tmpl));
+    uint32_t now = mtime::get_local_unix();
     uint8_t k = 0;
+    uint8_t cnt = 0;
+
+    if (!client.connected()) {
+        return;
+    }
+
+    if (dev_cnt > DEVICE_COUNT) {
+        dev_cnt = DEVICE_COUNT;
+    }
 
-    arr[i++] = FRAME_MARK;
-    arr[i++] = OPU_STATUS;
-    memcpy(&arr[i], id, 6);
-    i += 6;
-    arr[i++] = dev_cnt;
+    uint8_t *p_cnt = w.put<MqttCount>(0);
     for (k = 0; k < dev_cnt; k++) {
+        if ((mask & (1 << k)) == 0) {
+            continue;
+        }
         const DEVICE_INFO_t *p_dev = &dev_list[k];
-        arr[i++] = p_dev->offset;
-        arr[i++] = p_dev->type;
-        arr[i++] = p_dev->r;
-        arr[i++] = p_dev->p;
-        esp8266_mlib::u32_to_buf(p_dev->v, &arr[i]);
-        i += 4;
-        esp8266_mlib::u32_to_buf(mtime::get_local_unix(), &arr[i]);
-        i += 4;
-    }
-
-	DB("\r\n%s: len=%d", __FUNCTION__, i);
-	client.publish(mqtt_pub_topic, arr, i);
+        w.put<MqttDeviceStatus>(p_dev->offset, p_dev->type, p_dev->r, p_dev->p, p_dev->v, now);
+        cnt++;
+    }
+    MqttCount::put(p_cnt, cnt);
+    pub_tmpl::set_retained(&g_status_tmpl, cnt == dev_cnt);
+
+	DB("\r\n%s: cnt=%d, len=%d", __FUNCTION__, cnt, w.length());
+	publish(&g_status_tmpl, w.length());
+}
+
+/** @brief send OPU_EVENT packet to Server.
+ *  @note data()        = [Dropped(4)][EvCnt(1)=M][EventList(M x 9)]
+        Event(9)        = [type(1)][time(4)][detail(4)]
+        Dropped is the total number of events lost on overflow since boot.
+        Sent with QoS1: PubSubClient keeps it until the PUBACK, across reconnects. While offline,
+        the events stay in evlog (RAM & flash, across reboots) rather than in the small RAM
+        queue of PubSubClient.
+    @return true if the packet is queued for delivery.
+*/
+bool mqtt_inf::send_EVENT(int ev_cnt, const EVENT_INFO_t *ev_list)
+{
+    uint8_t arr[MqttHeader::size + MqttEventHeader::size + EVLOG_BATCH_CNT * EVLOG_EVENT_SZ];
+    wdm_frame::Writer w(arr, sizeof(arr));
+    uint8_t k = 0;
+
+    if (!client.connected() || (ev_cnt > EVLOG_BATCH_CNT)) {
+        return false;
+    }
+
+    w.put<MqttHeader>(FRAME_MARK, OPU_EVENT, esp8266_mlib::get_id());
+    w.put<MqttEventHeader>(evlog::dropped(), ev_cnt);
+    for (k = 0; k < ev_cnt; k++) {
+        evlog::pack(&ev_list[k], w.reserve(EVLOG_EVENT_SZ));
+    }
+
+	DB("\r\n%s: cnt=%d, len=%d", __FUNCTION__, ev_cnt, w.length());
+	return publish(mqtt_pub_topic, arr, w.length(), false, 1);
+}
+
+/** @brief send OPU_PERF packet on the diagnostic topic.
+ *  @param reset: clear the histograms once sent.
+ *  @note data()        = [uptime(4)][HistCnt(1)=H][BucketCnt(1)=B][BaseShift(1)][H x Hist()]
+        Hist()          = [id(1)][count(4)][max(4)][avg(4)][B x bucket(2)]
+        Times are in us; bucket k counts the samples in [2^BaseShift << (k - 1), 2^BaseShift << k).
+*/
+void mqtt_inf::send_PERF(bool reset)
+{
+    uint8_t arr[MqttHeader::size + MqttPerfHeader::size +
+                PERF_CNT * (MqttPerfHist::size + PERF_BUCKET_CNT * MqttPerfBucket::size)];
+    wdm_frame::Writer w(arr, sizeof(arr));
+
+    w.put<MqttHeader>(FRAME_MARK, OPU_PERF, esp8266_mlib::get_id());
+    w.put<MqttPerfHeader>(millis() / 1000, PERF_CNT, PERF_BUCKET_CNT, PERF_BASE_SHIFT);
+    for (uint8_t id = 0; id < PERF_CNT; id++) {
+        const PERF_HIST_t *p = perf::get(id);
+        uint32_t avg = p->count ? (uint32_t)(p->sum / p->count) : 0;
+        w.put<MqttPerfHist>(id, p->count, p->max, avg);
+        for (uint8_t k = 0; k < PERF_BUCKET_CNT; k++) {
+            w.put<MqttPerfBucket>(p->buckets[k]);
+        }
+    }
+
+	DB("\r\n%s: len=%d", __FUNCTION__, w.length());
+	if (publish(mqtt_diag_topic, arr, w.length()) && reset) {
+        perf::reset();
+    }
+}
+
+/** @brief send OPU_OTA packet to Server: the answer to each OTA chunk.
+ *  @note data()        = [status(1)][next(4)]
+        status: DELTA_* (see delta_patch.h), next: offset of the patch chunk expected next.
+*/
+void mqtt_inf::send_OTA(int8_t status, uint32_t next)
+{
+    uint8_t arr[MqttHeader::size + MqttOtaStatus::size];
+    wdm_frame::Writer w(arr, sizeof(arr));
+
+    w.put<MqttHeader>(FRAME_MARK, OPU_OTA, esp8266_mlib::get_id());
+    w.put<MqttOtaStatus>((uint8_t)status, next);
+
+	DB("\r\n%s: status=%d, next=%u", __FUNCTION__, status, next);
+	publish(mqtt_pub_topic, arr, w.length());
+}
+
+/** @brief send a node packet (UDP framing) on the link topic, as is.
+*/
+bool mqtt_inf::send_LINK(const uint8_t *frame, unsigned int len)
+{
+    if (!client.connected()) {
+        return false;
+    }
+	DB("\r\n%s: len=%d", __FUNCTION__, len);
+    return publish(mqtt_link_topic, frame, len);
+}
+
+/** @brief take the last node packet received: return its length, 0 if none.
+*/
+int mqtt_inf::take_LINK(uint8_t *buf, unsigned int size)
+{
+    int len = g_link_rx_len;
+    if (len == 0) {
+        return 0;
+    }
+    g_link_rx_len = 0;
+    if ((unsigned int)len > size) {
+        return -1;
+    }
+    memcpy(buf, g_link_rx, len);
+    return len;
 }
 
 ///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool mqtt_inf::publish(const char *topic, const uint8_t *payload, unsigned int len, bool retained,
+                       uint8_t qos)
+{
+    uint32_t t0 = micros();
+    bool ret = client.publish(topic, payload, len, retained, qos);
+    perf::stop(PERF_PUBLISH, t0);
+    return ret;
+}
+
+bool mqtt_inf::publish(PUB_TMPL_t *tmpl, uint16_t data_len)
+{
+    uint32_t t0 = micros();
+    bool ret = pub_tmpl::send(client, tmpl, data_len);
+    perf::stop(PERF_PUBLISH, t0);
+    return ret;
+}
+
 /** @brief Process RX packet.
  *  @note packet format:
  *      MQTT.Payload() = [mark(1)][opcode(1)][rx_id(6)][data()]
+ *      or a node packet (mark = UDP_MARKER): [marker(1)][sequence(4)][id(6)][opcode(1)][data()][FCS(8)]
  * 
 */
 void mqtt_inf::mqtt_rx_callback(char* topic, byte* payload, unsigned int len) {
@@ -147,57 +346,172 @@ void mqtt_inf::mqtt_rx_callback(char* topic, byte* payload, unsigned int len) {
         return;
     }
 
+    // Node packet: kept for transport_mqtt (the last one wins)
+    if ((len > 0) && (payload[0] == UDP_MARKER)) {
+        if (len <= LINK_PACKET_SIZE) {
+            memcpy(g_link_rx, payload, len);
+            g_link_rx_len = len;
+        }
+        return;
+    }
+
     // Process RX packet: [mark(1)][opcode(1)][rx_id(6)][data()]
-    int byte_index = 0;
-    uint8_t mark = payload[byte_index++];
-    uint8_t opcode = payload[byte_index++];
-    uint8_t *rx_id = &payload[byte_index];
-    byte_index += 6;
-    DB(" -> mark=%02Xh, opcode=%02Xh, rx_id=%02X", mark, opcode, rx_id[0]);
-
-    // Validate params:    
-    if (mark != 0x01) {
+    wdm_frame::View<MqttHeader> hdr(payload, len);
+    if (!hdr.valid()) {
+        DB(" -> too short!");
+        return;
+    }
+    uint8_t opcode = hdr.get<MQTT_HDR_OPCODE>();
+    const uint8_t *data = hdr.tail();
+    size_t data_len = hdr.tail_len();
+    DB(" -> mark=%02Xh, opcode=%02Xh, rx_id=%02X", hdr.get<MQTT_HDR_MARK>(), opcode, hdr.get<MQTT_HDR_ID>()[0]);
+
+    // Validate params:
+    if (hdr.get<MQTT_HDR_MARK>() != FRAME_MARK) {
         DB("\r\n -> Invalid marker!");
         return;
     }
-    const uint8_t *local_id = esp8266_mlib::get_id();
-    for (int i = 0; i < 6; i++) {
-        if (local_id[i] != rx_id[i]) {
-            DB(" -> invalid rx_id!");
-            return;
-        }
+    if (memcmp(hdr.get<MQTT_HDR_ID>(), esp8266_mlib::get_id(), WDM_ID_SZ) != 0) {
+        DB(" -> invalid rx_id!");
+        return;
     }
 
     switch (opcode) {
     case 'a': {
         // data() = [currentTime(4)]
-        uint32_t t = esp8266_mlib::buf_to_u32(&payload[8]);
+        wdm_frame::View<MqttTime> v(data, data_len);
+        if (!v.valid()) {
+            DB(" -> invalid length!");
+            break;
+        }
+        uint32_t t = v.get<MQTT_TIME_T>();
         uint32_t t_local = t + wifi_inf::get_settings()->timezone * 60;
         DB("\r\n -> OPH_TIME: t_utc=%lu -> t_local=%lu", t, t_local);
         mtime::set_local_unix(t_local);
     } break;
 
     case 'c': {
-        /*  data = {"offset":number, "en":number, "name":string,
-               "disp":string, "sch":[ [id1, enable, days, time, cmd], [id2,
-               enable, days, time, cmd]'
-                                            ...
-                                    ]
-                            }
-            */
-        
+        /*  data() = MsgPack {"offset":number, "en":number, "name":string, "disp":string,
+                "sch":[ [id1, enable, days, time, cmd], [id2, enable, days, time, cmd], ... ]}
+            or a rule table: ['R'(1)][RuleCnt(1)=N][N x MqttRule]
+        */
+        static StaticJsonDocument<CONFIG_DOC_SIZE> doc;
+        DEVICE_CONFIG_t cfg;
+
+        if (data_len == 0) {
+            DB(" -> invalid length!");
+            break;
+        }
+        if (data[0] == RULE_TABLE_MARK) {
+            bool ok = rules::set(data + 1, data_len - 1);
+            DB("\r\n -> OPH_CONFIG: rules=%u, ok=%u", rules::count(), ok);
+            break;
+        }
+        // Non-const input: strings are decoded in place (zero-copy)
+        DeserializationError err = deserializeMsgPack(doc, &payload[MqttHeader::size], data_len);
+        if (err) {
+            DB("\r\n -> OPH_CONFIG: invalid data: %s", err.c_str());
+            break;
+        }
+
+        memset(&cfg, 0, sizeof(cfg));
+        uint8_t offset = doc["offset"];
+        cfg.enable = doc["en"] | 1;
+        JsonArray sch_list = doc["sch"];
+        uint8_t k = 0;
+        for (JsonArray sch : sch_list) {
+            if (k >= DEVICE_SCHEDULE_CNT) {
+                break;
+            }
+            SCHD_INFO_t *p_sch = &cfg.schedules[k++];
+            p_sch->id = sch[0];
+            p_sch->enable = sch[1];
+            p_sch->days = sch[2];
+            p_sch->time = sch[3];
+            p_sch->cmd = sch[4];
+        }
+        DB("\r\n -> OPH_CONFIG: offset=%u, en=%u, sch_cnt=%u", offset, cfg.enable, k);
+        device::config(offset, &cfg);
     } break;
 
     case 'd': {
-        // data() = [offset(1)][cmd(1)]
-        uint8_t offset = payload[byte_index++];
-        uint8_t cmd = payload[byte_index++];
-        DB("\r\n -> OPH_COMMAND: offset=%d, cmd=%d", offset, cmd);
-        device::control(offset, cmd);
+        // data() = [offset(1)][cmd(1)] x N
+        perf::start(PERF_CMD);
+        uint16_t mask = 0;
+        uint16_t cmds = 0;
+        wdm_frame::Reader rd(data, data_len);
+        for (wdm_frame::View<MqttCommand> v = rd.next<MqttCommand>(); v.valid(); v = rd.next<MqttCommand>()) {
+            uint8_t offset = v.get<MQTT_CMD_OFFSET>();
+            uint8_t cmd = v.get<MQTT_CMD_CMD>();
+            DB("\r\n -> OPH_COMMAND: offset=%d, cmd=%d", offset, cmd);
+            if ((offset > 0) && (offset <= DEVICE_COUNT)) {
+                mask |= (1 << (offset - 1));
+                if (cmd) {
+                    cmds |= (1 << (offset - 1));
+                } else {
+                    cmds &= ~(1 << (offset - 1));
+                }
+            }
+        }
+        device::control_mask(mask, cmds);
+    } break;
+
+    case 'm': {
+        // data() = [mask(2)][cmds(2)]: bit (offset - 1) selects/sets the device at 'offset'
+        wdm_frame::View<MqttCommandMask> v(data, data_len);
+        if (!v.valid()) {
+            DB(" -> invalid length!");
+            break;
+        }
+        uint16_t mask = v.get<MQTT_MASK_MASK>();
+        uint16_t cmds = v.get<MQTT_MASK_CMDS>();
+        DB("\r\n -> OPH_COMMAND_MASK: mask=%04Xh, cmds=%04Xh", mask, cmds);
+        perf::start(PERF_CMD);
+        device::control_mask(mask, cmds);
+    } break;
+
+    case 's': {
+        // data() = [src_id(6)][DevCnt(1)=N][N x UdpDeviceStatus]: samples of a sensor node
+        wdm_frame::Reader rd(data, data_len);
+        wdm_frame::View<MqttSampleHeader> v = rd.next<MqttSampleHeader>();
+        if (!v.valid()) {
+            DB(" -> invalid length!");
+            break;
+        }
+        perf::start(PERF_CMD);
+        uint8_t cnt = v.get<MQTT_SMP_CNT>();
+        for (uint8_t k = 0; k < cnt; k++) {
+            wdm_frame::View<UdpDeviceStatus> dev = rd.next<UdpDeviceStatus>();
+            if (!dev.valid()) {
+                break;
+            }
+            rules::sample(v.get<MQTT_SMP_SRC_ID>(), dev.get<UDP_DEV_OFFSET>(), (int32_t)dev.get<UDP_DEV_VALUE>());
+        }
+    } break;
+
+    case 'u': {
+        // data() = [offset(4)][chunk()]: delta OTA patch, see ota.h
+        wdm_frame::View<MqttOtaChunk> v(data, data_len);
+        if (!v.valid()) {
+            DB(" -> invalid length!");
+            break;
+        }
+        uint32_t next;
+        int8_t st = ota::rx_chunk(v.get<MQTT_OTA_OFFSET>(), v.tail(), v.tail_len(), &next);
+        send_OTA(st, next);
+    } break;
+
+    case 'h': {
+        // data() = [reset(1)], optional: send the performance histograms
+        wdm_frame::View<MqttPerfRequest> v(data, data_len);
+        send_PERF(v.valid() && v.get<MQTT_PERF_REQ_RESET>());
     } break;
     
     default:
         DB(" -> unknown Opcode=%02xh!", opcode);
         break;
     }
+
+    // No output changed (device already in the requested state):
+    perf::cancel(PERF_CMD);
 }
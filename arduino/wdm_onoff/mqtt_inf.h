@@ -8,6 +8,8 @@
 
 #include "device.h"
 
+struct PUB_TMPL_t;
+
 class mqtt_inf
 {
     public:
@@ -21,11 +23,20 @@ class mqtt_inf
 		static bool is_connected();
 		
 		/* Transmission functions */
-        static void send_TIME_GET(const uint8_t id[], uint32_t now);
-        static void send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list);
-        static void send_EVENT(int ev_cnt, const EVENT_INFO_t *ev_list);
+        static void send_TIME_GET(uint32_t now);
+        static void send_STATUS(int dev_cnt, const DEVICE_INFO_t *dev_list, uint16_t mask = 0xFFFF);
+        static bool send_EVENT(int ev_cnt, const EVENT_INFO_t *ev_list);
+        static void send_PERF(bool reset);
+        static void send_OTA(int8_t status, uint32_t next);
+
+        /* Node packets (UDP framing), see transport_mqtt */
+        static bool send_LINK(const uint8_t *frame, unsigned int len);
+        static int take_LINK(uint8_t *buf, unsigned int size);
 
     private:
+        static bool publish(const char *topic, const uint8_t *payload, unsigned int len, bool retained = false,
+                            uint8_t qos = 0);
+        static bool publish(PUB_TMPL_t *tmpl, uint16_t data_len);
         static void mqtt_rx_callback(char* topic, byte* payload, unsigned int len);
 };
 
@@ -0,0 +1,108 @@
+/**	@brief implement the OTA module.
+ *  The running image is read back from the flash (address 0, where the bootloader copies it), the
+ *  new one goes through the core's Updater: its area is erased & written sector by sector, and
+ *  the bootloader copies it over the running image at the next boot only if it is complete.
+ *  RAM: the patch applier's blocks & one chunk (in the MQTT buffer).
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include <Updater.h>
+#include "delta_patch.h"
+#include "evlog.h"
+#include "esp8266_mlib.h"
+#include "ota.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* OTA states */
+#define OTA_IDLE                    0
+#define OTA_RUN                     1
+#define OTA_DONE                    2       // Reboot pending
+#define OTA_FAILED                  3
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static uint8_t g_state;
+static uint32_t g_next;             // Patch offset expected next
+static uint32_t g_sketch_size;
+static uint32_t g_done_ms;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+int8_t ota::rx_chunk(uint32_t offset, const uint8_t *data, size_t len, uint32_t *next)
+{
+    if (offset == 0) {
+        if (g_state == OTA_DONE) {
+            *next = g_next;
+            return DELTA_DONE;
+        }
+        if (Update.isRunning()) {
+            Update.end();           // Not finished: dropped, nothing is booted
+        }
+        g_sketch_size = ESP.getSketchSize();
+        delta_patch::begin(read_old, write_new);
+        g_next = 0;
+        g_state = OTA_RUN;
+        DB("\r\n%s: start, sketch=%u", __FUNCTION__, g_sketch_size);
+    }
+
+    // Out of order (lost or repeated chunk) or not started: the server resumes from 'next'
+    if ((g_state != OTA_RUN) || (offset != g_next)) {
+        *next = g_next;
+        return delta_patch::status();
+    }
+
+    int8_t st = delta_patch::feed(data, len);
+    g_next += len;
+    *next = g_next;
+    if (st == DELTA_DONE) {
+        if (Update.end()) {
+            g_state = OTA_DONE;
+            g_done_ms = millis();
+        } else {
+            g_state = OTA_FAILED;
+            st = DELTA_E_IO;
+        }
+    } else if (st < 0) {
+        if (Update.isRunning()) {
+            Update.end();
+        }
+        g_state = OTA_FAILED;
+    }
+    if (st != DELTA_OK) {
+        DB("\r\n%s: status=%d, new=%u", __FUNCTION__, st, delta_patch::written());
+        evlog::push(EV_TYPE_OTA, (uint32_t)(int32_t)st);
+    }
+    return st;
+}
+
+void ota::manager()
+{
+    if ((g_state == OTA_DONE) && (millis() - g_done_ms >= OTA_REBOOT_MS)) {
+        esp8266_mlib::soft_reboot();
+    }
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool ota::read_old(uint32_t offset, uint8_t *buf, size_t len)
+{
+    if (offset + len > g_sketch_size) {
+        return false;
+    }
+    return ESP.flashRead(offset, (uint32_t *)buf, (len + 3) & ~3);
+}
+
+/** @brief write the new image: the Updater starts on the first block, when the size is known.
+*/
+bool ota::write_new(const uint8_t *buf, size_t len)
+{
+    if (!Update.isRunning() && !Update.begin(delta_patch::new_size())) {
+        DB("\r\n%s: begin failed, err=%u", __FUNCTION__, Update.getError());
+        return false;
+    }
+    return Update.write((uint8_t *)buf, len) == len;
+}
@@ -0,0 +1,34 @@
+/** @brief define Constants, Prototypes for the OTA module: firmware updates by delta patch
+ *  (delta_patch, made by tools/wdm_delta) received in chunks from the server ('u' packets).
+ *  The new image is written to the OTA area of the flash as the chunks come, then booted.
+ *  Stop-and-wait: each chunk is answered (OPU_OTA) with the offset of the next one expected, a
+ *  lost or repeated chunk is sent again from there. A chunk is any size which fits in one MQTT
+ *  packet (PubSubClient buffer), the patch needs no alignment.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _OTA_H_
+#define _OTA_H_
+
+#include "Arduino.h"
+
+/* Delay between the last answer & the reboot into the new image (ms) */
+#define OTA_REBOOT_MS               1000
+
+class ota
+{
+    public:
+        /* Apply the chunk at 'offset' of the patch (0: start a new update). Return the status
+        (DELTA_*, see delta_patch.h), 'next' is the offset expected next. */
+        static int8_t rx_chunk(uint32_t offset, const uint8_t *data, size_t len, uint32_t *next);
+
+        /* Reboot into the new image once complete: called from loop() */
+        static void manager();
+
+    private:
+        static bool read_old(uint32_t offset, uint8_t *buf, size_t len);
+        static bool write_new(const uint8_t *buf, size_t len);
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**	@brief implement the Performance probes: fixed log2 buckets, so adding a sample is a few
+ *  instructions and the histograms have a constant size.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "perf.h"
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static PERF_HIST_t g_hist[PERF_CNT];
+
+/* start() time of the pending probes */
+static uint32_t g_start[PERF_CNT];
+static uint8_t g_started;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void perf::add(uint8_t id, uint32_t us)
+{
+#if PERF_ENABLE
+    if (id >= PERF_CNT) {
+        return;
+    }
+    PERF_HIST_t *p = &g_hist[id];
+    uint16_t *b = &p->buckets[bucket(us)];
+
+    p->count++;
+    if (us > p->max) {
+        p->max = us;
+    }
+    p->sum += us;
+    if (*b < 0xFFFF) {
+        (*b)++;
+    }
+#endif
+}
+
+void perf::start(uint8_t id)
+{
+#if PERF_ENABLE
+    if (id < PERF_CNT) {
+        g_start[id] = micros();
+        g_started |= (1 << id);
+    }
+#endif
+}
+
+void perf::end(uint8_t id)
+{
+#if PERF_ENABLE
+    if ((id < PERF_CNT) && (g_started & (1 << id))) {
+        g_started &= ~(1 << id);
+        add(id, micros() - g_start[id]);
+    }
+#endif
+}
+
+void perf::cancel(uint8_t id)
+{
+#if PERF_ENABLE
+    if (id < PERF_CNT) {
+        g_started &= ~(1 << id);
+    }
+#endif
+}
+
+const PERF_HIST_t *perf::get(uint8_t id)
+{
+    return (id < PERF_CNT) ? &g_hist[id] : NULL;
+}
+
+void perf::reset()
+{
+    memset(g_hist, 0, sizeof(g_hist));
+}
+
+uint8_t perf::bucket(uint32_t us)
+{
+    uint32_t v = us >> PERF_BASE_SHIFT;
+    uint8_t k = (v == 0) ? 0 : 32 - __builtin_clz(v);
+    return (k < PERF_BUCKET_CNT) ? k : PERF_BUCKET_CNT - 1;
+}
@@ -0,0 +1,59 @@
+/** @brief define Constants, Types & Prototypes for the Performance probes module: micros()
+ *  based latency histograms, sent to the server on request (see mqtt_inf, opcode 'h').
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _PERF_H_
+#define _PERF_H_
+
+#include "Arduino.h"
+
+/* 0: probes compile to nothing */
+#define PERF_ENABLE                 1
+
+/* Histograms */
+#define PERF_LOOP                   0   // One loop() iteration
+#define PERF_MQTT_LOOP              1   // client.loop()
+#define PERF_PUBLISH                2   // client.publish()
+#define PERF_CMD                    3   // Command ('d', 'm') received -> outputs switched
+#define PERF_CNT                    4
+
+/* Buckets: 0 is [0, 64us), bucket k is [64us << (k - 1), 64us << k), the last one is open
+(>= 1s) */
+#define PERF_BUCKET_CNT             16
+#define PERF_BASE_SHIFT             6
+
+struct PERF_HIST_t {
+    uint32_t count;
+    uint32_t max;                       // us
+    uint64_t sum;                       // us, to get the average
+    uint16_t buckets[PERF_BUCKET_CNT];  // Saturated at 0xFFFF
+};
+
+class perf
+{
+    public:
+        /* Add one sample */
+        static void add(uint8_t id, uint32_t us);
+
+        /* Add the time since 't0' (a micros() value) */
+        static inline void stop(uint8_t id, uint32_t t0) {
+#if PERF_ENABLE
+            add(id, micros() - t0);
+#endif
+        }
+
+        /* Start / end of a probe spanning several modules: end() only counts after a start() */
+        static void start(uint8_t id);
+        static void end(uint8_t id);
+        static void cancel(uint8_t id);
+
+        static const PERF_HIST_t *get(uint8_t id);
+        static void reset();
+
+        /* Bucket of a duration */
+        static uint8_t bucket(uint32_t us);
+};
+
+#endif
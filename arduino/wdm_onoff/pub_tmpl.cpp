@@ -0,0 +1,74 @@
+/**	@brief implement the Publish templates.
+ *  The remaining length is the only field of the fixed header which changes: it is written just
+ *  before the topic, so the packet starts 0 or 1 byte into the buffer (1 or 2 length bytes).
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "pub_tmpl.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define MQTT_PUBLISH                0x30
+#define MQTT_RETAIN                 0x01
+#define MQTT_QOS1                   0x02
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+bool pub_tmpl::init(PUB_TMPL_t *t, uint8_t *buf, uint16_t size, const char *topic,
+                    const uint8_t *prefix, uint8_t prefix_len, bool retained, uint8_t qos)
+{
+    size_t topic_len = strlen(topic);
+    t->buf = buf;
+    t->size = 0;
+    t->data_pos = 0;
+    if (PUB_TMPL_SIZE(topic_len, prefix_len) > size) {
+        return false;
+    }
+
+    uint16_t pos = PUB_TMPL_HDR_SZ;
+    buf[pos++] = (uint8_t)(topic_len >> 8);
+    buf[pos++] = (uint8_t)topic_len;
+    memcpy(&buf[pos], topic, topic_len);
+    pos += topic_len;
+    if (qos == 1) {
+        buf[pos++] = 0;
+        buf[pos++] = 0;
+    }
+    memcpy(&buf[pos], prefix, prefix_len);
+    pos += prefix_len;
+
+    t->size = size;
+    t->data_pos = pos;
+    t->header = MQTT_PUBLISH | (retained ? MQTT_RETAIN : 0) | ((qos == 1) ? MQTT_QOS1 : 0);
+    return true;
+}
+
+void pub_tmpl::set_retained(PUB_TMPL_t *t, bool retained) {
+    t->header = (t->header & ~MQTT_RETAIN) | (retained ? MQTT_RETAIN : 0);
+}
+
+uint8_t *pub_tmpl::data(const PUB_TMPL_t *t) {
+    return &t->buf[t->data_pos];
+}
+
+uint16_t pub_tmpl::data_max(const PUB_TMPL_t *t) {
+    return (t->size > t->data_pos) ? t->size - t->data_pos : 0;
+}
+
+bool pub_tmpl::send(PubSubClient &client, PUB_TMPL_t *t, uint16_t data_len)
+{
+    if ((t->size == 0) || (data_len > data_max(t))) {
+        return false;
+    }
+    uint16_t len = t->data_pos + data_len - PUB_TMPL_HDR_SZ;     // Remaining length
+    uint8_t *p;
+    if (len < 0x80) {
+        p = &t->buf[1];
+        p[1] = (uint8_t)len;
+    } else {
+        p = &t->buf[0];
+        p[1] = (uint8_t)(len | 0x80);
+        p[2] = (uint8_t)(len >> 7);
+    }
+    p[0] = t->header;
+    return client.publishPacket(p, &t->buf[t->data_pos + data_len] - p);
+}
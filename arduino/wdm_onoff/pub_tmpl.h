@@ -0,0 +1,49 @@
+/** @brief define Constants, Types & Prototypes for the Publish templates: the MQTT PUBLISH packet
+ *  of a message sent again and again (STATUS, TIME_GET), encoded once with its topic & the
+ *  constant frame prefix ([mark][opcode][id]). A send only writes the variable data in place,
+ *  sets the remaining length & hands the packet to the client in one write (no strlen, no copy).
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _PUB_TMPL_H_
+#define _PUB_TMPL_H_
+
+#include "Arduino.h"
+#include <PubSubClient.h>
+
+/* Room for the fixed header: [type(1)][remaining length(1..2)] (packets below 16 KB) */
+#define PUB_TMPL_HDR_SZ             3
+
+/* Buffer size of a template: topic of 'topic_sz' chars, frame (prefix + data) of 'frame_sz'
+(+ the msgId of a QoS1 one) */
+#define PUB_TMPL_SIZE(topic_sz, frame_sz)   (PUB_TMPL_HDR_SZ + 2 + (topic_sz) + 2 + (frame_sz))
+
+struct PUB_TMPL_t {
+    uint8_t *buf;               // [fixed header][topic len(2)][topic][msgId(2), QoS1][frame prefix][data()]
+    uint16_t size;
+    uint16_t data_pos;          // Start of data()
+    uint8_t header;             // PUBLISH & flags
+};
+
+class pub_tmpl
+{
+    public:
+        /* Encode the constant part of the packet in 'buf': return false if it doesn't fit.
+        QoS1: each send() is queued by the client, which sets the msgId */
+        static bool init(PUB_TMPL_t *t, uint8_t *buf, uint16_t size, const char *topic,
+                         const uint8_t *prefix, uint8_t prefix_len, bool retained = false,
+                         uint8_t qos = 0);
+
+        /* Retain flag of the next sends */
+        static void set_retained(PUB_TMPL_t *t, bool retained);
+
+        /* Variable part of the frame, written in place before send(), & its room */
+        static uint8_t *data(const PUB_TMPL_t *t);
+        static uint16_t data_max(const PUB_TMPL_t *t);
+
+        /* Send (QoS0) or queue (QoS1) the packet with 'data_len' bytes of data */
+        static bool send(PubSubClient &client, PUB_TMPL_t *t, uint16_t data_len);
+};
+
+#endif
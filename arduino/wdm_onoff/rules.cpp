@@ -0,0 +1,213 @@
+/**	@brief implement the Rule engine.
+ *  A sample is checked against the rules of its source only; a rule acts when its condition
+ *  changes state (hysteresis: no chatter around the threshold), and all the devices switched by
+ *  one sample go through a single device::control_mask() (one STATUS packet).
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "FS.h"
+#include <wdm_proto.h>
+#include "esp8266_mlib.h"
+#include "device.h"
+#include "evlog.h"
+#include "rules.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* Rule table file: [magic(4)][size(2)][crc16(2)][RuleCnt(1)=N][N x MqttRule] */
+static const char *RULES_FILE_NAME = "/wdm_rules.bin";
+#define RULES_FILE_MAGIC            0x524D4457      // 'WDMR'
+#define RULES_FILE_HDR_SZ           8
+#define RULES_DATA_MAX              (wdm_proto::MqttCount::size + RULE_CNT * wdm_proto::MqttRule::size)
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static RULE_t g_rules[RULE_CNT];
+static uint8_t g_rule_cnt;
+
+///////////////////////////////////////LOCAL FUNCTIONS/////////////////////////////////////////////
+/** @brief decode a rule table: [RuleCnt(1)=N][N x MqttRule].
+ *  @return the number of rules, -1 if the table is invalid.
+*/
+static int decode(const uint8_t *data, size_t len, RULE_t *tbl) {
+    wdm_frame::Reader rd(data, len);
+    wdm_frame::View<MqttCount> hdr = rd.next<MqttCount>();
+    if (!hdr.valid() || (hdr.get<0>() > RULE_CNT)) {
+        return -1;
+    }
+
+    uint8_t cnt = hdr.get<0>();
+    for (uint8_t i = 0; i < cnt; i++) {
+        wdm_frame::View<MqttRule> v = rd.next<MqttRule>();
+        if (!v.valid()) {
+            return -1;
+        }
+        RULE_t *r = &tbl[i];
+        r->id = v.get<MQTT_RULE_ID>();
+        r->flags = v.get<MQTT_RULE_FLAGS>();
+        memcpy(r->src_id, v.get<MQTT_RULE_SRC_ID>(), WDM_ID_SZ);
+        r->src_offset = v.get<MQTT_RULE_SRC_OFFSET>();
+        r->op = v.get<MQTT_RULE_OP>();
+        r->threshold = (int32_t)v.get<MQTT_RULE_THRESHOLD>();
+        r->hyst = v.get<MQTT_RULE_HYST>();
+        r->offset = v.get<MQTT_RULE_OFFSET>();
+        r->cmd = v.get<MQTT_RULE_CMD>();
+        r->state = RULE_STATE_UNKNOWN;
+        if (((r->op != RULE_OP_ABOVE) && (r->op != RULE_OP_BELOW)) ||
+            (r->offset == 0) || (r->offset > device::count())) {
+            return -1;
+        }
+    }
+    return cnt;
+}
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void rules::init()
+{
+    load();
+}
+
+bool rules::set(const uint8_t *data, size_t len)
+{
+    static RULE_t tbl[RULE_CNT];
+    int cnt = decode(data, len, tbl);
+
+    DB("\r\n%s: len=%u -> cnt=%d", __FUNCTION__, (unsigned)len, cnt);
+    if (cnt < 0) {
+        return false;
+    }
+    memcpy(g_rules, tbl, cnt * sizeof(RULE_t));
+    g_rule_cnt = cnt;
+    store();
+    return true;
+}
+
+uint8_t rules::sample(const uint8_t src_id[], uint8_t src_offset, int32_t value)
+{
+    uint16_t mask = 0;
+    uint16_t cmds = 0;
+    uint8_t fired = 0;
+
+    for (uint8_t i = 0; i < g_rule_cnt; i++) {
+        RULE_t *r = &g_rules[i];
+        if (!(r->flags & RULE_F_ENABLE) || (r->src_offset != src_offset) ||
+            (memcmp(r->src_id, src_id, WDM_ID_SZ) != 0)) {
+            continue;
+        }
+
+        // Condition, with hysteresis: in the band, the state is kept (false after boot)
+        uint8_t state = r->state;
+        if (r->op == RULE_OP_ABOVE) {
+            if (value > r->threshold) {
+                state = RULE_STATE_TRUE;
+            } else if ((int64_t)value < (int64_t)r->threshold - r->hyst) {
+                state = RULE_STATE_FALSE;
+            }
+        } else {
+            if (value < r->threshold) {
+                state = RULE_STATE_TRUE;
+            } else if ((int64_t)value > (int64_t)r->threshold + r->hyst) {
+                state = RULE_STATE_FALSE;
+            }
+        }
+        if (state == RULE_STATE_UNKNOWN) {
+            state = RULE_STATE_FALSE;
+        }
+        if (state == r->state) {
+            continue;
+        }
+        r->state = state;
+        fired++;
+
+        // Action:
+        uint8_t cmd;
+        if (state == RULE_STATE_TRUE) {
+            cmd = r->cmd ? 1 : 0;
+        } else if (r->flags & RULE_F_REVERT) {
+            cmd = r->cmd ? 0 : 1;
+        } else {
+            continue;
+        }
+        uint16_t bit = 1 << (r->offset - 1);
+        mask |= bit;
+        cmds = cmd ? (cmds | bit) : (cmds & ~bit);
+        evlog::push(EV_TYPE_RULE, ((uint32_t)r->id << 16) | (r->offset << 8) | cmd);
+        DB("\r\n%s: rule=%u, value=%d -> state=%u, offset=%u, cmd=%u", __FUNCTION__, r->id, value, state, r->offset, cmd);
+    }
+
+    if (mask != 0) {
+        device::control_mask(mask, cmds);
+    }
+    return fired;
+}
+
+uint8_t rules::count()
+{
+    return g_rule_cnt;
+}
+
+const RULE_t *rules::get(uint8_t idx)
+{
+    return (idx < g_rule_cnt) ? &g_rules[idx] : NULL;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/**
+ * Load the rule table from ROM (Non-volatile).
+ * File format (binary): [magic(4)][size(2)][crc16(2)][data(size)]
+ *  - data: the rule table, as received ([RuleCnt(1)=N][N x MqttRule]).
+*/
+void rules::load()
+{
+    uint8_t buf[RULES_FILE_HDR_SZ + RULES_DATA_MAX];
+    uint32_t sz = 0;
+
+    g_rule_cnt = 0;
+    esp8266_mlib::recover_data(RULES_FILE_NAME);
+    File f = SPIFFS.open(RULES_FILE_NAME, "r");
+    if (!f) {
+        return;
+    }
+    sz = f.read(buf, sizeof(buf));
+    f.close();
+
+    if (sz >= RULES_FILE_HDR_SZ) {
+        uint32_t magic = esp8266_mlib::buf_to_u32(&buf[0]);
+        uint16_t size = esp8266_mlib::buf_to_u16(&buf[4]);
+        uint16_t crc = esp8266_mlib::buf_to_u16(&buf[6]);
+        if ((magic == RULES_FILE_MAGIC) && (sz >= (uint32_t)RULES_FILE_HDR_SZ + size) &&
+            (crc == esp8266_mlib::crc16(&buf[RULES_FILE_HDR_SZ], size))) {
+            int cnt = decode(&buf[RULES_FILE_HDR_SZ], size, g_rules);
+            g_rule_cnt = (cnt > 0) ? cnt : 0;
+        }
+    }
+    DB("\r\n%s: sz=%u, cnt=%u", __FUNCTION__, sz, g_rule_cnt);
+}
+
+/**
+ * Store the rule table to ROM.
+*/
+void rules::store()
+{
+    uint8_t buf[RULES_FILE_HDR_SZ + RULES_DATA_MAX];
+    wdm_frame::Writer w(&buf[RULES_FILE_HDR_SZ], RULES_DATA_MAX);
+
+    w.put<MqttCount>(g_rule_cnt);
+    for (uint8_t i = 0; i < g_rule_cnt; i++) {
+        const RULE_t *r = &g_rules[i];
+        w.put<MqttRule>(r->id, r->flags, r->src_id, r->src_offset, r->op, (uint32_t)r->threshold,
+                        r->hyst, r->offset, r->cmd);
+    }
+    esp8266_mlib::u32_to_buf(RULES_FILE_MAGIC, &buf[0]);
+    esp8266_mlib::u16_to_buf(w.length(), &buf[4]);
+    esp8266_mlib::u16_to_buf(esp8266_mlib::crc16(&buf[RULES_FILE_HDR_SZ], w.length()), &buf[6]);
+    DB("\r\n%s: cnt=%u, len=%u", __FUNCTION__, g_rule_cnt, (unsigned)w.length());
+    esp8266_mlib::save_data(RULES_FILE_NAME, buf, RULES_FILE_HDR_SZ + w.length());
+}
@@ -0,0 +1,63 @@
+/** @brief define Constants, Types & Prototypes for the Rule engine: rules link the samples of
+ *  sensor nodes (e.g. the temperature of a wdm_th) to the devices of this node, so they react
+ *  without a round trip to the server.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _RULES_H_
+#define _RULES_H_
+
+#include "Arduino.h"
+
+/* Maximum number of rules */
+#define RULE_CNT                    16
+
+/* Conditions */
+#define RULE_OP_ABOVE               1   // true above 'threshold', false again below 'threshold - hyst'
+#define RULE_OP_BELOW               2   // true below 'threshold', false again above 'threshold + hyst'
+
+/* Flags */
+#define RULE_F_ENABLE               0x01
+#define RULE_F_REVERT               0x02    // Send !cmd when the condition turns false
+
+/* Condition state */
+#define RULE_STATE_FALSE            0
+#define RULE_STATE_TRUE             1
+#define RULE_STATE_UNKNOWN          0xFF    // No sample since boot
+
+struct RULE_t {
+    uint8_t id;
+    uint8_t flags;
+    uint8_t src_id[6];          // Sensor node & device
+    uint8_t src_offset;
+    uint8_t op;
+    int32_t threshold;          // Same unit as the sample (e.g. 0.1 degC)
+    uint16_t hyst;
+    uint8_t offset;             // Device to control & command sent when the condition turns true
+    uint8_t cmd;
+    uint8_t state;
+};
+
+class rules
+{
+    public:
+        /* Load the rule table */
+        static void init();
+
+        /* Replace the rule table: data = [RuleCnt(1)=N][N x MqttRule] (see wdm_proto.h) */
+        static bool set(const uint8_t *data, size_t len);
+
+        /* Evaluate the rules of a sample: the devices whose rule changed state are switched at
+        once. Return the number of rules which changed state. */
+        static uint8_t sample(const uint8_t src_id[], uint8_t src_offset, int32_t value);
+
+        static uint8_t count();
+        static const RULE_t *get(uint8_t idx);
+
+    private:
+        static void load();
+        static void store();
+};
+
+#endif
@@ -0,0 +1,52 @@
+/** @brief define the Transport interface: how the node packets (see wdm_proto.h, UDP framing)
+ *  reach the other end. The protocol code only sees a TRANSPORT_t, the backends (UDP, MQTT,
+ *  ESP-NOW, in-process loopback) fill it with their functions.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _TRANSPORT_H_
+#define _TRANSPORT_H_
+
+#include "Arduino.h"
+
+/* Flags */
+#define TRANSPORT_F_AUTH            0x01    // Received packets must carry a valid FCS (open medium)
+
+/* Poll period of a blocking recv() (ms) */
+#define TRANSPORT_POLL_MS           2
+
+struct TRANSPORT_t {
+    const char *name;
+    uint8_t flags;
+    uint16_t ack_ms;            // Expected round trip bound: how long to wait for an ACK
+
+    /* Start the backend (its settings are set beforehand by its own setup function) */
+    bool (*open)();
+
+    /* Send one packet: return true if it left the node */
+    bool (*send)(const uint8_t *frame, size_t len);
+
+    /* Receive one packet within 'timeout_ms' (0: only what is already there): return its
+    length, 0 if none, -1 if it doesn't fit in 'size' (dropped) */
+    int (*recv)(uint8_t *buf, size_t size, uint32_t timeout_ms);
+
+    /* Link quality: 0 (no link) .. 100 */
+    uint8_t (*quality)();
+};
+
+/* Link quality of a WiFi link from its RSSI: -100dBm -> 0, -50dBm & above -> 100 */
+static inline uint8_t transport_rssi_quality(int32_t rssi) {
+    if (rssi >= 0) {
+        return 0;           // Not connected
+    }
+    if (rssi <= -100) {
+        return 0;
+    }
+    if (rssi >= -50) {
+        return 100;
+    }
+    return (uint8_t)(2 * (rssi + 100));
+}
+
+#endif
@@ -0,0 +1,45 @@
+#include "Arduino.h"
+#include <ESP8266WiFi.h>
+#include "mqtt_inf.h"
+#include "transport_mqtt.h"
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+const TRANSPORT_t transport_mqtt::ops = {
+    "mqtt", 0, MQTT_ACK_MS,
+    transport_mqtt::open, transport_mqtt::send, transport_mqtt::recv, transport_mqtt::quality
+};
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/** @brief the connection is opened & kept by mqtt_inf.
+*/
+bool transport_mqtt::open()
+{
+    return mqtt_inf::is_connected();
+}
+
+bool transport_mqtt::send(const uint8_t *frame, size_t len)
+{
+    return mqtt_inf::send_LINK(frame, len);
+}
+
+/** @brief the packets are received by the MQTT client loop: it runs while waiting.
+*/
+int transport_mqtt::recv(uint8_t *buf, size_t size, uint32_t timeout_ms)
+{
+    uint32_t t0 = millis();
+    int len;
+
+    while ((len = mqtt_inf::take_LINK(buf, size)) == 0) {
+        if (millis() - t0 >= timeout_ms) {
+            return 0;
+        }
+        mqtt_inf::manager();
+        delay(TRANSPORT_POLL_MS);
+    }
+    return len;
+}
+
+uint8_t transport_mqtt::quality()
+{
+    return mqtt_inf::is_connected() ? transport_rssi_quality(WiFi.RSSI()) : 0;
+}
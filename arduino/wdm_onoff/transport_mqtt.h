@@ -0,0 +1,27 @@
+/** @brief define Constants, Prototypes for the MQTT transport: node packets (UDP framing) carried
+ *  as is over the MQTT connection of mqtt_inf, published on the link topic.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _TRANSPORT_MQTT_H_
+#define _TRANSPORT_MQTT_H_
+
+#include "transport.h"
+
+/* Round trip through the broker (ms) */
+#define MQTT_ACK_MS                 2000
+
+class transport_mqtt
+{
+    public:
+        static const TRANSPORT_t ops;
+
+    private:
+        static bool open();
+        static bool send(const uint8_t *frame, size_t len);
+        static int recv(uint8_t *buf, size_t size, uint32_t timeout_ms);
+        static uint8_t quality();
+};
+
+#endif
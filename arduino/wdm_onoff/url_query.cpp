@@ -0,0 +1,88 @@
+/**	@brief implement the URL query parser.
+ *  One pass: 'r' reads the encoded string & 'w' writes the decoded bytes behind it (decoding never
+ *  makes the string longer). '&' & the first '=' of a pair are read as separators before decoding,
+ *  so an escaped '%26' or '%3D' stays in the value. An invalid escape is kept as is.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "url_query.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+uint8_t url_query::parse(URL_QUERY_t *q, char *str)
+{
+    const char *r = str;
+    char *w = str;
+    char *key = w;
+    char *val = NULL;
+
+    q->cnt = 0;
+    while (true) {
+        char c = *r++;
+
+        if ((c == '&') || (c == '\0')) {
+            *w = '\0';
+            // Skip empty pairs ("a=1&&b=2") & the params which don't fit:
+            if ((w != key) && (q->cnt < URL_QUERY_PARAM_CNT)) {
+                URL_QUERY_PARAM_t *p = &q->params[q->cnt++];
+                p->key = key;
+                p->val = val ? val : w;
+                p->val_len = val ? (w - val) : 0;
+            }
+            if (c == '\0') {
+                break;
+            }
+            key = ++w;
+            val = NULL;
+        } else if ((c == '=') && (val == NULL)) {
+            *w++ = '\0';
+            val = w;
+        } else if (c == '+') {
+            *w++ = ' ';
+        } else if (c == '%') {
+            int8_t h = hex(r[0]);
+            int8_t l = (h >= 0) ? hex(r[1]) : -1;
+            if (l >= 0) {
+                *w++ = (h << 4) | l;
+                r += 2;
+            } else {
+                *w++ = c;
+            }
+        } else {
+            *w++ = c;
+        }
+    }
+
+    DB("\r\n%s: cnt=%u", __FUNCTION__, q->cnt);
+    return q->cnt;
+}
+
+const char *url_query::get(const URL_QUERY_t *q, const char *key, uint16_t *len)
+{
+    for (uint8_t i = 0; i < q->cnt; i++) {
+        if (strcmp(q->params[i].key, key) == 0) {
+            *len = q->params[i].val_len;
+            return q->params[i].val;
+        }
+    }
+    *len = 0;
+    return NULL;
+}
+
+int8_t url_query::hex(char c)
+{
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    c |= 0x20;      // Lower case
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
@@ -0,0 +1,40 @@
+/** @brief define Constants, Types & Prototypes for the URL query parser: the query string
+ *  ("ssid=my%20net&password=...") is split into (key, value) pairs & decoded ('%xx', '+') in place,
+ *  in one pass, into a small fixed table.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _URL_QUERY_H_
+#define _URL_QUERY_H_
+
+#include "Arduino.h"
+
+/* Maximum number of parameters (the next ones are ignored) */
+#define URL_QUERY_PARAM_CNT         8
+
+struct URL_QUERY_PARAM_t {
+    const char *key;                // NUL terminated, decoded
+    const char *val;                // NUL terminated, decoded ("" if no '=')
+    uint16_t val_len;               // Decoded length (a '%00' ends the string early)
+};
+
+struct URL_QUERY_t {
+    uint8_t cnt;
+    URL_QUERY_PARAM_t params[URL_QUERY_PARAM_CNT];
+};
+
+class url_query
+{
+    public:
+        /* Split & decode 'str' in place (the table points into it), return the number of params */
+        static uint8_t parse(URL_QUERY_t *q, char *str);
+
+        /* Value of the first param named 'key', NULL if none. 'len' gets its decoded length. */
+        static const char *get(const URL_QUERY_t *q, const char *key, uint16_t *len);
+
+        /* Value of a hex digit (either case), -1 if not one */
+        static int8_t hex(char c);
+};
+
+#endif
@@ -12,12 +12,19 @@
 #include <Ticker.h>
 
 #include "device.h"
+#include "dlog.h"
 #include "esp8266_mlib.h"
+#include "evlog.h"
+#include "gateway.h"
+#include "lan_inf.h"
 #include "mqtt_inf.h"
 #include "mtime.h"
+#include "ota.h"
+#include "perf.h"
+#include "rules.h"
 #include "wifi_inf.h"
 
-#define DB Serial.printf
+#define DB DLOG
 #define DB_print Serial.print
 
 const int PIN_BT_RESET = 13;
@@ -37,8 +44,13 @@ void setup() {
     esp8266_mlib::init();
     Serial.print("\r\nesp8266_mlib.init done!");
 
-    // Init Device:
+    // Deferred log (DB output), sent to Serial when the loop is idle:
+    dlog::init();
+
+    // Init Event log, Device & Rules:
+    evlog::init();
     device::init();
+    rules::init();
 
     // Init WIFI connection:
     wifi_inf::start();
@@ -48,6 +60,9 @@ void setup() {
     const ROM_SETTINGS_t *cfg = wifi_inf::get_settings();
     mqtt_inf::start(id, cfg->security, cfg->server_addr, cfg->server_port);
 
+    // Init LAN discovery & control (same key):
+    lan_inf::start(cfg->security);
+
     // Start ticker:
     g_ticker.attach_ms(1000, timer_1s);
 }
@@ -55,6 +70,7 @@ void setup() {
 void loop() {
     #define SYNC_CYCLE (1 * 60)
     static uint16_t sync_cnt = SYNC_CYCLE - 1;
+    uint32_t t0 = micros();
 
     // Wait for user settings in AP mode:
     wifi_inf::manager();
@@ -63,6 +79,7 @@ void loop() {
     int bt_event = capture_button();
     if (bt_event != 0) {
         DB("\r\n -> bt_event=%u", bt_event);
+        evlog::push(EV_TYPE_BUTTON, bt_event);
         if (bt_event == 2) {
             wifi_inf::factory_reset();
             esp8266_mlib::soft_reboot();
@@ -74,6 +91,15 @@ void loop() {
     // Handle MQTT connection with server:
     mqtt_inf::manager();
 
+    // LAN packets & announce:
+    lan_inf::manager();
+
+    // Packets of the battery nodes (ESP-NOW):
+    gateway::manager();
+
+    // Boot the new firmware once an update is complete:
+    ota::manager();
+
     // 1 second checker:
     if (g_1s_flg) {
         g_1s_flg = 0;
@@ -82,13 +108,21 @@ void loop() {
         if (mqtt_inf::is_connected()) {
             if (++sync_cnt >= SYNC_CYCLE) {
                 sync_cnt = 0;
-                mqtt_inf::send_TIME_GET(esp8266_mlib::get_id(), mtime::get_local_unix());
+                mqtt_inf::send_TIME_GET(mtime::get_local_unix());
             }
+
+            // Send events recorded while offline (or since the last second):
+            evlog::flush();
         }
 
         // Scheduler:
         device::manager();
     }
+
+    // Send the deferred log, as much as the Serial TX FIFO takes:
+    dlog::idle();
+
+    perf::stop(PERF_LOOP, t0);
 }
 
 void timer_1s() {
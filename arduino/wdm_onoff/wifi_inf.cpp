@@ -4,19 +4,26 @@
 #include "esp8266_mlib.h"
 #include "httpd.h"
 #include "wifi_inf.h"
+#include "dlog.h"
 
 
-#define DB      Serial.printf
+#define DB      DLOG
 #ifndef DB
   #define DB
 #endif
 
 ///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
 /* WIFI ROM settings file name */
-const char *ROM_SETTINGS_FILE_NAME = "/wdm_cfg.txt";
+const char *ROM_SETTINGS_FILE_NAME = "/wdm_cfg.bin";
 
-/* ROM setting size */
-#define ROM_SETTINGS_SIZE				200
+/* Settings file of old firmwares (text), converted on first boot */
+const char *ROM_SETTINGS_TXT_FILE_NAME = "/wdm_cfg.txt";
+
+/* Text settings size */
+#define ROM_SETTINGS_TXT_SIZE			256
+
+/* Binary settings file marker: 'WDMS' */
+#define ROM_SETTINGS_MAGIC				0x534D4457
 
 /* Default Password in AP mode */
 const char *WIFI_PASSWORD_DEFAULT = "wdm-open";
@@ -24,8 +31,24 @@ const char *WIFI_PASSWORD_DEFAULT = "wdm-open";
 /* NVM magic number */
 #define NVM_MAGIC_NUMBER		0x41424344
 
+/* AP mode: sleep between two polls of the provisioning server, when idle (ms) */
+#define WIFI_AP_IDLE_MS         20
+
+/* AP mode: delay of the reboot after new settings, to finish the response to the client (ms) */
+#define WIFI_AP_REBOOT_MS       1000
+
 /* WIFI modes */
 
+/* Binary settings file: header + settings */
+struct ROM_SETTINGS_FILE_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;      // Size of the settings which follow
+    uint16_t crc;       // CRC-16 of the settings
+    uint16_t reserved;
+    ROM_SETTINGS_t settings;
+};
+
 ///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
 /* Default DNS servers */
 static IPAddress g_dns1(8,8,8,8);
@@ -97,21 +120,35 @@ const ROM_SETTINGS_t * wifi_inf::get_settings()
     return &g_rom_settings;    
 }
 
+/**
+ * AP mode: run the provisioning server (HTTP & DNS captive portal) until new settings are received,
+ * then store them & reboot WIFI_AP_REBOOT_MS later, so the response still reaches the client.
+ * The CPU sleeps between the events (delay() yields to the system).
+*/
 void wifi_inf::manager()
 {
 	ROM_SETTINGS_t settings;
+	uint32_t reboot_ms = 0;
 	
 	if (g_wifi_status.mode == WIFI_AP) {
 		while (true) {
-			if (httpd::get_config(&settings)) {
+            uint8_t ev = httpd::poll(&settings);
+			if ((ev == HTTPD_EV_CONFIG) && (reboot_ms == 0)) {
 				DB("\r\n -> having new settings -> store...");
                 memcpy(&g_rom_settings, &settings, sizeof(ROM_SETTINGS_t));
                 g_rom_settings.magic_number = NVM_MAGIC_NUMBER;
                 store_rom_settings();
-				
+                reboot_ms = millis() | 1;
+            }
+            if ((reboot_ms != 0) && (millis() - reboot_ms >= WIFI_AP_REBOOT_MS)) {
 				DB("\r\n -> reboot now!");
+                dlog::flush();
                 ESP.restart();
-            }			
+            }
+            dlog::idle();
+            if (ev == HTTPD_EV_NONE) {
+                delay(WIFI_AP_IDLE_MS);
+            }
 		}		
 	}	
 }
@@ -132,6 +169,60 @@ void wifi_inf::factory_reset()
 ///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
 /**
  * Load settings from ROM memory (Non-volatile).
+ * File format (binary): [magic(4)][version(2)][size(2)][crc16(2)][reserved(2)][settings(size)]
+ *  - settings: ROM_SETTINGS_t, as written by the firmware which stored the file.
+ *  - fields are only appended to ROM_SETTINGS_t: a shorter record (older firmware) leaves the
+ *    new fields at 0, a longer record (newer firmware) is truncated.
+ * If there's no binary file, the text file of old firmwares is converted.
+*/
+void wifi_inf::load_rom_settings()
+{
+    ROM_SETTINGS_FILE_t rec;
+    bool valid = false;
+
+    memset(&g_rom_settings, 0, sizeof(ROM_SETTINGS_t));
+    memset(&rec, 0, sizeof(rec));
+
+    esp8266_mlib::recover_data(ROM_SETTINGS_FILE_NAME);
+    File f = SPIFFS.open(ROM_SETTINGS_FILE_NAME, "r");
+    if (f) {
+        uint32_t sz = f.read((uint8_t *)&rec, sizeof(rec));
+        uint32_t hdr_sz = sizeof(rec) - sizeof(ROM_SETTINGS_t);
+        uint32_t known = (rec.size < sizeof(ROM_SETTINGS_t)) ? rec.size : sizeof(ROM_SETTINGS_t);
+        if ((rec.magic == ROM_SETTINGS_MAGIC) && (sz >= hdr_sz + known)) {
+            uint16_t crc = esp8266_mlib::crc16((const uint8_t *)&rec.settings, known);
+
+            // Settings from a newer firmware: CRC the fields unknown to us.
+            uint8_t buf[16];
+            uint32_t left = rec.size - known;
+            while (left > 0) {
+                uint32_t n = f.read(buf, (left < sizeof(buf)) ? left : sizeof(buf));
+                if (n == 0) {
+                    break;
+                }
+                crc = esp8266_mlib::crc16(buf, n, crc);
+                left -= n;
+            }
+
+            if ((left == 0) && (crc == rec.crc)) {
+                memset((uint8_t *)&rec.settings + known, 0, sizeof(ROM_SETTINGS_t) - known);
+                memcpy(&g_rom_settings, &rec.settings, sizeof(ROM_SETTINGS_t));
+                valid = true;
+            }
+        }
+        f.close();
+        DB("\r\n%s: version=%u, size=%u, valid=%u", __FUNCTION__, rec.version, rec.size, valid);
+    } else if (SPIFFS.exists(ROM_SETTINGS_TXT_FILE_NAME)) {
+        DB("\r\n%s: convert text settings", __FUNCTION__);
+        load_rom_settings_txt();
+        if (store_rom_settings()) {
+            SPIFFS.remove(ROM_SETTINGS_TXT_FILE_NAME);
+        }
+    }
+}
+
+/**
+ * Load settings from the text file of old firmwares.
  * File format (text):
  *  Line-0: [MagicNumber][LF]
  *  Line-1: [ssid][LF]
@@ -141,10 +232,10 @@ void wifi_inf::factory_reset()
  *  Line-5: [security][LF]
  *  Line-6: [timezone][LF]
 */
-void wifi_inf::load_rom_settings()
+void wifi_inf::load_rom_settings_txt()
 {
-    char file_buf[ROM_SETTINGS_SIZE];
-    uint32_t sz = esp8266_mlib::load_file(ROM_SETTINGS_FILE_NAME, file_buf, ROM_SETTINGS_SIZE);
+    char file_buf[ROM_SETTINGS_TXT_SIZE];
+    uint32_t sz = esp8266_mlib::load_file(ROM_SETTINGS_TXT_FILE_NAME, file_buf, ROM_SETTINGS_TXT_SIZE);
     char *p1 = NULL;
     char *p2 = NULL;
 
@@ -214,27 +305,18 @@ void wifi_inf::load_rom_settings()
 }
 
 /**
- * Store settings to ROM memory.
+ * Store settings to ROM memory: return true if stored (the file is replaced only then).
 */
-void wifi_inf::store_rom_settings()
+bool wifi_inf::store_rom_settings()
 {
-    char file_buf[ROM_SETTINGS_SIZE] = "";
-    char str[64];
-
-	snprintf(str, CFG_PASSWORD_SZ, "%u\n", g_rom_settings.magic_number);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SSID_SZ, "%s\n", g_rom_settings.ssid);
-	strcat(file_buf, str);
-    snprintf(str, CFG_PASSWORD_SZ, "%s\n", g_rom_settings.password);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SERVER_SZ, "%s\n", g_rom_settings.server_addr);
-    strcat(file_buf, str);
-	snprintf(str, CFG_PASSWORD_SZ, "%u\n", g_rom_settings.server_port);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SECURITY_SZ, "%s\n", g_rom_settings.security);
-    strcat(file_buf, str);
-	snprintf(str, CFG_SECURITY_SZ, "%d\n", g_rom_settings.timezone);
-    strcat(file_buf, str);
-    DB("\r\n%s: -> content=[%s]", __FUNCTION__, file_buf);
-    esp8266_mlib::save_file(ROM_SETTINGS_FILE_NAME, file_buf);
+    ROM_SETTINGS_FILE_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = ROM_SETTINGS_MAGIC;
+    rec.version = ROM_SETTINGS_VERSION;
+    rec.size = sizeof(ROM_SETTINGS_t);
+    memcpy(&rec.settings, &g_rom_settings, sizeof(ROM_SETTINGS_t));
+    rec.crc = esp8266_mlib::crc16((const uint8_t *)&rec.settings, sizeof(ROM_SETTINGS_t));
+    DB("\r\n%s: version=%u, size=%u", __FUNCTION__, rec.version, rec.size);
+    return esp8266_mlib::save_data(ROM_SETTINGS_FILE_NAME, &rec, sizeof(rec));
 }
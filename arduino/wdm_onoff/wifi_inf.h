@@ -11,10 +11,13 @@
 /* Settings parameter limits */
 #define CFG_SSID_SZ             32
 #define CFG_PASSWORD_SZ         32
-#define CFG_SERVER_SZ           64
+#define CFG_SERVER_SZ           96
 #define CFG_SECURITY_SZ         32
 
-/* ROM memory settings parameters */
+/* ROM memory settings parameters: stored as a binary record (see wifi_inf::load_rom_settings()).
+New fields must be appended at the end, with ROM_SETTINGS_VERSION increased. */
+#define ROM_SETTINGS_VERSION    1
+
 struct ROM_SETTINGS_t {
 	uint32_t magic_number;
     char ssid[CFG_SSID_SZ];
@@ -52,7 +55,8 @@ class wifi_inf
 	
 	private:
 		static void load_rom_settings();
-		static void store_rom_settings();
+		static void load_rom_settings_txt();
+		static bool store_rom_settings();
 };
 
 #endif
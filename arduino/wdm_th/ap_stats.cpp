@@ -0,0 +1,102 @@
+/**	@brief implement the AP profile statistics.
+ *  A profile which connected in t ms for k of its n last tries is expected to cost
+ *      E = t + (n - k) / k * timeout
+ *  (each failure waits for the timeout, one try in n/k succeeds). A profile which never connected
+ *  costs more than any other one but is still tried, last.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "esp8266_mlib.h"
+#include "ap_stats.h"
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void ap_stats::check(AP_STATS_t *p, const char *ssid)
+{
+    uint16_t crc = esp8266_mlib::crc16((const uint8_t *)ssid, strlen(ssid));
+    if (p->ssid_crc != crc) {
+        memset(p, 0, sizeof(AP_STATS_t));
+        p->ssid_crc = crc;
+    }
+}
+
+void ap_stats::update(AP_STATS_t *p, bool ok, uint32_t ms)
+{
+    p->history = (p->history << 1) | (ok ? 1 : 0);
+    if (p->tries < AP_STATS_HISTORY) {
+        p->tries++;
+    }
+    if (ok) {
+        if (ms > 0xFFFF) {
+            ms = 0xFFFF;
+        }
+        if (ms == 0) {
+            ms = 1;
+        }
+        // Moving average, the last connect weighs 1/4:
+        p->connect_ms = (p->connect_ms == 0) ? ms : (3 * (uint32_t)p->connect_ms + ms) / 4;
+    } else {
+        // The AP may have moved: scan on the next try
+        p->channel = 0;
+    }
+}
+
+uint32_t ap_stats::expected_ms(const AP_STATS_t *p)
+{
+    uint8_t ok = success_cnt(p);
+
+    if (p->tries == 0) {
+        return AP_STATS_UNKNOWN_MS;
+    }
+    if (ok == 0) {
+        return AP_STATS_TIMEOUT_MS * (AP_STATS_HISTORY + 1);
+    }
+    return p->connect_ms + (uint32_t)(p->tries - ok) * timeout_ms(p) / ok;
+}
+
+uint32_t ap_stats::timeout_ms(const AP_STATS_t *p)
+{
+    if ((p->connect_ms == 0) || (success_cnt(p) == 0)) {
+        return AP_STATS_TIMEOUT_MS;
+    }
+    uint32_t ms = (uint32_t)p->connect_ms * AP_STATS_TIMEOUT_FACTOR;
+    if (ms < AP_STATS_TIMEOUT_MIN_MS) {
+        ms = AP_STATS_TIMEOUT_MIN_MS;
+    }
+    return (ms < AP_STATS_TIMEOUT_MS) ? ms : AP_STATS_TIMEOUT_MS;
+}
+
+uint8_t ap_stats::sort(const AP_STATS_t *tbl, uint8_t cnt, uint8_t mask, uint8_t *order)
+{
+    uint32_t cost[8];
+    uint8_t n = 0;
+
+    // Insertion sort (a few profiles), stable: equal costs keep the profile order
+    for (uint8_t i = 0; (i < cnt) && (i < 8); i++) {
+        if (!(mask & (1 << i))) {
+            continue;
+        }
+        uint32_t c = expected_ms(&tbl[i]);
+        uint8_t k = n;
+        while ((k > 0) && (cost[k - 1] > c)) {
+            cost[k] = cost[k - 1];
+            order[k] = order[k - 1];
+            k--;
+        }
+        cost[k] = c;
+        order[k] = i;
+        n++;
+    }
+    return n;
+}
+
+uint8_t ap_stats::success_cnt(const AP_STATS_t *p)
+{
+    uint8_t bits = (p->tries >= 8) ? p->history : (p->history & ((1 << p->tries) - 1));
+    uint8_t n = 0;
+    while (bits) {
+        bits &= bits - 1;
+        n++;
+    }
+    return n;
+}
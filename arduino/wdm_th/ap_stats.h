@@ -0,0 +1,60 @@
+/** @brief define Constants, Types & Prototypes for the AP profile statistics: what the last connects
+ *  to each AP profile cost (time, success, where the AP was), kept in RTC memory through deep sleep,
+ *  to try the profiles in order of expected connect time.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _AP_STATS_H_
+#define _AP_STATS_H_
+
+#include "Arduino.h"
+
+/* Connect timeouts (ms): profile never connected / shortest one for a known profile */
+#define AP_STATS_TIMEOUT_MS         5000
+#define AP_STATS_TIMEOUT_MIN_MS     1000
+
+/* A known profile is given this many times its average connect time */
+#define AP_STATS_TIMEOUT_FACTOR     3
+
+/* Expected connect time of a profile never tried (ms) */
+#define AP_STATS_UNKNOWN_MS         3000
+
+/* Number of results kept in the history */
+#define AP_STATS_HISTORY            8
+
+struct AP_STATS_t {
+    uint16_t ssid_crc;              // CRC-16 of the SSID the stats belong to
+    uint16_t connect_ms;            // Average connect time, 0 if never connected
+    uint8_t bssid[6];               // Last AP the profile connected to
+    uint8_t channel;                // 0 if unknown: connect with a scan
+    int8_t rssi;
+    uint8_t history;                // Last results, bit 0 is the last one (1: connected)
+    uint8_t tries;                  // Number of results in 'history'
+    uint8_t reserved[2];
+};
+
+class ap_stats
+{
+    public:
+        /* Reset the stats if they belong to another SSID */
+        static void check(AP_STATS_t *p, const char *ssid);
+
+        /* Record a connect result */
+        static void update(AP_STATS_t *p, bool ok, uint32_t ms);
+
+        /* Expected time to connect to the profile (ms), retries on failure included */
+        static uint32_t expected_ms(const AP_STATS_t *p);
+
+        /* Time to give to a connect before moving to the next profile (ms) */
+        static uint32_t timeout_ms(const AP_STATS_t *p);
+
+        /* Sort the profiles set in 'mask' (bit i: profile i) by expected connect time: 'order'
+        gets their index, return their count */
+        static uint8_t sort(const AP_STATS_t *tbl, uint8_t cnt, uint8_t mask, uint8_t *order);
+
+        /* Number of successful connects in the history */
+        static uint8_t success_cnt(const AP_STATS_t *p);
+};
+
+#endif
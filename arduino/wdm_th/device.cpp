@@ -4,8 +4,9 @@
 #include "esp8266_mlib.h"
 #include "mqtt_inf.h"
 #include "device.h"
+#include "dlog.h"
 
-#define DB      Serial.printf
+#define DB      DLOG
 #define ERR     Serial.printf
 #ifndef DB
   #define DB
@@ -0,0 +1,99 @@
+/** @brief define Constants, Prototypes for the Deferred log module: DLOG() records the format
+ *  string address & the raw arguments in a ring buffer (no formatting, no UART wait); the
+ *  buffer is sent to Serial in binary only when idle or on demand, and decoded on the host by
+ *  arduino/tools/dlog_decode.py using the format strings of the firmware ELF.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _DLOG_H_
+#define _DLOG_H_
+
+#include "Arduino.h"
+#include <type_traits>
+
+/* Ring buffer size */
+#define DLOG_BUF_SZ                 192
+
+/* Keep the buffer in RTC memory (through deep sleep): needs the rtc_mem module */
+#define DLOG_RTC_MEM                1
+
+/* Longest entry & longest string argument (longer strings are truncated) */
+#define DLOG_ENTRY_MAX              64
+#define DLOG_STR_MAX                24
+
+/* Serial frame: [sync(1)][entry()][sum(1)]
+    entry() = [len(1)][fmt(4)][ms(4)][args()]: integers & pointers are 4 bytes, 64-bit integers &
+    doubles are 8 bytes, strings are [n(1)][chars(n)] */
+#define DLOG_SYNC                   0xD1
+#define DLOG_HDR_SZ                 9
+
+/* printf-like, deferred: the format is still checked by the compiler, but never executed */
+#define DLOG(fmt, ...)  do { if (0) Serial.printf(fmt, ##__VA_ARGS__); dlog::log(fmt, ##__VA_ARGS__); } while (0)
+
+class dlog
+{
+    public:
+        /* Set up the ring buffer (restored from RTC memory if enabled) & log a boot marker */
+        static void init();
+
+        /* Record one entry: drops the oldest entries when the buffer is full */
+        template <typename... A> static void log(const char *fmt, A... args) {
+            uint8_t e[DLOG_ENTRY_MAX];
+            uint8_t n = DLOG_HDR_SZ;
+            put_u32(&e[1], (uint32_t)(uintptr_t)fmt);
+            put_u32(&e[5], millis());
+            pack(e, n, args...);
+            e[0] = n;
+            write(e, n);
+        }
+
+        /* Drain without blocking: only what the Serial TX FIFO accepts now. Call it when idle. */
+        static void idle();
+
+        /* Drain everything (blocking) */
+        static void flush();
+
+        /* Number of bytes waiting in the buffer */
+        static uint16_t pending();
+
+    private:
+        static void write(const uint8_t *e, uint8_t n);
+        static bool drain_one(bool block);
+
+        static inline void put_u32(uint8_t *p, uint32_t v) {
+            p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+        }
+
+        /* Argument packing: resolved at compile time, one case per argument */
+        static inline void pack(uint8_t *, uint8_t &) {}
+
+        template <typename T, typename... A> static inline void pack(uint8_t *e, uint8_t &n, T v, A... args) {
+            pack_one(e, n, v);
+            pack(e, n, args...);
+        }
+
+        template <typename T> static inline
+        typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+        pack_one(uint8_t *e, uint8_t &n, T v) {
+            if (sizeof(T) > 4) {
+                pack_raw(e, n, &v, 8);
+            } else if (n + 4 <= DLOG_ENTRY_MAX) {
+                put_u32(&e[n], (uint32_t)v);
+                n += 4;
+            }
+        }
+
+        static inline void pack_one(uint8_t *e, uint8_t &n, double v) { pack_raw(e, n, &v, 8); }
+        static inline void pack_one(uint8_t *e, uint8_t &n, const void *v) {
+            if (n + 4 <= DLOG_ENTRY_MAX) {
+                put_u32(&e[n], (uint32_t)(uintptr_t)v);
+                n += 4;
+            }
+        }
+        static void pack_one(uint8_t *e, uint8_t &n, const char *s);
+        static inline void pack_one(uint8_t *e, uint8_t &n, char *s) { pack_one(e, n, (const char *)s); }
+        static void pack_raw(uint8_t *e, uint8_t &n, const void *v, uint8_t sz);
+};
+
+#endif
@@ -7,6 +7,7 @@
 #include "FS.h"
 #include <ESP8266WiFi.h>
 #include "esp8266_mlib.h"
+#include "rtc_mem.h"
 
 
 //#define DB      Serial.printf
@@ -70,6 +71,7 @@ void esp8266_mlib::enter_sleep(uint32_t us)
 {
     uint32_t u32 = PWR_BOOT_SLEEP;
     DB("\r\n -> %s", __FUNCTION__);
+    rtc_mem::store();
     ESP.rtcUserMemoryWrite(0x0000, &u32, 4);
     ESP.deepSleep(us, WAKE_RF_DEFAULT);
 }
@@ -80,6 +82,7 @@ void esp8266_mlib::soft_reboot()
 {
     uint32_t u32 = PWR_BOOT_SOFT;
     DB("\r\n -> %s", __FUNCTION__);
+    rtc_mem::store();
     ESP.rtcUserMemoryWrite(0x0000, &u32, 4);
     ESP.restart();
 }
@@ -90,7 +93,7 @@ void esp8266_mlib::soft_reboot()
     @param str_sz: size of the output buffer.
     @return number of read bytes.
 */
-uint32_t esp8266_mlib::load_file(const char *file_name, char *str, uint8_t str_sz)
+uint32_t esp8266_mlib::load_file(const char *file_name, char *str, uint32_t str_sz)
 {
     uint32_t ret = 0;
     DB("\r\n%s: file=%s", __FUNCTION__, file_name);
@@ -131,6 +134,52 @@ bool esp8266_mlib::save_file(const char *file_name, const char *content)
     return true;
 }
 
+/** @brief store a binary content to a file: written to '<file_name>.tmp' first, which then
+    replaces the file, so a power loss never leaves a partly written file (see recover_data()).
+    @param *file_name: name of the file to store to, always override the file.
+    @param *data: the content to store.
+    @param sz: size of the content.
+    @return true if store successully, false if not (the file is unchanged).
+*/
+bool esp8266_mlib::save_data(const char *file_name, const void *data, uint32_t sz)
+{
+    char tmp_name[ESP_FILE_NAME_SZ];
+
+    DB("\r\n%s: fname=%s, sz=%u", __FUNCTION__, file_name, sz);
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", file_name);
+    File f = SPIFFS.open(tmp_name, "w");
+    if (!f) {
+        DB(" -> open file failed!");
+        return false;
+    }
+    bool ret = (f.write((const uint8_t *)data, sz) == sz);
+    f.close();
+    if (!ret) {
+        SPIFFS.remove(tmp_name);
+        return false;
+    }
+    SPIFFS.remove(file_name);
+    return SPIFFS.rename(tmp_name, file_name);
+}
+
+/** @brief finish a save_data() interrupted by a power loss, before reading the file: the
+    temporary file replaces the file only if it was removed (the temporary file is complete).
+*/
+void esp8266_mlib::recover_data(const char *file_name)
+{
+    char tmp_name[ESP_FILE_NAME_SZ];
+
+    snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", file_name);
+    if (SPIFFS.exists(tmp_name)) {
+        DB("\r\n%s: fname=%s", __FUNCTION__, file_name);
+        if (SPIFFS.exists(file_name)) {
+            SPIFFS.remove(tmp_name);
+        } else {
+            SPIFFS.rename(tmp_name, file_name);
+        }
+    }
+}
+
 uint32_t esp8266_mlib::buf_to_u32(uint8_t buf[])
 {
     uint32_t ret = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
@@ -157,3 +206,17 @@ void esp8266_mlib::u16_to_buf(uint16_t u16, uint8_t buf[])
     buf[0] = (uint8_t)(u16 & 0xff);
     buf[1] = (uint8_t)((u16 >> 8) & 0xff);
 }
+
+/** @brief CRC-16/CCITT (poly 0x1021).
+    @param crc: initial value, or the result of the previous call to continue a calculation.
+*/
+uint16_t esp8266_mlib::crc16(const uint8_t buf[], uint32_t len, uint16_t crc)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= (uint16_t)buf[i] << 8;
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
@@ -19,6 +19,9 @@
 /* RTC Magic number */
 #define RTC_MAGIC_VALUE             0x41424344
 
+/* Longest file name (SPIFFS), '\0' included */
+#define ESP_FILE_NAME_SZ            32
+
 class esp8266_mlib
 {
 	public:
@@ -32,14 +35,18 @@ class esp8266_mlib
 		static void enter_sleep(uint32_t us);
 		static void soft_reboot();
 		
-		static uint32_t load_file(const char *file_name, char *str, uint8_t str_sz);
+		static uint32_t load_file(const char *file_name, char *str, uint32_t str_sz);
 		static bool save_file(const char *file_name, const char *content);
+		static bool save_data(const char *file_name, const void *data, uint32_t sz);
+		static void recover_data(const char *file_name);
 
 		static uint32_t buf_to_u32(uint8_t buf[]);
 		static void u32_to_buf(uint32_t u32, uint8_t buf[]);	
 
 		static uint16_t buf_to_u16(uint8_t buf[]);
 		static void u16_to_buf(uint16_t u16, uint8_t buf[]);
+
+		static uint16_t crc16(const uint8_t buf[], uint32_t len, uint16_t crc = 0xFFFF);
 };
 
 #endif
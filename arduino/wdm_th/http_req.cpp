@@ -0,0 +1,188 @@
+/**	@brief implement the HTTP request parser: one pass over the bytes, one state per element of
+ *      request-line = method SP request-target SP HTTP-version CRLF
+ *      headers      = *(header-line CRLF) CRLF
+ *  Bare LF is accepted as line end. Headers are only checked & counted.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "http_req.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+/* States */
+#define ST_METHOD           0
+#define ST_TARGET           1
+#define ST_VERSION          2
+#define ST_LINE_LF          3   // CR of the request-line seen
+#define ST_HDR_START        4   // Start of a header line (or of the final CRLF)
+#define ST_HDR              5
+#define ST_HDR_LF           6
+#define ST_END_LF           7
+#define ST_DONE             8
+#define ST_ERROR            9
+
+static const char HTTP_VERSION_PREFIX[] = "HTTP/1.";
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+void http_req::init(HTTP_REQ_t *req)
+{
+    req->state = ST_METHOD;
+    req->method = 0;
+    req->status = 0;
+    req->pos = 0;
+    req->hdr_cnt = 0;
+    req->query = 0;
+    req->target[0] = '\0';
+}
+
+int8_t http_req::feed(HTTP_REQ_t *req, const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; (i < len) && (req->state < ST_DONE); i++) {
+        uint8_t c = buf[i];
+
+        switch (req->state) {
+        case ST_METHOD:
+            if (c == ' ') {
+                if (req->pos == 0) {
+                    return fail(req, 400);
+                }
+                req->method_buf[req->pos] = '\0';
+                if (strcmp(req->method_buf, "GET") == 0) {
+                    req->method = HTTP_METHOD_GET;
+                } else if (strcmp(req->method_buf, "HEAD") == 0) {
+                    req->method = HTTP_METHOD_HEAD;
+                } else {
+                    req->method = HTTP_METHOD_OTHER;
+                }
+                req->pos = 0;
+                req->state = ST_TARGET;
+            } else if ((c < 'A') || (c > 'Z')) {
+                return fail(req, 400);
+            } else if (req->pos >= HTTP_REQ_METHOD_SZ - 1) {
+                return fail(req, 501);
+            } else {
+                req->method_buf[req->pos++] = c;
+            }
+            break;
+
+        case ST_TARGET:
+            if (c == ' ') {
+                if (req->pos == 0) {
+                    return fail(req, 400);
+                }
+                req->target[req->pos] = '\0';
+                if (req->query == 0) {
+                    req->query = req->pos;      // No query: empty string
+                }
+                req->pos = 0;
+                req->state = ST_VERSION;
+            } else if ((c <= ' ') || (c >= 0x7F) || ((req->pos == 0) && (c != '/'))) {
+                return fail(req, 400);
+            } else if (req->pos >= HTTP_REQ_TARGET_SZ - 1) {
+                return fail(req, 414);
+            } else {
+                // Split path & query in place:
+                if ((c == '?') && (req->query == 0)) {
+                    c = '\0';
+                    req->query = req->pos + 1;
+                }
+                req->target[req->pos++] = c;
+            }
+            break;
+
+        case ST_VERSION:
+            if (req->pos < sizeof(HTTP_VERSION_PREFIX) - 1) {
+                if (c != (uint8_t)HTTP_VERSION_PREFIX[req->pos]) {
+                    return fail(req, (req->pos >= 5) ? 505 : 400);
+                }
+                req->pos++;
+            } else if (req->pos == sizeof(HTTP_VERSION_PREFIX) - 1) {
+                if ((c != '0') && (c != '1')) {
+                    return fail(req, 505);
+                }
+                req->pos++;
+            } else if (c == '\r') {
+                req->state = ST_LINE_LF;
+            } else if (c == '\n') {
+                req->state = ST_HDR_START;
+            } else {
+                return fail(req, 400);
+            }
+            break;
+
+        case ST_LINE_LF:
+        case ST_HDR_LF:
+            if (c != '\n') {
+                return fail(req, 400);
+            }
+            req->state = ST_HDR_START;
+            break;
+
+        case ST_HDR_START:
+            if (c == '\r') {
+                req->state = ST_END_LF;
+                break;
+            }
+            if (c == '\n') {
+                req->state = ST_DONE;
+                break;
+            }
+            if (++req->hdr_cnt > HTTP_REQ_HDR_CNT) {
+                return fail(req, 431);
+            }
+            req->pos = 0;
+            req->state = ST_HDR;
+            // The byte is the first one of the header line:
+            // fall through
+        case ST_HDR:
+            if (c == '\r') {
+                req->state = ST_HDR_LF;
+            } else if (c == '\n') {
+                req->state = ST_HDR_START;
+            } else if ((c < ' ') && (c != '\t')) {
+                return fail(req, 400);
+            } else if (++req->pos > HTTP_REQ_HDR_LINE_MAX) {
+                return fail(req, 431);
+            }
+            break;
+
+        case ST_END_LF:
+            if (c != '\n') {
+                return fail(req, 400);
+            }
+            req->state = ST_DONE;
+            break;
+        }
+    }
+
+    if (req->state == ST_DONE) {
+        DB("\r\n%s: method=%u, target=%s", __FUNCTION__, req->method, req->target);
+        return HTTP_REQ_DONE;
+    }
+    return (req->state == ST_ERROR) ? HTTP_REQ_ERROR : HTTP_REQ_MORE;
+}
+
+const char *http_req::path(const HTTP_REQ_t *req)
+{
+    return req->target;
+}
+
+char *http_req::query(HTTP_REQ_t *req)
+{
+    return &req->target[req->query];
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+int8_t http_req::fail(HTTP_REQ_t *req, uint16_t status)
+{
+    DB("\r\n%s: state=%u, pos=%u -> %u", __FUNCTION__, req->state, req->pos, status);
+    req->state = ST_ERROR;
+    req->status = status;
+    return HTTP_REQ_ERROR;
+}
@@ -0,0 +1,62 @@
+/** @brief define Constants, Types & Prototypes for the HTTP request parser: an incremental
+ *  state machine over the request-line & headers, fed with the bytes as they arrive. It keeps
+ *  the request-target in a fixed buffer & only counts the headers, so a request allocates
+ *  nothing, and over-long or malformed requests stop with an error status.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _HTTP_REQ_H_
+#define _HTTP_REQ_H_
+
+#include "Arduino.h"
+
+/* Request-target buffer (path & query, NUL terminated) */
+#define HTTP_REQ_TARGET_SZ          256
+
+/* Header limits: longer lines / more lines -> 431 */
+#define HTTP_REQ_HDR_LINE_MAX       512
+#define HTTP_REQ_HDR_CNT            32
+
+/* Method token buffer */
+#define HTTP_REQ_METHOD_SZ          8
+
+/* Methods */
+#define HTTP_METHOD_GET             1
+#define HTTP_METHOD_HEAD            2
+#define HTTP_METHOD_OTHER           3
+
+/* feed() results */
+#define HTTP_REQ_MORE               0
+#define HTTP_REQ_DONE               1
+#define HTTP_REQ_ERROR              -1
+
+struct HTTP_REQ_t {
+    uint8_t state;
+    uint8_t method;
+    uint16_t status;                // Error status (400, 414, 431, 505...), 0 if none
+    uint16_t pos;                   // Position in the current token/line
+    uint16_t hdr_cnt;
+    uint16_t query;                 // Offset of the query in 'target' (at the NUL if none)
+    char method_buf[HTTP_REQ_METHOD_SZ];
+    char target[HTTP_REQ_TARGET_SZ];
+};
+
+class http_req
+{
+    public:
+        static void init(HTTP_REQ_t *req);
+
+        /* Parse the next bytes. Return HTTP_REQ_DONE at the end of the headers (the bytes after
+        it are not used), HTTP_REQ_ERROR on error (see req->status), HTTP_REQ_MORE otherwise. */
+        static int8_t feed(HTTP_REQ_t *req, const uint8_t *buf, size_t len);
+
+        /* Once done: path ("/cfg") & raw query ("a=1&b=2", "" if none) */
+        static const char *path(const HTTP_REQ_t *req);
+        static char *query(HTTP_REQ_t *req);
+
+    private:
+        static int8_t fail(HTTP_REQ_t *req, uint16_t status);
+};
+
+#endif
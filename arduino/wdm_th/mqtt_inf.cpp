@@ -3,8 +3,9 @@
 #include <PubSubClient.h>
 #include "esp8266_mlib.h"
 #include "mqtt_inf.h"
+#include "dlog.h"
 
-#define DB        Serial.printf
+#define DB        DLOG
 #define DB_print  Serial.print
 #define ERR       Serial.printf
 #ifndef DB
@@ -0,0 +1,174 @@
+#include <Arduino.h>
+#include "FS.h"
+#include <wdm_proto.h>
+#include <wdm_siphash.h>
+#include "device.h"
+#include "esp8266_mlib.h"
+#include "rtc_mem.h"
+#include "node_link.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+#define LINK_PACKET_SIZE_MAX    128
+
+#define OPU_CONNECT             0x01
+#define OPU_STATUS              0x02
+#define OPU_ACK                 0x03
+
+#define OPH_CONNACK             0x01
+#define OPH_ACK                 0x02
+#define OPH_CMD                 0x03
+
+/* Maximum number of devices in a STATUS */
+#define LINK_DEV_CNT_MAX        10
+
+using namespace wdm_proto;
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static uint8_t g_node_id[WDM_ID_SZ];
+static wdm_siphash::Key g_key;
+static LINK_RTC_t g_rtc_link;
+static_assert(sizeof(g_rtc_link) <= RTC_MEM_LINK_SIZE, "node_link: RTC memory region over its budget");
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+/** @brief load the link state: after a power loss, the sequence restarts at the end of the
+ *  block reserved in flash.
+*/
+void node_link::init(const uint8_t id[], const char *security)
+{
+    memcpy(g_node_id, id, WDM_ID_SZ);
+    g_key = wdm_siphash::derive(security);
+
+    int8_t rtc_id = rtc_mem::add("link", RTC_LINK_VERSION, &g_rtc_link, sizeof(g_rtc_link));
+    if (!rtc_mem::is_valid(rtc_id)) {
+        memset(&g_rtc_link, 0, sizeof(g_rtc_link));
+        esp8266_mlib::recover_data(LINK_SEQ_FILE);
+        File f = SPIFFS.open(LINK_SEQ_FILE, "r");
+        if (f) {
+            f.read((uint8_t *)&g_rtc_link.seq_limit, sizeof(g_rtc_link.seq_limit));
+            f.close();
+        }
+        g_rtc_link.seq = g_rtc_link.seq_limit;
+    }
+    DB("\r\n%s: seq=%u/%u, gw=%02X..%02X, fails=%u", __FUNCTION__, g_rtc_link.seq, g_rtc_link.seq_limit,
+        g_rtc_link.gw_mac[0], g_rtc_link.gw_mac[5], g_rtc_link.gw_fails);
+}
+
+LINK_RTC_t *node_link::state()
+{
+    return &g_rtc_link;
+}
+
+/*  Packet: [Marker=0xa8][Sequence(4)][NodeId(6)][Opcode(1)][Data()][FCS(8)]
+        Data()          = [DevCnt(1)=N][DeviceStatusList(N x 8)]
+        DeviceStatus()  = [Offset(1)][Type(1)][Value(4)][Rssi(1)][Power(1)]
+        FCS             = SipHash-2-4 of the packet, keyed with the 'security' setting
+*/
+bool node_link::send_STATUS(const TRANSPORT_t *tp, int dev_cnt, const DEVICE_INFO_t dev_list[])
+{
+    uint8_t tx_buf[LINK_PACKET_SIZE_MAX];
+    wdm_frame::Writer w(tx_buf, sizeof(tx_buf));
+
+    DB("\r\n%s: %s, dev_cnt=%u", __FUNCTION__, tp->name, dev_cnt);
+    if (dev_cnt > LINK_DEV_CNT_MAX) {
+        return false;
+    }
+
+    // Create packet:
+    uint32_t seq = next_seq();
+    w.put<UdpHeader>(UDP_MARKER, seq, g_node_id, OPU_STATUS);
+    w.put<UdpCount>(dev_cnt);
+    for (int k = 0; k < dev_cnt; k++) {
+        const DEVICE_INFO_t *p_dev = &dev_list[k];
+        w.put<UdpDeviceStatus>(p_dev->offset, p_dev->type, p_dev->v, p_dev->r, p_dev->p);
+    }
+    uint8_t *fcs = w.reserve(UDP_FCS_SZ);
+    if (!w.ok()) {
+        DB(" -> packet too long!");
+        return false;
+    }
+    wdm_siphash::sign(g_key, tx_buf, w.length() - UDP_FCS_SZ, fcs);
+
+    // Send & wait for ACK:
+    if (!tp->send(tx_buf, w.length())) {
+        DB(" -> send failed!");
+        return false;
+    }
+    return wait_ack(tp, seq, OPU_STATUS);
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/** @brief next sequence: a new block is reserved in flash when the current one is used up.
+*/
+uint32_t node_link::next_seq()
+{
+    if (++g_rtc_link.seq >= g_rtc_link.seq_limit) {
+        g_rtc_link.seq_limit = g_rtc_link.seq + LINK_SEQ_BLOCK;
+        esp8266_mlib::save_data(LINK_SEQ_FILE, &g_rtc_link.seq_limit, sizeof(g_rtc_link.seq_limit));
+    }
+    return g_rtc_link.seq;
+}
+
+/** @brief wait for the ACK of (seq, op) for the round trip time of the transport.
+*/
+bool node_link::wait_ack(const TRANSPORT_t *tp, uint32_t seq, uint8_t op)
+{
+    uint8_t rx_buf[LINK_PACKET_SIZE_MAX];
+    uint32_t t0 = millis();
+
+    while (true) {
+        uint32_t elapsed = millis() - t0;
+        uint32_t left = (elapsed < tp->ack_ms) ? tp->ack_ms - elapsed : 0;
+        int len = tp->recv(rx_buf, sizeof(rx_buf), left);
+        if ((len > 0) && rx_packet(tp, rx_buf, len, seq, op)) {
+            DB(" -> ACKed!!!");
+            return true;
+        }
+        if ((len == 0) || (left == 0)) {
+            DB(" -> no ACK");
+            return false;
+        }
+    }
+}
+
+/** @brief Process RX packet: return true if it is the ACK of (seq, op).
+ *  @note other packets are logged & dropped; on an open medium (TRANSPORT_F_AUTH) only signed
+ *  packets are taken.
+*/
+bool node_link::rx_packet(const TRANSPORT_t *tp, const uint8_t *buf, size_t len, uint32_t seq, uint8_t op)
+{
+    // Validate header:
+    wdm_frame::View<UdpHeader> hdr(buf, (len >= UDP_FCS_SZ) ? len - UDP_FCS_SZ : 0);
+    if (!hdr.valid() || (hdr.get<UDP_HDR_MARKER>() != UDP_MARKER)) {
+        DB(" -> Invalid packet!");
+        return false;
+    }
+    if (memcmp(hdr.get<UDP_HDR_ID>(), g_node_id, WDM_ID_SZ) != 0) {
+        DB(" -> Invalid ID!");
+        return false;
+    }
+    if ((tp->flags & TRANSPORT_F_AUTH) &&
+        !wdm_siphash::verify(g_key, buf, len - UDP_FCS_SZ, &buf[len - UDP_FCS_SZ])) {
+        DB(" -> Invalid FCS!");
+        return false;
+    }
+
+    // Process based on Opcode:
+    uint8_t rx_op = hdr.get<UDP_HDR_OPCODE>();
+    DB(" -> seq=%u, op=%02Xh", hdr.get<UDP_HDR_SEQ>(), rx_op);
+    if (rx_op == OPH_ACK) {
+        wdm_frame::View<UdpAck> ack(hdr.tail(), hdr.tail_len());
+        return ack.valid() && (ack.get<UDP_ACK_SEQ>() == seq) && (ack.get<UDP_ACK_OP>() == op);
+    } else if (rx_op == OPH_CMD) {
+        wdm_frame::View<UdpCommand> cmd(hdr.tail(), hdr.tail_len());
+        if (cmd.valid()) {
+            DB(" -> offset=%u, cmd=%u", cmd.get<UDP_CMD_OFFSET>(), cmd.get<UDP_CMD_CMD>());
+        }
+    }
+    return false;
+}
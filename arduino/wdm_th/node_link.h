@@ -0,0 +1,47 @@
+/** @brief define Constants, Prototypes for the Node link: the node protocol (UDP framing, see
+ *  wdm_proto.h) over any transport: packets, sequence, FCS & ACK.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _NODE_LINK_H_
+#define _NODE_LINK_H_
+
+#include "device.h"
+#include "transport.h"
+
+/* Sequence: kept in RTC memory; blocks of LINK_SEQ_BLOCK are reserved in flash, so it keeps
+increasing after a power loss (the receivers reject old sequences) */
+#define LINK_SEQ_FILE               "/wdm_seq.bin"
+#define LINK_SEQ_BLOCK              1024
+
+/* Link state: the "link" region of rtc_mem */
+#define RTC_LINK_VERSION            1
+
+struct LINK_RTC_t {
+    uint32_t seq;               // Last sequence sent
+    uint32_t seq_limit;         // End of the reserved block
+    uint8_t gw_mac[6];          // ESP-NOW gateway, from its last ACK (0: unknown)
+    uint8_t gw_fails;           // ESP-NOW packets without ACK in a row
+    uint8_t reserved;
+};
+
+class node_link
+{
+    public:
+        /* Load the link state */
+        static void init(const uint8_t id[], const char *security);
+
+        /* Send a STATUS packet over 'tp' & wait for its ACK: return true if ACKed */
+        static bool send_STATUS(const TRANSPORT_t *tp, int dev_cnt, const DEVICE_INFO_t dev_list[]);
+
+        /* Link state (gateway), stored with the RTC memory */
+        static LINK_RTC_t *state();
+
+    private:
+        static uint32_t next_seq();
+        static bool wait_ack(const TRANSPORT_t *tp, uint32_t seq, uint8_t op);
+        static bool rx_packet(const TRANSPORT_t *tp, const uint8_t *buf, size_t len, uint32_t seq, uint8_t op);
+};
+
+#endif
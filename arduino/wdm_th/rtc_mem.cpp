@@ -0,0 +1,126 @@
+/**	@brief implement the RTC memory registry.
+ *  The whole registry area is read once (on the first add()), each region is then validated
+ *  against its header: a region registered with another name, version or size, or with a bad
+ *  CRC, starts zeroed instead of using stale data. store() only writes the regions which
+ *  changed since they were loaded/stored.
+	  @date
+		- 2026_10_19: Create.
+*/
+#include "Arduino.h"
+#include "esp8266_mlib.h"
+#include "rtc_mem.h"
+
+//#define DB      Serial.printf
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL TYPES/////////////////////////////////////////////////
+struct RTC_REGION_t {
+    const char *name;
+    uint16_t tag;
+    uint8_t version;
+    uint8_t valid;
+    uint8_t block;      // First block (header) in the registry area
+    uint8_t blocks;     // Data blocks
+    uint16_t size;
+    void *data;
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static RTC_REGION_t g_regions[RTC_MEM_REGION_CNT];
+static uint8_t g_region_cnt;
+static uint8_t g_next_block;
+
+/* Copy of the registry area, as it is in RTC memory */
+static uint32_t g_image[RTC_MEM_BLOCKS];
+static uint8_t g_image_loaded;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+int8_t rtc_mem::add(const char *name, uint8_t version, void *data, uint16_t size)
+{
+    uint8_t blocks = (size + 3) / 4;
+
+    if (!g_image_loaded) {
+        load_image();
+    }
+    if ((g_region_cnt >= RTC_MEM_REGION_CNT) ||
+        (g_next_block + RTC_MEM_HDR_BLOCKS + blocks > RTC_MEM_BLOCKS)) {
+        DB("\r\n%s: %s -> no room!", __FUNCTION__, name);
+        return -1;
+    }
+
+    int8_t id = g_region_cnt++;
+    RTC_REGION_t *p = &g_regions[id];
+    p->name = name;
+    p->tag = esp8266_mlib::crc16((const uint8_t *)name, strlen(name));
+    p->version = version;
+    p->block = g_next_block;
+    p->blocks = blocks;
+    p->size = size;
+    p->data = data;
+    g_next_block += RTC_MEM_HDR_BLOCKS + blocks;
+
+    // Validate:
+    uint32_t hdr0 = p->tag | ((uint32_t)version << 16) | ((uint32_t)blocks << 24);
+    uint32_t hdr1 = g_image[p->block + 1];
+    uint8_t *img = (uint8_t *)&g_image[p->block + RTC_MEM_HDR_BLOCKS];
+    p->valid = (g_image[p->block] == hdr0) && ((hdr1 >> 16) == RTC_MEM_MARKER) &&
+               ((hdr1 & 0xFFFF) == esp8266_mlib::crc16(img, blocks * 4));
+    if (p->valid) {
+        memcpy(data, img, size);
+    } else {
+        memset(data, 0, size);
+        // Force a write on the next store():
+        g_image[p->block] = ~hdr0;
+    }
+    DB("\r\n%s: %s, v%u, block=%u+%u -> valid=%u", __FUNCTION__, name, version, p->block, blocks, p->valid);
+    return id;
+}
+
+bool rtc_mem::is_valid(int8_t id)
+{
+    return (id >= 0) && (id < g_region_cnt) && g_regions[id].valid;
+}
+
+/** @brief write back changed regions.
+    @return number of written regions.
+*/
+uint8_t rtc_mem::store()
+{
+    uint8_t cnt = 0;
+
+    for (uint8_t i = 0; i < g_region_cnt; i++) {
+        RTC_REGION_t *p = &g_regions[i];
+        uint32_t *hdr = &g_image[p->block];
+        uint8_t *img = (uint8_t *)&hdr[RTC_MEM_HDR_BLOCKS];
+        uint32_t hdr0 = p->tag | ((uint32_t)p->version << 16) | ((uint32_t)p->blocks << 24);
+
+        if ((hdr[0] == hdr0) && (memcmp(img, p->data, p->size) == 0)) {
+            continue;
+        }
+        memcpy(img, p->data, p->size);
+        memset(img + p->size, 0, p->blocks * 4 - p->size);
+        hdr[0] = hdr0;
+        hdr[1] = ((uint32_t)RTC_MEM_MARKER << 16) | esp8266_mlib::crc16(img, p->blocks * 4);
+        ESP.rtcUserMemoryWrite(RTC_MEM_BASE + p->block, hdr, (RTC_MEM_HDR_BLOCKS + p->blocks) * 4);
+        p->valid = 1;
+        cnt++;
+    }
+    DB("\r\n%s: %u regions written", __FUNCTION__, cnt);
+    return cnt;
+}
+
+void rtc_mem::reset()
+{
+    g_region_cnt = 0;
+    g_next_block = 0;
+    g_image_loaded = 0;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+void rtc_mem::load_image()
+{
+    ESP.rtcUserMemoryRead(RTC_MEM_BASE, g_image, sizeof(g_image));
+    g_image_loaded = 1;
+}
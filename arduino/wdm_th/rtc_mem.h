@@ -0,0 +1,58 @@
+/** @brief define Constants, Prototypes for the RTC memory registry: RTC user memory is shared by
+ *  all modules, each one owning a named, versioned & CRC-checked region.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _RTC_MEM_H_
+#define _RTC_MEM_H_
+
+#include "Arduino.h"
+
+/* RTC memory map (4-byte blocks): block 0 is the boot cause (see esp8266_mlib), the first 32
+blocks are used by OTA, the registry owns the rest. */
+#define RTC_MEM_BASE                32
+#define RTC_MEM_BLOCKS              96
+
+/* Maximum number of regions */
+#define RTC_MEM_REGION_CNT          8
+
+/* Region header (2 blocks): [tag(2)][version(1)][blocks(1)] [crc16(2)][marker(2)] */
+#define RTC_MEM_HDR_BLOCKS          2
+#define RTC_MEM_MARKER              0xA55A
+
+/* Blocks taken by a region of 'size' bytes, header included */
+#define RTC_MEM_REGION_BLOCKS(size) (RTC_MEM_HDR_BLOCKS + ((size) + 3) / 4)
+
+/* Budget of the regions (bytes): each owner checks its data fits its entry, the whole budget
+must fit the registry. A new region needs its entry here. */
+#define RTC_MEM_WIFI_SIZE           24      // wifi_inf: RTC_SETTINGS_t
+#define RTC_MEM_WIFI_AP_SIZE        64      // wifi_inf: AP_STATS_t x WIFI_AP_PROFILE_CNT
+#define RTC_MEM_LINK_SIZE           16      // node_link: LINK_RTC_t
+#define RTC_MEM_DLOG_SIZE           200     // dlog: DLOG_RING_t
+
+static_assert(RTC_MEM_REGION_BLOCKS(RTC_MEM_WIFI_SIZE) + RTC_MEM_REGION_BLOCKS(RTC_MEM_WIFI_AP_SIZE) +
+              RTC_MEM_REGION_BLOCKS(RTC_MEM_LINK_SIZE) + RTC_MEM_REGION_BLOCKS(RTC_MEM_DLOG_SIZE) <=
+              RTC_MEM_BLOCKS, "RTC memory regions don't fit RTC_MEM_BLOCKS");
+
+class rtc_mem
+{
+    public:
+        /* Register a region & load its content. Regions must be registered in the same order
+        on every boot. Return the region id (>= 0), or -1 if there's no room left. */
+        static int8_t add(const char *name, uint8_t version, void *data, uint16_t size);
+
+        /* true if the region content was restored from RTC memory */
+        static bool is_valid(int8_t id);
+
+        /* Write back the regions whose content changed: call it before sleeping/rebooting */
+        static uint8_t store();
+
+        /* Forget all regions (the RTC memory content is kept) */
+        static void reset();
+
+    private:
+        static void load_image();
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <espnow.h>
+extern "C" {
+#include <user_interface.h>
+}
+#include "transport_espnow.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+struct ESPNOW_FRAME_t {
+    uint8_t mac[6];
+    uint8_t len;
+    uint8_t data[ESPNOW_FRAME_MAX];
+};
+
+static const uint8_t BROADCAST_MAC[6] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+/* Settings */
+static bool g_gateway;
+static uint8_t g_peer[6];
+static uint8_t g_channel;
+
+/* RX queue: written by the receive callback (system context), read by recv() */
+static ESPNOW_FRAME_t g_rx[ESPNOW_RX_CNT];
+static volatile uint8_t g_rx_head;
+static volatile uint8_t g_rx_tail;
+static uint8_t g_rx_peer[6];
+
+/* MAC-level delivery of the last 8 packets sent (bit set: acknowledged) */
+static volatile uint8_t g_tx_hist;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+const TRANSPORT_t transport_espnow::ops = {
+    "espnow", TRANSPORT_F_AUTH, ESPNOW_ACK_MS,
+    transport_espnow::open, transport_espnow::send, transport_espnow::recv, transport_espnow::quality
+};
+
+void transport_espnow::setup(bool gateway, const uint8_t *peer, uint8_t channel)
+{
+    g_gateway = gateway;
+    g_channel = channel;
+    memcpy(g_peer, (peer != NULL) ? peer : BROADCAST_MAC, 6);
+}
+
+void transport_espnow::set_peer(const uint8_t mac[])
+{
+    memcpy(g_peer, mac, 6);
+}
+
+const uint8_t *transport_espnow::rx_peer()
+{
+    return g_rx_peer;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool transport_espnow::open()
+{
+    DB("\r\n%s: gateway=%u, ch=%u", __FUNCTION__, g_gateway, g_channel);
+    if (g_channel != 0) {
+        wifi_set_channel(g_channel);
+    }
+    if (esp_now_init() != 0) {
+        DB(" -> init failed!");
+        return false;
+    }
+    esp_now_set_self_role(g_gateway ? ESP_NOW_ROLE_COMBO : ESP_NOW_ROLE_CONTROLLER);
+    esp_now_register_recv_cb(rx_cb);
+    esp_now_register_send_cb(tx_cb);
+    g_rx_head = g_rx_tail = 0;
+    g_tx_hist = 0xFF;
+    return true;
+}
+
+/** @brief send one packet to the peer: the peer is registered for the time of the send only,
+ *  so a gateway answers any number of nodes.
+*/
+bool transport_espnow::send(const uint8_t *frame, size_t len)
+{
+    if (len > ESPNOW_FRAME_MAX) {
+        return false;
+    }
+    bool added = (esp_now_is_peer_exist(g_peer) <= 0);
+    if (added) {
+        esp_now_add_peer(g_peer, g_gateway ? ESP_NOW_ROLE_CONTROLLER : ESP_NOW_ROLE_SLAVE,
+                         g_channel, NULL, 0);
+    }
+    int ret = esp_now_send(g_peer, (uint8_t *)frame, len);
+    if (added && g_gateway) {
+        esp_now_del_peer(g_peer);
+    }
+    return ret == 0;
+}
+
+int transport_espnow::recv(uint8_t *buf, size_t size, uint32_t timeout_ms)
+{
+    uint32_t t0 = millis();
+
+    while (g_rx_head == g_rx_tail) {
+        if (millis() - t0 >= timeout_ms) {
+            return 0;
+        }
+        delay(TRANSPORT_POLL_MS);
+    }
+
+    ESPNOW_FRAME_t *p = &g_rx[g_rx_tail];
+    int len = p->len;
+    memcpy(g_rx_peer, p->mac, 6);
+    if ((size_t)len > size) {
+        len = -1;
+    } else {
+        memcpy(buf, p->data, len);
+    }
+    g_rx_tail = (g_rx_tail + 1) % ESPNOW_RX_CNT;
+    return len;
+}
+
+uint8_t transport_espnow::quality()
+{
+    uint8_t cnt = 0;
+    for (uint8_t h = g_tx_hist; h != 0; h &= h - 1) {
+        cnt++;
+    }
+    return (cnt * 100) / 8;
+}
+
+/** @brief receive callback: queue the packet, drop it when the queue is full.
+*/
+void transport_espnow::rx_cb(uint8_t *mac, uint8_t *data, uint8_t len)
+{
+    uint8_t next = (g_rx_head + 1) % ESPNOW_RX_CNT;
+    if ((next == g_rx_tail) || (len > ESPNOW_FRAME_MAX)) {
+        return;
+    }
+    ESPNOW_FRAME_t *p = &g_rx[g_rx_head];
+    memcpy(p->mac, mac, 6);
+    memcpy(p->data, data, len);
+    p->len = len;
+    g_rx_head = next;
+}
+
+void transport_espnow::tx_cb(uint8_t *mac, uint8_t status)
+{
+    (void)mac;
+    g_tx_hist = (g_tx_hist << 1) | (status == 0);
+}
@@ -0,0 +1,46 @@
+/** @brief define Constants, Prototypes for the ESP-NOW transport: connectionless frames between
+ *  nodes, without WiFi association. A battery node sends its packets to a mains powered
+ *  wdm_onoff (the gateway) in a few ms instead of joining the AP.
+ *  The medium is open: the packets are signed (FCS, see TRANSPORT_F_AUTH).
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _TRANSPORT_ESPNOW_H_
+#define _TRANSPORT_ESPNOW_H_
+
+#include "transport.h"
+
+/* Largest packet (same as UDP) & RX queue depth */
+#define ESPNOW_FRAME_MAX            128
+#define ESPNOW_RX_CNT               4
+
+/* Round trip to the gateway (ms) */
+#define ESPNOW_ACK_MS               30
+
+class transport_espnow
+{
+    public:
+        /* Settings: 'gateway' receives from any node; 'peer' is where send() goes (NULL:
+        broadcast, any gateway in range answers); 'channel' is the radio channel of a node
+        which is not associated (0: keep the current one). */
+        static void setup(bool gateway, const uint8_t *peer, uint8_t channel);
+
+        /* Send the next packets to 'mac' (e.g. the sender of the last packet received) */
+        static void set_peer(const uint8_t mac[]);
+
+        /* MAC address of the sender of the last packet received */
+        static const uint8_t *rx_peer();
+
+        static const TRANSPORT_t ops;
+
+    private:
+        static bool open();
+        static bool send(const uint8_t *frame, size_t len);
+        static int recv(uint8_t *buf, size_t size, uint32_t timeout_ms);
+        static uint8_t quality();
+        static void rx_cb(uint8_t *mac, uint8_t *data, uint8_t len);
+        static void tx_cb(uint8_t *mac, uint8_t status);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "Arduino.h"
+#include "transport_loop.h"
+
+///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
+struct LOOP_FRAME_t {
+    uint8_t len;
+    uint8_t data[LOOP_FRAME_MAX];
+};
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+static void (*g_peer)(const uint8_t *frame, size_t len);
+static uint32_t g_drop_every;
+static uint32_t g_sent;
+static uint32_t g_dropped;
+
+static LOOP_FRAME_t g_rx[LOOP_RX_CNT];
+static uint8_t g_rx_head;
+static uint8_t g_rx_tail;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+const TRANSPORT_t transport_loop::ops = {
+    "loop", TRANSPORT_F_AUTH, 0,
+    transport_loop::open, transport_loop::send, transport_loop::recv, transport_loop::quality
+};
+
+void transport_loop::setup(void (*peer)(const uint8_t *frame, size_t len), uint32_t drop_every)
+{
+    g_peer = peer;
+    g_drop_every = drop_every;
+    g_sent = 0;
+    g_dropped = 0;
+    g_rx_head = g_rx_tail = 0;
+}
+
+bool transport_loop::inject(const uint8_t *frame, size_t len)
+{
+    uint8_t next = (g_rx_head + 1) % LOOP_RX_CNT;
+    if ((next == g_rx_tail) || (len > LOOP_FRAME_MAX)) {
+        return false;
+    }
+    memcpy(g_rx[g_rx_head].data, frame, len);
+    g_rx[g_rx_head].len = len;
+    g_rx_head = next;
+    return true;
+}
+
+uint32_t transport_loop::sent()
+{
+    return g_sent;
+}
+
+uint32_t transport_loop::dropped()
+{
+    return g_dropped;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool transport_loop::open()
+{
+    return true;
+}
+
+bool transport_loop::send(const uint8_t *frame, size_t len)
+{
+    g_sent++;
+    if ((g_drop_every != 0) && (g_sent % g_drop_every == 0)) {
+        g_dropped++;
+    } else if (g_peer != NULL) {
+        g_peer(frame, len);
+    }
+    return true;
+}
+
+/** @brief nothing can arrive while waiting in a single process: the timeout is not used.
+*/
+int transport_loop::recv(uint8_t *buf, size_t size, uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    if (g_rx_head == g_rx_tail) {
+        return 0;
+    }
+    LOOP_FRAME_t *p = &g_rx[g_rx_tail];
+    int len = p->len;
+    if ((size_t)len > size) {
+        len = -1;
+    } else {
+        memcpy(buf, p->data, len);
+    }
+    g_rx_tail = (g_rx_tail + 1) % LOOP_RX_CNT;
+    return len;
+}
+
+uint8_t transport_loop::quality()
+{
+    return (g_sent == 0) ? 100 : (uint8_t)(100 - (100 * g_dropped) / g_sent);
+}
@@ -0,0 +1,39 @@
+/** @brief define Constants, Prototypes for the loopback transport: both ends in one process, so
+ *  the protocol code runs on the host (tests & benchmarks). The other end is a callback which
+ *  gets every packet sent and answers with inject().
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _TRANSPORT_LOOP_H_
+#define _TRANSPORT_LOOP_H_
+
+#include "transport.h"
+
+/* Largest packet & RX queue depth */
+#define LOOP_FRAME_MAX              128
+#define LOOP_RX_CNT                 4
+
+class transport_loop
+{
+    public:
+        /* Settings: the other end, & every 'drop_every'-th packet sent is lost (0: none) */
+        static void setup(void (*peer)(const uint8_t *frame, size_t len), uint32_t drop_every = 0);
+
+        /* Queue a packet for recv(): return false if the queue is full */
+        static bool inject(const uint8_t *frame, size_t len);
+
+        /* Counters since setup() */
+        static uint32_t sent();
+        static uint32_t dropped();
+
+        static const TRANSPORT_t ops;
+
+    private:
+        static bool open();
+        static bool send(const uint8_t *frame, size_t len);
+        static int recv(uint8_t *buf, size_t size, uint32_t timeout_ms);
+        static uint8_t quality();
+};
+
+#endif
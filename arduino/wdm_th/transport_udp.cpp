@@ -0,0 +1,78 @@
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include "transport_udp.h"
+#include "dlog.h"
+
+#define DB      DLOG
+#ifndef DB
+  #define DB
+#endif
+
+///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
+/* Server */
+static IPAddress g_server_ip;
+static uint16_t g_server_port;
+
+/* UDP socket */
+static WiFiUDP udp;
+
+///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
+const TRANSPORT_t transport_udp::ops = {
+    "udp", 0, UDP_ACK_MS,
+    transport_udp::open, transport_udp::send, transport_udp::recv, transport_udp::quality
+};
+
+void transport_udp::setup(uint32_t server_ip, uint16_t server_port)
+{
+    g_server_ip = IPAddress(server_ip);
+    g_server_port = server_port;
+}
+
+///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+bool transport_udp::open()
+{
+    return udp.begin(0) != 0;
+}
+
+bool transport_udp::send(const uint8_t *frame, size_t len)
+{
+    if (!udp.beginPacket(g_server_ip, g_server_port)) {
+        DB(" -> begin failed!");
+        return false;
+    }
+    if (udp.write(frame, len) != len) {
+        DB(" -> write fail: not enough memory??");
+    }
+    if (!udp.endPacket()) {
+        DB(" -> sending failed");
+        return false;
+    }
+
+    // Without the following command, the UDP packet will not be sent when enter DeepSleep right after calling this function.
+    yield();
+    return true;
+}
+
+int transport_udp::recv(uint8_t *buf, size_t size, uint32_t timeout_ms)
+{
+    uint32_t t0 = millis();
+    int rx_sz;
+
+    while ((rx_sz = udp.parsePacket()) <= 0) {
+        if (millis() - t0 >= timeout_ms) {
+            return 0;
+        }
+        delay(TRANSPORT_POLL_MS);
+    }
+    DB("\r\n -> Received %d bytes from %s, port %d", rx_sz, udp.remoteIP().toString().c_str(), udp.remotePort());
+    if ((size_t)rx_sz > size) {
+        return -1;
+    }
+    return udp.read(buf, size);
+}
+
+uint8_t transport_udp::quality()
+{
+    return (WiFi.status() == WL_CONNECTED) ? transport_rssi_quality(WiFi.RSSI()) : 0;
+}
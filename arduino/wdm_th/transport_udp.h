@@ -0,0 +1,30 @@
+/** @brief define Constants, Prototypes for the UDP transport: packets to the server, over the
+ *  WiFi association.
+ *  @date
+ *      - 2026_10_19: Create.
+ *
+*/
+#ifndef _TRANSPORT_UDP_H_
+#define _TRANSPORT_UDP_H_
+
+#include "transport.h"
+
+/* Round trip to the server (ms) */
+#define UDP_ACK_MS                  1000
+
+class transport_udp
+{
+    public:
+        /* Settings: the server */
+        static void setup(uint32_t server_ip, uint16_t server_port);
+
+        static const TRANSPORT_t ops;
+
+    private:
+        static bool open();
+        static bool send(const uint8_t *frame, size_t len);
+        static int recv(uint8_t *buf, size_t size, uint32_t timeout_ms);
+        static uint8_t quality();
+};
+
+#endif
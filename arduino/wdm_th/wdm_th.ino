@@ -5,12 +5,15 @@
 #include "esp8266_mlib.h"
 #include "wifi_inf.h"
 
-#include "udp_inf.h"
+#include "node_link.h"
+#include "transport_espnow.h"
+#include "transport_udp.h"
+#include "dlog.h"
 
 #include <Wire.h>
 #include "DFRobot_SHT20.h"
 
-#define DB      	Serial.printf
+#define DB      	DLOG
 #define DB_print 	Serial.print
 
 const int PIN_SCL = 5;
@@ -18,6 +21,14 @@ const int PIN_SDA = 4;
 const int PIN_BT_RESET = 13;
 const int PIN_LED = 14;
 
+/* Server port (UDP) */
+#define SERVER_UDP_PORT   7523
+
+/* ESP-NOW gateway: without one, a broadcast is tried every LINK_GW_PROBE_BOOTS boots; a known one
+is forgotten after LINK_GW_FAIL_MAX packets without ACK in a row */
+#define LINK_GW_PROBE_BOOTS   8
+#define LINK_GW_FAIL_MAX      3
+
 DFRobot_SHT20    sht20;
 
 void setup() {
@@ -28,6 +39,9 @@ void setup() {
 
   esp8266_mlib::init();
 
+  // Deferred log: kept in RTC memory, sent to Serial only in SETUP (AP) mode:
+  dlog::init();
+
   // Signal LED:
   led_write(HIGH);
 
@@ -39,8 +53,8 @@ void setup() {
     DB(" -> enter SETUP (AP) mode now!");
     wifi_inf::start(1);
   } else {
-    // Start WIFI connection:
-    wifi_inf::start(0);
+    // Load WIFI settings: the AP is joined only if there's no ESP-NOW gateway
+    wifi_inf::start(0, false);
   }
 
   // Read Temperature & Humidity:
@@ -50,19 +64,19 @@ void setup() {
   // Wait for new settings when in AP mode:
   wifi_inf::manager();
 
-  // Init UDP:
+  // Init Node link:
   const ROM_SETTINGS_t *p_cfg = wifi_inf::get_settings();
   const WIFI_STATUS_t *p_wf = wifi_inf::get_status();
-  udp_inf::init(p_wf->node_id, p_cfg->security, p_wf->server_ip, 7523);
+  node_link::init(p_wf->node_id, p_cfg->security);
 
   // Send status to server:
   DEVICE_INFO_t dev;
   dev.v = t;
   dev.offset = 1;
   dev.p = 100;
-  dev.r = WiFi.RSSI();
+  dev.r = 0;
   dev.type = DEV_TYPE_TEMPERATURE;
-  udp_inf::send_STATUS(1, &dev);
+  report_status(1, &dev);
 
   // Sleep:
   esp8266_mlib::enter_sleep(30 * 1000 * 1000);
@@ -84,6 +98,45 @@ void loop() {
 #endif
 }
 
+/*  Send the status through the ESP-NOW gateway if there's one (no WIFI association: a few ms
+    on air), else or if it doesn't answer, to the server over WIFI & UDP.
+    Return true if ACKed.
+*/
+bool report_status(int dev_cnt, DEVICE_INFO_t dev_list[]) {
+  static const uint8_t no_gw[6] = { 0 };
+  LINK_RTC_t *p_link = node_link::state();
+  const WIFI_STATUS_t *p_wf = wifi_inf::get_status();
+  uint8_t channel = wifi_inf::get_channel();
+  bool known = (memcmp(p_link->gw_mac, no_gw, 6) != 0);
+
+  if ((channel != 0) && (known || (p_wf->boot_cnt % LINK_GW_PROBE_BOOTS == 0))) {
+    // Not associated: the RSSI of the AP from the last connect
+    for (int k = 0; k < dev_cnt; k++) {
+      dev_list[k].r = wifi_inf::get_rssi();
+    }
+    transport_espnow::setup(false, known ? p_link->gw_mac : NULL, channel);
+    if (transport_espnow::ops.open() && node_link::send_STATUS(&transport_espnow::ops, dev_cnt, dev_list)) {
+      memcpy(p_link->gw_mac, transport_espnow::rx_peer(), 6);
+      p_link->gw_fails = 0;
+      return true;
+    }
+    if (known && (++p_link->gw_fails >= LINK_GW_FAIL_MAX)) {
+      DB("\r\n -> gateway lost");
+      memset(p_link->gw_mac, 0, 6);
+      p_link->gw_fails = 0;
+    }
+  }
+
+  if (!wifi_inf::associate()) {
+    return false;
+  }
+  for (int k = 0; k < dev_cnt; k++) {
+    dev_list[k].r = WiFi.RSSI();
+  }
+  transport_udp::setup(p_wf->server_ip, SERVER_UDP_PORT);
+  return transport_udp::ops.open() && node_link::send_STATUS(&transport_udp::ops, dev_cnt, dev_list);
+}
+
 /*  Capture RESET button: if the button is hold for 3-6 seconds then release -> do factory reset.
 */
 int capture_reset() {
@@ -3,20 +3,28 @@
 #include <ESP8266WiFi.h>
 #include "esp8266_mlib.h"
 #include "httpd.h"
+#include "rtc_mem.h"
 #include "wifi_inf.h"
+#include "dlog.h"
 
 
-#define DB      Serial.printf
+#define DB      DLOG
 #ifndef DB
   #define DB
 #endif
 
 ///////////////////////////////////////LOCAL CONSTANTS/////////////////////////////////////////////
 /* WIFI ROM settings file name */
-const char *ROM_SETTINGS_FILE_NAME = "/wdm_cfg.txt";
+const char *ROM_SETTINGS_FILE_NAME = "/wdm_cfg.bin";
 
-/* ROM setting size */
-#define ROM_SETTINGS_SIZE				200
+/* Settings file of old firmwares (text), converted on first boot */
+const char *ROM_SETTINGS_TXT_FILE_NAME = "/wdm_cfg.txt";
+
+/* Text settings size */
+#define ROM_SETTINGS_TXT_SIZE			256
+
+/* Binary settings file marker: 'WDMS' */
+#define ROM_SETTINGS_MAGIC				0x534D4457
 
 /* Default Password in AP mode */
 const char *WIFI_PASSWORD_DEFAULT = "wdm-open";
@@ -24,9 +32,26 @@ const char *WIFI_PASSWORD_DEFAULT = "wdm-open";
 /* NVM magic number */
 #define NVM_MAGIC_NUMBER		0x41424344
 
-/* RTC memory map: first 32 blocks are used by OTA */
-#define RTC_SETTINGS_ADDR       64 // 4-byte block offset.
-#define RTC_SETTINGS_CNT        6
+/* AP mode: sleep between two polls of the provisioning server, when idle (ms) */
+#define WIFI_AP_IDLE_MS         20
+
+/* AP mode: delay of the reboot after new settings, to finish the response to the client (ms) */
+#define WIFI_AP_REBOOT_MS       1000
+
+/* AP mode: without any station & request for this time (ms), deep sleep for WIFI_AP_SLEEP_US */
+#define WIFI_AP_TIMEOUT_MS      (5 * 60 * 1000UL)
+#define WIFI_AP_SLEEP_US        (60 * 60 * 1000000UL)
+
+
+/* Binary settings file: header + settings */
+struct ROM_SETTINGS_FILE_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;      // Size of the settings which follow
+    uint16_t crc;       // CRC-16 of the settings
+    uint16_t reserved;
+    ROM_SETTINGS_t settings;
+};
 
 ///////////////////////////////////////LOCAL VARIABLES/////////////////////////////////////////////
 /* Default DNS servers */
@@ -39,12 +64,25 @@ static struct ROM_SETTINGS_t g_rom_settings;
 /* WIFI status */
 static struct WIFI_STATUS_t g_wifi_status;
 
+/* RTC settings region */
+static struct RTC_SETTINGS_t g_rtc_settings;
+static_assert(sizeof(g_rtc_settings) <= RTC_MEM_WIFI_SIZE, "wifi: RTC memory region over its budget");
+
+/* RTC AP profile statistics region */
+static AP_STATS_t g_rtc_ap_stats[WIFI_AP_PROFILE_CNT];
+static_assert(sizeof(g_rtc_ap_stats) <= RTC_MEM_WIFI_AP_SIZE, "wifi_ap: RTC memory region over its budget");
+
 ///////////////////////////////////////PUBLIC FUNCTIONS////////////////////////////////////////////
-void wifi_inf::start(uint8_t force_ap)
+void wifi_inf::start(uint8_t force_ap, bool join)
 {
     uint8_t mac_addr[8];
     char ssid[32];
 
+    // The SDK doesn't store the station config in flash: each profile tried (WiFi.begin()) &
+    // each disconnect would rewrite it. The profiles are in the settings file, the AP stats in
+    // RTC memory.
+    WiFi.persistent(false);
+
 	// Load settings:
     WiFi.macAddress(mac_addr);
     memcpy(g_wifi_status.node_id, mac_addr, 6);
@@ -78,52 +116,66 @@ void wifi_inf::start(uint8_t force_ap)
 		
 		g_wifi_status.mode = WIFI_STA;
 
-		DB("\r\n -> start wifi in STA mode: last_ip=%08Xh/%08Xh/%08Xh",
-            g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet);
+		DB("\r\n -> start wifi in STA mode: last_ip=%08Xh/%08Xh/%08Xh, profile=%u",
+            g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, g_wifi_status.profile);
 
 		WiFi.mode(WIFI_STA);
-        WiFi.begin(g_rom_settings.ssid, g_rom_settings.password);
-        if (g_wifi_status.local_ip == 0) {
-            WiFi.setAutoConnect(true);
+        if (join) {
+            associate();
         } else {
-            WiFi.config(g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, g_dns1, g_dns2);
-        }
-		
-		// Wait up to 5s for connecting:
-		int stat = 0;
-		int i = 0;
-		for (i = 0; i < 50; i++) {
-			stat = WiFi.status();
-			if (stat == WL_CONNECTED) {
-				g_wifi_status.local_ip = WiFi.localIP();
-				g_wifi_status.gateway = WiFi.gatewayIP();
-				g_wifi_status.subnet = WiFi.subnetMask();
-				g_wifi_status.is_connected = 1;
-				DB(" -> connected: Ip=%08lXh, GW=%08lXh, Sub=%08lXh", 
-					g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet);
-
-                // Resolve server IP: every 8 boots
-                if (((g_wifi_status.boot_cnt & 0x07) == 0) || (g_wifi_status.server_ip == 0)) {
-                    resolve_server();
-                }
-
-                // Store RTC:
-                store_rtc_settings();
-				break;
-			}
-			DB(" %d", stat);
-			delay(100);    
-		}
-        if (i >= 50) {
-            DB(" -> connect WIFI failed -> reset local IP!");
-            g_wifi_status.local_ip = 0;
-            g_wifi_status.subnet = 0;
-            g_wifi_status.gateway = 0;
             store_rtc_settings();
         }
 	}
 }
 
+/**
+ * STA mode: join one of the APs & resolve the server.
+ * Return true if connected.
+*/
+bool wifi_inf::associate()
+{
+    if (connect()) {
+        g_wifi_status.is_connected = 1;
+
+        // Resolve server IP: every 8 boots
+        if (((g_wifi_status.boot_cnt & 0x07) == 0) || (g_wifi_status.server_ip == 0)) {
+            resolve_server();
+        }
+    } else {
+        DB(" -> connect WIFI failed -> reset local IP!");
+        g_wifi_status.local_ip = 0;
+        g_wifi_status.subnet = 0;
+        g_wifi_status.gateway = 0;
+    }
+
+    // Store RTC:
+    store_rtc_settings();
+    return g_wifi_status.is_connected != 0;
+}
+
+/**
+ * Channel of the last connected AP (0 if unknown): the nodes sharing that AP (e.g. an ESP-NOW
+ * gateway) are on the same channel.
+*/
+uint8_t wifi_inf::get_channel()
+{
+    if (g_wifi_status.profile >= WIFI_AP_PROFILE_CNT) {
+        return 0;
+    }
+    return g_rtc_ap_stats[g_wifi_status.profile].channel;
+}
+
+/**
+ * RSSI of the last connected AP (0 if unknown): the signal of a node that doesn't join it.
+*/
+int8_t wifi_inf::get_rssi()
+{
+    if (g_wifi_status.profile >= WIFI_AP_PROFILE_CNT) {
+        return 0;
+    }
+    return g_rtc_ap_stats[g_wifi_status.profile].rssi;
+}
+
 const ROM_SETTINGS_t * wifi_inf::get_settings()
 {
     return &g_rom_settings;    
@@ -134,21 +186,47 @@ const WIFI_STATUS_t * wifi_inf::get_status()
     return &g_wifi_status;    
 }
 
+/**
+ * AP mode: run the provisioning server (HTTP & DNS captive portal) until new settings are received,
+ * then store them & reboot WIFI_AP_REBOOT_MS later, so the response still reaches the client.
+ * The CPU sleeps between the events (delay() yields to the system).
+ * Without any station & request for WIFI_AP_TIMEOUT_MS, go back to deep sleep: a node left in
+ * setup mode doesn't drain its batteries.
+*/
 void wifi_inf::manager()
 {
 	ROM_SETTINGS_t settings;
+	uint32_t reboot_ms = 0;
 	
 	if (g_wifi_status.mode == WIFI_AP) {
+        uint32_t last_ms = millis();
+
 		while (true) {
-			if (httpd::get_config(&settings)) {
+            uint8_t ev = httpd::poll(&settings);
+			if ((ev == HTTPD_EV_CONFIG) && (reboot_ms == 0)) {
 				DB("\r\n -> having new settings -> store...");
                 memcpy(&g_rom_settings, &settings, sizeof(ROM_SETTINGS_t));
                 g_rom_settings.magic_number = NVM_MAGIC_NUMBER;
                 store_rom_settings();
-				
+                reboot_ms = millis() | 1;
+            }
+            if ((reboot_ms != 0) && (millis() - reboot_ms >= WIFI_AP_REBOOT_MS)) {
 				DB("\r\n -> reboot now!");
+                dlog::flush();
                 ESP.restart();
-            }			
+            }
+
+            if ((ev != HTTPD_EV_NONE) || (WiFi.softAPgetStationNum() > 0)) {
+                last_ms = millis();
+            } else if (millis() - last_ms >= WIFI_AP_TIMEOUT_MS) {
+                DB("\r\n -> AP timeout -> sleep");
+                esp8266_mlib::enter_sleep(WIFI_AP_SLEEP_US);
+            }
+
+            dlog::idle();
+            if (ev == HTTPD_EV_NONE) {
+                delay(WIFI_AP_IDLE_MS);
+            }
 		}		
 	}	
 }
@@ -156,17 +234,167 @@ void wifi_inf::manager()
 void wifi_inf::factory_reset()
 {
     DB("\r\n -> factory_reset!");
-	g_rom_settings.magic_number = 0;
-	sprintf(g_rom_settings.ssid, "");
-	sprintf(g_rom_settings.password, "");
-	sprintf(g_rom_settings.server_addr, "");
-	g_rom_settings.server_port = 0;
-	sprintf(g_rom_settings.security, "");
+	// Clear the whole record, the extra AP profiles included:
+	memset(&g_rom_settings, 0, sizeof(ROM_SETTINGS_t));
 	g_rom_settings.timezone = 7 * 60;
 	store_rom_settings();
 }
 
 ///////////////////////////////////////PRIVATE FUNCTIONS///////////////////////////////////////////
+/**
+ * Connect to one of the AP profiles: they are tried in order of expected connect time (see ap_stats),
+ * each one for its own timeout, so a dead AP only costs a few times the usual connect time of a
+ * good one. If all fail, scan once & retry the profiles in range, strongest first.
+ * Return true if connected.
+*/
+bool wifi_inf::connect()
+{
+    uint8_t order[WIFI_AP_PROFILE_CNT];
+    uint8_t mask = 0;
+
+    for (uint8_t i = 0; i < WIFI_AP_PROFILE_CNT; i++) {
+        const char *pwd;
+        const char *ssid = get_profile(i, &pwd);
+        if (ssid != NULL) {
+            ap_stats::check(&g_rtc_ap_stats[i], ssid);
+            mask |= (1 << i);
+        }
+    }
+
+    uint8_t cnt = ap_stats::sort(g_rtc_ap_stats, WIFI_AP_PROFILE_CNT, mask, order);
+    for (uint8_t k = 0; k < cnt; k++) {
+        if (connect_profile(order[k], ap_stats::timeout_ms(&g_rtc_ap_stats[order[k]]))) {
+            return true;
+        }
+    }
+
+    // Scan: the profiles in range get their channel & BSSID, by RSSI
+    cnt = scan_profiles();
+    for (uint8_t k = 0; k < cnt; k++) {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < WIFI_AP_PROFILE_CNT; i++) {
+            if ((mask & (1 << i)) && (g_rtc_ap_stats[i].channel != 0) &&
+                ((best < 0) || (g_rtc_ap_stats[i].rssi > g_rtc_ap_stats[best].rssi))) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        mask &= ~(1 << best);
+        if (connect_profile(best, AP_STATS_TIMEOUT_MS)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Connect to the AP profile 'idx' within 'timeout_ms'. A known AP is joined directly on its channel
+ * & BSSID (no scan), the cached IP is used only on the network it was got on. The result goes to
+ * the profile statistics.
+ * Return true if connected.
+*/
+bool wifi_inf::connect_profile(uint8_t idx, uint32_t timeout_ms)
+{
+    AP_STATS_t *p_st = &g_rtc_ap_stats[idx];
+    const char *pwd;
+    const char *ssid = get_profile(idx, &pwd);
+    uint32_t t0 = millis();
+    int stat = 0;
+
+    DB("\r\n%s: idx=%u, ssid=%s, ch=%u, timeout=%u", __FUNCTION__, idx, ssid, p_st->channel, timeout_ms);
+    if ((g_wifi_status.local_ip != 0) && (g_wifi_status.profile == idx)) {
+        WiFi.config(g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, g_dns1, g_dns2);
+    } else {
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());
+    }
+    if (p_st->channel != 0) {
+        WiFi.begin(ssid, pwd, p_st->channel, p_st->bssid);
+    } else {
+        WiFi.begin(ssid, pwd);
+    }
+
+    while (millis() - t0 < timeout_ms) {
+        stat = WiFi.status();
+        if (stat == WL_CONNECTED) {
+            uint32_t ms = millis() - t0;
+            g_wifi_status.local_ip = WiFi.localIP();
+            g_wifi_status.gateway = WiFi.gatewayIP();
+            g_wifi_status.subnet = WiFi.subnetMask();
+            g_wifi_status.profile = idx;
+            memcpy(p_st->bssid, WiFi.BSSID(), 6);
+            p_st->channel = WiFi.channel();
+            p_st->rssi = WiFi.RSSI();
+            ap_stats::update(p_st, true, ms);
+            DB(" -> connected: ms=%u, Ip=%08lXh, GW=%08lXh, Sub=%08lXh, rssi=%d", ms,
+                g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, p_st->rssi);
+            return true;
+        }
+        // Not in range or wrong password: don't wait for the timeout
+        if ((stat == WL_NO_SSID_AVAIL) || (stat == WL_CONNECT_FAILED)) {
+            break;
+        }
+        delay(50);
+    }
+
+    DB(" -> failed: stat=%d", stat);
+    WiFi.disconnect();
+    ap_stats::update(p_st, false, 0);
+    return false;
+}
+
+/**
+ * Scan the channels: the profiles in range get the channel, BSSID & RSSI of their strongest AP, the
+ * other ones lose their channel.
+ * Return the number of profiles in range.
+*/
+uint8_t wifi_inf::scan_profiles()
+{
+    uint8_t cnt = 0;
+    int n = WiFi.scanNetworks();
+
+    DB("\r\n%s: n=%d", __FUNCTION__, n);
+    for (uint8_t i = 0; i < WIFI_AP_PROFILE_CNT; i++) {
+        AP_STATS_t *p_st = &g_rtc_ap_stats[i];
+        const char *pwd;
+        const char *ssid = get_profile(i, &pwd);
+
+        p_st->channel = 0;
+        for (int k = 0; (ssid != NULL) && (k < n); k++) {
+            if ((strcmp(WiFi.SSID(k).c_str(), ssid) == 0) && ((p_st->channel == 0) || (WiFi.RSSI(k) > p_st->rssi))) {
+                memcpy(p_st->bssid, WiFi.BSSID(k), 6);
+                p_st->channel = WiFi.channel(k);
+                p_st->rssi = WiFi.RSSI(k);
+            }
+        }
+        if (p_st->channel != 0) {
+            DB(" -> %s: ch=%u, rssi=%d", ssid, p_st->channel, p_st->rssi);
+            cnt++;
+        }
+    }
+    WiFi.scanDelete();
+    return cnt;
+}
+
+/**
+ * Return the SSID of the AP profile 'idx' & its password, NULL if the profile is not used.
+ * Profile 0 is the one of the settings.
+*/
+const char *wifi_inf::get_profile(uint8_t idx, const char **password)
+{
+    const char *ssid;
+
+    if (idx == 0) {
+        ssid = g_rom_settings.ssid;
+        *password = g_rom_settings.password;
+    } else {
+        ssid = g_rom_settings.ap_extra[idx - 1].ssid;
+        *password = g_rom_settings.ap_extra[idx - 1].password;
+    }
+    return (ssid[0] != '\0') ? ssid : NULL;
+}
+
 /**
  * Send DNS request to get the server's IP address.
 */
@@ -185,6 +413,60 @@ void wifi_inf::resolve_server()
 
 /**
  * Load settings from ROM memory (Non-volatile).
+ * File format (binary): [magic(4)][version(2)][size(2)][crc16(2)][reserved(2)][settings(size)]
+ *  - settings: ROM_SETTINGS_t, as written by the firmware which stored the file.
+ *  - fields are only appended to ROM_SETTINGS_t: a shorter record (older firmware) leaves the
+ *    new fields at 0, a longer record (newer firmware) is truncated.
+ * If there's no binary file, the text file of old firmwares is converted.
+*/
+void wifi_inf::load_rom_settings()
+{
+    ROM_SETTINGS_FILE_t rec;
+    bool valid = false;
+
+    memset(&g_rom_settings, 0, sizeof(ROM_SETTINGS_t));
+    memset(&rec, 0, sizeof(rec));
+
+    esp8266_mlib::recover_data(ROM_SETTINGS_FILE_NAME);
+    File f = SPIFFS.open(ROM_SETTINGS_FILE_NAME, "r");
+    if (f) {
+        uint32_t sz = f.read((uint8_t *)&rec, sizeof(rec));
+        uint32_t hdr_sz = sizeof(rec) - sizeof(ROM_SETTINGS_t);
+        uint32_t known = (rec.size < sizeof(ROM_SETTINGS_t)) ? rec.size : sizeof(ROM_SETTINGS_t);
+        if ((rec.magic == ROM_SETTINGS_MAGIC) && (sz >= hdr_sz + known)) {
+            uint16_t crc = esp8266_mlib::crc16((const uint8_t *)&rec.settings, known);
+
+            // Settings from a newer firmware: CRC the fields unknown to us.
+            uint8_t buf[16];
+            uint32_t left = rec.size - known;
+            while (left > 0) {
+                uint32_t n = f.read(buf, (left < sizeof(buf)) ? left : sizeof(buf));
+                if (n == 0) {
+                    break;
+                }
+                crc = esp8266_mlib::crc16(buf, n, crc);
+                left -= n;
+            }
+
+            if ((left == 0) && (crc == rec.crc)) {
+                memset((uint8_t *)&rec.settings + known, 0, sizeof(ROM_SETTINGS_t) - known);
+                memcpy(&g_rom_settings, &rec.settings, sizeof(ROM_SETTINGS_t));
+                valid = true;
+            }
+        }
+        f.close();
+        DB("\r\n%s: version=%u, size=%u, valid=%u", __FUNCTION__, rec.version, rec.size, valid);
+    } else if (SPIFFS.exists(ROM_SETTINGS_TXT_FILE_NAME)) {
+        DB("\r\n%s: convert text settings", __FUNCTION__);
+        load_rom_settings_txt();
+        if (store_rom_settings()) {
+            SPIFFS.remove(ROM_SETTINGS_TXT_FILE_NAME);
+        }
+    }
+}
+
+/**
+ * Load settings from the text file of old firmwares.
  * File format (text):
  *  Line-0: [MagicNumber][LF]
  *  Line-1: [ssid][LF]
@@ -194,10 +476,10 @@ void wifi_inf::resolve_server()
  *  Line-5: [security][LF]
  *  Line-6: [timezone][LF]
 */
-void wifi_inf::load_rom_settings()
+void wifi_inf::load_rom_settings_txt()
 {
-    char file_buf[ROM_SETTINGS_SIZE];
-    uint32_t sz = esp8266_mlib::load_file(ROM_SETTINGS_FILE_NAME, file_buf, ROM_SETTINGS_SIZE);
+    char file_buf[ROM_SETTINGS_TXT_SIZE];
+    uint32_t sz = esp8266_mlib::load_file(ROM_SETTINGS_TXT_FILE_NAME, file_buf, ROM_SETTINGS_TXT_SIZE);
     char *p1 = NULL;
     char *p2 = NULL;
 
@@ -267,29 +549,20 @@ void wifi_inf::load_rom_settings()
 }
 
 /**
- * Store settings to ROM memory.
+ * Store settings to ROM memory: return true if stored (the file is replaced only then).
 */
-void wifi_inf::store_rom_settings()
+bool wifi_inf::store_rom_settings()
 {
-    char file_buf[ROM_SETTINGS_SIZE] = "";
-    char str[64];
-
-	snprintf(str, CFG_PASSWORD_SZ, "%u\n", g_rom_settings.magic_number);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SSID_SZ, "%s\n", g_rom_settings.ssid);
-	strcat(file_buf, str);
-    snprintf(str, CFG_PASSWORD_SZ, "%s\n", g_rom_settings.password);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SERVER_SZ, "%s\n", g_rom_settings.server_addr);
-    strcat(file_buf, str);
-	snprintf(str, CFG_PASSWORD_SZ, "%u\n", g_rom_settings.server_port);
-    strcat(file_buf, str);
-    snprintf(str, CFG_SECURITY_SZ, "%s\n", g_rom_settings.security);
-    strcat(file_buf, str);
-	snprintf(str, CFG_SECURITY_SZ, "%d\n", g_rom_settings.timezone);
-    strcat(file_buf, str);
-    DB("\r\n%s: -> content=[%s]", __FUNCTION__, file_buf);
-    esp8266_mlib::save_file(ROM_SETTINGS_FILE_NAME, file_buf);
+    ROM_SETTINGS_FILE_t rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = ROM_SETTINGS_MAGIC;
+    rec.version = ROM_SETTINGS_VERSION;
+    rec.size = sizeof(ROM_SETTINGS_t);
+    memcpy(&rec.settings, &g_rom_settings, sizeof(ROM_SETTINGS_t));
+    rec.crc = esp8266_mlib::crc16((const uint8_t *)&rec.settings, sizeof(ROM_SETTINGS_t));
+    DB("\r\n%s: version=%u, size=%u", __FUNCTION__, rec.version, rec.size);
+    return esp8266_mlib::save_data(ROM_SETTINGS_FILE_NAME, &rec, sizeof(rec));
 }
 
 /**
@@ -298,41 +571,35 @@ void wifi_inf::store_rom_settings()
 */
 void wifi_inf::load_rtc_settings()
 {
-    uint32_t buf[8];
-
-    // Load RAM settings: [Magic(4)][LocIp(4)][Gw(4)][Subnet(4)][ServerIp(4)][BootCnt(4)]
-    ESP.rtcUserMemoryRead(RTC_SETTINGS_ADDR, buf, RTC_SETTINGS_CNT * 4);
-    if (buf[0] != RTC_MAGIC_VALUE) {
+    int8_t id = rtc_mem::add("wifi", RTC_SETTINGS_VERSION, &g_rtc_settings, sizeof(g_rtc_settings));
+    if (!rtc_mem::is_valid(id)) {
         DB("->RTC invalid!");
-        g_wifi_status.local_ip = 0;
-        g_wifi_status.gateway = 0;
-        g_wifi_status.subnet = 0;
-        g_wifi_status.server_ip = 0;
-        g_wifi_status.boot_cnt = 0;
-    } else {
-        g_wifi_status.local_ip = buf[1];
-        g_wifi_status.gateway = buf[2];
-        g_wifi_status.subnet = buf[3];
-        g_wifi_status.server_ip = buf[4];
-        g_wifi_status.boot_cnt = buf[5];
-        DB("->RTC settings: ip=%08lXh, gw=%08lXh, sub=%08lXh, serverip=%08lXh, boot_cnt=%u", 
-            g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, 
-            g_wifi_status.server_ip, g_wifi_status.boot_cnt);
     }
+    g_wifi_status.local_ip = g_rtc_settings.local_ip;
+    g_wifi_status.gateway = g_rtc_settings.gateway;
+    g_wifi_status.subnet = g_rtc_settings.subnet;
+    g_wifi_status.server_ip = g_rtc_settings.server_ip;
+    g_wifi_status.boot_cnt = g_rtc_settings.boot_cnt;
+    g_wifi_status.profile = g_rtc_settings.profile;
+
+    id = rtc_mem::add("wifi_ap", RTC_AP_STATS_VERSION, g_rtc_ap_stats, sizeof(g_rtc_ap_stats));
+    if (!rtc_mem::is_valid(id)) {
+        DB("->RTC AP stats invalid!");
+    }
+    DB("->RTC settings: ip=%08lXh, gw=%08lXh, sub=%08lXh, serverip=%08lXh, boot_cnt=%u", 
+        g_wifi_status.local_ip, g_wifi_status.gateway, g_wifi_status.subnet, 
+        g_wifi_status.server_ip, g_wifi_status.boot_cnt);
 }
 
 /**
- * Store local settings to RTC memory.
+ * Store local settings to RTC memory: the region is written by rtc_mem::store() before sleeping.
 */
 void wifi_inf::store_rtc_settings()
 {
-    uint32_t buf[8];
-
-    buf[0] = RTC_MAGIC_VALUE;    
-    buf[1] = g_wifi_status.local_ip;
-    buf[2] = g_wifi_status.gateway;
-    buf[3] = g_wifi_status.subnet;
-    buf[4] = g_wifi_status.server_ip;
-    buf[5] = g_wifi_status.boot_cnt;
-    ESP.rtcUserMemoryWrite(RTC_SETTINGS_ADDR, buf, RTC_SETTINGS_CNT * 4);
-}
\ No newline at end of file
+    g_rtc_settings.local_ip = g_wifi_status.local_ip;
+    g_rtc_settings.gateway = g_wifi_status.gateway;
+    g_rtc_settings.subnet = g_wifi_status.subnet;
+    g_rtc_settings.server_ip = g_wifi_status.server_ip;
+    g_rtc_settings.boot_cnt = g_wifi_status.boot_cnt;
+    g_rtc_settings.profile = g_wifi_status.profile;
+}
@@ -7,14 +7,26 @@
 #define _WIFI_INF_H_
 
 #include <ESP8266WiFi.h>
+#include "ap_stats.h"
 
 /* Settings parameter limits */
 #define CFG_SSID_SZ             32
 #define CFG_PASSWORD_SZ         32
-#define CFG_SERVER_SZ           64
+#define CFG_SERVER_SZ           96
 #define CFG_SECURITY_SZ         32
 
-/* ROM memory settings parameters */
+/* AP profiles: the one of the settings (ssid, password) & WIFI_AP_PROFILE_CNT - 1 extra ones */
+#define WIFI_AP_PROFILE_CNT     4
+
+struct WIFI_AP_t {
+    char ssid[CFG_SSID_SZ];         // "" if not used
+    char password[CFG_PASSWORD_SZ];
+};
+
+/* ROM memory settings parameters: stored as a binary record (see wifi_inf::load_rom_settings()).
+New fields must be appended at the end, with ROM_SETTINGS_VERSION increased. */
+#define ROM_SETTINGS_VERSION    2
+
 struct ROM_SETTINGS_t {
 	uint32_t magic_number;
     char ssid[CFG_SSID_SZ];
@@ -23,16 +35,24 @@ struct ROM_SETTINGS_t {
 	uint32_t server_port;
     char security[CFG_SECURITY_SZ];
 	int32_t timezone;
+    WIFI_AP_t ap_extra[WIFI_AP_PROFILE_CNT - 1];    // Version 2
 };
 
-/* RTC (RAM memory) settings parameters */
+/* RTC (RAM memory) settings parameters: the "wifi" region of rtc_mem */
+#define RTC_SETTINGS_VERSION    2
+
 struct RTC_SETTINGS_t {
-    uint32_t local_ip;
+    uint32_t local_ip;              // Of the 'profile' network
     uint32_t gateway;
     uint32_t subnet;
     uint32_t server_ip;
+    uint32_t boot_cnt;
+    uint32_t profile;               // Last connected AP profile
 };
 
+/* AP profile statistics: the "wifi_ap" region of rtc_mem */
+#define RTC_AP_STATS_VERSION    1
+
 /* WIFI Status */
 struct WIFI_STATUS_t {
 	uint8_t mode;
@@ -44,14 +64,25 @@ struct WIFI_STATUS_t {
     uint32_t subnet;
 	uint32_t server_ip;
 	uint32_t boot_cnt;
+	uint32_t profile;
 };
 
 class wifi_inf
 {
     public:
         /* Start wifi connection: if having valid settings -> start in Station mode, 
-		if not -> start in Access Point mode */
-        static void start(uint8_t force_ap);
+		if not -> start in Access Point mode. Station mode: join the AP later (associate())
+		if 'join' is false. */
+        static void start(uint8_t force_ap, bool join = true);
+
+        /* Station mode: join the AP, return true if connected */
+        static bool associate();
+
+        /* Channel of the last connected AP, 0 if unknown */
+        static uint8_t get_channel();
+
+        /* RSSI of the last connected AP (dBm), 0 if unknown */
+        static int8_t get_rssi();
 
         /* Get current settings */
         static const ROM_SETTINGS_t *get_settings();
@@ -64,9 +95,14 @@ class wifi_inf
 		static void factory_reset();
 	
 	private:
+		static bool connect();
+		static bool connect_profile(uint8_t idx, uint32_t timeout_ms);
+		static uint8_t scan_profiles();
+		static const char *get_profile(uint8_t idx, const char **password);
 		static void resolve_server();
 		static void load_rom_settings();
-		static void store_rom_settings();
+		static void load_rom_settings_txt();
+		static bool store_rom_settings();
 		static void load_rtc_settings();
 		static void store_rtc_settings();
 };